@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+// atlaspacker.cpp
+// ============
+// place rectangles on a texture atlas page with the skyline bottom-left
+// heuristic
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <climits>
+
+/***********************************************************
+ *  AtlasPacker()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AtlasPacker::AtlasPacker()
+{
+	m_width = 0;
+	m_height = 0;
+	m_usedArea = 0;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for starting an empty page, whose
+ *  skyline is a single segment along the bottom.
+ ***********************************************************/
+void AtlasPacker::Reset(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+	m_usedArea = 0;
+
+	SKYLINE_NODE node;
+	node.x = 0;
+	node.y = 0;
+	node.width = width;
+	m_skyline.clear();
+	m_skyline.push_back(node);
+}
+
+/***********************************************************
+ *  FitRectangle()
+ *
+ *  This method is used for finding how low a rectangle can
+ *  rest with its left edge at the start of a segment, which
+ *  is on top of the highest segment it spans.
+ ***********************************************************/
+int AtlasPacker::FitRectangle(int nodeIndex, int width, int height) const
+{
+	const SKYLINE_NODE& node = m_skyline[nodeIndex];
+	if ((node.x + width) > m_width)
+	{
+		return(-1);
+	}
+
+	int top = node.y;
+	int widthLeft = width;
+	int index = nodeIndex;
+	while (widthLeft > 0)
+	{
+		top = std::max(top, m_skyline[index].y);
+		if ((top + height) > m_height)
+		{
+			return(-1);
+		}
+		widthLeft -= m_skyline[index].width;
+		index++;
+	}
+
+	return(top);
+}
+
+/***********************************************************
+ *  Insert()
+ *
+ *  This method is used for placing a rectangle where its
+ *  top edge is lowest, then raising the skyline over it
+ *  and merging the segments that end up level.
+ ***********************************************************/
+bool AtlasPacker::Insert(int width, int height, int& outX, int& outY)
+{
+	int bestIndex = -1;
+	int bestTop = INT_MAX;
+	int bestWidth = INT_MAX;
+
+	for (int i = 0; i < m_skyline.size(); i++)
+	{
+		int top = FitRectangle(i, width, height);
+		if (top < 0)
+		{
+			continue;
+		}
+		if (((top + height) < bestTop) ||
+			(((top + height) == bestTop) && (m_skyline[i].width < bestWidth)))
+		{
+			bestIndex = i;
+			bestTop = top + height;
+			bestWidth = m_skyline[i].width;
+		}
+	}
+
+	if (bestIndex < 0)
+	{
+		return(false);
+	}
+
+	outX = m_skyline[bestIndex].x;
+	outY = bestTop - height;
+
+	SKYLINE_NODE node;
+	node.x = outX;
+	node.y = bestTop;
+	node.width = width;
+	m_skyline.insert(m_skyline.begin() + bestIndex, node);
+
+	// cut the segments now covered by the new one
+	for (int i = bestIndex + 1; i < m_skyline.size(); i++)
+	{
+		const SKYLINE_NODE& previous = m_skyline[i - 1];
+		int overlap = (previous.x + previous.width) - m_skyline[i].x;
+		if (overlap <= 0)
+		{
+			break;
+		}
+
+		m_skyline[i].x += overlap;
+		m_skyline[i].width -= overlap;
+		if (m_skyline[i].width > 0)
+		{
+			break;
+		}
+		m_skyline.erase(m_skyline.begin() + i);
+		i--;
+	}
+
+	// join neighbors at the same height
+	for (int i = 0; (i + 1) < m_skyline.size(); i++)
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+			i--;
+		}
+	}
+
+	m_usedArea += (long long)width * height;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetOccupancy()
+ *
+ *  This method is used for getting how much of the page the
+ *  placed rectangles cover.
+ ***********************************************************/
+float AtlasPacker::GetOccupancy() const
+{
+	if ((m_width <= 0) || (m_height <= 0))
+	{
+		return(0.0f);
+	}
+
+	return((float)((double)m_usedArea / ((double)m_width * m_height)));
+}
@@ -0,0 +1,55 @@
+///////////////////////////////////////////////////////////////////////////////
+// atlaspacker.h
+// ============
+// place rectangles on a texture atlas page with the skyline bottom-left
+// heuristic
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+/***********************************************************
+ *  AtlasPacker
+ *
+ *  This class tracks the filled part of an atlas page as a
+ *  skyline, the top edge of the rectangles placed so far,
+ *  stored as horizontal segments from left to right.  A new
+ *  rectangle goes where its top edge ends up lowest, and on
+ *  the narrowest segment when that is a tie, which keeps
+ *  the skyline flat and wastes little space for rectangles
+ *  inserted tallest first.
+ ***********************************************************/
+class AtlasPacker
+{
+public:
+	// constructor
+	AtlasPacker();
+
+	// start an empty page of this size
+	void Reset(int width, int height);
+	// place a rectangle, false when the page has no room
+	bool Insert(int width, int height, int& outX, int& outY);
+	// fraction of the page area covered by rectangles
+	float GetOccupancy() const;
+
+private:
+	// one horizontal segment of the skyline
+	struct SKYLINE_NODE
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	std::vector<SKYLINE_NODE> m_skyline;
+	int m_width;
+	int m_height;
+	long long m_usedArea;
+
+	// lowest top a rectangle can rest at with its left edge on
+	// a segment, or -1 when it does not fit there
+	int FitRectangle(int nodeIndex, int width, int height) const;
+};
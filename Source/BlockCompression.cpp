@@ -0,0 +1,679 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockcompression.cpp
+// ============
+// encode and decode the BC1, BC3 and BC7 block compressed texture formats
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// declaration of the global variables and defines
+namespace
+{
+	// texels and channels of a 4x4 RGBA block
+	const int BLOCK_TEXELS = 16;
+	const int BLOCK_CHANNELS = 4;
+
+	// interpolation weights of the 4 bit BC7 indices, out of 64
+	const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// position in a block while packing or unpacking its bits,
+	// lowest bit of the first byte first
+	struct BLOCK_BITS
+	{
+		unsigned char* bytes;
+		int position;
+	};
+
+	void WriteBits(BLOCK_BITS& bits, unsigned int value, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if ((value >> i) & 1)
+			{
+				bits.bytes[bits.position >> 3] |= (unsigned char)(1 << (bits.position & 7));
+			}
+			bits.position++;
+		}
+	}
+
+	unsigned int ReadBits(BLOCK_BITS& bits, int count)
+	{
+		unsigned int value = 0;
+		for (int i = 0; i < count; i++)
+		{
+			value |= ((bits.bytes[bits.position >> 3] >> (bits.position & 7)) & 1u) << i;
+			bits.position++;
+		}
+		return(value);
+	}
+
+	// find the mean of the first channels of the texels and the
+	// axis they spread the most along, by power iteration on
+	// their covariance
+	void FindPrincipalAxis(const unsigned char* texels, int channels, float* mean, float* axis)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			mean[c] = 0.0f;
+			for (int i = 0; i < BLOCK_TEXELS; i++)
+			{
+				mean[c] += texels[(i * BLOCK_CHANNELS) + c];
+			}
+			mean[c] /= BLOCK_TEXELS;
+		}
+
+		float covariance[4][4] = { { 0.0f } };
+		for (int i = 0; i < BLOCK_TEXELS; i++)
+		{
+			float offset[4];
+			for (int c = 0; c < channels; c++)
+			{
+				offset[c] = texels[(i * BLOCK_CHANNELS) + c] - mean[c];
+			}
+			for (int row = 0; row < channels; row++)
+			{
+				for (int column = 0; column < channels; column++)
+				{
+					covariance[row][column] += offset[row] * offset[column];
+				}
+			}
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			axis[c] = 1.0f;
+		}
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = { 0.0f };
+			float length = 0.0f;
+			for (int row = 0; row < channels; row++)
+			{
+				for (int column = 0; column < channels; column++)
+				{
+					next[row] += covariance[row][column] * axis[column];
+				}
+				length += next[row] * next[row];
+			}
+
+			// a flat block has no axis, any direction will do
+			if (length < 1.0e-12f)
+			{
+				break;
+			}
+			length = std::sqrt(length);
+			for (int c = 0; c < channels; c++)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float length = 0.0f;
+		for (int c = 0; c < channels; c++)
+		{
+			length += axis[c] * axis[c];
+		}
+		length = std::sqrt(length);
+		for (int c = 0; c < channels; c++)
+		{
+			axis[c] /= length;
+		}
+	}
+
+	// place two endpoints at the ends of the texel spread
+	// along the main axis, the first at the low end
+	void FindEndpoints(const unsigned char* texels, int channels, float* outLow, float* outHigh)
+	{
+		float mean[4];
+		float axis[4];
+		FindPrincipalAxis(texels, channels, mean, axis);
+
+		float lowest = 0.0f;
+		float highest = 0.0f;
+		for (int i = 0; i < BLOCK_TEXELS; i++)
+		{
+			float projection = 0.0f;
+			for (int c = 0; c < channels; c++)
+			{
+				projection += (texels[(i * BLOCK_CHANNELS) + c] - mean[c]) * axis[c];
+			}
+			lowest = std::min(lowest, projection);
+			highest = std::max(highest, projection);
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			outLow[c] = std::min(std::max(mean[c] + (lowest * axis[c]), 0.0f), 255.0f);
+			outHigh[c] = std::min(std::max(mean[c] + (highest * axis[c]), 0.0f), 255.0f);
+		}
+	}
+
+	// squared error between a texel and a palette color
+	int ColorError(const unsigned char* texel, const int* color, int channels)
+	{
+		int error = 0;
+		for (int c = 0; c < channels; c++)
+		{
+			int difference = (int)texel[c] - color[c];
+			error += difference * difference;
+		}
+		return(error);
+	}
+
+	unsigned short PackRGB565(const float* color)
+	{
+		int red = (int)((color[0] * 31.0f / 255.0f) + 0.5f);
+		int green = (int)((color[1] * 63.0f / 255.0f) + 0.5f);
+		int blue = (int)((color[2] * 31.0f / 255.0f) + 0.5f);
+		return((unsigned short)((red << 11) | (green << 5) | blue));
+	}
+
+	void UnpackRGB565(unsigned short packed, int* outColor)
+	{
+		int red = (packed >> 11) & 0x1F;
+		int green = (packed >> 5) & 0x3F;
+		int blue = packed & 0x1F;
+		outColor[0] = (red << 3) | (red >> 2);
+		outColor[1] = (green << 2) | (green >> 4);
+		outColor[2] = (blue << 3) | (blue >> 2);
+	}
+
+	// encode the color of a block as BC1 in four color mode
+	void CompressColorBlock(const unsigned char* texels, unsigned char* outBlock)
+	{
+		float low[4];
+		float high[4];
+		FindEndpoints(texels, 3, low, high);
+
+		unsigned short color0 = PackRGB565(high);
+		unsigned short color1 = PackRGB565(low);
+		// four color mode needs the first color to be larger
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		outBlock[0] = (unsigned char)(color0 & 0xFF);
+		outBlock[1] = (unsigned char)(color0 >> 8);
+		outBlock[2] = (unsigned char)(color1 & 0xFF);
+		outBlock[3] = (unsigned char)(color1 >> 8);
+
+		unsigned int indices = 0;
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = ((2 * palette[0][c]) + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + (2 * palette[1][c])) / 3;
+			}
+
+			for (int i = 0; i < BLOCK_TEXELS; i++)
+			{
+				int bestIndex = 0;
+				int bestError = ColorError(&texels[i * BLOCK_CHANNELS], palette[0], 3);
+				for (int index = 1; index < 4; index++)
+				{
+					int error = ColorError(&texels[i * BLOCK_CHANNELS], palette[index], 3);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = index;
+					}
+				}
+				indices |= (unsigned int)bestIndex << (i * 2);
+			}
+		}
+
+		outBlock[4] = (unsigned char)(indices & 0xFF);
+		outBlock[5] = (unsigned char)((indices >> 8) & 0xFF);
+		outBlock[6] = (unsigned char)((indices >> 16) & 0xFF);
+		outBlock[7] = (unsigned char)((indices >> 24) & 0xFF);
+	}
+
+	// decode a BC1 color block, where three color mode with
+	// transparent black is only allowed outside of BC3
+	void DecompressColorBlock(const unsigned char* block, bool bAllowThreeColor, unsigned char* outTexels)
+	{
+		unsigned short color0 = (unsigned short)(block[0] | (block[1] << 8));
+		unsigned short color1 = (unsigned short)(block[2] | (block[3] << 8));
+		unsigned int indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((unsigned int)block[7] << 24);
+
+		int palette[4][4];
+		UnpackRGB565(color0, palette[0]);
+		UnpackRGB565(color1, palette[1]);
+		for (int index = 0; index < 4; index++)
+		{
+			palette[index][3] = 255;
+		}
+		for (int c = 0; c < 3; c++)
+		{
+			if ((color0 > color1) || (bAllowThreeColor == false))
+			{
+				palette[2][c] = ((2 * palette[0][c]) + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + (2 * palette[1][c])) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		if ((color0 <= color1) && bAllowThreeColor)
+		{
+			palette[3][3] = 0;
+		}
+
+		for (int i = 0; i < BLOCK_TEXELS; i++)
+		{
+			int index = (indices >> (i * 2)) & 3;
+			for (int c = 0; c < BLOCK_CHANNELS; c++)
+			{
+				outTexels[(i * BLOCK_CHANNELS) + c] = (unsigned char)palette[index][c];
+			}
+		}
+	}
+
+	// pick the 7 bit endpoint and p-bit closest to an 8 bit color
+	int QuantizeBC7Endpoint(const float* color, int* outComponents)
+	{
+		int bestBit = 0;
+		float bestError = 0.0f;
+		for (int bit = 0; bit < 2; bit++)
+		{
+			float error = 0.0f;
+			int components[4];
+			for (int c = 0; c < BLOCK_CHANNELS; c++)
+			{
+				components[c] = std::min(std::max((int)std::floor(((color[c] - bit) / 2.0f) + 0.5f), 0), 127);
+				float difference = (float)((components[c] << 1) | bit) - color[c];
+				error += difference * difference;
+			}
+			if ((bit == 0) || (error < bestError))
+			{
+				bestBit = bit;
+				bestError = error;
+				for (int c = 0; c < BLOCK_CHANNELS; c++)
+				{
+					outComponents[c] = components[c];
+				}
+			}
+		}
+		return(bestBit);
+	}
+}
+
+/***********************************************************
+ *  GetBlockBytes()
+ *
+ *  This method is used for getting the size of one 4x4
+ *  block of a format.
+ ***********************************************************/
+int BlockCompression::GetBlockBytes(BLOCK_FORMAT format)
+{
+	return((format == FORMAT_BC1) ? 8 : 16);
+}
+
+/***********************************************************
+ *  GetImageSize()
+ *
+ *  This method is used for getting the size of an image
+ *  after compression.  Sizes that are not a multiple of 4
+ *  round up to whole blocks.
+ ***********************************************************/
+size_t BlockCompression::GetImageSize(BLOCK_FORMAT format, int width, int height)
+{
+	size_t blocksX = (size_t)(width + 3) / 4;
+	size_t blocksY = (size_t)(height + 3) / 4;
+
+	return(blocksX * blocksY * GetBlockBytes(format));
+}
+
+/***********************************************************
+ *  CompressImage()
+ *
+ *  This method is used for compressing an RGBA image block
+ *  by block.  Blocks on the right and bottom edges of sizes
+ *  that are not a multiple of 4 repeat the last texels.
+ ***********************************************************/
+void BlockCompression::CompressImage(
+	BLOCK_FORMAT format,
+	const unsigned char* rgbaPixels,
+	int width,
+	int height,
+	std::vector<unsigned char>& outBlocks)
+{
+	const int blockBytes = GetBlockBytes(format);
+	unsigned char texels[BLOCK_TEXELS * BLOCK_CHANNELS];
+
+	for (int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (int blockX = 0; blockX < width; blockX += 4)
+		{
+			for (int y = 0; y < 4; y++)
+			{
+				int sourceY = std::min(blockY + y, height - 1);
+				for (int x = 0; x < 4; x++)
+				{
+					int sourceX = std::min(blockX + x, width - 1);
+					memcpy(
+						&texels[((y * 4) + x) * BLOCK_CHANNELS],
+						&rgbaPixels[(((size_t)sourceY * width) + sourceX) * BLOCK_CHANNELS],
+						BLOCK_CHANNELS);
+				}
+			}
+
+			size_t offset = outBlocks.size();
+			outBlocks.resize(offset + blockBytes);
+			switch (format)
+			{
+			case FORMAT_BC1:
+				CompressBC1Block(texels, &outBlocks[offset]);
+				break;
+			case FORMAT_BC3:
+				CompressBC3Block(texels, &outBlocks[offset]);
+				break;
+			case FORMAT_BC7:
+				CompressBC7Block(texels, &outBlocks[offset]);
+				break;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  DecompressImage()
+ *
+ *  This method is used for decompressing the blocks of an
+ *  image back into RGBA pixels.
+ ***********************************************************/
+void BlockCompression::DecompressImage(
+	BLOCK_FORMAT format,
+	const unsigned char* blocks,
+	int width,
+	int height,
+	std::vector<unsigned char>& outRgbaPixels)
+{
+	const int blockBytes = GetBlockBytes(format);
+	unsigned char texels[BLOCK_TEXELS * BLOCK_CHANNELS];
+
+	outRgbaPixels.resize((size_t)width * height * BLOCK_CHANNELS);
+
+	for (int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (int blockX = 0; blockX < width; blockX += 4)
+		{
+			switch (format)
+			{
+			case FORMAT_BC1:
+				DecompressBC1Block(blocks, texels);
+				break;
+			case FORMAT_BC3:
+				DecompressBC3Block(blocks, texels);
+				break;
+			case FORMAT_BC7:
+				DecompressBC7Block(blocks, texels);
+				break;
+			}
+			blocks += blockBytes;
+
+			for (int y = 0; (y < 4) && ((blockY + y) < height); y++)
+			{
+				for (int x = 0; (x < 4) && ((blockX + x) < width); x++)
+				{
+					memcpy(
+						&outRgbaPixels[((((size_t)blockY + y) * width) + blockX + x) * BLOCK_CHANNELS],
+						&texels[((y * 4) + x) * BLOCK_CHANNELS],
+						BLOCK_CHANNELS);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  CompressBC1Block()
+ *
+ *  This method is used for encoding the 16 texels of a
+ *  block as BC1, ignoring their alpha.
+ ***********************************************************/
+void BlockCompression::CompressBC1Block(const unsigned char* texels, unsigned char* outBlock)
+{
+	CompressColorBlock(texels, outBlock);
+}
+
+/***********************************************************
+ *  CompressBC3Block()
+ *
+ *  This method is used for encoding the 16 texels of a
+ *  block as BC3.  The alpha endpoints are the lowest and
+ *  highest alpha of the block, with six steps between them.
+ ***********************************************************/
+void BlockCompression::CompressBC3Block(const unsigned char* texels, unsigned char* outBlock)
+{
+	int lowest = 255;
+	int highest = 0;
+	for (int i = 0; i < BLOCK_TEXELS; i++)
+	{
+		lowest = std::min(lowest, (int)texels[(i * BLOCK_CHANNELS) + 3]);
+		highest = std::max(highest, (int)texels[(i * BLOCK_CHANNELS) + 3]);
+	}
+
+	// eight value mode needs the first alpha to be larger
+	memset(outBlock, 0, 8);
+	outBlock[0] = (unsigned char)highest;
+	outBlock[1] = (unsigned char)lowest;
+
+	if (highest > lowest)
+	{
+		int palette[8];
+		palette[0] = highest;
+		palette[1] = lowest;
+		for (int index = 2; index < 8; index++)
+		{
+			palette[index] = (((8 - index) * highest) + ((index - 1) * lowest)) / 7;
+		}
+
+		BLOCK_BITS bits;
+		bits.bytes = outBlock;
+		bits.position = 16;
+		for (int i = 0; i < BLOCK_TEXELS; i++)
+		{
+			int alpha = texels[(i * BLOCK_CHANNELS) + 3];
+			int bestIndex = 0;
+			for (int index = 1; index < 8; index++)
+			{
+				if (std::abs(palette[index] - alpha) < std::abs(palette[bestIndex] - alpha))
+				{
+					bestIndex = index;
+				}
+			}
+			WriteBits(bits, bestIndex, 3);
+		}
+	}
+
+	CompressColorBlock(texels, outBlock + 8);
+}
+
+/***********************************************************
+ *  CompressBC7Block()
+ *
+ *  This method is used for encoding the 16 texels of a
+ *  block in BC7 mode 6: one subset, RGBA endpoints of 7
+ *  bits plus a p-bit each, and 4 bit indices.  The index of
+ *  the first texel has an implied high bit of 0, so the
+ *  endpoints are swapped when it would need a 1.
+ ***********************************************************/
+void BlockCompression::CompressBC7Block(const unsigned char* texels, unsigned char* outBlock)
+{
+	float low[4];
+	float high[4];
+	FindEndpoints(texels, BLOCK_CHANNELS, low, high);
+
+	int endpoints[2][4];
+	int pBits[2];
+	pBits[0] = QuantizeBC7Endpoint(low, endpoints[0]);
+	pBits[1] = QuantizeBC7Endpoint(high, endpoints[1]);
+
+	int palette[16][4];
+	for (int c = 0; c < BLOCK_CHANNELS; c++)
+	{
+		int value0 = (endpoints[0][c] << 1) | pBits[0];
+		int value1 = (endpoints[1][c] << 1) | pBits[1];
+		for (int index = 0; index < 16; index++)
+		{
+			palette[index][c] = (((64 - BC7_WEIGHTS[index]) * value0) + (BC7_WEIGHTS[index] * value1) + 32) >> 6;
+		}
+	}
+
+	int indices[BLOCK_TEXELS];
+	for (int i = 0; i < BLOCK_TEXELS; i++)
+	{
+		int bestIndex = 0;
+		int bestError = ColorError(&texels[i * BLOCK_CHANNELS], palette[0], BLOCK_CHANNELS);
+		for (int index = 1; index < 16; index++)
+		{
+			int error = ColorError(&texels[i * BLOCK_CHANNELS], palette[index], BLOCK_CHANNELS);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = index;
+			}
+		}
+		indices[i] = bestIndex;
+	}
+
+	if (indices[0] >= 8)
+	{
+		for (int c = 0; c < BLOCK_CHANNELS; c++)
+		{
+			std::swap(endpoints[0][c], endpoints[1][c]);
+		}
+		std::swap(pBits[0], pBits[1]);
+		for (int i = 0; i < BLOCK_TEXELS; i++)
+		{
+			indices[i] = 15 - indices[i];
+		}
+	}
+
+	memset(outBlock, 0, 16);
+	BLOCK_BITS bits;
+	bits.bytes = outBlock;
+	bits.position = 0;
+
+	// mode 6 is six 0 bits followed by a 1
+	WriteBits(bits, 1 << 6, 7);
+	for (int c = 0; c < BLOCK_CHANNELS; c++)
+	{
+		WriteBits(bits, endpoints[0][c], 7);
+		WriteBits(bits, endpoints[1][c], 7);
+	}
+	WriteBits(bits, pBits[0], 1);
+	WriteBits(bits, pBits[1], 1);
+	WriteBits(bits, indices[0], 3);
+	for (int i = 1; i < BLOCK_TEXELS; i++)
+	{
+		WriteBits(bits, indices[i], 4);
+	}
+}
+
+/***********************************************************
+ *  DecompressBC1Block()
+ *
+ *  This method is used for decoding a BC1 block into its
+ *  16 RGBA texels.
+ ***********************************************************/
+void BlockCompression::DecompressBC1Block(const unsigned char* block, unsigned char* outTexels)
+{
+	DecompressColorBlock(block, true, outTexels);
+}
+
+/***********************************************************
+ *  DecompressBC3Block()
+ *
+ *  This method is used for decoding a BC3 block into its
+ *  16 RGBA texels.
+ ***********************************************************/
+void BlockCompression::DecompressBC3Block(const unsigned char* block, unsigned char* outTexels)
+{
+	DecompressColorBlock(block + 8, false, outTexels);
+
+	int alpha0 = block[0];
+	int alpha1 = block[1];
+	int palette[8];
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	if (alpha0 > alpha1)
+	{
+		for (int index = 2; index < 8; index++)
+		{
+			palette[index] = (((8 - index) * alpha0) + ((index - 1) * alpha1)) / 7;
+		}
+	}
+	else
+	{
+		for (int index = 2; index < 6; index++)
+		{
+			palette[index] = (((6 - index) * alpha0) + ((index - 1) * alpha1)) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	BLOCK_BITS bits;
+	bits.bytes = const_cast<unsigned char*>(block);
+	bits.position = 16;
+	for (int i = 0; i < BLOCK_TEXELS; i++)
+	{
+		outTexels[(i * BLOCK_CHANNELS) + 3] = (unsigned char)palette[ReadBits(bits, 3)];
+	}
+}
+
+/***********************************************************
+ *  DecompressBC7Block()
+ *
+ *  This method is used for decoding a BC7 mode 6 block into
+ *  its 16 RGBA texels.  Blocks of the other modes decode to
+ *  transparent black.
+ ***********************************************************/
+void BlockCompression::DecompressBC7Block(const unsigned char* block, unsigned char* outTexels)
+{
+	memset(outTexels, 0, BLOCK_TEXELS * BLOCK_CHANNELS);
+	if ((block[0] & 0x7F) != 0x40)
+	{
+		return;
+	}
+
+	BLOCK_BITS bits;
+	bits.bytes = const_cast<unsigned char*>(block);
+	bits.position = 7;
+
+	int endpoints[2][4];
+	for (int c = 0; c < BLOCK_CHANNELS; c++)
+	{
+		endpoints[0][c] = ReadBits(bits, 7);
+		endpoints[1][c] = ReadBits(bits, 7);
+	}
+	int pBit0 = ReadBits(bits, 1);
+	int pBit1 = ReadBits(bits, 1);
+
+	for (int i = 0; i < BLOCK_TEXELS; i++)
+	{
+		int index = ReadBits(bits, (i == 0) ? 3 : 4);
+		for (int c = 0; c < BLOCK_CHANNELS; c++)
+		{
+			int value0 = (endpoints[0][c] << 1) | pBit0;
+			int value1 = (endpoints[1][c] << 1) | pBit1;
+			outTexels[(i * BLOCK_CHANNELS) + c] =
+				(unsigned char)((((64 - BC7_WEIGHTS[index]) * value0) + (BC7_WEIGHTS[index] * value1) + 32) >> 6);
+		}
+	}
+}
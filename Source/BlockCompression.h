@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockcompression.h
+// ============
+// encode and decode the BC1, BC3 and BC7 block compressed texture formats
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  BlockCompression
+ *
+ *  This class compresses RGBA images into 4x4 texel blocks
+ *  that the GPU samples directly:
+ *
+ *   BC1 - 8 bytes per block, two 565 colors and 2 bit
+ *         indices, for opaque images
+ *   BC3 - 16 bytes per block, a BC1 color block after an
+ *         alpha block of two 8 bit values and 3 bit indices
+ *   BC7 - 16 bytes per block, written in mode 6 only, with
+ *         two RGBA 7777 endpoints, a p-bit each and 4 bit
+ *         indices, for opaque and translucent images
+ *
+ *  The endpoints of every block are placed along the main
+ *  axis of its colors.  The decoders are only meant for
+ *  measuring the error of the encoders, and BC7 decoding
+ *  only understands mode 6.
+ ***********************************************************/
+class BlockCompression
+{
+public:
+	// block compressed formats
+	enum BLOCK_FORMAT
+	{
+		FORMAT_BC1 = 0,
+		FORMAT_BC3,
+		FORMAT_BC7
+	};
+
+	// bytes of one 4x4 block
+	static int GetBlockBytes(BLOCK_FORMAT format);
+	// bytes of an image of this size, rounded up to blocks
+	static size_t GetImageSize(BLOCK_FORMAT format, int width, int height);
+
+	// compress an RGBA image, appending the blocks row by row
+	static void CompressImage(
+		BLOCK_FORMAT format,
+		const unsigned char* rgbaPixels,
+		int width,
+		int height,
+		std::vector<unsigned char>& outBlocks);
+	// decompress the blocks of an image into RGBA pixels
+	static void DecompressImage(
+		BLOCK_FORMAT format,
+		const unsigned char* blocks,
+		int width,
+		int height,
+		std::vector<unsigned char>& outRgbaPixels);
+
+	// compress or decompress the 16 RGBA texels of one block
+	static void CompressBC1Block(const unsigned char* texels, unsigned char* outBlock);
+	static void CompressBC3Block(const unsigned char* texels, unsigned char* outBlock);
+	static void CompressBC7Block(const unsigned char* texels, unsigned char* outBlock);
+	static void DecompressBC1Block(const unsigned char* block, unsigned char* outTexels);
+	static void DecompressBC3Block(const unsigned char* block, unsigned char* outTexels);
+	static void DecompressBC7Block(const unsigned char* block, unsigned char* outTexels);
+};
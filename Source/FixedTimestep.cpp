@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// fixedtimestep.cpp
+// ============
+// split the time between frames into fixed update steps, read from a 64 bit
+// monotonic clock, with the leftover time given as an interpolation factor
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FixedTimestep.h"
+
+#include <chrono>
+
+// declaration of the global variables and defines
+namespace
+{
+	// clock ticks in one second
+	const int64_t TICKS_PER_SECOND = 1000000000;
+}
+
+/***********************************************************
+ *  FixedTimestep()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FixedTimestep::FixedTimestep(double stepSeconds, int maxStepsPerFrame)
+{
+	m_stepTicks = (int64_t)(stepSeconds * (double)TICKS_PER_SECOND);
+	if (m_stepTicks < 1)
+	{
+		m_stepTicks = 1;
+	}
+	m_maxStepsPerFrame = (maxStepsPerFrame > 0) ? maxStepsPerFrame : 1;
+	Reset();
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for starting the clock over, such as
+ *  once the scene has loaded, so the load is not caught up.
+ ***********************************************************/
+void FixedTimestep::Reset()
+{
+	m_startTicks = GetClockTicks();
+	m_lastTicks = m_startTicks;
+	m_accumulatedTicks = 0;
+	m_droppedSteps = 0;
+}
+
+/***********************************************************
+ *  Advance()
+ *
+ *  This method is used for adding the time since the last
+ *  frame and taking the whole steps out of it.  Past the
+ *  cap, the whole steps are dropped and only the part of a
+ *  step is kept, so the updates carry on from the present
+ *  instead of replaying the stall.
+ ***********************************************************/
+int FixedTimestep::Advance()
+{
+	int64_t now = GetClockTicks();
+	m_accumulatedTicks += now - m_lastTicks;
+	m_lastTicks = now;
+
+	int64_t steps = m_accumulatedTicks / m_stepTicks;
+	if (steps > m_maxStepsPerFrame)
+	{
+		m_droppedSteps += steps - m_maxStepsPerFrame;
+		m_accumulatedTicks %= m_stepTicks;
+		steps = m_maxStepsPerFrame;
+	}
+	else
+	{
+		m_accumulatedTicks -= steps * m_stepTicks;
+	}
+
+	return((int)steps);
+}
+
+/***********************************************************
+ *  GetStepSeconds()
+ ***********************************************************/
+double FixedTimestep::GetStepSeconds() const
+{
+	return((double)m_stepTicks / (double)TICKS_PER_SECOND);
+}
+
+/***********************************************************
+ *  GetInterpolation()
+ *
+ *  This method is used for getting the part of a step the
+ *  clock is past the last update.
+ ***********************************************************/
+float FixedTimestep::GetInterpolation() const
+{
+	return((float)((double)m_accumulatedTicks / (double)m_stepTicks));
+}
+
+/***********************************************************
+ *  GetElapsedSeconds()
+ ***********************************************************/
+double FixedTimestep::GetElapsedSeconds() const
+{
+	return((double)(m_lastTicks - m_startTicks) / (double)TICKS_PER_SECOND);
+}
+
+/***********************************************************
+ *  GetDroppedSteps()
+ ***********************************************************/
+int64_t FixedTimestep::GetDroppedSteps() const
+{
+	return(m_droppedSteps);
+}
+
+/***********************************************************
+ *  GetClockTicks()
+ *
+ *  This method is used for reading the monotonic clock in
+ *  64 bit nanoseconds, which keeps full precision for
+ *  centuries of uptime.
+ ***********************************************************/
+int64_t FixedTimestep::GetClockTicks()
+{
+	return((int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// fixedtimestep.h
+// ============
+// split the time between frames into fixed update steps, read from a 64 bit
+// monotonic clock, with the leftover time given as an interpolation factor
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+/***********************************************************
+ *  FixedTimestep
+ *
+ *  This class runs the scene updates at a fixed rate while
+ *  the frames are rendered as fast as they come.  Each
+ *  frame reads the clock, and the time since the last frame
+ *  is added up in whole clock ticks, so there is no float
+ *  drift however long the application runs.  Every full
+ *  step of it is one update, and the part of a step that is
+ *  left over tells the renderer how far to blend from the
+ *  previous update to the last one.
+ *
+ *  After a stall - a long load, a debugger break, a window
+ *  drag - the catch-up is capped at a few steps per frame
+ *  and the rest of the time is dropped, so slow frames
+ *  never pile up more updates that make them slower still.
+ ***********************************************************/
+class FixedTimestep
+{
+public:
+	// constructor
+	FixedTimestep(double stepSeconds, int maxStepsPerFrame);
+
+	// start the clock over with no time left to update
+	void Reset();
+	// read the clock and get the number of updates to run
+	// before rendering this frame
+	int Advance();
+
+	// length of one update in seconds
+	double GetStepSeconds() const;
+	// how far the frame is past the last update, from 0 for
+	// the previous update to 1 for the last one
+	float GetInterpolation() const;
+	// seconds since Reset(), in double precision
+	double GetElapsedSeconds() const;
+	// updates dropped by the catch-up cap since Reset()
+	int64_t GetDroppedSteps() const;
+
+	// nanoseconds on the 64 bit monotonic clock
+	static int64_t GetClockTicks();
+
+private:
+	// length of one update in clock ticks
+	int64_t m_stepTicks;
+	int m_maxStepsPerFrame;
+	int64_t m_startTicks;
+	int64_t m_lastTicks;
+	// time read from the clock and not yet updated
+	int64_t m_accumulatedTicks;
+	int64_t m_droppedSteps;
+};
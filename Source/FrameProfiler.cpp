@@ -0,0 +1,553 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// ============
+// measure the CPU and GPU time of each section of a frame, and write the
+// measurements as a Chrome trace and as rolling per-section histograms
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+
+#if FRAME_PROFILER_ENABLED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// declaration of the global variables and defines
+namespace
+{
+	const char* SECTION_NAMES[FrameProfiler::SECTION_COUNT] =
+	{
+		"PrepareSceneView",
+		"TextureStreaming",
+		"Visibility",
+		"Submit",
+		"Draw",
+		"SwapBuffers"
+	};
+
+	// upper edges of the histogram buckets in milliseconds
+	const double BUCKET_LIMITS[FrameProfiler::HISTOGRAM_BUCKETS] =
+	{
+		0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0,
+		std::numeric_limits<double>::infinity()
+	};
+
+	// frames of queries in flight - the queries of a frame are
+	// read when the same set is used again
+	const int QUERY_FRAMES = 2;
+
+	// trace events of the whole frame use this section index
+	const int FRAME_EVENT = FrameProfiler::SECTION_COUNT;
+
+	// one complete event of the trace
+	struct TRACE_EVENT
+	{
+		int section;
+		bool bGpu;
+		int frame;
+		double startUs;
+		double durationUs;
+	};
+
+	// the samples of the last frames of one section, with the
+	// bucket counts kept up to date as samples come and go
+	struct ROLLING_HISTOGRAM
+	{
+		double samples[FrameProfiler::HISTOGRAM_FRAMES];
+		int next;
+		int count;
+		double sum;
+		int bucketCounts[FrameProfiler::HISTOGRAM_BUCKETS];
+	};
+
+	bool g_bEnabled = false;
+	bool g_bGpuTiming = false;
+	std::chrono::steady_clock::time_point g_startTime;
+	int g_frame = 0;
+	double g_frameStartUs = 0.0;
+
+	// CPU time of each section in the current frame, and its start
+	double g_sectionStartUs[FrameProfiler::SECTION_COUNT];
+	double g_frameSectionMs[FrameProfiler::SECTION_COUNT];
+	bool g_bSectionRan[FrameProfiler::SECTION_COUNT];
+
+	// elapsed time queries of each set, the CPU start of the
+	// section they time and the frame the set was issued in
+	GLuint g_queries[QUERY_FRAMES][FrameProfiler::SECTION_COUNT];
+	bool g_bQueryIssued[QUERY_FRAMES][FrameProfiler::SECTION_COUNT];
+	double g_queryStartUs[QUERY_FRAMES][FrameProfiler::SECTION_COUNT];
+	int g_queryFrame[QUERY_FRAMES];
+	// the section whose query is active, -1 for none
+	int g_activeQuerySection = -1;
+	int g_droppedQueries = 0;
+
+	// histograms of the CPU times [0] and the GPU times [1]
+	ROLLING_HISTOGRAM g_histograms[2][FrameProfiler::SECTION_COUNT];
+
+	std::vector<TRACE_EVENT> g_events;
+
+	/***********************************************************
+	 *  NowUs()
+	 *
+	 *  Microseconds since the profiler was initialized.
+	 ***********************************************************/
+	double NowUs()
+	{
+		return(std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - g_startTime).count());
+	}
+
+	/***********************************************************
+	 *  AddSample()
+	 *
+	 *  Add a time to a rolling histogram, replacing the oldest
+	 *  one once the window is full.
+	 ***********************************************************/
+	void AddSample(ROLLING_HISTOGRAM& histogram, double ms)
+	{
+		if (histogram.count == FrameProfiler::HISTOGRAM_FRAMES)
+		{
+			double oldest = histogram.samples[histogram.next];
+			histogram.sum -= oldest;
+			histogram.bucketCounts[std::lower_bound(BUCKET_LIMITS, BUCKET_LIMITS + FrameProfiler::HISTOGRAM_BUCKETS, oldest) - BUCKET_LIMITS]--;
+		}
+		else
+		{
+			histogram.count++;
+		}
+
+		histogram.samples[histogram.next] = ms;
+		histogram.sum += ms;
+		histogram.bucketCounts[std::lower_bound(BUCKET_LIMITS, BUCKET_LIMITS + FrameProfiler::HISTOGRAM_BUCKETS, ms) - BUCKET_LIMITS]++;
+		histogram.next = (histogram.next + 1) % FrameProfiler::HISTOGRAM_FRAMES;
+	}
+
+	/***********************************************************
+	 *  AddEvent()
+	 *
+	 *  Record an event of the trace, until the trace is full.
+	 ***********************************************************/
+	void AddEvent(int section, bool bGpu, int frame, double startUs, double durationUs)
+	{
+		if (g_events.size() < (size_t)FrameProfiler::MAX_TRACE_EVENTS)
+		{
+			TRACE_EVENT event = { section, bGpu, frame, startUs, durationUs };
+			g_events.push_back(event);
+		}
+	}
+
+	/***********************************************************
+	 *  CollectQueries()
+	 *
+	 *  Read the results of a set of queries.  Unless bWait is
+	 *  set, a result that is not available yet is dropped
+	 *  instead of stalling until the GPU gets to it.
+	 ***********************************************************/
+	void CollectQueries(int set, bool bWait)
+	{
+		for (int i = 0; i < FrameProfiler::SECTION_COUNT; i++)
+		{
+			if (!g_bQueryIssued[set][i])
+			{
+				continue;
+			}
+			g_bQueryIssued[set][i] = false;
+
+			GLint available = GL_TRUE;
+			if (!bWait)
+			{
+				glGetQueryObjectiv(g_queries[set][i], GL_QUERY_RESULT_AVAILABLE, &available);
+			}
+			if (available == GL_FALSE)
+			{
+				g_droppedQueries++;
+				continue;
+			}
+
+			GLuint64 elapsedNs = 0;
+			glGetQueryObjectui64v(g_queries[set][i], GL_QUERY_RESULT, &elapsedNs);
+			double elapsedUs = (double)elapsedNs / 1000.0;
+			AddSample(g_histograms[1][i], elapsedUs / 1000.0);
+			// the GPU work is placed at the time it was submitted,
+			// since an elapsed time query has no start time
+			AddEvent(i, true, g_queryFrame[set], g_queryStartUs[set][i], elapsedUs);
+		}
+	}
+
+	/***********************************************************
+	 *  WriteStatsRow()
+	 *
+	 *  Write one row of the histogram table.
+	 ***********************************************************/
+	void WriteStatsRow(std::ostream& output, FrameProfiler::SECTION section, bool bGpu)
+	{
+		FrameProfiler::SECTION_STATS stats;
+		FrameProfiler::GetSectionStats(section, bGpu, stats);
+		if (stats.samples == 0)
+		{
+			return;
+		}
+
+		output << std::left << std::setw(18) << FrameProfiler::GetSectionName(section)
+			<< std::setw(5) << (bGpu ? "GPU" : "CPU") << std::right
+			<< std::setw(9) << stats.meanMs
+			<< std::setw(9) << stats.p50Ms
+			<< std::setw(9) << stats.p95Ms
+			<< std::setw(9) << stats.maxMs << " |";
+		for (int i = 0; i < FrameProfiler::HISTOGRAM_BUCKETS; i++)
+		{
+			output << std::setw(6) << stats.bucketCounts[i];
+		}
+		output << std::endl;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for starting the profiler once the
+ *  OpenGL context is current.  The GPU sections are only
+ *  timed when the context has timer queries.
+ ***********************************************************/
+void FrameProfiler::Initialize()
+{
+	g_startTime = std::chrono::steady_clock::now();
+	g_frame = 0;
+	g_activeQuerySection = -1;
+	g_droppedQueries = 0;
+	g_events.clear();
+	g_events.reserve(SECTION_COUNT * 2 * 1024);
+
+	for (int type = 0; type < 2; type++)
+	{
+		for (int i = 0; i < SECTION_COUNT; i++)
+		{
+			ROLLING_HISTOGRAM& histogram = g_histograms[type][i];
+			histogram.next = 0;
+			histogram.count = 0;
+			histogram.sum = 0.0;
+			std::fill(histogram.bucketCounts, histogram.bucketCounts + HISTOGRAM_BUCKETS, 0);
+		}
+	}
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		g_frameSectionMs[i] = 0.0;
+		g_bSectionRan[i] = false;
+	}
+
+	g_bGpuTiming = (GLEW_VERSION_3_3 || GLEW_ARB_timer_query);
+	for (int set = 0; set < QUERY_FRAMES; set++)
+	{
+		if (g_bGpuTiming)
+		{
+			glGenQueries(SECTION_COUNT, g_queries[set]);
+		}
+		std::fill(g_bQueryIssued[set], g_bQueryIssued[set] + SECTION_COUNT, false);
+		g_queryFrame[set] = 0;
+	}
+
+	g_bEnabled = true;
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for stopping the profiler.  The
+ *  queries still in flight are waited for, so the last
+ *  frames are in the outputs, and then deleted.  The
+ *  recorded times are kept for writing the outputs.
+ ***********************************************************/
+void FrameProfiler::Shutdown()
+{
+	if (!g_bEnabled)
+	{
+		return;
+	}
+	g_bEnabled = false;
+
+	if (g_bGpuTiming)
+	{
+		if (g_activeQuerySection >= 0)
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+			g_activeQuerySection = -1;
+		}
+		for (int i = 0; i < QUERY_FRAMES; i++)
+		{
+			CollectQueries((g_frame + i) % QUERY_FRAMES, true);
+		}
+		for (int set = 0; set < QUERY_FRAMES; set++)
+		{
+			glDeleteQueries(SECTION_COUNT, g_queries[set]);
+		}
+	}
+
+	if (g_droppedQueries > 0)
+	{
+		std::cout << "WARNING: " << g_droppedQueries
+			<< " GPU timings were not ready in time and were dropped" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used for checking if the profiler runs.
+ ***********************************************************/
+bool FrameProfiler::IsEnabled()
+{
+	return(g_bEnabled);
+}
+
+/***********************************************************
+ *  HasGpuTiming()
+ *
+ *  This method is used for checking if the GPU is timed.
+ ***********************************************************/
+bool FrameProfiler::HasGpuTiming()
+{
+	return(g_bGpuTiming);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a frame.  The query set
+ *  of this frame was last used two frames ago, so its
+ *  results are read before the set is used again.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	if (!g_bEnabled)
+	{
+		return;
+	}
+
+	int set = g_frame % QUERY_FRAMES;
+	if (g_bGpuTiming)
+	{
+		CollectQueries(set, false);
+	}
+	g_queryFrame[set] = g_frame;
+
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		g_frameSectionMs[i] = 0.0;
+		g_bSectionRan[i] = false;
+	}
+	g_frameStartUs = NowUs();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for ending a frame, adding the CPU
+ *  time of each section that ran to its histogram.
+ ***********************************************************/
+void FrameProfiler::EndFrame()
+{
+	if (!g_bEnabled)
+	{
+		return;
+	}
+
+	double endUs = NowUs();
+	AddEvent(FRAME_EVENT, false, g_frame, g_frameStartUs, endUs - g_frameStartUs);
+
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		if (g_bSectionRan[i])
+		{
+			AddSample(g_histograms[0][i], g_frameSectionMs[i]);
+		}
+	}
+	g_frame++;
+}
+
+/***********************************************************
+ *  BeginSection()
+ *
+ *  This method is used for starting the timing of a section.
+ *  The GPU query is only begun when no other section's query
+ *  is active and the section has not had one this frame.
+ ***********************************************************/
+void FrameProfiler::BeginSection(SECTION section)
+{
+	if (!g_bEnabled)
+	{
+		return;
+	}
+
+	double startUs = NowUs();
+	g_sectionStartUs[section] = startUs;
+
+	int set = g_frame % QUERY_FRAMES;
+	if (g_bGpuTiming && (g_activeQuerySection < 0) && !g_bQueryIssued[set][section])
+	{
+		glBeginQuery(GL_TIME_ELAPSED, g_queries[set][section]);
+		g_bQueryIssued[set][section] = true;
+		g_queryStartUs[set][section] = startUs;
+		g_activeQuerySection = section;
+	}
+}
+
+/***********************************************************
+ *  EndSection()
+ *
+ *  This method is used for ending the timing of a section.
+ ***********************************************************/
+void FrameProfiler::EndSection(SECTION section)
+{
+	if (!g_bEnabled)
+	{
+		return;
+	}
+
+	if (g_activeQuerySection == section)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		g_activeQuerySection = -1;
+	}
+
+	double durationUs = NowUs() - g_sectionStartUs[section];
+	g_frameSectionMs[section] += durationUs / 1000.0;
+	g_bSectionRan[section] = true;
+	AddEvent(section, false, g_frame, g_sectionStartUs[section], durationUs);
+}
+
+/***********************************************************
+ *  GetSectionStats()
+ *
+ *  This method is used for getting the mean, percentiles,
+ *  maximum and bucket counts of a section over the frames
+ *  in its rolling histogram.
+ ***********************************************************/
+void FrameProfiler::GetSectionStats(SECTION section, bool bGpu, SECTION_STATS& outStats)
+{
+	const ROLLING_HISTOGRAM& histogram = g_histograms[bGpu ? 1 : 0][section];
+
+	outStats.samples = histogram.count;
+	outStats.meanMs = 0.0;
+	outStats.p50Ms = 0.0;
+	outStats.p95Ms = 0.0;
+	outStats.maxMs = 0.0;
+	std::copy(histogram.bucketCounts, histogram.bucketCounts + HISTOGRAM_BUCKETS, outStats.bucketCounts);
+	if (histogram.count == 0)
+	{
+		return;
+	}
+
+	std::vector<double> sorted(histogram.samples, histogram.samples + histogram.count);
+	std::sort(sorted.begin(), sorted.end());
+	outStats.meanMs = histogram.sum / histogram.count;
+	outStats.p50Ms = sorted[(sorted.size() - 1) / 2];
+	outStats.p95Ms = sorted[(sorted.size() - 1) * 95 / 100];
+	outStats.maxMs = sorted.back();
+}
+
+/***********************************************************
+ *  GetSectionName()
+ *
+ *  This method is used for getting the name of a section.
+ ***********************************************************/
+const char* FrameProfiler::GetSectionName(SECTION section)
+{
+	return(SECTION_NAMES[section]);
+}
+
+/***********************************************************
+ *  GetBucketLimit()
+ *
+ *  This method is used for getting the upper edge of a
+ *  histogram bucket, infinite for the last one.
+ ***********************************************************/
+double FrameProfiler::GetBucketLimit(int bucket)
+{
+	return(BUCKET_LIMITS[bucket]);
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the recorded events in
+ *  the Chrome trace event format, which chrome://tracing and
+ *  Perfetto open.  The CPU and the GPU sections are on two
+ *  tracks, with the frames on the CPU track around them.
+ ***********************************************************/
+bool FrameProfiler::WriteChromeTrace(const std::string& filename)
+{
+	FILE* file = fopen(filename.c_str(), "w");
+	if (NULL == file)
+	{
+		std::cout << "Could not write trace:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+	for (size_t i = 0; i < g_events.size(); i++)
+	{
+		const TRACE_EVENT& event = g_events[i];
+		const char* name = (event.section == FRAME_EVENT) ? "Frame" : SECTION_NAMES[event.section];
+		fprintf(file,
+			",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}",
+			name,
+			event.bGpu ? "gpu" : "cpu",
+			event.bGpu ? 2 : 1,
+			event.startUs,
+			event.durationUs,
+			event.frame);
+	}
+	fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(file);
+
+	if (g_events.size() >= (size_t)MAX_TRACE_EVENTS)
+	{
+		std::cout << "WARNING: The trace was full and only holds the first "
+			<< MAX_TRACE_EVENTS << " events" << std::endl;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteHistograms()
+ *
+ *  This method is used for writing the statistics and the
+ *  bucket counts of every section over the last frames.
+ ***********************************************************/
+void FrameProfiler::WriteHistograms(std::ostream& output)
+{
+	std::ios_base::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+
+	output << "INFO: Frame sections over the last " << HISTOGRAM_FRAMES << " frames (ms)" << std::endl;
+	output << std::left << std::setw(23) << "section" << std::right
+		<< std::setw(9) << "mean" << std::setw(9) << "p50"
+		<< std::setw(9) << "p95" << std::setw(9) << "max" << " |";
+	for (int i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+	{
+		output << std::setw(6) << BUCKET_LIMITS[i];
+	}
+	output << std::setw(6) << "more" << std::endl;
+
+	output << std::fixed << std::setprecision(3);
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		WriteStatsRow(output, (SECTION)i, false);
+		WriteStatsRow(output, (SECTION)i, true);
+	}
+
+	output.flags(flags);
+	output.precision(precision);
+}
+
+#endif
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// measure the CPU and GPU time of each section of a frame, and write the
+// measurements as a Chrome trace and as rolling per-section histograms
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// the profiler is compiled in unless the build defines
+// FRAME_PROFILER_ENABLED as 0, which removes the section
+// markers and the profiler code entirely
+#ifndef FRAME_PROFILER_ENABLED
+#define FRAME_PROFILER_ENABLED 1
+#endif
+
+#if FRAME_PROFILER_ENABLED
+
+#include <GL/glew.h>
+
+#include <ostream>
+#include <string>
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class times the sections of each frame on the CPU
+ *  with a steady clock, and on the GPU with a GL_TIME_ELAPSED
+ *  query begun and ended around the section.  The queries
+ *  of a frame are only read two frames later, when the GPU
+ *  is normally done with them, so reading them never waits;
+ *  a result that is still not available is dropped.
+ *
+ *  Elapsed time queries cannot be nested, so the sections
+ *  follow each other; a section begun inside another one is
+ *  only timed on the CPU.  The profiler does nothing until
+ *  it is enabled, and each marker then costs two clock reads
+ *  and two queries.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// the timed sections of a frame, in the order they run
+	enum SECTION
+	{
+		SECTION_PREPARE_VIEW = 0,
+		SECTION_TEXTURE_STREAMING,
+		SECTION_VISIBILITY,
+		SECTION_SUBMIT,
+		SECTION_DRAW,
+		SECTION_SWAP_BUFFERS,
+		SECTION_COUNT
+	};
+
+	// number of frames in the rolling histograms
+	static const int HISTOGRAM_FRAMES = 300;
+	// number of histogram buckets, the last one unbounded
+	static const int HISTOGRAM_BUCKETS = 10;
+	// most trace events kept before the trace stops recording
+	static const int MAX_TRACE_EVENTS = 1 << 20;
+
+	// summary of one section over the rolling window
+	struct SECTION_STATS
+	{
+		int samples;
+		double meanMs;
+		double p50Ms;
+		double p95Ms;
+		double maxMs;
+		int bucketCounts[HISTOGRAM_BUCKETS];
+	};
+
+	// create the GPU queries when the context has timer
+	// queries, and start timing
+	static void Initialize();
+	// stop timing and delete the GPU queries
+	static void Shutdown();
+	static bool IsEnabled();
+	static bool HasGpuTiming();
+
+	// frame bracket - the GPU results of an earlier frame
+	// are collected when a frame begins
+	static void BeginFrame();
+	static void EndFrame();
+
+	// section bracket
+	static void BeginSection(SECTION section);
+	static void EndSection(SECTION section);
+
+	// statistics of a section over the rolling window
+	static void GetSectionStats(SECTION section, bool bGpu, SECTION_STATS& outStats);
+	// name of a section, as written to the outputs
+	static const char* GetSectionName(SECTION section);
+	// upper edge of a histogram bucket in milliseconds
+	static double GetBucketLimit(int bucket);
+
+	// write the recorded events as Chrome trace event JSON
+	static bool WriteChromeTrace(const std::string& filename);
+	// write the rolling histograms as a text table
+	static void WriteHistograms(std::ostream& output);
+
+	// times a section for the lifetime of the object
+	class ScopedSection
+	{
+	public:
+		explicit ScopedSection(SECTION section) : m_section(section) { BeginSection(section); }
+		~ScopedSection() { EndSection(m_section); }
+
+	private:
+		SECTION m_section;
+	};
+};
+
+// markers placed in the timed code
+#define PROFILE_FRAME_BEGIN() FrameProfiler::BeginFrame()
+#define PROFILE_FRAME_END() FrameProfiler::EndFrame()
+#define PROFILE_SECTION_BEGIN(section) FrameProfiler::BeginSection(FrameProfiler::section)
+#define PROFILE_SECTION_END(section) FrameProfiler::EndSection(FrameProfiler::section)
+#define PROFILE_SCOPED_SECTION(section) FrameProfiler::ScopedSection profiledSection(FrameProfiler::section)
+
+#else
+
+#define PROFILE_FRAME_BEGIN()
+#define PROFILE_FRAME_END()
+#define PROFILE_SECTION_BEGIN(section)
+#define PROFILE_SECTION_END(section)
+#define PROFILE_SCOPED_SECTION(section)
+
+#endif
@@ -0,0 +1,663 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.cpp
+// ============
+// test the world-space bounding boxes of the scene objects against the
+// planes of the camera frustum, using SSE or AVX2 when available
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrustumCuller.h"
+
+#include <cmath>
+#include <cstdint>
+
+// the SIMD kernels are only built for x86 targets
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define FRUSTUM_CULLER_X86
+#include <immintrin.h>
+#endif
+
+// allow the AVX2 kernel to be compiled without enabling AVX2
+// for the whole translation unit - it is only called after
+// the CPU has been checked at runtime
+#if defined(FRUSTUM_CULLER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE
+#define TARGET_AVX2
+#endif
+
+// declaration of the global variables and defines
+namespace
+{
+	// half extent given to boxes without bounds, large enough
+	// that no plane can cull them without overflowing
+	const float UNBOUNDED_EXTENT = 1.0e30f;
+
+	/***********************************************************
+	 *  CullScalar()
+	 *
+	 *  Test the boxes one at a time.  A box is outside when it
+	 *  is fully behind any plane, which is when the distance
+	 *  of its center plus its extent projected on the plane
+	 *  normal is negative.  The sums are done in the same order
+	 *  as the SIMD kernels so that the results match exactly.
+	 ***********************************************************/
+	int CullScalar(
+		const FrustumCuller::PLANE* planes,
+		const FrustumCuller::BOUNDS_STREAMS& streams,
+		int first,
+		int count,
+		unsigned char* pOut)
+	{
+		int visibleCount = 0;
+
+		for (int i = first; i < count; i++)
+		{
+			unsigned char visible = 1;
+			for (int p = 0; p < FrustumCuller::PLANE_COUNT; p++)
+			{
+				const glm::vec3& n = planes[p].normal;
+				float distance = (n.x * streams.centerX[i]) + (n.y * streams.centerY[i]);
+				distance = distance + (n.z * streams.centerZ[i]);
+				distance = distance + planes[p].distance;
+				float radius = (std::fabs(n.x) * streams.extentX[i]) + (std::fabs(n.y) * streams.extentY[i]);
+				radius = radius + (std::fabs(n.z) * streams.extentZ[i]);
+				if ((distance + radius) < 0.0f)
+				{
+					visible = 0;
+					break;
+				}
+			}
+			pOut[i] = visible;
+			visibleCount += visible;
+		}
+
+		return(visibleCount);
+	}
+
+#ifdef FRUSTUM_CULLER_X86
+	/***********************************************************
+	 *  StoreMaskBytes()
+	 *
+	 *  Write one byte per lane of an inside mask, returning the
+	 *  number of lanes that are inside.
+	 ***********************************************************/
+	int StoreMaskBytes(int insideMask, int lanes, unsigned char* pOut)
+	{
+		int visibleCount = 0;
+		for (int lane = 0; lane < lanes; lane++)
+		{
+			unsigned char visible = (unsigned char)((insideMask >> lane) & 1);
+			pOut[lane] = visible;
+			visibleCount += visible;
+		}
+
+		return(visibleCount);
+	}
+
+	/***********************************************************
+	 *  CullSSE()
+	 *
+	 *  Test four boxes at a time against every plane.
+	 ***********************************************************/
+	TARGET_SSE int CullSSE(
+		const FrustumCuller::PLANE* planes,
+		const FrustumCuller::BOUNDS_STREAMS& streams,
+		int count,
+		unsigned char* pOut)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		__m128 nx[FrustumCuller::PLANE_COUNT];
+		__m128 ny[FrustumCuller::PLANE_COUNT];
+		__m128 nz[FrustumCuller::PLANE_COUNT];
+		__m128 nd[FrustumCuller::PLANE_COUNT];
+		__m128 ax[FrustumCuller::PLANE_COUNT];
+		__m128 ay[FrustumCuller::PLANE_COUNT];
+		__m128 az[FrustumCuller::PLANE_COUNT];
+		for (int p = 0; p < FrustumCuller::PLANE_COUNT; p++)
+		{
+			nx[p] = _mm_set1_ps(planes[p].normal.x);
+			ny[p] = _mm_set1_ps(planes[p].normal.y);
+			nz[p] = _mm_set1_ps(planes[p].normal.z);
+			nd[p] = _mm_set1_ps(planes[p].distance);
+			ax[p] = _mm_set1_ps(std::fabs(planes[p].normal.x));
+			ay[p] = _mm_set1_ps(std::fabs(planes[p].normal.y));
+			az[p] = _mm_set1_ps(std::fabs(planes[p].normal.z));
+		}
+
+		int visibleCount = 0;
+		int i = 0;
+		for (; (i + 4) <= count; i += 4)
+		{
+			__m128 cx = _mm_loadu_ps(streams.centerX + i);
+			__m128 cy = _mm_loadu_ps(streams.centerY + i);
+			__m128 cz = _mm_loadu_ps(streams.centerZ + i);
+			__m128 ex = _mm_loadu_ps(streams.extentX + i);
+			__m128 ey = _mm_loadu_ps(streams.extentY + i);
+			__m128 ez = _mm_loadu_ps(streams.extentZ + i);
+
+			// gather the lanes that are behind any of the planes
+			__m128 outside = zero;
+			for (int p = 0; p < FrustumCuller::PLANE_COUNT; p++)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy));
+				distance = _mm_add_ps(distance, _mm_mul_ps(nz[p], cz));
+				distance = _mm_add_ps(distance, nd[p]);
+				__m128 radius = _mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey));
+				radius = _mm_add_ps(radius, _mm_mul_ps(az[p], ez));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			visibleCount += StoreMaskBytes(~_mm_movemask_ps(outside), 4, pOut + i);
+		}
+
+		// the remaining boxes that do not fill a register
+		visibleCount += CullScalar(planes, streams, i, count, pOut);
+
+		return(visibleCount);
+	}
+
+	/***********************************************************
+	 *  CullAVX2()
+	 *
+	 *  Test eight boxes at a time against every plane.
+	 ***********************************************************/
+	TARGET_AVX2 int CullAVX2(
+		const FrustumCuller::PLANE* planes,
+		const FrustumCuller::BOUNDS_STREAMS& streams,
+		int count,
+		unsigned char* pOut)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 nx[FrustumCuller::PLANE_COUNT];
+		__m256 ny[FrustumCuller::PLANE_COUNT];
+		__m256 nz[FrustumCuller::PLANE_COUNT];
+		__m256 nd[FrustumCuller::PLANE_COUNT];
+		__m256 ax[FrustumCuller::PLANE_COUNT];
+		__m256 ay[FrustumCuller::PLANE_COUNT];
+		__m256 az[FrustumCuller::PLANE_COUNT];
+		for (int p = 0; p < FrustumCuller::PLANE_COUNT; p++)
+		{
+			nx[p] = _mm256_set1_ps(planes[p].normal.x);
+			ny[p] = _mm256_set1_ps(planes[p].normal.y);
+			nz[p] = _mm256_set1_ps(planes[p].normal.z);
+			nd[p] = _mm256_set1_ps(planes[p].distance);
+			ax[p] = _mm256_set1_ps(std::fabs(planes[p].normal.x));
+			ay[p] = _mm256_set1_ps(std::fabs(planes[p].normal.y));
+			az[p] = _mm256_set1_ps(std::fabs(planes[p].normal.z));
+		}
+
+		int visibleCount = 0;
+		int i = 0;
+		for (; (i + 8) <= count; i += 8)
+		{
+			__m256 cx = _mm256_loadu_ps(streams.centerX + i);
+			__m256 cy = _mm256_loadu_ps(streams.centerY + i);
+			__m256 cz = _mm256_loadu_ps(streams.centerZ + i);
+			__m256 ex = _mm256_loadu_ps(streams.extentX + i);
+			__m256 ey = _mm256_loadu_ps(streams.extentY + i);
+			__m256 ez = _mm256_loadu_ps(streams.extentZ + i);
+
+			// gather the lanes that are behind any of the planes
+			__m256 outside = zero;
+			for (int p = 0; p < FrustumCuller::PLANE_COUNT; p++)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(nz[p], cz));
+				distance = _mm256_add_ps(distance, nd[p]);
+				__m256 radius = _mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(az[p], ez));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+
+			visibleCount += StoreMaskBytes(~_mm256_movemask_ps(outside), 8, pOut + i);
+		}
+
+		// the remaining boxes that do not fill a register
+		visibleCount += CullScalar(planes, streams, i, count, pOut);
+
+		return(visibleCount);
+	}
+#endif // FRUSTUM_CULLER_X86
+
+	/***********************************************************
+	 *  NextRandom()
+	 *
+	 *  Small deterministic generator for the kernel validation,
+	 *  returns a value between minValue and maxValue.
+	 ***********************************************************/
+	float NextRandom(uint32_t& state, float minValue, float maxValue)
+	{
+		state = (state * 1664525u) + 1013904223u;
+		float unit = (float)(state >> 8) / (float)(1u << 24);
+		return(minValue + (unit * (maxValue - minValue)));
+	}
+}
+
+/***********************************************************
+ *  FrustumCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrustumCuller::FrustumCuller()
+{
+	// planes that every box is inside of, until a matrix is set
+	for (int p = 0; p < PLANE_COUNT; p++)
+	{
+		m_planes[p].normal = glm::vec3(0.0f);
+		m_planes[p].distance = 1.0f;
+	}
+	m_stats.testedObjects = 0;
+	m_stats.visibleObjects = 0;
+}
+
+/***********************************************************
+ *  ~FrustumCuller()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrustumCuller::~FrustumCuller()
+{
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of boxes in
+ *  the table.  Added boxes have no bounds yet, so they are
+ *  never culled until SetBounds() is called for them.
+ ***********************************************************/
+void FrustumCuller::Resize(int count)
+{
+	if (count < 0)
+	{
+		count = 0;
+	}
+
+	m_centerX.resize(count, 0.0f);
+	m_centerY.resize(count, 0.0f);
+	m_centerZ.resize(count, 0.0f);
+	m_extentX.resize(count, UNBOUNDED_EXTENT);
+	m_extentY.resize(count, UNBOUNDED_EXTENT);
+	m_extentZ.resize(count, UNBOUNDED_EXTENT);
+	m_visible.resize(count, 1);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of boxes in
+ *  the table.
+ ***********************************************************/
+int FrustumCuller::GetCount() const
+{
+	return((int)m_centerX.size());
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for setting the world bounds of a box
+ *  from the object space bounds of its mesh and its model
+ *  matrix.
+ ***********************************************************/
+void FrustumCuller::SetBounds(
+	int index,
+	const glm::mat4& modelMatrix,
+	const glm::vec3& localMin,
+	const glm::vec3& localMax)
+{
+	if ((index < 0) || (index >= GetCount()))
+	{
+		return;
+	}
+
+	glm::vec3 center;
+	glm::vec3 extent;
+	TransformBounds(modelMatrix, localMin, localMax, center, extent);
+
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_extentX[index] = extent.x;
+	m_extentY[index] = extent.y;
+	m_extentZ[index] = extent.z;
+}
+
+/***********************************************************
+ *  SetUnbounded()
+ *
+ *  This method is used for marking a box as having no known
+ *  bounds, such as for a mesh type without geometry, so that
+ *  it is never culled.
+ ***********************************************************/
+void FrustumCuller::SetUnbounded(int index)
+{
+	if ((index < 0) || (index >= GetCount()))
+	{
+		return;
+	}
+
+	m_centerX[index] = 0.0f;
+	m_centerY[index] = 0.0f;
+	m_centerZ[index] = 0.0f;
+	m_extentX[index] = UNBOUNDED_EXTENT;
+	m_extentY[index] = UNBOUNDED_EXTENT;
+	m_extentZ[index] = UNBOUNDED_EXTENT;
+}
+
+/***********************************************************
+ *  IsBounded()
+ *
+ *  This method is used for checking whether a box has had
+ *  its bounds set, rather than being left unbounded.
+ ***********************************************************/
+bool FrustumCuller::IsBounded(int index) const
+{
+	if ((index < 0) || (index >= GetCount()))
+	{
+		return(false);
+	}
+
+	return((m_extentX[index] < UNBOUNDED_EXTENT) &&
+		(m_extentY[index] < UNBOUNDED_EXTENT) &&
+		(m_extentZ[index] < UNBOUNDED_EXTENT));
+}
+
+/***********************************************************
+ *  GetStreams()
+ *
+ *  This method is used for getting streams that reference
+ *  the columns of the table.
+ ***********************************************************/
+FrustumCuller::BOUNDS_STREAMS FrustumCuller::GetStreams() const
+{
+	BOUNDS_STREAMS streams;
+
+	streams.centerX = m_centerX.data();
+	streams.centerY = m_centerY.data();
+	streams.centerZ = m_centerZ.data();
+	streams.extentX = m_extentX.data();
+	streams.extentY = m_extentY.data();
+	streams.extentZ = m_extentZ.data();
+
+	return(streams);
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for setting the frustum that the
+ *  boxes are tested against from the camera matrices.
+ ***********************************************************/
+void FrustumCuller::SetViewProjection(const glm::mat4& viewProjection)
+{
+	ExtractPlanes(viewProjection, m_planes);
+}
+
+/***********************************************************
+ *  GetPlane()
+ *
+ *  This method is used for getting one of the planes of the
+ *  current frustum.
+ ***********************************************************/
+const FrustumCuller::PLANE& FrustumCuller::GetPlane(int index) const
+{
+	if ((index < 0) || (index >= PLANE_COUNT))
+	{
+		index = PLANE_NEAR;
+	}
+
+	return(m_planes[index]);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing every box in the table
+ *  against the current frustum.  The number of visible boxes
+ *  is returned, and IsVisible() gives the result of each.
+ ***********************************************************/
+int FrustumCuller::Cull()
+{
+	int count = GetCount();
+
+	m_visible.resize(count);
+	m_stats.testedObjects = count;
+	m_stats.visibleObjects = 0;
+	if (count > 0)
+	{
+		m_stats.visibleObjects = CullBounds(m_planes, GetStreams(), count, m_visible.data());
+	}
+
+	return(m_stats.visibleObjects);
+}
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  This method is used for checking whether a box passed
+ *  the last cull.  Boxes outside the table are visible.
+ ***********************************************************/
+bool FrustumCuller::IsVisible(int index) const
+{
+	if ((index < 0) || (index >= (int)m_visible.size()))
+	{
+		return(true);
+	}
+
+	return(m_visible[index] != 0);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the number of boxes that
+ *  were tested and found visible by the last cull.
+ ***********************************************************/
+const FrustumCuller::CULL_STATS& FrustumCuller::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  ExtractPlanes()
+ *
+ *  This method is used for extracting the six planes of the
+ *  frustum from the rows of a projection * view matrix.  A
+ *  point is inside when its clip coordinates are within -w
+ *  and w, so each plane is the fourth row plus or minus one
+ *  of the others.  The planes are normalized so that the
+ *  distances can be compared with the box extents.
+ ***********************************************************/
+void FrustumCuller::ExtractPlanes(const glm::mat4& viewProjection, PLANE* outPlanes)
+{
+	if (NULL == outPlanes)
+	{
+		return;
+	}
+
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(
+			viewProjection[0][row],
+			viewProjection[1][row],
+			viewProjection[2][row],
+			viewProjection[3][row]);
+	}
+
+	glm::vec4 equations[PLANE_COUNT];
+	equations[PLANE_LEFT] = rows[3] + rows[0];
+	equations[PLANE_RIGHT] = rows[3] - rows[0];
+	equations[PLANE_BOTTOM] = rows[3] + rows[1];
+	equations[PLANE_TOP] = rows[3] - rows[1];
+	equations[PLANE_NEAR] = rows[3] + rows[2];
+	equations[PLANE_FAR] = rows[3] - rows[2];
+
+	for (int p = 0; p < PLANE_COUNT; p++)
+	{
+		glm::vec3 normal = glm::vec3(equations[p].x, equations[p].y, equations[p].z);
+		float length = glm::length(normal);
+		if (length > 0.0f)
+		{
+			outPlanes[p].normal = normal / length;
+			outPlanes[p].distance = equations[p].w / length;
+		}
+		else
+		{
+			outPlanes[p].normal = glm::vec3(0.0f);
+			outPlanes[p].distance = 1.0f;
+		}
+	}
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method is used for computing the world box of an
+ *  object from its object space box.  The center is moved
+ *  by the model matrix, and the extent along each world axis
+ *  is the sum of the local extents scaled by the absolute
+ *  values of the matching row of the upper 3x3 matrix.
+ ***********************************************************/
+void FrustumCuller::TransformBounds(
+	const glm::mat4& modelMatrix,
+	const glm::vec3& localMin,
+	const glm::vec3& localMax,
+	glm::vec3& outCenter,
+	glm::vec3& outExtent)
+{
+	glm::vec3 localCenter = (localMin + localMax) * 0.5f;
+	glm::vec3 localExtent = (localMax - localMin) * 0.5f;
+
+	outCenter = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
+	for (int row = 0; row < 3; row++)
+	{
+		outExtent[row] =
+			(std::fabs(modelMatrix[0][row]) * localExtent.x) +
+			(std::fabs(modelMatrix[1][row]) * localExtent.y) +
+			(std::fabs(modelMatrix[2][row]) * localExtent.z);
+	}
+}
+
+/***********************************************************
+ *  CullBounds()
+ *
+ *  This method is used for testing count boxes with the
+ *  widest kernel supported by the running CPU.
+ ***********************************************************/
+int FrustumCuller::CullBounds(
+	const PLANE* planes,
+	const BOUNDS_STREAMS& streams,
+	int count,
+	unsigned char* outVisible)
+{
+	return(CullBounds(TransformBatch::GetSupportedKernel(), planes, streams, count, outVisible));
+}
+
+/***********************************************************
+ *  CullBounds()
+ *
+ *  This method is used for testing count boxes with the
+ *  passed in kernel.  Kernels that cannot run on this CPU
+ *  fall back to the scalar code.
+ ***********************************************************/
+int FrustumCuller::CullBounds(
+	TransformBatch::KERNEL_TYPE kernel,
+	const PLANE* planes,
+	const BOUNDS_STREAMS& streams,
+	int count,
+	unsigned char* outVisible)
+{
+	if ((count <= 0) || (NULL == planes) || (NULL == outVisible))
+	{
+		return(0);
+	}
+
+	if (kernel > TransformBatch::GetSupportedKernel())
+	{
+		kernel = TransformBatch::KERNEL_SCALAR;
+	}
+
+	switch (kernel)
+	{
+#ifdef FRUSTUM_CULLER_X86
+	case TransformBatch::KERNEL_AVX2:
+		return(CullAVX2(planes, streams, count, outVisible));
+	case TransformBatch::KERNEL_SSE:
+		return(CullSSE(planes, streams, count, outVisible));
+#endif
+	default:
+		return(CullScalar(planes, streams, 0, count, outVisible));
+	}
+}
+
+/***********************************************************
+ *  ValidateKernels()
+ *
+ *  This method is used for checking every kernel supported
+ *  by the running CPU against the scalar test, using random
+ *  boxes and planes.  The number of boxes that got another
+ *  result is returned through mismatches.
+ ***********************************************************/
+bool FrustumCuller::ValidateKernels(int* mismatches)
+{
+	// an odd count so that the scalar tail of each kernel runs
+	const int VALIDATION_COUNT = 1027;
+
+	FrustumCuller culler;
+	PLANE planes[PLANE_COUNT];
+	std::vector<unsigned char> reference(VALIDATION_COUNT);
+	std::vector<unsigned char> result(VALIDATION_COUNT);
+	uint32_t state = 330;
+	int mismatchCount = 0;
+
+	culler.Resize(VALIDATION_COUNT);
+	for (int i = 0; i < VALIDATION_COUNT; i++)
+	{
+		glm::vec3 center = glm::vec3(
+			NextRandom(state, -100.0f, 100.0f),
+			NextRandom(state, -100.0f, 100.0f),
+			NextRandom(state, -100.0f, 100.0f));
+		glm::vec3 extent = glm::vec3(
+			NextRandom(state, 0.0f, 20.0f),
+			NextRandom(state, 0.0f, 20.0f),
+			NextRandom(state, 0.0f, 20.0f));
+		culler.SetBounds(i, glm::mat4(1.0f), center - extent, center + extent);
+	}
+
+	for (int p = 0; p < PLANE_COUNT; p++)
+	{
+		glm::vec3 normal = glm::vec3(
+			NextRandom(state, -1.0f, 1.0f),
+			NextRandom(state, -1.0f, 1.0f),
+			NextRandom(state, -1.0f, 1.0f));
+		planes[p].normal = normal / glm::length(normal);
+		planes[p].distance = NextRandom(state, 0.0f, 100.0f);
+	}
+
+	CullBounds(TransformBatch::KERNEL_SCALAR, planes, culler.GetStreams(), VALIDATION_COUNT, reference.data());
+	for (int kernel = TransformBatch::KERNEL_SSE; kernel <= TransformBatch::GetSupportedKernel(); kernel++)
+	{
+		CullBounds((TransformBatch::KERNEL_TYPE)kernel, planes, culler.GetStreams(), VALIDATION_COUNT, result.data());
+
+		for (int i = 0; i < VALIDATION_COUNT; i++)
+		{
+			if (result[i] != reference[i])
+			{
+				mismatchCount++;
+			}
+		}
+	}
+
+	if (NULL != mismatches)
+	{
+		*mismatches = mismatchCount;
+	}
+
+	return(mismatchCount == 0);
+}
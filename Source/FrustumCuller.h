@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.h
+// ============
+// test the world-space bounding boxes of the scene objects against the
+// planes of the camera frustum, using SSE or AVX2 when available
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TransformBatch.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  FrustumCuller
+ *
+ *  This class holds a structure of arrays table of world
+ *  space axis-aligned bounding boxes, stored as a center and
+ *  a half extent, and tests them against the six planes of a
+ *  projection * view matrix.  The planes are taken straight
+ *  from the matrix, so both the perspective and orthographic
+ *  projections of ViewManager are handled the same way.
+ *
+ *  The same kernel picked for TransformBatch is used here,
+ *  falling back to the scalar code when SSE or AVX2 are not
+ *  available.
+ ***********************************************************/
+class FrustumCuller
+{
+public:
+	// constructor
+	FrustumCuller();
+	// destructor
+	~FrustumCuller();
+
+	// frustum planes in the order they are extracted
+	enum PLANE_INDEX
+	{
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+	// plane with a unit normal pointing into the frustum, so
+	// that dot(normal, point) + distance >= 0 for inside points
+	struct PLANE
+	{
+		glm::vec3 normal;
+		float distance;
+	};
+
+	// bounding box streams for a batch
+	struct BOUNDS_STREAMS
+	{
+		const float* centerX;
+		const float* centerY;
+		const float* centerZ;
+		const float* extentX;
+		const float* extentY;
+		const float* extentZ;
+	};
+
+	// boxes tested and found visible by the last cull
+	struct CULL_STATS
+	{
+		int testedObjects;
+		int visibleObjects;
+	};
+
+	// set the number of boxes in the table - new boxes are
+	// never culled until their bounds are set
+	void Resize(int count);
+	// number of boxes in the table
+	int GetCount() const;
+	// set the world bounds of a box from its object space bounds
+	// and its model matrix
+	void SetBounds(
+		int index,
+		const glm::mat4& modelMatrix,
+		const glm::vec3& localMin,
+		const glm::vec3& localMax);
+	// mark a box as having no bounds so it is never culled
+	void SetUnbounded(int index);
+	bool IsBounded(int index) const;
+	// streams referencing the table columns
+	BOUNDS_STREAMS GetStreams() const;
+
+	// extract the frustum planes from a projection * view matrix
+	void SetViewProjection(const glm::mat4& viewProjection);
+	const PLANE& GetPlane(int index) const;
+
+	// test every box in the table against the frustum planes
+	int Cull();
+	// true when the box passed the last cull
+	bool IsVisible(int index) const;
+	const CULL_STATS& GetStats() const;
+
+	// extract the six frustum planes from a matrix
+	static void ExtractPlanes(const glm::mat4& viewProjection, PLANE* outPlanes);
+	// compute the world center and half extent of a box from
+	// its object space bounds and its model matrix
+	static void TransformBounds(
+		const glm::mat4& modelMatrix,
+		const glm::vec3& localMin,
+		const glm::vec3& localMax,
+		glm::vec3& outCenter,
+		glm::vec3& outExtent);
+	// test count boxes with the best kernel, writing 1 for each
+	// visible box and 0 for each culled one
+	static int CullBounds(
+		const PLANE* planes,
+		const BOUNDS_STREAMS& streams,
+		int count,
+		unsigned char* outVisible);
+	// test count boxes with a specific kernel
+	static int CullBounds(
+		TransformBatch::KERNEL_TYPE kernel,
+		const PLANE* planes,
+		const BOUNDS_STREAMS& streams,
+		int count,
+		unsigned char* outVisible);
+
+	// compare every supported kernel against the scalar test,
+	// returns false when any box gets a different result
+	static bool ValidateKernels(int* mismatches);
+
+private:
+	// table columns
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+	std::vector<float> m_extentZ;
+	// result of the last cull, one entry per box
+	std::vector<unsigned char> m_visible;
+	// planes of the current frustum
+	PLANE m_planes[PLANE_COUNT];
+	// counters of the last cull
+	CULL_STATS m_stats;
+};
@@ -0,0 +1,311 @@
+///////////////////////////////////////////////////////////////////////////////
+// headlesscontext.cpp
+// ============
+// create an OpenGL context without a window or a display server, and a
+// framebuffer object to render the scene into
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessContext.h"
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// declaration of the global variables and defines
+namespace
+{
+	// context versions tried in order - the shaders need 4.4
+	const int CONTEXT_VERSIONS[][2] = { { 4, 6 }, { 4, 5 }, { 4, 4 } };
+	const int CONTEXT_VERSION_COUNT = sizeof(CONTEXT_VERSIONS) / sizeof(CONTEXT_VERSIONS[0]);
+}
+
+/***********************************************************
+ *  HeadlessContext()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+HeadlessContext::HeadlessContext()
+{
+	m_display = NULL;
+	m_context = NULL;
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+	m_width = 0;
+	m_height = 0;
+}
+
+/***********************************************************
+ *  ~HeadlessContext()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+HeadlessContext::~HeadlessContext()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating a core profile context
+ *  with no surface and making it current.  The surfaceless
+ *  Mesa platform needs no device or display server at all,
+ *  so it is tried before the default display.
+ ***********************************************************/
+bool HeadlessContext::Create()
+{
+#if defined(__linux__)
+	EGLDisplay display = EGL_NO_DISPLAY;
+
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (NULL != getPlatformDisplay)
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	EGLint majorVersion = 0;
+	EGLint minorVersion = 0;
+	if ((display == EGL_NO_DISPLAY) || (eglInitialize(display, &majorVersion, &minorVersion) == EGL_FALSE))
+	{
+		std::cout << "Failed to initialize an EGL display" << std::endl;
+		return(false);
+	}
+	m_display = display;
+
+	if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+	{
+		std::cout << "EGL display has no desktop OpenGL" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	// no surface is ever created, so any config with desktop
+	// OpenGL will do
+	const EGLint configAttributes[] =
+	{
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config = NULL;
+	EGLint configCount = 0;
+	if ((eglChooseConfig(display, configAttributes, &config, 1, &configCount) == EGL_FALSE) || (configCount == 0))
+	{
+		std::cout << "No EGL config with desktop OpenGL" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	EGLContext context = EGL_NO_CONTEXT;
+	for (int i = 0; (i < CONTEXT_VERSION_COUNT) && (context == EGL_NO_CONTEXT); i++)
+	{
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, CONTEXT_VERSIONS[i][0],
+			EGL_CONTEXT_MINOR_VERSION, CONTEXT_VERSIONS[i][1],
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	}
+	if (context == EGL_NO_CONTEXT)
+	{
+		std::cout << "Failed to create an OpenGL 4.4 core context through EGL" << std::endl;
+		Destroy();
+		return(false);
+	}
+	m_context = context;
+
+	if (eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_FALSE)
+	{
+		std::cout << "EGL display cannot make a context current without a surface" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	std::cout << "INFO: Headless EGL " << majorVersion << "." << minorVersion
+		<< " context created" << std::endl;
+
+	return(true);
+#else
+	std::cout << "Headless rendering needs EGL, which is only used on Linux" << std::endl;
+	return(false);
+#endif
+}
+
+/***********************************************************
+ *  CreateFramebuffer()
+ *
+ *  This method is used for creating the framebuffer object
+ *  the frames are rendered into, with a color and a depth
+ *  renderbuffer of the requested size, and binding it.
+ ***********************************************************/
+bool HeadlessContext::CreateFramebuffer(int width, int height)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Headless framebuffer of " << width << "x" << height << " is not complete" << std::endl;
+		return(false);
+	}
+
+	BindFramebuffer();
+
+	return(true);
+}
+
+/***********************************************************
+ *  BindFramebuffer()
+ *
+ *  This method is used for drawing into the framebuffer
+ *  object, with the viewport covering all of it.
+ ***********************************************************/
+void HeadlessContext::BindFramebuffer()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  FinishFrame()
+ *
+ *  This method is used in place of swapping the buffers.
+ *  With nothing presented, the driver could queue frames
+ *  without limit, so each frame is finished before the
+ *  next one starts and the frame time covers the GPU work.
+ ***********************************************************/
+void HeadlessContext::FinishFrame()
+{
+	glFinish();
+}
+
+/***********************************************************
+ *  SaveColorBuffer()
+ *
+ *  This method is used for writing the color buffer to a
+ *  binary PPM file, flipped so the image is upright.
+ ***********************************************************/
+bool HeadlessContext::SaveColorBuffer(const std::string& filename)
+{
+	if (m_framebuffer == 0)
+	{
+		return(false);
+	}
+
+	std::vector<unsigned char> pixels((size_t)m_width * m_height * 3);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write image:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "P6\n%d %d\n255\n", m_width, m_height);
+	size_t rowSize = (size_t)m_width * 3;
+	for (int row = m_height - 1; row >= 0; row--)
+	{
+		fwrite(&pixels[row * rowSize], 1, rowSize, file);
+	}
+	fclose(file);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the framebuffer object,
+ *  while the context is still current, and then the
+ *  context and the display.
+ ***********************************************************/
+void HeadlessContext::Destroy()
+{
+	if (m_framebuffer != 0)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (m_colorBuffer != 0)
+	{
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		m_colorBuffer = 0;
+	}
+	if (m_depthBuffer != 0)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+
+#if defined(__linux__)
+	if (NULL != m_display)
+	{
+		eglMakeCurrent((EGLDisplay)m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (NULL != m_context)
+		{
+			eglDestroyContext((EGLDisplay)m_display, (EGLContext)m_context);
+		}
+		eglTerminate((EGLDisplay)m_display);
+	}
+#endif
+	m_context = NULL;
+	m_display = NULL;
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method is used for getting the framebuffer width.
+ ***********************************************************/
+int HeadlessContext::GetWidth() const
+{
+	return(m_width);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method is used for getting the framebuffer height.
+ ***********************************************************/
+int HeadlessContext::GetHeight() const
+{
+	return(m_height);
+}
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// headlesscontext.h
+// ============
+// create an OpenGL context without a window or a display server, and a
+// framebuffer object to render the scene into
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  HeadlessContext
+ *
+ *  This class creates a core profile OpenGL context through
+ *  EGL with no surface at all, so the scene can be rendered
+ *  on machines without a GPU or an X server.  The Mesa
+ *  surfaceless platform is tried first, which works with
+ *  the llvmpipe software rasterizer, then the default EGL
+ *  display.  EGL is only used on Linux; elsewhere Create()
+ *  reports that headless rendering is not available.
+ *
+ *  With no default framebuffer, the frames are rendered into
+ *  a framebuffer object of the requested size, which stays
+ *  bound and sets the viewport once it is created.
+ ***********************************************************/
+class HeadlessContext
+{
+public:
+	// constructor
+	HeadlessContext();
+	// destructor - destroys the framebuffer and the context
+	~HeadlessContext();
+
+	// create the context and make it current, trying the
+	// newest core profile version first
+	bool Create();
+	// create the framebuffer object, once GLEW is initialized
+	bool CreateFramebuffer(int width, int height);
+	// bind the framebuffer and set the viewport to its size
+	void BindFramebuffer();
+	// wait for the rendering of the frame to finish
+	void FinishFrame();
+	// write the color buffer to a binary PPM image
+	bool SaveColorBuffer(const std::string& filename);
+	// free the framebuffer and the context
+	void Destroy();
+
+	int GetWidth() const;
+	int GetHeight() const;
+
+private:
+	// EGL objects, kept untyped so EGL is only included by
+	// the source file
+	void* m_display;
+	void* m_context;
+	// framebuffer object and its attachments
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	int m_width;
+	int m_height;
+};
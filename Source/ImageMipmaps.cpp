@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagemipmaps.cpp
+// ============
+// build the mipmap chain of an 8 bit per channel image on the CPU
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageMipmaps.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  Generate()
+ *
+ *  This method is used for building every mipmap level of
+ *  an image down to 1x1.  Each texel of a level averages the
+ *  2x2 block of texels under it in the level before, with
+ *  the last row or column repeated for odd sizes.  The
+ *  levels are appended to the pixels, one after another.
+ ***********************************************************/
+void ImageMipmaps::Generate(
+	std::vector<unsigned char>& pixels,
+	int width,
+	int height,
+	int colorChannels,
+	std::vector<MIP_LEVEL>& outLevels)
+{
+	outLevels.clear();
+
+	MIP_LEVEL level;
+	level.width = width;
+	level.height = height;
+	level.offset = 0;
+	level.size = (size_t)width * height * colorChannels;
+	outLevels.push_back(level);
+
+	// the whole chain adds about a third to the first level
+	pixels.reserve(level.size + (level.size / 3) + (colorChannels * 16));
+
+	while ((level.width > 1) || (level.height > 1))
+	{
+		const MIP_LEVEL source = level;
+
+		level.width = std::max(source.width / 2, 1);
+		level.height = std::max(source.height / 2, 1);
+		level.offset = source.offset + source.size;
+		level.size = (size_t)level.width * level.height * colorChannels;
+		pixels.resize(level.offset + level.size);
+
+		const unsigned char* sourcePixels = pixels.data() + source.offset;
+		unsigned char* targetPixels = pixels.data() + level.offset;
+		const size_t sourceStride = (size_t)source.width * colorChannels;
+
+		for (int y = 0; y < level.height; y++)
+		{
+			int y0 = std::min(y * 2, source.height - 1);
+			int y1 = std::min((y * 2) + 1, source.height - 1);
+
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(x * 2, source.width - 1);
+				int x1 = std::min((x * 2) + 1, source.width - 1);
+
+				for (int channel = 0; channel < colorChannels; channel++)
+				{
+					int sum =
+						sourcePixels[(y0 * sourceStride) + (x0 * colorChannels) + channel] +
+						sourcePixels[(y0 * sourceStride) + (x1 * colorChannels) + channel] +
+						sourcePixels[(y1 * sourceStride) + (x0 * colorChannels) + channel] +
+						sourcePixels[(y1 * sourceStride) + (x1 * colorChannels) + channel];
+					targetPixels[(((size_t)y * level.width) + x) * colorChannels + channel] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+
+		outLevels.push_back(level);
+	}
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method is used for getting the number of levels in
+ *  a full mipmap chain, which halves the larger side until
+ *  it reaches one texel.
+ ***********************************************************/
+int ImageMipmaps::GetLevelCount(int width, int height)
+{
+	int levelCount = 1;
+	while (((width | height) >> levelCount) != 0)
+	{
+		levelCount++;
+	}
+
+	return(levelCount);
+}
@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagemipmaps.h
+// ============
+// build the mipmap chain of an 8 bit per channel image on the CPU
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  ImageMipmaps
+ *
+ *  This class builds every mipmap level of an image with a
+ *  box filter, without any OpenGL calls, so that the level
+ *  chain can be made on a worker thread or by the offline
+ *  texture cooker.  The levels are kept one after another
+ *  in a single pixel buffer.
+ ***********************************************************/
+class ImageMipmaps
+{
+public:
+	// one mipmap level inside the pixels of an image
+	struct MIP_LEVEL
+	{
+		int width;
+		int height;
+		size_t offset;
+		size_t size;
+	};
+
+	// append the box filtered mipmap levels of an image after
+	// its pixels, listing every level including the first
+	static void Generate(
+		std::vector<unsigned char>& pixels,
+		int width,
+		int height,
+		int colorChannels,
+		std::vector<MIP_LEVEL>& outLevels);
+	// number of levels in a full chain down to 1x1
+	static int GetLevelCount(int width, int height);
+};
@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputlog.cpp
+// ============
+// record the input applied to the camera as timestamped events, and read
+// and write them as a compact binary log for deterministic replay
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputLog.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// declaration of the global variables and defines
+namespace
+{
+	// every input log starts with these bytes and version
+	const unsigned char INPUT_LOG_IDENTIFIER[4] = { 'I', 'N', 'P', 'L' };
+	const uint32_t INPUT_LOG_VERSION = 1;
+	// identifier, version, start state and the two counts
+	const size_t HEADER_SIZE = 4 + 4 + (21 * 4) + 1 + 4 + 4;
+	// type byte and the smallest payload, of a keys event
+	const size_t MIN_EVENT_SIZE = 1 + 1;
+
+	void PutUInt32(std::vector<unsigned char>& bytes, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			bytes.push_back((unsigned char)(value >> (i * 8)));
+		}
+	}
+
+	// floats are saved by their bits, so a replay gets back
+	// exactly the recorded values
+	void PutFloat(std::vector<unsigned char>& bytes, float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		PutUInt32(bytes, bits);
+	}
+
+	void PutVec3(std::vector<unsigned char>& bytes, const glm::vec3& value)
+	{
+		PutFloat(bytes, value.x);
+		PutFloat(bytes, value.y);
+		PutFloat(bytes, value.z);
+	}
+
+	uint32_t GetUInt32(const unsigned char* bytes)
+	{
+		return((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+	}
+
+	float GetFloat(const unsigned char* bytes)
+	{
+		uint32_t bits = GetUInt32(bytes);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return(value);
+	}
+
+	glm::vec3 GetVec3(const unsigned char* bytes)
+	{
+		return(glm::vec3(GetFloat(bytes), GetFloat(bytes + 4), GetFloat(bytes + 8)));
+	}
+
+	// bytes saved after the type of an event, 0 for a type
+	// that is not known
+	size_t GetPayloadSize(unsigned char type)
+	{
+		switch (type)
+		{
+		case InputLog::EVENT_FRAME:
+		case InputLog::EVENT_SCROLL:
+			return(4);
+		case InputLog::EVENT_MOUSE_MOVE:
+			return(8);
+		case InputLog::EVENT_KEYS:
+			return(1);
+		default:
+			return(0);
+		}
+	}
+}
+
+/***********************************************************
+ *  InputLog()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputLog::InputLog()
+{
+	m_startState.position = glm::vec3(0.0f);
+	m_startState.front = glm::vec3(0.0f, 0.0f, -1.0f);
+	m_startState.up = glm::vec3(0.0f, 1.0f, 0.0f);
+	m_startState.right = glm::vec3(1.0f, 0.0f, 0.0f);
+	m_startState.worldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+	m_startState.yaw = 0.0f;
+	m_startState.pitch = 0.0f;
+	m_startState.cameraSpeed = 0.0f;
+	m_startState.mouseSensitivity = 0.0f;
+	m_startState.zoom = 0.0f;
+	m_startState.movementSpeed = 0.0f;
+	m_startState.bOrthographic = false;
+	Clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting the recorded events
+ *  and starting the clock over.
+ ***********************************************************/
+void InputLog::Clear()
+{
+	m_events.clear();
+	m_frameCount = 0;
+	m_time = 0.0;
+	m_keys = 0;
+}
+
+/***********************************************************
+ *  SetStartState()
+ *
+ *  This method is used for setting the camera and view
+ *  state the recording starts from.
+ ***********************************************************/
+void InputLog::SetStartState(const VIEW_STATE& state)
+{
+	m_startState = state;
+}
+
+/***********************************************************
+ *  GetStartState()
+ ***********************************************************/
+const InputLog::VIEW_STATE& InputLog::GetStartState() const
+{
+	return(m_startState);
+}
+
+/***********************************************************
+ *  AddMouseMove()
+ *
+ *  This method is used for recording the offsets the camera
+ *  was turned by.
+ ***********************************************************/
+void InputLog::AddMouseMove(float xOffset, float yOffset)
+{
+	AddEvent(EVENT_MOUSE_MOVE, xOffset, yOffset, 0);
+}
+
+/***********************************************************
+ *  AddScroll()
+ *
+ *  This method is used for recording a scroll wheel step.
+ ***********************************************************/
+void InputLog::AddScroll(float offset)
+{
+	AddEvent(EVENT_SCROLL, offset, 0.0f, 0);
+}
+
+/***********************************************************
+ *  SetKeys()
+ *
+ *  This method is used for recording the keys pressed in
+ *  the current frame.  Keys are held for many frames, so an
+ *  event is only added when they change.
+ ***********************************************************/
+void InputLog::SetKeys(uint32_t keys)
+{
+	if (keys != m_keys)
+	{
+		AddEvent(EVENT_KEYS, 0.0f, 0.0f, keys);
+		m_keys = keys;
+	}
+}
+
+/***********************************************************
+ *  AddFrame()
+ *
+ *  This method is used for ending the current frame.  The
+ *  time step is what the frame moved the camera by, and
+ *  the clock moves on by it.
+ ***********************************************************/
+void InputLog::AddFrame(float deltaTime)
+{
+	m_time += deltaTime;
+	AddEvent(EVENT_FRAME, deltaTime, 0.0f, 0);
+	m_frameCount++;
+}
+
+/***********************************************************
+ *  GetEvents()
+ ***********************************************************/
+const std::vector<InputLog::INPUT_EVENT>& InputLog::GetEvents() const
+{
+	return(m_events);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ ***********************************************************/
+int InputLog::GetFrameCount() const
+{
+	return(m_frameCount);
+}
+
+/***********************************************************
+ *  GetDuration()
+ ***********************************************************/
+double InputLog::GetDuration() const
+{
+	return(m_time);
+}
+
+/***********************************************************
+ *  AddEvent()
+ *
+ *  This method is used for adding an event stamped with
+ *  the current time.
+ ***********************************************************/
+void InputLog::AddEvent(EVENT_TYPE type, float x, float y, uint32_t keys)
+{
+	INPUT_EVENT event;
+	event.type = type;
+	event.time = m_time;
+	event.x = x;
+	event.y = y;
+	event.keys = keys;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing the start state and the
+ *  events to a file.  Each event is its type byte followed
+ *  by only the values that type uses, in little endian
+ *  order.
+ ***********************************************************/
+bool InputLog::Write(const std::string& filename) const
+{
+	std::vector<unsigned char> bytes;
+	bytes.reserve(HEADER_SIZE + m_events.size() * 5);
+
+	bytes.insert(bytes.end(), INPUT_LOG_IDENTIFIER, INPUT_LOG_IDENTIFIER + 4);
+	PutUInt32(bytes, INPUT_LOG_VERSION);
+	PutVec3(bytes, m_startState.position);
+	PutVec3(bytes, m_startState.front);
+	PutVec3(bytes, m_startState.up);
+	PutVec3(bytes, m_startState.right);
+	PutVec3(bytes, m_startState.worldUp);
+	PutFloat(bytes, m_startState.yaw);
+	PutFloat(bytes, m_startState.pitch);
+	PutFloat(bytes, m_startState.cameraSpeed);
+	PutFloat(bytes, m_startState.mouseSensitivity);
+	PutFloat(bytes, m_startState.zoom);
+	PutFloat(bytes, m_startState.movementSpeed);
+	bytes.push_back(m_startState.bOrthographic ? 1 : 0);
+	PutUInt32(bytes, (uint32_t)m_frameCount);
+	PutUInt32(bytes, (uint32_t)m_events.size());
+
+	for (size_t i = 0; i < m_events.size(); i++)
+	{
+		const INPUT_EVENT& event = m_events[i];
+		bytes.push_back((unsigned char)event.type);
+		switch (event.type)
+		{
+		case EVENT_FRAME:
+		case EVENT_SCROLL:
+			PutFloat(bytes, event.x);
+			break;
+		case EVENT_MOUSE_MOVE:
+			PutFloat(bytes, event.x);
+			PutFloat(bytes, event.y);
+			break;
+		case EVENT_KEYS:
+			bytes.push_back((unsigned char)event.keys);
+			break;
+		}
+	}
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+	file.write((const char*)bytes.data(), bytes.size());
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  Read()
+ *
+ *  This method is used for reading a file written by
+ *  Write(), replacing the events.  The clock is rebuilt from
+ *  the frame time steps.  A file that is not an input log,
+ *  or is cut short, leaves the log empty.
+ ***********************************************************/
+bool InputLog::Read(const std::string& filename)
+{
+	Clear();
+
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+	std::vector<unsigned char> bytes(
+		(std::istreambuf_iterator<char>(file)),
+		std::istreambuf_iterator<char>());
+
+	if ((bytes.size() < HEADER_SIZE) ||
+		(memcmp(bytes.data(), INPUT_LOG_IDENTIFIER, 4) != 0) ||
+		(GetUInt32(&bytes[4]) != INPUT_LOG_VERSION))
+	{
+		return(false);
+	}
+
+	const unsigned char* state = &bytes[8];
+	m_startState.position = GetVec3(state);
+	m_startState.front = GetVec3(state + 12);
+	m_startState.up = GetVec3(state + 24);
+	m_startState.right = GetVec3(state + 36);
+	m_startState.worldUp = GetVec3(state + 48);
+	m_startState.yaw = GetFloat(state + 60);
+	m_startState.pitch = GetFloat(state + 64);
+	m_startState.cameraSpeed = GetFloat(state + 68);
+	m_startState.mouseSensitivity = GetFloat(state + 72);
+	m_startState.zoom = GetFloat(state + 76);
+	m_startState.movementSpeed = GetFloat(state + 80);
+	m_startState.bOrthographic = (state[84] != 0);
+	uint32_t frameCount = GetUInt32(state + 85);
+	uint32_t eventCount = GetUInt32(state + 89);
+
+	// the count comes from the file, so check the bytes can
+	// hold that many events before making room for them
+	if (eventCount > (bytes.size() - HEADER_SIZE) / MIN_EVENT_SIZE)
+	{
+		Clear();
+		return(false);
+	}
+
+	size_t offset = HEADER_SIZE;
+	m_events.reserve(eventCount);
+	for (uint32_t i = 0; i < eventCount; i++)
+	{
+		if (offset >= bytes.size())
+		{
+			Clear();
+			return(false);
+		}
+		unsigned char type = bytes[offset++];
+		size_t payloadSize = GetPayloadSize(type);
+		if ((payloadSize == 0) || (offset + payloadSize > bytes.size()))
+		{
+			Clear();
+			return(false);
+		}
+
+		const unsigned char* payload = &bytes[offset];
+		switch (type)
+		{
+		case EVENT_FRAME:
+			AddFrame(GetFloat(payload));
+			break;
+		case EVENT_MOUSE_MOVE:
+			AddMouseMove(GetFloat(payload), GetFloat(payload + 4));
+			break;
+		case EVENT_SCROLL:
+			AddScroll(GetFloat(payload));
+			break;
+		case EVENT_KEYS:
+			AddEvent(EVENT_KEYS, 0.0f, 0.0f, payload[0]);
+			m_keys = payload[0];
+			break;
+		}
+		offset += payloadSize;
+	}
+
+	if ((uint32_t)m_frameCount != frameCount)
+	{
+		Clear();
+		return(false);
+	}
+
+	return(true);
+}
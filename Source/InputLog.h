@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputlog.h
+// ============
+// record the input applied to the camera as timestamped events, and read
+// and write them as a compact binary log for deterministic replay
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  InputLog
+ *
+ *  This class holds the input of a session as the values
+ *  the camera was given - mouse offsets, scroll steps and
+ *  the pressed keys - rather than the raw window events, so
+ *  a replay applies exactly the same floats in the same
+ *  order.  Every frame ends with a frame event holding its
+ *  time step, which is the clock of the replay, and every
+ *  event is stamped with that clock.
+ *
+ *  The camera and view state at the start of the recording
+ *  is saved with the events, so a replay starts from the
+ *  same place whatever the camera was doing before.
+ ***********************************************************/
+class InputLog
+{
+public:
+	// constructor
+	InputLog();
+
+	// kinds of recorded events
+	enum EVENT_TYPE
+	{
+		EVENT_FRAME = 1,
+		EVENT_MOUSE_MOVE = 2,
+		EVENT_SCROLL = 3,
+		EVENT_KEYS = 4
+	};
+
+	// bits of the pressed keys
+	static const uint32_t KEY_FORWARD = 0x01;
+	static const uint32_t KEY_BACKWARD = 0x02;
+	static const uint32_t KEY_LEFT = 0x04;
+	static const uint32_t KEY_RIGHT = 0x08;
+	static const uint32_t KEY_UP = 0x10;
+	static const uint32_t KEY_DOWN = 0x20;
+	static const uint32_t KEY_PROJECTION = 0x40;
+
+	// one recorded event - the values are the time step of
+	// a frame, the mouse offsets, or the scroll step
+	struct INPUT_EVENT
+	{
+		EVENT_TYPE type;
+		// seconds on the recorded clock, not saved since it
+		// is the sum of the frame time steps
+		double time;
+		float x;
+		float y;
+		uint32_t keys;
+	};
+
+	// camera and view settings the recording starts from
+	struct VIEW_STATE
+	{
+		glm::vec3 position;
+		glm::vec3 front;
+		glm::vec3 up;
+		glm::vec3 right;
+		glm::vec3 worldUp;
+		float yaw;
+		float pitch;
+		float cameraSpeed;
+		float mouseSensitivity;
+		float zoom;
+		float movementSpeed;
+		bool bOrthographic;
+	};
+
+	// forget the events and start the clock over
+	void Clear();
+	// state the recording starts from
+	void SetStartState(const VIEW_STATE& state);
+	const VIEW_STATE& GetStartState() const;
+
+	// add events at the current time
+	void AddMouseMove(float xOffset, float yOffset);
+	void AddScroll(float offset);
+	// add a keys event when the pressed keys changed
+	void SetKeys(uint32_t keys);
+	// end the frame and move the clock on by its time step
+	void AddFrame(float deltaTime);
+
+	// recorded events, oldest first
+	const std::vector<INPUT_EVENT>& GetEvents() const;
+	int GetFrameCount() const;
+	// seconds on the recorded clock
+	double GetDuration() const;
+
+	// write and read the binary log
+	bool Write(const std::string& filename) const;
+	bool Read(const std::string& filename);
+
+private:
+	VIEW_STATE m_startState;
+	std::vector<INPUT_EVENT> m_events;
+	int m_frameCount;
+	double m_time;
+	// keys of the last keys event
+	uint32_t m_keys;
+
+	void AddEvent(EVENT_TYPE type, float x, float y, uint32_t keys);
+};
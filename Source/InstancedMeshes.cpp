@@ -0,0 +1,408 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.cpp
+// ============
+// draw many copies of the basic shapes with a single instanced draw call
+// fed by a per-instance attribute buffer
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstancedMeshes.h"
+
+#include <cstddef>
+
+// declaration of the global variables and defines
+namespace
+{
+	// smallest number of instances allocated in the buffer
+	const int MIN_INSTANCE_CAPACITY = 256;
+}
+
+/***********************************************************
+ *  InstancedMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InstancedMeshes::InstancedMeshes()
+{
+	for (int i = 0; i < MESH_TYPE_COUNT; i++)
+	{
+		for (int lod = 0; lod < ShapeGeometry::MAX_LOD_COUNT; lod++)
+		{
+			m_meshes[i][lod].vao = 0;
+			m_meshes[i][lod].vbo = 0;
+			m_meshes[i][lod].ibo = 0;
+			m_meshes[i][lod].nIndices = 0;
+			m_meshes[i][lod].bLoaded = false;
+		}
+	}
+	m_instanceBuffer = 0;
+	m_instanceCapacity = 0;
+	m_pStateCache = NULL;
+}
+
+/***********************************************************
+ *  ~InstancedMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InstancedMeshes::~InstancedMeshes()
+{
+	for (int i = 0; i < MESH_TYPE_COUNT; i++)
+	{
+		for (int lod = 0; lod < ShapeGeometry::MAX_LOD_COUNT; lod++)
+		{
+			GL_INSTANCED_MESH& mesh = m_meshes[i][lod];
+			if (mesh.bLoaded)
+			{
+				glDeleteVertexArrays(1, &mesh.vao);
+				glDeleteBuffers(1, &mesh.vbo);
+				glDeleteBuffers(1, &mesh.ibo);
+				mesh.bLoaded = false;
+			}
+		}
+	}
+	if (m_instanceBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+		m_instanceBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  LoadPlaneMesh()
+ *
+ *  This method is used for loading the instanced plane mesh.
+ ***********************************************************/
+void InstancedMeshes::LoadPlaneMesh()
+{
+	LoadMesh(MESH_PLANE);
+}
+
+/***********************************************************
+ *  LoadBoxMesh()
+ *
+ *  This method is used for loading the instanced box mesh.
+ ***********************************************************/
+void InstancedMeshes::LoadBoxMesh()
+{
+	LoadMesh(MESH_BOX);
+}
+
+/***********************************************************
+ *  LoadPrismMesh()
+ *
+ *  This method is used for loading the instanced prism mesh.
+ ***********************************************************/
+void InstancedMeshes::LoadPrismMesh()
+{
+	LoadMesh(MESH_PRISM);
+}
+
+/***********************************************************
+ *  LoadCylinderMesh()
+ *
+ *  This method is used for loading the instanced cylinder
+ *  mesh.
+ ***********************************************************/
+void InstancedMeshes::LoadCylinderMesh()
+{
+	LoadMesh(MESH_CYLINDER);
+}
+
+/***********************************************************
+ *  LoadMesh()
+ *
+ *  This method is used for loading every detail level of a
+ *  basic shape.
+ ***********************************************************/
+void InstancedMeshes::LoadMesh(int meshType)
+{
+	for (int lod = 0; lod < ShapeGeometry::GetLodCount(meshType); lod++)
+	{
+		LoadMeshLod(meshType, lod);
+	}
+}
+
+/***********************************************************
+ *  LoadMeshLod()
+ *
+ *  This method is used for creating the vertex and index
+ *  buffers of a detail level of a basic shape, and the
+ *  vertex array object that combines them with the shared
+ *  instance buffer.
+ ***********************************************************/
+void InstancedMeshes::LoadMeshLod(int meshType, int lod)
+{
+	if ((meshType < 0) || (meshType >= MESH_TYPE_COUNT) ||
+		(lod < 0) || (lod >= ShapeGeometry::MAX_LOD_COUNT) ||
+		(m_meshes[meshType][lod].bLoaded))
+	{
+		return;
+	}
+
+	ShapeGeometry::GEOMETRY geometry;
+	if (ShapeGeometry::BuildMeshLod(meshType, lod, geometry) == false)
+	{
+		return;
+	}
+
+	// the instance buffer is shared by all of the meshes
+	if (m_instanceBuffer == 0)
+	{
+		glGenBuffers(1, &m_instanceBuffer);
+	}
+
+	GL_INSTANCED_MESH& mesh = m_meshes[meshType][lod];
+	const GLsizei vertexStride = sizeof(ShapeGeometry::VERTEX);
+
+	glGenVertexArrays(1, &mesh.vao);
+	glBindVertexArray(mesh.vao);
+
+	// per-vertex data
+	glGenBuffers(1, &mesh.vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	glBufferData(
+		GL_ARRAY_BUFFER,
+		geometry.vertices.size() * sizeof(ShapeGeometry::VERTEX),
+		geometry.vertices.data(),
+		GL_STATIC_DRAW);
+
+	glGenBuffers(1, &mesh.ibo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+	glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		geometry.indices.size() * sizeof(uint32_t),
+		geometry.indices.data(),
+		GL_STATIC_DRAW);
+	mesh.nIndices = (GLsizei)geometry.indices.size();
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, normal));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, textureCoordinate));
+	glEnableVertexAttribArray(2);
+
+	// per-instance data - advanced once per drawn instance
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	for (int column = 0; column < 4; column++)
+	{
+		glEnableVertexAttribArray(MODEL_ATTRIBUTE + column);
+		glVertexAttribDivisor(MODEL_ATTRIBUTE + column, 1);
+	}
+	glEnableVertexAttribArray(COLOR_ATTRIBUTE);
+	glVertexAttribDivisor(COLOR_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(UV_SCALE_ATTRIBUTE);
+	glVertexAttribDivisor(UV_SCALE_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(MATERIAL_ATTRIBUTE);
+	glVertexAttribDivisor(MATERIAL_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(TEXTURE_LAYER_ATTRIBUTE);
+	glVertexAttribDivisor(TEXTURE_LAYER_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(TEXTURE_RECT_ATTRIBUTE);
+	glVertexAttribDivisor(TEXTURE_RECT_ATTRIBUTE, 1);
+	SetInstanceAttributes();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	if (NULL != m_pStateCache)
+	{
+		m_pStateCache->InvalidateVertexArray();
+	}
+
+	mesh.bLoaded = true;
+}
+
+/***********************************************************
+ *  SetStateCache()
+ *
+ *  This method is used for setting a state cache that the
+ *  vertex arrays are bound through while drawing, so that
+ *  consecutive batches of one mesh do not rebind it.
+ ***********************************************************/
+void InstancedMeshes::SetStateCache(RenderStateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+}
+
+/***********************************************************
+ *  SetInstanceAttributes()
+ *
+ *  This method is used for pointing the per-instance vertex
+ *  attributes of the bound vertex array at the start of the
+ *  shared buffer.  This is done once per vertex array, and
+ *  a batch starts at its own instance through the base
+ *  instance of its draw.
+ ***********************************************************/
+void InstancedMeshes::SetInstanceAttributes()
+{
+	const GLsizei instanceStride = sizeof(INSTANCE_DATA);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	for (int column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(
+			MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, instanceStride,
+			(void*)(offsetof(INSTANCE_DATA, model) + (column * sizeof(glm::vec4))));
+	}
+	glVertexAttribPointer(
+		COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, instanceStride,
+		(void*)offsetof(INSTANCE_DATA, color));
+	glVertexAttribPointer(
+		UV_SCALE_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, instanceStride,
+		(void*)offsetof(INSTANCE_DATA, UVscale));
+	glVertexAttribIPointer(
+		MATERIAL_ATTRIBUTE, 1, GL_INT, instanceStride,
+		(void*)offsetof(INSTANCE_DATA, materialIndex));
+	glVertexAttribIPointer(
+		TEXTURE_LAYER_ATTRIBUTE, 1, GL_INT, instanceStride,
+		(void*)offsetof(INSTANCE_DATA, textureLayer));
+	glVertexAttribPointer(
+		TEXTURE_RECT_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, instanceStride,
+		(void*)offsetof(INSTANCE_DATA, textureRect));
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method is used for uploading the instance data of
+ *  every batch in the frame.  The buffer is orphaned before
+ *  the upload so the driver does not wait on the previous
+ *  frame, and it grows when more instances are needed.
+ ***********************************************************/
+void InstancedMeshes::UploadInstances(const INSTANCE_DATA* instances, int count)
+{
+	if ((m_instanceBuffer == 0) || (count <= 0))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+	if (count > m_instanceCapacity)
+	{
+		m_instanceCapacity = MIN_INSTANCE_CAPACITY;
+		while (m_instanceCapacity < count)
+		{
+			m_instanceCapacity *= 2;
+		}
+	}
+
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(INSTANCE_DATA), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(INSTANCE_DATA), instances);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawPlaneMeshInstanced()
+ *
+ *  This method is used for drawing instances of the plane.
+ ***********************************************************/
+void InstancedMeshes::DrawPlaneMeshInstanced(int firstInstance, int count)
+{
+	DrawMeshInstanced(MESH_PLANE, firstInstance, count);
+}
+
+/***********************************************************
+ *  DrawBoxMeshInstanced()
+ *
+ *  This method is used for drawing instances of the box.
+ ***********************************************************/
+void InstancedMeshes::DrawBoxMeshInstanced(int firstInstance, int count)
+{
+	DrawMeshInstanced(MESH_BOX, firstInstance, count);
+}
+
+/***********************************************************
+ *  DrawPrismMeshInstanced()
+ *
+ *  This method is used for drawing instances of the prism.
+ ***********************************************************/
+void InstancedMeshes::DrawPrismMeshInstanced(int firstInstance, int count)
+{
+	DrawMeshInstanced(MESH_PRISM, firstInstance, count);
+}
+
+/***********************************************************
+ *  DrawCylinderMeshInstanced()
+ *
+ *  This method is used for drawing instances of the
+ *  cylinder.
+ ***********************************************************/
+void InstancedMeshes::DrawCylinderMeshInstanced(int firstInstance, int count)
+{
+	DrawMeshInstanced(MESH_CYLINDER, firstInstance, count);
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for drawing count instances of a
+ *  basic shape, reading the instance data starting at
+ *  firstInstance in the uploaded buffer.
+ ***********************************************************/
+void InstancedMeshes::DrawMeshInstanced(int meshType, int firstInstance, int count)
+{
+	DrawMeshLodInstanced(meshType, 0, firstInstance, count);
+}
+
+/***********************************************************
+ *  DrawMeshLodInstanced()
+ *
+ *  This method is used for drawing count instances of a
+ *  detail level of a basic shape.  A level that was not
+ *  loaded falls back to the full detail mesh.  The base
+ *  instance offsets the per-instance attributes, so no
+ *  vertex array state changes between batches.
+ ***********************************************************/
+void InstancedMeshes::DrawMeshLodInstanced(int meshType, int lod, int firstInstance, int count)
+{
+	if ((meshType < 0) || (meshType >= MESH_TYPE_COUNT) || (count <= 0))
+	{
+		return;
+	}
+	if ((lod < 0) || (lod >= ShapeGeometry::MAX_LOD_COUNT) || (m_meshes[meshType][lod].bLoaded == false))
+	{
+		lod = 0;
+	}
+
+	const GL_INSTANCED_MESH& mesh = m_meshes[meshType][lod];
+	if (mesh.bLoaded == false)
+	{
+		return;
+	}
+
+	// with a state cache the vertex array is left bound for
+	// the next batch instead of being unbound
+	if (NULL != m_pStateCache)
+	{
+		m_pStateCache->BindVertexArray(mesh.vao);
+	}
+	else
+	{
+		glBindVertexArray(mesh.vao);
+	}
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES, mesh.nIndices, GL_UNSIGNED_INT, NULL, count, firstInstance);
+	if (NULL == m_pStateCache)
+	{
+		glBindVertexArray(0);
+	}
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used for getting the number of triangles
+ *  drawn for one instance of a detail level of a mesh type.
+ ***********************************************************/
+int InstancedMeshes::GetTriangleCount(int meshType, int lod) const
+{
+	if ((meshType < 0) || (meshType >= MESH_TYPE_COUNT) ||
+		(lod < 0) || (lod >= ShapeGeometry::MAX_LOD_COUNT))
+	{
+		return(0);
+	}
+
+	return((int)(m_meshes[meshType][lod].nIndices / 3));
+}
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.h
+// ============
+// draw many copies of the basic shapes with a single instanced draw call
+// fed by a per-instance attribute buffer
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+#include "RenderStateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+/***********************************************************
+ *  InstancedMeshes
+ *
+ *  This class owns vertex array objects for the basic shapes
+ *  that read their model matrix, color, UV scale and material
+ *  index from a shared per-instance buffer.  The instance
+ *  data for a frame is uploaded once, and each batch is then
+ *  drawn with one call starting at its first instance.
+ *  Every detail level of the curved shapes is loaded.
+ ***********************************************************/
+class InstancedMeshes
+{
+public:
+	// constructor
+	InstancedMeshes();
+	// destructor
+	~InstancedMeshes();
+
+	// per-instance attributes, matching the vertex shader inputs
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		int32_t materialIndex;
+		int32_t textureLayer;
+		glm::vec4 textureRect;
+	};
+
+	// shader attribute locations of the per-instance data
+	static const int MODEL_ATTRIBUTE = 3;		// uses locations 3 to 6
+	static const int COLOR_ATTRIBUTE = 7;
+	static const int UV_SCALE_ATTRIBUTE = 8;
+	static const int MATERIAL_ATTRIBUTE = 9;
+	static const int TEXTURE_LAYER_ATTRIBUTE = 11;
+	static const int TEXTURE_RECT_ATTRIBUTE = 12;
+
+	// load the instanced version of a basic shape mesh
+	void LoadPlaneMesh();
+	void LoadBoxMesh();
+	void LoadPrismMesh();
+	void LoadCylinderMesh();
+
+	// bind the vertex arrays through a state cache when drawing
+	void SetStateCache(RenderStateCache* pStateCache);
+
+	// upload the instance data for every batch of the frame
+	void UploadInstances(const INSTANCE_DATA* instances, int count);
+
+	// draw count instances starting at firstInstance
+	void DrawPlaneMeshInstanced(int firstInstance, int count);
+	void DrawBoxMeshInstanced(int firstInstance, int count);
+	void DrawPrismMeshInstanced(int firstInstance, int count);
+	void DrawCylinderMeshInstanced(int firstInstance, int count);
+	// draw count instances of a basic shape mesh type
+	void DrawMeshInstanced(int meshType, int firstInstance, int count);
+	// draw count instances of a detail level of a mesh type
+	void DrawMeshLodInstanced(int meshType, int lod, int firstInstance, int count);
+
+	// number of triangles in a detail level of a mesh type
+	int GetTriangleCount(int meshType, int lod) const;
+
+private:
+	// OpenGL objects for one instanced mesh
+	struct GL_INSTANCED_MESH
+	{
+		GLuint vao;
+		GLuint vbo;
+		GLuint ibo;
+		GLsizei nIndices;
+		bool bLoaded;
+	};
+
+	// instanced meshes indexed by MESH_TYPE and detail level
+	static const int MESH_TYPE_COUNT = 4;
+	GL_INSTANCED_MESH m_meshes[MESH_TYPE_COUNT][ShapeGeometry::MAX_LOD_COUNT];
+	// shared per-instance attribute buffer
+	GLuint m_instanceBuffer;
+	// allocated size of the instance buffer in instances
+	int m_instanceCapacity;
+	// optional cache of the bound vertex array
+	RenderStateCache* m_pStateCache;
+
+	// create the buffers and vertex arrays for every detail
+	// level of a mesh type
+	void LoadMesh(int meshType);
+	void LoadMeshLod(int meshType, int lod);
+	// point the per-instance attributes at the instance buffer
+	void SetInstanceAttributes();
+};
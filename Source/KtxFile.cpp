@@ -0,0 +1,478 @@
+///////////////////////////////////////////////////////////////////////////////
+// ktxfile.cpp
+// ============
+// read and write block compressed textures with their mipmap chain in the
+// KTX 2.0 container format
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "KtxFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// every KTX 2.0 file starts with these bytes
+	const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	// fixed header and index, then one entry per level
+	const size_t HEADER_SIZE = 80;
+	const size_t LEVEL_ENTRY_SIZE = 24;
+	// key/value data larger than this is not from the cooker
+	const uint32_t MAX_KEY_VALUE_BYTES = 65536;
+
+	// values of the data format descriptor
+	const uint32_t KHR_DF_MODEL_BC1A = 128;
+	const uint32_t KHR_DF_MODEL_BC3 = 130;
+	const uint32_t KHR_DF_MODEL_BC7 = 134;
+	const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+	const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+	const uint32_t KHR_DF_CHANNEL_COLOR = 0;
+	const uint32_t KHR_DF_CHANNEL_BC3_ALPHA = 15;
+
+	// keys of the key/value data, in the sorted order the
+	// format requires
+	const char* KEY_WRITER = "KTXwriter";
+	const char* KEY_SOURCE_CHANNELS = "SourceChannels";
+	const char* KEY_SOURCE_HASH = "SourceHash";
+
+	// place and size of a level inside the file
+	struct LEVEL_ENTRY
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+	};
+
+	void PutUInt32(std::vector<unsigned char>& bytes, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			bytes.push_back((unsigned char)(value >> (i * 8)));
+		}
+	}
+
+	void PutUInt64(std::vector<unsigned char>& bytes, uint64_t value)
+	{
+		PutUInt32(bytes, (uint32_t)value);
+		PutUInt32(bytes, (uint32_t)(value >> 32));
+	}
+
+	uint32_t GetUInt32(const unsigned char* bytes)
+	{
+		return((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+	}
+
+	uint64_t GetUInt64(const unsigned char* bytes)
+	{
+		return((uint64_t)GetUInt32(bytes) | ((uint64_t)GetUInt32(bytes + 4) << 32));
+	}
+
+	// append a key and its string value, padded to 4 bytes
+	void PutKeyValue(std::vector<unsigned char>& bytes, const std::string& key, const std::string& value)
+	{
+		PutUInt32(bytes, (uint32_t)(key.size() + value.size() + 2));
+		bytes.insert(bytes.end(), key.begin(), key.end());
+		bytes.push_back(0);
+		bytes.insert(bytes.end(), value.begin(), value.end());
+		bytes.push_back(0);
+		while ((bytes.size() % 4) != 0)
+		{
+			bytes.push_back(0);
+		}
+	}
+
+	// append one sample of the data format descriptor
+	void PutSample(std::vector<unsigned char>& bytes, uint32_t bitOffset, uint32_t bitLength, uint32_t channel)
+	{
+		PutUInt32(bytes, bitOffset | ((bitLength - 1) << 16) | (channel << 24));
+		PutUInt32(bytes, 0);
+		PutUInt32(bytes, 0);
+		PutUInt32(bytes, 0xFFFFFFFF);
+	}
+
+	// read and check the header, level index and key/value
+	// data of a cooked texture
+	bool ReadHeader(std::ifstream& file, KtxFile::KTX_INFO& info, std::vector<LEVEL_ENTRY>& outLevels)
+	{
+		unsigned char header[HEADER_SIZE];
+		if (!file.read((char*)header, HEADER_SIZE) ||
+			(memcmp(header, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0))
+		{
+			return(false);
+		}
+
+		info.vkFormat = GetUInt32(header + 12);
+		uint32_t typeSize = GetUInt32(header + 16);
+		uint32_t width = GetUInt32(header + 20);
+		uint32_t height = GetUInt32(header + 24);
+		uint32_t depth = GetUInt32(header + 28);
+		uint32_t layerCount = GetUInt32(header + 32);
+		uint32_t faceCount = GetUInt32(header + 36);
+		uint32_t levelCount = GetUInt32(header + 40);
+		uint32_t supercompression = GetUInt32(header + 44);
+		uint32_t keyValueOffset = GetUInt32(header + 56);
+		uint32_t keyValueLength = GetUInt32(header + 60);
+
+		// only single, uncompressed 2D images are cooked
+		BlockCompression::BLOCK_FORMAT format;
+		if ((KtxFile::GetBlockFormat(info.vkFormat, format) == false) ||
+			(typeSize != 1) || (depth != 0) || (layerCount != 0) || (faceCount != 1) ||
+			(supercompression != 0) ||
+			(width == 0) || (height == 0) || (width > 65536) || (height > 65536) ||
+			(levelCount == 0) || (levelCount > (uint32_t)ImageMipmaps::GetLevelCount(width, height)))
+		{
+			return(false);
+		}
+
+		info.width = (int)width;
+		info.height = (int)height;
+		info.levelCount = (int)levelCount;
+		info.sourceHash = 0;
+		info.sourceChannels = (format == BlockCompression::FORMAT_BC1) ? 3 : 4;
+
+		std::vector<unsigned char> levelIndex(levelCount * LEVEL_ENTRY_SIZE);
+		if (!file.read((char*)levelIndex.data(), levelIndex.size()))
+		{
+			return(false);
+		}
+
+		outLevels.clear();
+		for (int level = 0; level < info.levelCount; level++)
+		{
+			LEVEL_ENTRY entry;
+			entry.byteOffset = GetUInt64(&levelIndex[level * LEVEL_ENTRY_SIZE]);
+			entry.byteLength = GetUInt64(&levelIndex[(level * LEVEL_ENTRY_SIZE) + 8]);
+
+			size_t expectedLength = BlockCompression::GetImageSize(
+				format,
+				std::max(info.width >> level, 1),
+				std::max(info.height >> level, 1));
+			if (entry.byteLength != expectedLength)
+			{
+				return(false);
+			}
+			outLevels.push_back(entry);
+		}
+
+		if ((keyValueLength > 0) && (keyValueLength <= MAX_KEY_VALUE_BYTES))
+		{
+			std::vector<unsigned char> keyValues(keyValueLength);
+			file.seekg(keyValueOffset);
+			if (!file.read((char*)keyValues.data(), keyValues.size()))
+			{
+				return(false);
+			}
+
+			size_t position = 0;
+			while ((position + 4) <= keyValues.size())
+			{
+				uint32_t entryLength = GetUInt32(&keyValues[position]);
+				position += 4;
+				if ((entryLength == 0) || ((position + entryLength) > keyValues.size()))
+				{
+					break;
+				}
+
+				const char* entry = (const char*)&keyValues[position];
+				size_t keyLength = strnlen(entry, entryLength);
+				if (keyLength < entryLength)
+				{
+					std::string key(entry, keyLength);
+					std::string value(entry + keyLength + 1, strnlen(entry + keyLength + 1, entryLength - keyLength - 1));
+
+					if (key == KEY_SOURCE_HASH)
+					{
+						info.sourceHash = strtoull(value.c_str(), NULL, 16);
+					}
+					else if (key == KEY_SOURCE_CHANNELS)
+					{
+						info.sourceChannels = atoi(value.c_str());
+					}
+				}
+
+				position += (entryLength + 3) & ~(size_t)3;
+			}
+		}
+
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  ReadInfo()
+ *
+ *  This method is used for reading the description of a
+ *  cooked texture, which is enough to check it against its
+ *  source and to reserve its texture layer.
+ ***********************************************************/
+bool KtxFile::ReadInfo(const char* filename, KTX_INFO& outInfo)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	std::vector<LEVEL_ENTRY> levels;
+
+	return(ReadHeader(file, outInfo, levels));
+}
+
+/***********************************************************
+ *  Read()
+ *
+ *  This method is used for reading a cooked texture.  The
+ *  file stores the smallest level first, but the levels are
+ *  returned largest first, like ImageMipmaps builds them.
+ ***********************************************************/
+bool KtxFile::Read(const char* filename, KTX_IMAGE& outImage)
+{
+	outImage.data.clear();
+	outImage.levels.clear();
+
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	std::vector<LEVEL_ENTRY> entries;
+	if (ReadHeader(file, outImage.info, entries) == false)
+	{
+		return(false);
+	}
+
+	for (int level = 0; level < entries.size(); level++)
+	{
+		ImageMipmaps::MIP_LEVEL mipLevel;
+		mipLevel.width = std::max(outImage.info.width >> level, 1);
+		mipLevel.height = std::max(outImage.info.height >> level, 1);
+		mipLevel.offset = outImage.data.size();
+		mipLevel.size = (size_t)entries[level].byteLength;
+
+		outImage.data.resize(mipLevel.offset + mipLevel.size);
+		file.seekg(entries[level].byteOffset);
+		if (!file.read((char*)&outImage.data[mipLevel.offset], mipLevel.size))
+		{
+			outImage.data.clear();
+			outImage.levels.clear();
+			return(false);
+		}
+
+		outImage.levels.push_back(mipLevel);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing a cooked texture, with
+ *  the data format descriptor of its block format and the
+ *  source hash and channels in the key/value data.  The
+ *  level data starts on a block boundary, smallest first.
+ ***********************************************************/
+bool KtxFile::Write(const char* filename, const KTX_IMAGE& image)
+{
+	BlockCompression::BLOCK_FORMAT format;
+	if ((GetBlockFormat(image.info.vkFormat, format) == false) ||
+		(image.levels.empty()) ||
+		(image.levels.size() != image.info.levelCount))
+	{
+		return(false);
+	}
+
+	const uint32_t blockBytes = (uint32_t)BlockCompression::GetBlockBytes(format);
+
+	// data format descriptor with a single basic block
+	uint32_t colorModel = KHR_DF_MODEL_BC1A;
+	if (format == BlockCompression::FORMAT_BC3)
+	{
+		colorModel = KHR_DF_MODEL_BC3;
+	}
+	else if (format == BlockCompression::FORMAT_BC7)
+	{
+		colorModel = KHR_DF_MODEL_BC7;
+	}
+	uint32_t sampleCount = (format == BlockCompression::FORMAT_BC3) ? 2 : 1;
+	uint32_t descriptorBlockSize = 24 + (16 * sampleCount);
+
+	std::vector<unsigned char> descriptor;
+	PutUInt32(descriptor, 4 + descriptorBlockSize);
+	PutUInt32(descriptor, 0);
+	PutUInt32(descriptor, 2 | (descriptorBlockSize << 16));
+	PutUInt32(descriptor, colorModel | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+	PutUInt32(descriptor, 3 | (3 << 8));
+	PutUInt32(descriptor, blockBytes);
+	PutUInt32(descriptor, 0);
+	if (format == BlockCompression::FORMAT_BC3)
+	{
+		PutSample(descriptor, 0, 64, KHR_DF_CHANNEL_BC3_ALPHA);
+		PutSample(descriptor, 64, 64, KHR_DF_CHANNEL_COLOR);
+	}
+	else
+	{
+		PutSample(descriptor, 0, blockBytes * 8, KHR_DF_CHANNEL_COLOR);
+	}
+
+	char hashText[32];
+	snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)image.info.sourceHash);
+
+	std::vector<unsigned char> keyValues;
+	PutKeyValue(keyValues, KEY_WRITER, "TextureCooker");
+	PutKeyValue(keyValues, KEY_SOURCE_CHANNELS, std::to_string(image.info.sourceChannels));
+	PutKeyValue(keyValues, KEY_SOURCE_HASH, hashText);
+
+	const uint32_t levelCount = (uint32_t)image.levels.size();
+	const uint32_t descriptorOffset = (uint32_t)(HEADER_SIZE + (levelCount * LEVEL_ENTRY_SIZE));
+	const uint32_t keyValueOffset = descriptorOffset + (uint32_t)descriptor.size();
+	uint64_t dataOffset = keyValueOffset + keyValues.size();
+	dataOffset = ((dataOffset + blockBytes - 1) / blockBytes) * blockBytes;
+
+	// the smallest level comes first in the file
+	std::vector<uint64_t> levelOffsets(levelCount, 0);
+	uint64_t offset = dataOffset;
+	for (int level = (int)levelCount - 1; level >= 0; level--)
+	{
+		levelOffsets[level] = offset;
+		offset += image.levels[level].size;
+	}
+
+	std::vector<unsigned char> bytes(KTX_IDENTIFIER, KTX_IDENTIFIER + sizeof(KTX_IDENTIFIER));
+	PutUInt32(bytes, image.info.vkFormat);
+	PutUInt32(bytes, 1);
+	PutUInt32(bytes, (uint32_t)image.info.width);
+	PutUInt32(bytes, (uint32_t)image.info.height);
+	PutUInt32(bytes, 0);
+	PutUInt32(bytes, 0);
+	PutUInt32(bytes, 1);
+	PutUInt32(bytes, levelCount);
+	PutUInt32(bytes, 0);
+	PutUInt32(bytes, descriptorOffset);
+	PutUInt32(bytes, (uint32_t)descriptor.size());
+	PutUInt32(bytes, keyValueOffset);
+	PutUInt32(bytes, (uint32_t)keyValues.size());
+	PutUInt64(bytes, 0);
+	PutUInt64(bytes, 0);
+	for (int level = 0; level < levelCount; level++)
+	{
+		PutUInt64(bytes, levelOffsets[level]);
+		PutUInt64(bytes, image.levels[level].size);
+		PutUInt64(bytes, image.levels[level].size);
+	}
+	bytes.insert(bytes.end(), descriptor.begin(), descriptor.end());
+	bytes.insert(bytes.end(), keyValues.begin(), keyValues.end());
+	bytes.resize((size_t)dataOffset, 0);
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+	file.write((const char*)bytes.data(), bytes.size());
+	for (int level = (int)levelCount - 1; level >= 0; level--)
+	{
+		file.write((const char*)&image.data[image.levels[level].offset], image.levels[level].size);
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  GetBlockFormat()
+ *
+ *  This method is used for getting the block format that a
+ *  Vulkan format number stands for.
+ ***********************************************************/
+bool KtxFile::GetBlockFormat(uint32_t vkFormat, BlockCompression::BLOCK_FORMAT& outFormat)
+{
+	switch (vkFormat)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		outFormat = BlockCompression::FORMAT_BC1;
+		return(true);
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+		outFormat = BlockCompression::FORMAT_BC3;
+		return(true);
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+		outFormat = BlockCompression::FORMAT_BC7;
+		return(true);
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetVkFormat()
+ *
+ *  This method is used for getting the Vulkan format number
+ *  that a cooked texture of a block format is tagged with.
+ ***********************************************************/
+uint32_t KtxFile::GetVkFormat(BlockCompression::BLOCK_FORMAT format)
+{
+	switch (format)
+	{
+	case BlockCompression::FORMAT_BC3:
+		return(VK_FORMAT_BC3_UNORM_BLOCK);
+	case BlockCompression::FORMAT_BC7:
+		return(VK_FORMAT_BC7_UNORM_BLOCK);
+	default:
+		return(VK_FORMAT_BC1_RGB_UNORM_BLOCK);
+	}
+}
+
+/***********************************************************
+ *  HashFile()
+ *
+ *  This method is used for hashing the bytes of a file, so
+ *  a cooked texture can be matched to its source image.
+ ***********************************************************/
+uint64_t KtxFile::HashFile(const char* filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(0);
+	}
+
+	uint64_t hash = 14695981039346656037ULL;
+	char buffer[65536];
+	while (file)
+	{
+		file.read(buffer, sizeof(buffer));
+		std::streamsize count = file.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= (unsigned char)buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  GetCookedPath()
+ *
+ *  This method is used for getting the path of the cooked
+ *  texture of a source image, which sits next to it with
+ *  the .ktx2 extension.
+ ***********************************************************/
+std::string KtxFile::GetCookedPath(const std::string& sourcePath)
+{
+	size_t separator = sourcePath.find_last_of("/\\");
+	size_t extension = sourcePath.find_last_of('.');
+	if ((extension == std::string::npos) ||
+		((separator != std::string::npos) && (extension < separator)))
+	{
+		return(sourcePath + ".ktx2");
+	}
+
+	return(sourcePath.substr(0, extension) + ".ktx2");
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// ktxfile.h
+// ============
+// read and write block compressed textures with their mipmap chain in the
+// KTX 2.0 container format
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BlockCompression.h"
+#include "ImageMipmaps.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  KtxFile
+ *
+ *  This class reads and writes the cooked textures made by
+ *  the offline texture cooker.  Only what the cooker writes
+ *  is understood: a single 2D image in BC1, BC3 or BC7 with
+ *  its mipmap levels and no supercompression.
+ *
+ *  Besides the writer name, the key/value data records a
+ *  hash of the source image file and its number of color
+ *  channels, so the loader can tell whether a cooked file
+ *  is stale without decoding the source, and whether the
+ *  texture has alpha without looking at the block format.
+ ***********************************************************/
+class KtxFile
+{
+public:
+	// Vulkan format numbers of the supported block formats
+	static const uint32_t VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131;
+	static const uint32_t VK_FORMAT_BC3_UNORM_BLOCK = 137;
+	static const uint32_t VK_FORMAT_BC7_UNORM_BLOCK = 145;
+
+	// description of a cooked texture
+	struct KTX_INFO
+	{
+		uint32_t vkFormat;
+		int width;
+		int height;
+		int levelCount;
+		uint64_t sourceHash;
+		int sourceChannels;
+	};
+
+	// cooked texture with every level in data, largest first
+	struct KTX_IMAGE
+	{
+		KTX_INFO info;
+		std::vector<unsigned char> data;
+		std::vector<ImageMipmaps::MIP_LEVEL> levels;
+	};
+
+	// read the description of a cooked texture without its
+	// level data
+	static bool ReadInfo(const char* filename, KTX_INFO& outInfo);
+	// read a cooked texture and all of its levels
+	static bool Read(const char* filename, KTX_IMAGE& outImage);
+	// write a cooked texture
+	static bool Write(const char* filename, const KTX_IMAGE& image);
+
+	// block format of a Vulkan format number, false when it
+	// is not one of the supported formats
+	static bool GetBlockFormat(uint32_t vkFormat, BlockCompression::BLOCK_FORMAT& outFormat);
+	// Vulkan format number of a block format
+	static uint32_t GetVkFormat(BlockCompression::BLOCK_FORMAT format);
+
+	// 64 bit FNV-1a hash of the contents of a file, 0 when
+	// the file cannot be read
+	static uint64_t HashFile(const char* filename);
+	// path of the cooked texture made from a source image
+	static std::string GetCookedPath(const std::string& sourcePath);
+};
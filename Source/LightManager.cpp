@@ -0,0 +1,498 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.cpp
+// ============
+// store any number of point and spot lights in shader storage buffers and
+// assign them to view-space froxel clusters for clustered forward shading
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ *  LightManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightManager::LightManager()
+{
+	m_bLightsDirty = true;
+	m_clusterProjection = glm::mat4(0.0f);
+	m_nearPlane = 0.1f;
+	m_farPlane = 100.0f;
+	m_tileSize = glm::vec2(1.0f, 1.0f);
+	m_lightBuffer = 0;
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_clusterLights.resize(CLUSTER_COUNT);
+	m_clusterRanges.resize(CLUSTER_COUNT * 2, 0);
+}
+
+/***********************************************************
+ *  ~LightManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightManager::~LightManager()
+{
+	GLuint buffers[3] = { m_lightBuffer, m_clusterBuffer, m_indexBuffer };
+	for (int i = 0; i < 3; i++)
+	{
+		if (buffers[i] != 0)
+		{
+			glDeleteBuffers(1, &buffers[i]);
+		}
+	}
+	m_lightBuffer = 0;
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_lights.clear();
+}
+
+/***********************************************************
+ *  AddPointLight()
+ *
+ *  This method is used for adding a light that shines in
+ *  every direction up to its range.  The index of the new
+ *  light is returned.
+ ***********************************************************/
+int LightManager::AddPointLight(
+	glm::vec3 position,
+	glm::vec3 ambientColor,
+	glm::vec3 diffuseColor,
+	glm::vec3 specularColor,
+	float focalStrength,
+	float specularIntensity,
+	float range)
+{
+	LIGHT_SOURCE light;
+	light.type = LIGHT_POINT;
+	light.position = position;
+	light.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+	light.ambientColor = ambientColor;
+	light.diffuseColor = diffuseColor;
+	light.specularColor = specularColor;
+	light.focalStrength = focalStrength;
+	light.specularIntensity = specularIntensity;
+	light.range = range;
+	light.innerConeDegrees = 180.0f;
+	light.outerConeDegrees = 180.0f;
+
+	return(AddLight(light));
+}
+
+/***********************************************************
+ *  AddSpotLight()
+ *
+ *  This method is used for adding a light that shines along
+ *  a direction.  Full brightness is reached inside the inner
+ *  cone and it fades out toward the outer cone.
+ ***********************************************************/
+int LightManager::AddSpotLight(
+	glm::vec3 position,
+	glm::vec3 direction,
+	glm::vec3 ambientColor,
+	glm::vec3 diffuseColor,
+	glm::vec3 specularColor,
+	float focalStrength,
+	float specularIntensity,
+	float range,
+	float innerConeDegrees,
+	float outerConeDegrees)
+{
+	LIGHT_SOURCE light;
+	light.type = LIGHT_SPOT;
+	light.position = position;
+	light.direction = glm::normalize(direction);
+	light.ambientColor = ambientColor;
+	light.diffuseColor = diffuseColor;
+	light.specularColor = specularColor;
+	light.focalStrength = focalStrength;
+	light.specularIntensity = specularIntensity;
+	light.range = range;
+	light.innerConeDegrees = innerConeDegrees;
+	light.outerConeDegrees = outerConeDegrees;
+
+	return(AddLight(light));
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for adding a light with all of its
+ *  properties.  The index of the new light is returned.
+ ***********************************************************/
+int LightManager::AddLight(const LIGHT_SOURCE& light)
+{
+	m_lights.push_back(light);
+	m_bLightsDirty = true;
+
+	return((int)m_lights.size() - 1);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for replacing the properties of a
+ *  previously added light.
+ ***********************************************************/
+void LightManager::SetLight(int index, const LIGHT_SOURCE& light)
+{
+	if ((index >= 0) && (index < (int)m_lights.size()))
+	{
+		m_lights[index] = light;
+		m_bLightsDirty = true;
+	}
+}
+
+/***********************************************************
+ *  GetLight()
+ *
+ *  This method is used for getting a light by its index.
+ ***********************************************************/
+const LightManager::LIGHT_SOURCE& LightManager::GetLight(int index) const
+{
+	return(m_lights[index]);
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of lights.
+ ***********************************************************/
+int LightManager::GetLightCount() const
+{
+	return((int)m_lights.size());
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the lights.
+ ***********************************************************/
+void LightManager::Clear()
+{
+	m_lights.clear();
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  UploadLights()
+ *
+ *  This method is used for packing the light properties
+ *  into the std430 layout of the light buffer.
+ ***********************************************************/
+void LightManager::UploadLights()
+{
+	const float DEGREES_TO_RADIANS = 0.01745329251994329577f;
+
+	std::vector<GPU_LIGHT> gpuLights(m_lights.size());
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		const LIGHT_SOURCE& light = m_lights[i];
+		gpuLights[i].position = glm::vec4(light.position, light.range);
+		gpuLights[i].direction = glm::vec4(light.direction, (float)light.type);
+		gpuLights[i].ambientColor = glm::vec4(light.ambientColor, light.focalStrength);
+		gpuLights[i].diffuseColor = glm::vec4(light.diffuseColor, light.specularIntensity);
+		gpuLights[i].specularColor = glm::vec4(light.specularColor, 0.0f);
+		gpuLights[i].spotCone = glm::vec4(
+			std::cos(light.innerConeDegrees * DEGREES_TO_RADIANS),
+			std::cos(light.outerConeDegrees * DEGREES_TO_RADIANS),
+			0.0f, 0.0f);
+	}
+
+	// an empty buffer cannot be bound, so keep at least one entry
+	if (gpuLights.empty())
+	{
+		gpuLights.resize(1);
+		gpuLights[0].position = glm::vec4(0.0f);
+	}
+
+	UploadBuffer(m_lightBuffer, LIGHT_BINDING_POINT, gpuLights.data(), gpuLights.size() * sizeof(GPU_LIGHT));
+	m_bLightsDirty = false;
+}
+
+/***********************************************************
+ *  BuildClusterBounds()
+ *
+ *  This method is used for building the view-space bounding
+ *  boxes of the clusters.  The near and far planes are read
+ *  back from the projection so that both the perspective and
+ *  the orthographic projections are supported, and the depth
+ *  is sliced exponentially so that clusters keep a similar
+ *  shape along the view direction.  False is returned when
+ *  the projection has no usable near and far planes.
+ ***********************************************************/
+bool LightManager::BuildClusterBounds(const glm::mat4& projection)
+{
+	float nearPlane = 0.0f;
+	float farPlane = 0.0f;
+
+	// perspective projections have -1 in the w row of column 2
+	if (projection[2][3] != 0.0f)
+	{
+		nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+		farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+	}
+	else
+	{
+		nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+		farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+	}
+
+	// exponential slices need a near plane in front of the eye
+	if ((nearPlane <= 0.0f) || (farPlane <= nearPlane))
+	{
+		return(false);
+	}
+	m_nearPlane = nearPlane;
+	m_farPlane = farPlane;
+	m_clusterProjection = projection;
+
+	// the view-space line through every tile corner, from the
+	// near plane to the far plane
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	const int cornersX = CLUSTER_COUNT_X + 1;
+	const int cornersY = CLUSTER_COUNT_Y + 1;
+	std::vector<glm::vec3> nearCorners(cornersX * cornersY);
+	std::vector<glm::vec3> farCorners(cornersX * cornersY);
+	for (int y = 0; y < cornersY; y++)
+	{
+		for (int x = 0; x < cornersX; x++)
+		{
+			float ndcX = -1.0f + (2.0f * x / CLUSTER_COUNT_X);
+			float ndcY = -1.0f + (2.0f * y / CLUSTER_COUNT_Y);
+			glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+			glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+			nearCorners[(y * cornersX) + x] = glm::vec3(nearPoint) / nearPoint.w;
+			farCorners[(y * cornersX) + x] = glm::vec3(farPoint) / farPoint.w;
+		}
+	}
+
+	m_clusterBounds.resize(CLUSTER_COUNT);
+	float depthRatio = m_farPlane / m_nearPlane;
+	for (int z = 0; z < CLUSTER_COUNT_Z; z++)
+	{
+		float sliceNear = m_nearPlane * std::pow(depthRatio, (float)z / CLUSTER_COUNT_Z);
+		float sliceFar = m_nearPlane * std::pow(depthRatio, (float)(z + 1) / CLUSTER_COUNT_Z);
+		float sliceDepths[2] = { sliceNear, sliceFar };
+
+		for (int y = 0; y < CLUSTER_COUNT_Y; y++)
+		{
+			for (int x = 0; x < CLUSTER_COUNT_X; x++)
+			{
+				CLUSTER_BOUNDS& bounds = m_clusterBounds[(((z * CLUSTER_COUNT_Y) + y) * CLUSTER_COUNT_X) + x];
+				bounds.minPoint = glm::vec3(1.0e30f);
+				bounds.maxPoint = glm::vec3(-1.0e30f);
+
+				for (int corner = 0; corner < 4; corner++)
+				{
+					int index = ((y + (corner / 2)) * cornersX) + x + (corner % 2);
+					glm::vec3 lineStart = nearCorners[index];
+					glm::vec3 lineDelta = farCorners[index] - lineStart;
+
+					// where the corner line crosses both slice planes
+					for (int plane = 0; plane < 2; plane++)
+					{
+						float t = (-sliceDepths[plane] - lineStart.z) / lineDelta.z;
+						glm::vec3 point = lineStart + (lineDelta * t);
+						bounds.minPoint = glm::min(bounds.minPoint, point);
+						bounds.maxPoint = glm::max(bounds.maxPoint, point);
+					}
+				}
+			}
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetDepthSlice()
+ *
+ *  This method is used for getting the depth slice of the
+ *  cluster grid that holds a positive view-space depth.
+ ***********************************************************/
+int LightManager::GetDepthSlice(float depth) const
+{
+	int slice = (int)std::floor(
+		std::log(depth / m_nearPlane) / std::log(m_farPlane / m_nearPlane) * CLUSTER_COUNT_Z);
+
+	if (slice < 0)
+	{
+		slice = 0;
+	}
+	if (slice >= CLUSTER_COUNT_Z)
+	{
+		slice = CLUSTER_COUNT_Z - 1;
+	}
+
+	return(slice);
+}
+
+/***********************************************************
+ *  UpdateClusters()
+ *
+ *  This method is used for assigning the lights to the
+ *  clusters for the current camera.  The range sphere of
+ *  every light is moved into view space, only the depth
+ *  slices it overlaps are visited, and it is added to each
+ *  cluster whose bounds it touches.  The per-cluster ranges
+ *  and the flattened light index list are then uploaded.
+ *  When the projection cannot be sliced, or a light has no
+ *  range, the light is added to every cluster instead, so
+ *  the buffers never keep the lists of an earlier frame.
+ ***********************************************************/
+void LightManager::UpdateClusters(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	int viewportWidth,
+	int viewportHeight)
+{
+	if (m_bLightsDirty)
+	{
+		UploadLights();
+	}
+
+	bool bClustered = true;
+	if ((m_clusterBounds.empty()) || (projection != m_clusterProjection))
+	{
+		bClustered = BuildClusterBounds(projection);
+	}
+
+	m_tileSize = glm::vec2(
+		(float)viewportWidth / CLUSTER_COUNT_X,
+		(float)viewportHeight / CLUSTER_COUNT_Y);
+
+	for (int i = 0; i < CLUSTER_COUNT; i++)
+	{
+		m_clusterLights[i].clear();
+	}
+
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		if ((bClustered == false) || (m_lights[i].range <= 0.0f))
+		{
+			for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+			{
+				m_clusterLights[cluster].push_back((uint32_t)i);
+			}
+			continue;
+		}
+
+		glm::vec3 center = glm::vec3(view * glm::vec4(m_lights[i].position, 1.0f));
+		float radius = m_lights[i].range;
+		float depth = -center.z;
+
+		// skip the lights that are outside of the depth range
+		if ((depth + radius < m_nearPlane) || (depth - radius > m_farPlane))
+		{
+			continue;
+		}
+
+		int firstSlice = GetDepthSlice(std::max(depth - radius, m_nearPlane));
+		int lastSlice = GetDepthSlice(std::min(depth + radius, m_farPlane));
+		float radiusSquared = radius * radius;
+
+		for (int z = firstSlice; z <= lastSlice; z++)
+		{
+			for (int cluster = z * CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+				cluster < (z + 1) * CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+				cluster++)
+			{
+				// squared distance from the sphere center to the box
+				const CLUSTER_BOUNDS& bounds = m_clusterBounds[cluster];
+				glm::vec3 closest = glm::max(bounds.minPoint, glm::min(center, bounds.maxPoint));
+				glm::vec3 offset = closest - center;
+				if (glm::dot(offset, offset) <= radiusSquared)
+				{
+					m_clusterLights[cluster].push_back((uint32_t)i);
+				}
+			}
+		}
+	}
+
+	// flatten the cluster lists into one index list
+	m_lightIndices.clear();
+	for (int i = 0; i < CLUSTER_COUNT; i++)
+	{
+		m_clusterRanges[(i * 2) + 0] = (uint32_t)m_lightIndices.size();
+		m_clusterRanges[(i * 2) + 1] = (uint32_t)m_clusterLights[i].size();
+		m_lightIndices.insert(m_lightIndices.end(), m_clusterLights[i].begin(), m_clusterLights[i].end());
+	}
+
+	UploadBuffer(m_clusterBuffer, CLUSTER_BINDING_POINT, m_clusterRanges.data(), m_clusterRanges.size() * sizeof(uint32_t));
+
+	// an empty buffer cannot be bound, so keep at least one entry
+	uint32_t emptyIndex = 0;
+	if (m_lightIndices.empty())
+	{
+		UploadBuffer(m_indexBuffer, INDEX_BINDING_POINT, &emptyIndex, sizeof(uint32_t));
+	}
+	else
+	{
+		UploadBuffer(m_indexBuffer, INDEX_BINDING_POINT, m_lightIndices.data(), m_lightIndices.size() * sizeof(uint32_t));
+	}
+}
+
+/***********************************************************
+ *  UploadBuffer()
+ *
+ *  This method is used for replacing the contents of a
+ *  shader storage buffer and binding it to its binding
+ *  point.  The old storage is orphaned so the upload does
+ *  not wait on draws that still read the previous frame.
+ ***********************************************************/
+void LightManager::UploadBuffer(GLuint& buffer, GLuint bindingPoint, const void* data, size_t size)
+{
+	if (buffer == 0)
+	{
+		glGenBuffers(1, &buffer);
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, buffer);
+}
+
+/***********************************************************
+ *  GetClusterTileSize()
+ *
+ *  This method is used for getting the size in pixels of
+ *  the screen tile covered by one column of clusters.
+ ***********************************************************/
+glm::vec2 LightManager::GetClusterTileSize() const
+{
+	return(m_tileSize);
+}
+
+/***********************************************************
+ *  GetClusterDepthParams()
+ *
+ *  This method is used for getting the scale and bias that
+ *  turn the log of a view-space depth into a depth slice,
+ *  slice = floor(log(depth) * scale - bias).
+ ***********************************************************/
+glm::vec2 LightManager::GetClusterDepthParams() const
+{
+	float logRatio = std::log(m_farPlane / m_nearPlane);
+
+	return(glm::vec2(
+		CLUSTER_COUNT_Z / logRatio,
+		CLUSTER_COUNT_Z * std::log(m_nearPlane) / logRatio));
+}
+
+/***********************************************************
+ *  GetAssignedLightCount()
+ *
+ *  This method is used for getting the number of light and
+ *  cluster pairs found by the last cluster update.
+ ***********************************************************/
+int LightManager::GetAssignedLightCount() const
+{
+	return((int)m_lightIndices.size());
+}
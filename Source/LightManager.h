@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.h
+// ============
+// store any number of point and spot lights in shader storage buffers and
+// assign them to view-space froxel clusters for clustered forward shading
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  LightManager
+ *
+ *  This class holds the light sources of the scene.  Every
+ *  frame the lights are assigned to the clusters of a grid
+ *  that slices the view frustum in screen tiles and
+ *  exponential depth slices, and the per-cluster light lists
+ *  are uploaded so that the fragment shader only evaluates
+ *  the lights whose range reaches the fragment's cluster.
+ ***********************************************************/
+class LightManager
+{
+public:
+	// constructor
+	LightManager();
+	// destructor
+	~LightManager();
+
+	// kinds of light source
+	enum LIGHT_TYPE
+	{
+		LIGHT_POINT = 0,
+		LIGHT_SPOT
+	};
+
+	// properties of a light source
+	struct LIGHT_SOURCE
+	{
+		int type;
+		glm::vec3 position;
+		glm::vec3 direction;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+		// distance at which the light fades out completely, or
+		// 0 for a light that reaches everywhere with no falloff
+		float range;
+		// spot cone angles in degrees
+		float innerConeDegrees;
+		float outerConeDegrees;
+	};
+
+	// size of the cluster grid
+	static const int CLUSTER_COUNT_X = 16;
+	static const int CLUSTER_COUNT_Y = 9;
+	static const int CLUSTER_COUNT_Z = 24;
+	static const int CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+
+	// shader storage buffer binding points used by the shaders
+	static const GLuint LIGHT_BINDING_POINT = 1;
+	static const GLuint CLUSTER_BINDING_POINT = 2;
+	static const GLuint INDEX_BINDING_POINT = 3;
+
+	// add a light that shines in every direction
+	int AddPointLight(
+		glm::vec3 position,
+		glm::vec3 ambientColor,
+		glm::vec3 diffuseColor,
+		glm::vec3 specularColor,
+		float focalStrength,
+		float specularIntensity,
+		float range);
+	// add a light that shines inside a cone
+	int AddSpotLight(
+		glm::vec3 position,
+		glm::vec3 direction,
+		glm::vec3 ambientColor,
+		glm::vec3 diffuseColor,
+		glm::vec3 specularColor,
+		float focalStrength,
+		float specularIntensity,
+		float range,
+		float innerConeDegrees,
+		float outerConeDegrees);
+	// add a light with all of its properties
+	int AddLight(const LIGHT_SOURCE& light);
+	// replace the properties of a light
+	void SetLight(int index, const LIGHT_SOURCE& light);
+	// get a light by index
+	const LIGHT_SOURCE& GetLight(int index) const;
+	int GetLightCount() const;
+	// remove all of the lights
+	void Clear();
+
+	// assign the lights to the clusters and upload the buffers
+	void UpdateClusters(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		int viewportWidth,
+		int viewportHeight);
+
+	// values the shader needs to find the cluster of a fragment
+	glm::vec2 GetClusterTileSize() const;
+	glm::vec2 GetClusterDepthParams() const;
+	// number of light references in the last cluster update
+	int GetAssignedLightCount() const;
+
+private:
+	// light source in the std430 layout of the shader buffer
+	struct GPU_LIGHT
+	{
+		glm::vec4 position;			// xyz position, w range
+		glm::vec4 direction;		// xyz direction, w type
+		glm::vec4 ambientColor;		// w focal strength
+		glm::vec4 diffuseColor;		// w specular intensity
+		glm::vec4 specularColor;
+		glm::vec4 spotCone;			// x cos inner, y cos outer
+	};
+
+	// view-space bounds of one cluster
+	struct CLUSTER_BOUNDS
+	{
+		glm::vec3 minPoint;
+		glm::vec3 maxPoint;
+	};
+
+	// light sources of the scene
+	std::vector<LIGHT_SOURCE> m_lights;
+	// true when the lights changed since the last upload
+	bool m_bLightsDirty;
+
+	// cluster bounds for the current projection
+	std::vector<CLUSTER_BOUNDS> m_clusterBounds;
+	glm::mat4 m_clusterProjection;
+	float m_nearPlane;
+	float m_farPlane;
+	glm::vec2 m_tileSize;
+
+	// per-cluster first index and count into m_lightIndices
+	std::vector<uint32_t> m_clusterRanges;
+	std::vector<uint32_t> m_lightIndices;
+	// temporary per-cluster light lists
+	std::vector<std::vector<uint32_t> > m_clusterLights;
+
+	// OpenGL shader storage buffers
+	GLuint m_lightBuffer;
+	GLuint m_clusterBuffer;
+	GLuint m_indexBuffer;
+
+	// upload the light properties
+	void UploadLights();
+	// build the view-space bounds of every cluster
+	bool BuildClusterBounds(const glm::mat4& projection);
+	// depth slice that holds a positive view-space depth
+	int GetDepthSlice(float depth) const;
+	// upload a vector into a shader storage buffer
+	void UploadBuffer(GLuint& buffer, GLuint bindingPoint, const void* data, size_t size);
+};
@@ -1,5 +1,9 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstdio>           // sscanf
+#include <cstring>          // command line flags
+#include <chrono>           // headless frame timing
+#include <string>
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +17,10 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "HeadlessContext.h"
+#include "FrameProfiler.h"
+#include "FixedTimestep.h"
 
 // Namespace for declaring global variables
 namespace
@@ -27,14 +35,52 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// active uniforms of the loaded shader program, resolved once
+	ShaderUniforms* g_ShaderUniforms = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+
+	// options read from the command line - rendering without a
+	// window is selected with --headless
+	struct COMMAND_LINE_OPTIONS
+	{
+		bool bHeadless;
+		int width;
+		int height;
+		int frameCount;
+		std::string outputFilename;
+		// Chrome trace written by the frame profiler, which
+		// only runs when this is set
+		std::string profileFilename;
+		// input log the camera input is recorded to, or that
+		// drives the camera in place of the live input
+		std::string recordFilename;
+		std::string replayFilename;
+	};
+	// offscreen context used in place of the GLFW window
+	HeadlessContext* g_HeadlessContext = nullptr;
+
+	// the camera is updated at a fixed rate, and the frames
+	// rendered between updates blend the last two of them
+	const double UPDATE_STEP_SECONDS = 1.0 / 60.0;
+	// most updates run before one frame - after a stall the
+	// rest of the time is dropped rather than caught up
+	const int MAX_UPDATE_STEPS = 5;
+
+	// the shaders are GLSL 4.40, and the draws use base
+	// instances and indirect multi-draws from OpenGL 4.2/4.3
+	const int REQUIRED_GL_MAJOR = 4;
+	const int REQUIRED_GL_MINOR = 4;
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
 bool InitializeGLFW();
 bool InitializeGLEW();
+bool CheckOpenGLVersion();
+bool ParseCommandLine(int argc, char* argv[], COMMAND_LINE_OPTIONS& options);
+bool InitializeHeadless(const COMMAND_LINE_OPTIONS& options);
+void RenderHeadlessFrames(const COMMAND_LINE_OPTIONS& options);
 
 
 /***********************************************************
@@ -45,8 +91,23 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	COMMAND_LINE_OPTIONS options;
+	if (ParseCommandLine(argc, argv, options) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// a headless run needs no window system, so GLFW is
+	// never initialized
+	if (options.bHeadless)
+	{
+		if (InitializeHeadless(options) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+	}
 	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
+	else if (InitializeGLFW() == false)
 	{
 		return(EXIT_FAILURE);
 	}
@@ -57,50 +118,156 @@ int main(int argc, char* argv[])
 	g_ViewManager = new ViewManager(
 		g_ShaderManager);
 
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
+	if (options.bHeadless)
 	{
-		return(EXIT_FAILURE);
+		// render into the framebuffer of the headless context
+		g_ViewManager->InitializeOffscreenView(options.width, options.height);
+	}
+	else
+	{
+		// try to create the main display window
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+		// if GLEW fails initialization, then terminate the application
+		if (InitializeGLEW() == false)
+		{
+			return(EXIT_FAILURE);
+		}
 	}
 
-	// load the shader code from the external GLSL files
+	// load the shader code from the project GLSL files - these
+	// extend the Utilities shaders with per-instance attributes
 	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
+		"shaders/vertexShader.glsl",
+		"shaders/fragmentShader.glsl");
 	g_ShaderManager->use();
 
+	// reflect the active uniforms once so that the managers
+	// can set them through handles instead of by name
+	g_ShaderUniforms = new ShaderUniforms();
+	g_ShaderUniforms->Reflect(g_ShaderManager->m_programID);
+	g_ViewManager->SetShaderUniforms(g_ShaderUniforms);
+
 	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager = new SceneManager(g_ShaderManager, g_ShaderUniforms);
 	g_SceneManager->PrepareScene();
-	g_SceneManager->LoadSceneTextures();	// <---AH: ADD THIS LINE (Textures)
+	if (options.bHeadless)
+	{
+		// the window's viewport is read once by the scene, but
+		// the framebuffer size is already known
+		g_SceneManager->SetViewportSize(options.width, options.height);
+	}
+
+	// time the frames once the scene has been loaded
+#if FRAME_PROFILER_ENABLED
+	if (!options.profileFilename.empty())
+	{
+		FrameProfiler::Initialize();
+	}
+#endif
+
+	// a replayed input log drives the camera for as many
+	// updates as were recorded, headless or in the window
+	if (!options.replayFilename.empty())
+	{
+		if (g_ViewManager->StartInputReplay(options.replayFilename) == false)
+		{
+			std::cout << "Could not read the input log " << options.replayFilename << std::endl;
+			return(EXIT_FAILURE);
+		}
+		options.frameCount = g_ViewManager->GetInputReplayFrameCount();
+		std::cout << "INFO: Replaying " << options.frameCount << " frames of input from "
+			<< options.replayFilename << std::endl;
+	}
+	else if (!options.recordFilename.empty())
+	{
+		g_ViewManager->StartInputRecording();
+	}
+
+	// a headless run renders its frames and exits
+	if (options.bHeadless)
+	{
+		RenderHeadlessFrames(options);
+	}
+
+	// the clock starts once the scene has loaded, so the load
+	// time is not caught up
+	FixedTimestep timestep(UPDATE_STEP_SECONDS, MAX_UPDATE_STEPS);
 
 	// loop will keep running until the application is closed 
 	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
+	while ((NULL != g_Window) && !glfwWindowShouldClose(g_Window) &&
+		!g_ViewManager->IsInputReplayFinished())
 	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
+		PROFILE_FRAME_BEGIN();
+
+		// run the updates the clock has moved past - a replay
+		// takes one recorded update for each of them, so it
+		// plays back at the recorded speed
+		int updateSteps = timestep.Advance();
+		float interpolation = timestep.GetInterpolation();
 
 		// Clear the frame and z buffers
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+		PROFILE_SECTION_BEGIN(SECTION_PREPARE_VIEW);
+		for (int step = 0; step < updateSteps; step++)
+		{
+			g_ViewManager->UpdateView((float)timestep.GetStepSeconds());
+		}
+		g_ViewManager->PrepareSceneView(interpolation);
+		g_SceneManager->SetViewTransform(
+			g_ViewManager->GetViewMatrix(),
+			g_ViewManager->GetProjectionMatrix());
+		PROFILE_SECTION_END(SECTION_PREPARE_VIEW);
 
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
 		// Flips the the back buffer with the front buffer every frame.
+		PROFILE_SECTION_BEGIN(SECTION_SWAP_BUFFERS);
 		glfwSwapBuffers(g_Window);
+		PROFILE_SECTION_END(SECTION_SWAP_BUFFERS);
+
+		PROFILE_FRAME_END();
 
 		// query the latest GLFW events
 		glfwPollEvents();
 	}
 
+	if (timestep.GetDroppedSteps() > 0)
+	{
+		std::cout << "INFO: Dropped " << timestep.GetDroppedSteps()
+			<< " updates after slow frames in " << timestep.GetElapsedSeconds() << " seconds" << std::endl;
+	}
+
+	if (!options.recordFilename.empty() && options.replayFilename.empty())
+	{
+		if (g_ViewManager->SaveInputRecording(options.recordFilename))
+		{
+			std::cout << "INFO: Saved the input log to " << options.recordFilename << std::endl;
+		}
+		else
+		{
+			std::cout << "WARNING: Could not write the input log " << options.recordFilename << std::endl;
+		}
+	}
+
+	// write the frame timings while the context is still current
+#if FRAME_PROFILER_ENABLED
+	if (FrameProfiler::IsEnabled())
+	{
+		FrameProfiler::Shutdown();
+		FrameProfiler::WriteHistograms(std::cout);
+		if (FrameProfiler::WriteChromeTrace(options.profileFilename))
+		{
+			std::cout << "INFO: Saved the frame trace to " << options.profileFilename << std::endl;
+		}
+	}
+#endif
+
 	// clear the allocated manager objects from memory
 	if (NULL != g_SceneManager)
 	{
@@ -112,11 +279,23 @@ int main(int argc, char* argv[])
 		delete g_ViewManager;
 		g_ViewManager = NULL;
 	}
+	if (NULL != g_ShaderUniforms)
+	{
+		delete g_ShaderUniforms;
+		g_ShaderUniforms = NULL;
+	}
 	if (NULL != g_ShaderManager)
 	{
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
+	// the context goes last, since the managers free their
+	// OpenGL objects while it is still current
+	if (NULL != g_HeadlessContext)
+	{
+		delete g_HeadlessContext;
+		g_HeadlessContext = NULL;
+	}
 
 	// Terminates the program successfully
 	exit(EXIT_SUCCESS); 
@@ -133,17 +312,13 @@ bool InitializeGLFW()
 	// --------------------------------------
 	glfwInit();
 
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	// set the version of OpenGL and profile to use - this is
+	// the lowest version the shaders run on, and drivers give
+	// the newest compatible one.  macOS stops at OpenGL 4.1,
+	// so creating the window fails there
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, REQUIRED_GL_MAJOR);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, REQUIRED_GL_MINOR);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
 	// GLFW: end -------------------------------
 
 	return(true);
@@ -173,5 +348,225 @@ bool InitializeGLEW()
 	std::cout << "INFO: OpenGL Successfully Initialized\n";
 	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
 
+	return(CheckOpenGLVersion());
+}
+
+/***********************************************************
+ *	CheckOpenGLVersion()
+ *
+ *  This function is used to check that the current context
+ *  has the OpenGL version the shaders and draws need, so an
+ *  older one fails here rather than when the shaders are
+ *  compiled.
+ ***********************************************************/
+bool CheckOpenGLVersion()
+{
+	GLint majorVersion = 0;
+	GLint minorVersion = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+	glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+
+	if ((majorVersion < REQUIRED_GL_MAJOR) ||
+		((majorVersion == REQUIRED_GL_MAJOR) && (minorVersion < REQUIRED_GL_MINOR)))
+	{
+		std::cout << "Failed to initialize OpenGL - version " << REQUIRED_GL_MAJOR << "." << REQUIRED_GL_MINOR
+			<< " is required, but the context is " << majorVersion << "." << minorVersion << std::endl;
+		return(false);
+	}
+
 	return(true);
-}
\ No newline at end of file
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the command line flags.
+ *  --headless renders without a window, --size WIDTHxHEIGHT
+ *  sets the framebuffer size, --frames the number of frames
+ *  to render and --output writes the last frame to a PPM
+ *  image.  --profile times the sections of every frame and
+ *  writes them to a Chrome trace.  --record saves the camera
+ *  input to a log, and --replay drives the camera from one,
+ *  rendering every recorded frame.
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[], COMMAND_LINE_OPTIONS& options)
+{
+	options.bHeadless = false;
+	options.width = 1000;
+	options.height = 800;
+	options.frameCount = 100;
+	options.outputFilename.clear();
+	options.profileFilename.clear();
+	options.recordFilename.clear();
+	options.replayFilename.clear();
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool bHasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			options.bHeadless = true;
+		}
+		else if ((strcmp(argv[i], "--size") == 0) && bHasValue)
+		{
+			i++;
+			if ((sscanf(argv[i], "%dx%d", &options.width, &options.height) != 2) ||
+				(options.width <= 0) || (options.height <= 0))
+			{
+				std::cout << "Invalid size:" << argv[i] << " - expected WIDTHxHEIGHT" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && bHasValue)
+		{
+			i++;
+			options.frameCount = atoi(argv[i]);
+			if (options.frameCount <= 0)
+			{
+				std::cout << "Invalid frame count:" << argv[i] << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--output") == 0) && bHasValue)
+		{
+			i++;
+			options.outputFilename = argv[i];
+		}
+		else if ((strcmp(argv[i], "--profile") == 0) && bHasValue)
+		{
+			i++;
+			options.profileFilename = argv[i];
+#if !FRAME_PROFILER_ENABLED
+			std::cout << "WARNING: The frame profiler was compiled out, --profile is ignored" << std::endl;
+#endif
+		}
+		else if ((strcmp(argv[i], "--record") == 0) && bHasValue)
+		{
+			i++;
+			options.recordFilename = argv[i];
+		}
+		else if ((strcmp(argv[i], "--replay") == 0) && bHasValue)
+		{
+			i++;
+			options.replayFilename = argv[i];
+		}
+		else
+		{
+			std::cout << "Unknown option:" << argv[i] << std::endl;
+			std::cout << "Usage: " << argv[0]
+				<< " [--profile trace.json] [--record input.log | --replay input.log]"
+				<< " [--headless [--size WIDTHxHEIGHT] [--frames N] [--output image.ppm]]" << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeHeadless()
+ *
+ *  This function is used to create the headless context,
+ *  initialize GLEW for it and create the framebuffer the
+ *  frames are rendered into.
+ ***********************************************************/
+bool InitializeHeadless(const COMMAND_LINE_OPTIONS& options)
+{
+	g_HeadlessContext = new HeadlessContext();
+	if (g_HeadlessContext->Create() == false)
+	{
+		return(false);
+	}
+
+	// glewInit() looks for GLX on Linux, which a context with
+	// no display server does not have, so only the OpenGL
+	// entry points are loaded
+	glewExperimental = GL_TRUE;
+	GLenum GLEWInitResult = glewContextInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return(false);
+	}
+
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n";
+	std::cout << "INFO: OpenGL Renderer: " << glGetString(GL_RENDERER) << "\n" << std::endl;
+
+	if (CheckOpenGLVersion() == false)
+	{
+		return(false);
+	}
+
+	return(g_HeadlessContext->CreateFramebuffer(options.width, options.height));
+}
+
+/***********************************************************
+ *	RenderHeadlessFrames()
+ *
+ *  This function is used to render the requested number of
+ *  frames into the headless framebuffer, through the same
+ *  view and scene calls as the display loop, and to report
+ *  the frame times.
+ ***********************************************************/
+void RenderHeadlessFrames(const COMMAND_LINE_OPTIONS& options)
+{
+	double totalTime = 0.0;
+	double minTime = 0.0;
+	double maxTime = 0.0;
+
+	for (int frame = 0; frame < options.frameCount; frame++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		PROFILE_FRAME_BEGIN();
+
+		// Clear the frame and z buffers
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// convert from 3D object space to 2D view - with no
+		// clock to follow, every frame is one whole update
+		PROFILE_SECTION_BEGIN(SECTION_PREPARE_VIEW);
+		g_ViewManager->UpdateView((float)UPDATE_STEP_SECONDS);
+		g_ViewManager->PrepareSceneView(1.0f);
+		g_SceneManager->SetViewTransform(
+			g_ViewManager->GetViewMatrix(),
+			g_ViewManager->GetProjectionMatrix());
+		PROFILE_SECTION_END(SECTION_PREPARE_VIEW);
+
+		// refresh the 3D scene
+		g_SceneManager->RenderScene();
+
+		// wait for the frame in place of swapping the buffers
+		PROFILE_SECTION_BEGIN(SECTION_SWAP_BUFFERS);
+		g_HeadlessContext->FinishFrame();
+		PROFILE_SECTION_END(SECTION_SWAP_BUFFERS);
+
+		PROFILE_FRAME_END();
+
+		double frameTime = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+		totalTime += frameTime;
+		if ((frame == 0) || (frameTime < minTime))
+		{
+			minTime = frameTime;
+		}
+		if ((frame == 0) || (frameTime > maxTime))
+		{
+			maxTime = frameTime;
+		}
+	}
+
+	std::cout << "INFO: Rendered " << options.frameCount << " frames at "
+		<< options.width << "x" << options.height
+		<< " - average " << (totalTime / options.frameCount) << " ms, min "
+		<< minTime << " ms, max " << maxTime << " ms" << std::endl;
+
+	if (!options.outputFilename.empty())
+	{
+		if (g_HeadlessContext->SaveColorBuffer(options.outputFilename))
+		{
+			std::cout << "INFO: Saved the last frame to " << options.outputFilename << std::endl;
+		}
+	}
+}
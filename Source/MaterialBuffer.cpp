@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.cpp
+// ============
+// hold every object material in one std140 uniform buffer so that draws
+// only need to select a material by its integer index
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MaterialBuffer.h"
+
+#include <iostream>
+#include <vector>
+
+// the array stride of the block must match the C++ struct
+static_assert(sizeof(MaterialBuffer::GPU_MATERIAL) == 48, "GPU_MATERIAL must match the std140 layout");
+
+/***********************************************************
+ *  MaterialBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MaterialBuffer::MaterialBuffer()
+{
+	m_uniformBuffer = 0;
+	m_count = 0;
+}
+
+/***********************************************************
+ *  ~MaterialBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MaterialBuffer::~MaterialBuffer()
+{
+	if (m_uniformBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_uniformBuffer);
+		m_uniformBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for packing the passed in materials
+ *  into the uniform buffer.  The buffer always holds the
+ *  whole array declared in the shaders, and the entries past
+ *  the uploaded materials are left zeroed.
+ ***********************************************************/
+void MaterialBuffer::Upload(const GPU_MATERIAL* materials, int count)
+{
+	if (count > MAX_MATERIALS)
+	{
+		std::cout << "INFO: Only the first " << MAX_MATERIALS << " of "
+			<< count << " materials fit in the material buffer" << std::endl;
+		count = MAX_MATERIALS;
+	}
+
+	std::vector<GPU_MATERIAL> table(MAX_MATERIALS);
+	for (int i = 0; i < MAX_MATERIALS; i++)
+	{
+		table[i].ambientColor = glm::vec3(0.0f);
+		table[i].ambientStrength = 0.0f;
+		table[i].diffuseColor = glm::vec3(0.0f);
+		table[i].shininess = 0.0f;
+		table[i].specularColor = glm::vec3(0.0f);
+		table[i].padding = 0.0f;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		table[i] = materials[i];
+	}
+
+	if (m_uniformBuffer == 0)
+	{
+		glGenBuffers(1, &m_uniformBuffer);
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_uniformBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, table.size() * sizeof(GPU_MATERIAL), table.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, m_uniformBuffer);
+
+	m_count = count;
+}
+
+/***********************************************************
+ *  BindToProgram()
+ *
+ *  This method is used for connecting the named uniform
+ *  block of a program to the binding point of the buffer.
+ *  The binding is set here instead of with a layout binding
+ *  qualifier, so the point is chosen in one place and the
+ *  shaders do not have to repeat it.
+ ***********************************************************/
+bool MaterialBuffer::BindToProgram(GLuint programID, const char* blockName)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(programID, blockName);
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		std::cout << "INFO: Uniform block " << blockName << " was not found in the shader program" << std::endl;
+		return(false);
+	}
+
+	glUniformBlockBinding(programID, blockIndex, BINDING_POINT);
+	if (m_uniformBuffer != 0)
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, m_uniformBuffer);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of materials
+ *  in the buffer.
+ ***********************************************************/
+int MaterialBuffer::GetCount() const
+{
+	return(m_count);
+}
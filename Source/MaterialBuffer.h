@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.h
+// ============
+// hold every object material in one std140 uniform buffer so that draws
+// only need to select a material by its integer index
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  MaterialBuffer
+ *
+ *  This class owns the uniform buffer that backs the
+ *  MaterialBlock declared in the shaders.  The material
+ *  table is packed and uploaded once at load time, and the
+ *  shaders then index it with the material index of the
+ *  draw or instance.
+ ***********************************************************/
+class MaterialBuffer
+{
+public:
+	// constructor
+	MaterialBuffer();
+	// destructor
+	~MaterialBuffer();
+
+	// one material in the std140 layout of the shader block -
+	// each vec3 is followed by a float to fill its 16 bytes
+	struct GPU_MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		float shininess;
+		glm::vec3 specularColor;
+		float padding;
+	};
+
+	// size of the material array declared in the shaders
+	static const int MAX_MATERIALS = 64;
+	// uniform buffer binding point used for the block
+	static const GLuint BINDING_POINT = 0;
+
+	// pack the passed in materials into the uniform buffer
+	void Upload(const GPU_MATERIAL* materials, int count);
+	// connect the named uniform block of a program to the buffer
+	bool BindToProgram(GLuint programID, const char* blockName);
+	// number of materials in the buffer
+	int GetCount() const;
+
+private:
+	// uniform buffer holding MAX_MATERIALS materials
+	GLuint m_uniformBuffer;
+	// number of materials uploaded
+	int m_count;
+};
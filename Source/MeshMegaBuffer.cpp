@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshmegabuffer.cpp
+// ============
+// pack every basic shape into one shared vertex and index buffer and draw
+// the whole scene with a few multi-draw indirect calls
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshMegaBuffer.h"
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// the array stride of the shader struct must match the C++ struct
+static_assert(sizeof(MeshMegaBuffer::GPU_DRAW_DATA) == 112, "GPU_DRAW_DATA must match the std430 layout");
+static_assert(sizeof(MeshMegaBuffer::DRAW_COMMAND) == 20, "DRAW_COMMAND must match the indirect command layout");
+
+// declaration of the global variables and defines
+namespace
+{
+	// smallest number of draws covered by the identity buffer
+	const int MIN_DRAW_CAPACITY = 256;
+}
+
+/***********************************************************
+ *  MeshMegaBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshMegaBuffer::MeshMegaBuffer()
+{
+	for (int i = 0; i < MESH_TYPE_COUNT; i++)
+	{
+		for (int lod = 0; lod < ShapeGeometry::MAX_LOD_COUNT; lod++)
+		{
+			m_ranges[i][lod].firstIndex = 0;
+			m_ranges[i][lod].indexCount = 0;
+			m_ranges[i][lod].baseVertex = 0;
+			m_ranges[i][lod].bLoaded = false;
+		}
+	}
+	m_vertexArray = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_drawIndexBuffer = 0;
+	m_drawBuffer = 0;
+	m_commandBuffer = 0;
+	m_drawCapacity = 0;
+	m_bLoaded = false;
+	m_pStateCache = NULL;
+}
+
+/***********************************************************
+ *  ~MeshMegaBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshMegaBuffer::~MeshMegaBuffer()
+{
+	if (m_vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+
+	GLuint buffers[5] = { m_vertexBuffer, m_indexBuffer, m_drawIndexBuffer, m_drawBuffer, m_commandBuffer };
+	for (int i = 0; i < 5; i++)
+	{
+		if (buffers[i] != 0)
+		{
+			glDeleteBuffers(1, &buffers[i]);
+		}
+	}
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_drawIndexBuffer = 0;
+	m_drawBuffer = 0;
+	m_commandBuffer = 0;
+	m_pStateCache = NULL;
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking that the context can
+ *  draw from indirect commands and read shader storage
+ *  buffers, which are core in OpenGL 4.3.
+ ***********************************************************/
+bool MeshMegaBuffer::IsSupported()
+{
+	if (GLEW_VERSION_4_3)
+	{
+		return(true);
+	}
+
+	return((GLEW_ARB_multi_draw_indirect != GL_FALSE) && (GLEW_ARB_shader_storage_buffer_object != GL_FALSE));
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for building every detail level of
+ *  the basic shapes, appending them into the shared vertex
+ *  and index buffers, and creating the vertex array object
+ *  that reads them.  The indices of each mesh stay relative
+ *  to its own first vertex, which the base vertex of the
+ *  draw adds back.
+ ***********************************************************/
+bool MeshMegaBuffer::LoadMeshes()
+{
+	if (m_bLoaded)
+	{
+		return(true);
+	}
+
+	std::vector<ShapeGeometry::VERTEX> vertices;
+	std::vector<uint32_t> indices;
+
+	for (int meshType = 0; meshType < MESH_TYPE_COUNT; meshType++)
+	{
+		for (int lod = 0; lod < ShapeGeometry::GetLodCount(meshType); lod++)
+		{
+			ShapeGeometry::GEOMETRY geometry;
+			if (ShapeGeometry::BuildMeshLod(meshType, lod, geometry) == false)
+			{
+				continue;
+			}
+
+			MESH_RANGE& range = m_ranges[meshType][lod];
+			range.firstIndex = (GLuint)indices.size();
+			range.indexCount = (GLuint)geometry.indices.size();
+			range.baseVertex = (GLint)vertices.size();
+			range.bLoaded = true;
+
+			vertices.insert(vertices.end(), geometry.vertices.begin(), geometry.vertices.end());
+			indices.insert(indices.end(), geometry.indices.begin(), geometry.indices.end());
+		}
+	}
+
+	if (indices.size() == 0)
+	{
+		return(false);
+	}
+
+	const GLsizei vertexStride = sizeof(ShapeGeometry::VERTEX);
+
+	glGenVertexArrays(1, &m_vertexArray);
+	glBindVertexArray(m_vertexArray);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ShapeGeometry::VERTEX), vertices.data(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, normal));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(ShapeGeometry::VERTEX, textureCoordinate));
+	glEnableVertexAttribArray(2);
+
+	// draw index - advanced once per instance, and offset by
+	// the base instance of each indirect command
+	glGenBuffers(1, &m_drawIndexBuffer);
+	ReserveDrawIndices(MIN_DRAW_CAPACITY);
+	glBindBuffer(GL_ARRAY_BUFFER, m_drawIndexBuffer);
+	glVertexAttribIPointer(DRAW_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+	glEnableVertexAttribArray(DRAW_INDEX_ATTRIBUTE);
+	glVertexAttribDivisor(DRAW_INDEX_ATTRIBUTE, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	if (NULL != m_pStateCache)
+	{
+		m_pStateCache->InvalidateVertexArray();
+	}
+
+	glGenBuffers(1, &m_drawBuffer);
+	glGenBuffers(1, &m_commandBuffer);
+
+	std::cout << "INFO: Mesh mega-buffer holds " << vertices.size() << " vertices and "
+		<< indices.size() << " indices" << std::endl;
+
+	m_bLoaded = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsLoaded()
+ *
+ *  This method is used for checking whether the shared
+ *  buffers have been built.
+ ***********************************************************/
+bool MeshMegaBuffer::IsLoaded() const
+{
+	return(m_bLoaded);
+}
+
+/***********************************************************
+ *  GetMeshRange()
+ *
+ *  This method is used for getting the index range and base
+ *  vertex of a mesh detail level.  A level that was not
+ *  loaded gives the range of the full detail mesh.
+ ***********************************************************/
+const MeshMegaBuffer::MESH_RANGE& MeshMegaBuffer::GetMeshRange(int meshType, int lod) const
+{
+	if ((meshType < 0) || (meshType >= MESH_TYPE_COUNT))
+	{
+		meshType = 0;
+	}
+	if ((lod < 0) || (lod >= ShapeGeometry::MAX_LOD_COUNT) || (m_ranges[meshType][lod].bLoaded == false))
+	{
+		lod = 0;
+	}
+
+	return(m_ranges[meshType][lod]);
+}
+
+/***********************************************************
+ *  SetStateCache()
+ *
+ *  This method is used for setting a state cache that the
+ *  vertex array is bound through while drawing.
+ ***********************************************************/
+void MeshMegaBuffer::SetStateCache(RenderStateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+}
+
+/***********************************************************
+ *  ReserveDrawIndices()
+ *
+ *  This method is used for growing the identity buffer that
+ *  the draw index attribute reads, so that it has an entry
+ *  for every draw of the frame.
+ ***********************************************************/
+void MeshMegaBuffer::ReserveDrawIndices(int count)
+{
+	if ((m_drawIndexBuffer == 0) || (count <= m_drawCapacity))
+	{
+		return;
+	}
+
+	int capacity = (m_drawCapacity > 0) ? m_drawCapacity : MIN_DRAW_CAPACITY;
+	while (capacity < count)
+	{
+		capacity *= 2;
+	}
+
+	std::vector<GLuint> drawIndices(capacity);
+	for (int i = 0; i < capacity; i++)
+	{
+		drawIndices[i] = (GLuint)i;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_drawIndexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GLuint), drawIndices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_drawCapacity = capacity;
+}
+
+/***********************************************************
+ *  UploadDraws()
+ *
+ *  This method is used for uploading the per-draw values of
+ *  the frame into the shader storage buffer.  The old
+ *  storage is orphaned so that the upload does not wait on
+ *  the draws of the previous frame.
+ ***********************************************************/
+void MeshMegaBuffer::UploadDraws(const GPU_DRAW_DATA* draws, int count)
+{
+	if ((m_bLoaded == false) || (count <= 0))
+	{
+		return;
+	}
+
+	ReserveDrawIndices(count);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(GPU_DRAW_DATA), draws, GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_BINDING_POINT, m_drawBuffer);
+}
+
+/***********************************************************
+ *  UploadCommands()
+ *
+ *  This method is used for uploading the indirect commands
+ *  of the frame.  The command buffer is left bound, since
+ *  the indirect draws read it from the binding point.
+ ***********************************************************/
+void MeshMegaBuffer::UploadCommands(const DRAW_COMMAND* commands, int count)
+{
+	if ((m_bLoaded == false) || (count <= 0))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, count * sizeof(DRAW_COMMAND), commands, GL_STREAM_DRAW);
+}
+
+/***********************************************************
+ *  MultiDraw()
+ *
+ *  This method is used for drawing count of the uploaded
+ *  commands, starting at firstCommand, with one call.
+ ***********************************************************/
+void MeshMegaBuffer::MultiDraw(int firstCommand, int count)
+{
+	if ((m_bLoaded == false) || (count <= 0))
+	{
+		return;
+	}
+
+	if (NULL != m_pStateCache)
+	{
+		m_pStateCache->BindVertexArray(m_vertexArray);
+	}
+	else
+	{
+		glBindVertexArray(m_vertexArray);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		(const void*)((size_t)firstCommand * sizeof(DRAW_COMMAND)),
+		count,
+		0);
+
+	if (NULL == m_pStateCache)
+	{
+		glBindVertexArray(0);
+	}
+}
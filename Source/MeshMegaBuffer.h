@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshmegabuffer.h
+// ============
+// pack every basic shape into one shared vertex and index buffer and draw
+// the whole scene with a few multi-draw indirect calls
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+#include "RenderStateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+/***********************************************************
+ *  MeshMegaBuffer
+ *
+ *  This class owns one vertex buffer and one index buffer
+ *  that hold every detail level of every basic shape, with a
+ *  single vertex array object over them.  A draw only picks
+ *  its index range and base vertex, so the vertex state is
+ *  never rebound between meshes.
+ *
+ *  The per-draw values are kept in a shader storage buffer.
+ *  Each indirect command points its base instance at the
+ *  first entry of its draw, and an instanced attribute that
+ *  holds 0, 1, 2, ... is read at the base instance plus the
+ *  instance ID, which gives the vertex shader the index of
+ *  its entry.
+ ***********************************************************/
+class MeshMegaBuffer
+{
+public:
+	// constructor
+	MeshMegaBuffer();
+	// destructor
+	~MeshMegaBuffer();
+
+	// per-draw values in the std430 layout of the shader
+	// DrawData struct
+	struct GPU_DRAW_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		int32_t materialIndex;
+		int32_t textureLayer;
+		glm::vec4 textureRect;
+	};
+
+	// layout of one glMultiDrawElementsIndirect command
+	struct DRAW_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// place of a mesh detail level in the shared buffers
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+		bool bLoaded;
+	};
+
+	// shader storage buffer binding point of the draw data
+	static const GLuint DRAW_BINDING_POINT = 4;
+	// shader attribute location of the draw index
+	static const int DRAW_INDEX_ATTRIBUTE = 10;
+
+	// true when the context has multi-draw indirect and
+	// shader storage buffers
+	static bool IsSupported();
+
+	// pack every detail level of the basic shapes into the
+	// shared buffers
+	bool LoadMeshes();
+	bool IsLoaded() const;
+	// place of a mesh detail level in the shared buffers
+	const MESH_RANGE& GetMeshRange(int meshType, int lod) const;
+
+	// bind the vertex array through a state cache when drawing
+	void SetStateCache(RenderStateCache* pStateCache);
+
+	// upload the per-draw values and commands of the frame
+	void UploadDraws(const GPU_DRAW_DATA* draws, int count);
+	void UploadCommands(const DRAW_COMMAND* commands, int count);
+	// draw count uploaded commands starting at firstCommand
+	void MultiDraw(int firstCommand, int count);
+
+private:
+	// mesh ranges indexed by MESH_TYPE and detail level
+	static const int MESH_TYPE_COUNT = 4;
+	MESH_RANGE m_ranges[MESH_TYPE_COUNT][ShapeGeometry::MAX_LOD_COUNT];
+
+	// shared geometry
+	GLuint m_vertexArray;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// identity buffer read as the per-instance draw index
+	GLuint m_drawIndexBuffer;
+	// per-draw values and indirect commands of the frame
+	GLuint m_drawBuffer;
+	GLuint m_commandBuffer;
+	// number of draws the identity buffer covers
+	int m_drawCapacity;
+	bool m_bLoaded;
+	// optional cache of the bound vertex array
+	RenderStateCache* m_pStateCache;
+
+	// grow the identity buffer to cover count draws
+	void ReserveDrawIndices(int count);
+};
@@ -0,0 +1,779 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.cpp
+// ============
+// rasterize large occluders into a low resolution depth buffer on a worker
+// thread and test the bounds of the scene objects against its depth pyramid
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// the SIMD rasterizer is only built for x86 targets
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define OCCLUSION_CULLER_X86
+#include <immintrin.h>
+#endif
+
+#if defined(OCCLUSION_CULLER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE __attribute__((target("sse2")))
+#else
+#define TARGET_SSE
+#endif
+
+// declaration of the global variables and defines
+namespace
+{
+	// depth the buffer is cleared to, the far plane
+	const float FAR_DEPTH = 1.0f;
+	// smallest clip w that is divided by
+	const float MIN_CLIP_W = 1.0e-5f;
+	// smallest screen area of a triangle that is rasterized
+	const float MIN_TRIANGLE_AREA = 1.0e-6f;
+
+	// corners of a box face, as indices of the corner table
+	// where bit 0 picks max X, bit 1 max Y and bit 2 max Z
+	const int BOX_FACES[6][4] =
+	{
+		{ 0, 2, 6, 4 },		// -X
+		{ 1, 3, 7, 5 },		// +X
+		{ 0, 1, 5, 4 },		// -Y
+		{ 2, 3, 7, 6 },		// +Y
+		{ 0, 1, 3, 2 },		// -Z
+		{ 4, 5, 7, 6 }		// +Z
+	};
+
+	// edge functions and depth plane of a triangle, each as
+	// A * x + B * y + C at a pixel center
+	struct TRIANGLE_SETUP
+	{
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		float depthA;
+		float depthB;
+		float depthC;
+		int minX;
+		int maxX;
+		int minY;
+		int maxY;
+	};
+
+	/***********************************************************
+	 *  RasterizeScalar()
+	 *
+	 *  Keep the nearest depth of every covered pixel, one pixel
+	 *  at a time.
+	 ***********************************************************/
+	void RasterizeScalar(const TRIANGLE_SETUP& setup, float* pDepth, int width)
+	{
+		for (int y = setup.minY; y <= setup.maxY; y++)
+		{
+			float py = (float)y + 0.5f;
+			float* pRow = pDepth + (y * width);
+			for (int x = setup.minX; x <= setup.maxX; x++)
+			{
+				float px = (float)x + 0.5f;
+				float e0 = (setup.edgeA[0] * px) + ((setup.edgeB[0] * py) + setup.edgeC[0]);
+				float e1 = (setup.edgeA[1] * px) + ((setup.edgeB[1] * py) + setup.edgeC[1]);
+				float e2 = (setup.edgeA[2] * px) + ((setup.edgeB[2] * py) + setup.edgeC[2]);
+				if ((e0 >= 0.0f) && (e1 >= 0.0f) && (e2 >= 0.0f))
+				{
+					float z = (setup.depthA * px) + ((setup.depthB * py) + setup.depthC);
+					pRow[x] = std::min(pRow[x], z);
+				}
+			}
+		}
+	}
+
+#ifdef OCCLUSION_CULLER_X86
+	/***********************************************************
+	 *  RasterizeSSE()
+	 *
+	 *  Keep the nearest depth of every covered pixel, four
+	 *  pixels of a row at a time.  The buffer width is a
+	 *  multiple of four, so the blocks never leave the row.
+	 ***********************************************************/
+	TARGET_SSE void RasterizeSSE(const TRIANGLE_SETUP& setup, float* pDepth, int width)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+		__m128 a0 = _mm_set1_ps(setup.edgeA[0]);
+		__m128 a1 = _mm_set1_ps(setup.edgeA[1]);
+		__m128 a2 = _mm_set1_ps(setup.edgeA[2]);
+		__m128 depthA = _mm_set1_ps(setup.depthA);
+		int startX = setup.minX & ~3;
+
+		for (int y = setup.minY; y <= setup.maxY; y++)
+		{
+			float py = (float)y + 0.5f;
+			__m128 row0 = _mm_set1_ps((setup.edgeB[0] * py) + setup.edgeC[0]);
+			__m128 row1 = _mm_set1_ps((setup.edgeB[1] * py) + setup.edgeC[1]);
+			__m128 row2 = _mm_set1_ps((setup.edgeB[2] * py) + setup.edgeC[2]);
+			__m128 rowDepth = _mm_set1_ps((setup.depthB * py) + setup.depthC);
+			float* pRow = pDepth + (y * width);
+
+			for (int x = startX; x <= setup.maxX; x += 4)
+			{
+				__m128 px = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+				__m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+				__m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+				__m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+				__m128 inside = _mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+					_mm_cmpge_ps(e2, zero));
+				if (_mm_movemask_ps(inside) == 0)
+				{
+					continue;
+				}
+
+				__m128 z = _mm_add_ps(_mm_mul_ps(depthA, px), rowDepth);
+				__m128 previous = _mm_loadu_ps(pRow + x);
+				__m128 nearest = _mm_min_ps(previous, z);
+				_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+			}
+		}
+	}
+#endif // OCCLUSION_CULLER_X86
+
+	/***********************************************************
+	 *  ClipNearPlane()
+	 *
+	 *  Clip a polygon in clip space against the near plane,
+	 *  where z >= -w.  Returns the number of output vertices,
+	 *  which is at most one more than the input.
+	 ***********************************************************/
+	int ClipNearPlane(const glm::vec4* pInput, int inputCount, glm::vec4* pOutput)
+	{
+		int outputCount = 0;
+
+		for (int i = 0; i < inputCount; i++)
+		{
+			const glm::vec4& current = pInput[i];
+			const glm::vec4& next = pInput[(i + 1) % inputCount];
+			float currentDistance = current.z + current.w;
+			float nextDistance = next.z + next.w;
+
+			if (currentDistance >= 0.0f)
+			{
+				pOutput[outputCount++] = current;
+			}
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				float t = currentDistance / (currentDistance - nextDistance);
+				pOutput[outputCount++] = current + ((next - current) * t);
+			}
+		}
+
+		return(outputCount);
+	}
+}
+
+/***********************************************************
+ *  OcclusionCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OcclusionCuller::OcclusionCuller()
+{
+	m_viewProjection = glm::mat4(1.0f);
+	m_pFrustumCuller = NULL;
+	m_depthBuffer.assign(DEPTH_WIDTH * DEPTH_HEIGHT, FAR_DEPTH);
+	m_stats.occluders = 0;
+	m_stats.rasterizedTriangles = 0;
+	m_stats.testedObjects = 0;
+	m_stats.occludedObjects = 0;
+	m_stats.cullMilliseconds = 0.0f;
+	m_bJobPending = false;
+	m_bJobRunning = false;
+	m_bQuit = false;
+
+	m_worker = std::thread(&OcclusionCuller::WorkerMain, this);
+}
+
+/***********************************************************
+ *  ~OcclusionCuller()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OcclusionCuller::~OcclusionCuller()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bQuit = true;
+	}
+	m_condition.notify_all();
+
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+	m_pFrustumCuller = NULL;
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is the loop of the worker thread.  It waits
+ *  for a job from BeginCull(), runs it and signals that it
+ *  has finished.
+ ***********************************************************/
+void OcclusionCuller::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true)
+	{
+		while ((m_bJobPending == false) && (m_bQuit == false))
+		{
+			m_condition.wait(lock);
+		}
+		if (m_bQuit)
+		{
+			break;
+		}
+
+		m_bJobPending = false;
+		m_bJobRunning = true;
+		lock.unlock();
+
+		Cull();
+
+		lock.lock();
+		m_bJobRunning = false;
+		m_condition.notify_all();
+	}
+}
+
+/***********************************************************
+ *  WaitForWorker()
+ *
+ *  This method is used for waiting until the worker thread
+ *  has finished any job that was handed to it.
+ ***********************************************************/
+void OcclusionCuller::WaitForWorker()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_bJobPending || m_bJobRunning)
+	{
+		m_condition.wait(lock);
+	}
+}
+
+/***********************************************************
+ *  ClearOccluders()
+ *
+ *  This method is used for removing the occluders of the
+ *  previous frame.
+ ***********************************************************/
+void OcclusionCuller::ClearOccluders()
+{
+	WaitForWorker();
+	m_occluders.clear();
+}
+
+/***********************************************************
+ *  AddOccluder()
+ *
+ *  This method is used for adding a box that hides what is
+ *  behind it.  A plane is added as a box with no thickness.
+ ***********************************************************/
+void OcclusionCuller::AddOccluder(
+	const glm::mat4& modelMatrix,
+	const glm::vec3& localMin,
+	const glm::vec3& localMax)
+{
+	WaitForWorker();
+
+	OCCLUDER occluder;
+	occluder.modelMatrix = modelMatrix;
+	occluder.localMin = localMin;
+	occluder.localMax = localMax;
+	m_occluders.push_back(occluder);
+}
+
+/***********************************************************
+ *  GetOccluderCount()
+ *
+ *  This method is used for getting the number of occluders
+ *  of the current frame.
+ ***********************************************************/
+int OcclusionCuller::GetOccluderCount() const
+{
+	return((int)m_occluders.size());
+}
+
+/***********************************************************
+ *  BeginCull()
+ *
+ *  This method is used for handing the current frame to the
+ *  worker thread.  It returns right away, so the caller can
+ *  go on with other work, such as queueing the occluders,
+ *  while the GPU is still drawing the previous frame.  The
+ *  boxes of the frustum culler that passed its last cull
+ *  are the ones tested.
+ ***********************************************************/
+void OcclusionCuller::BeginCull(const glm::mat4& viewProjection, const FrustumCuller* pFrustumCuller)
+{
+	WaitForWorker();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_viewProjection = viewProjection;
+		m_pFrustumCuller = pFrustumCuller;
+		m_bJobPending = true;
+	}
+	m_condition.notify_all();
+}
+
+/***********************************************************
+ *  FinishCull()
+ *
+ *  This method is used for waiting for the results of the
+ *  cull started by BeginCull().
+ ***********************************************************/
+void OcclusionCuller::FinishCull()
+{
+	WaitForWorker();
+}
+
+/***********************************************************
+ *  IsOccluded()
+ *
+ *  This method is used for checking whether a box was found
+ *  hidden by the last cull.  Boxes that were not tested are
+ *  never occluded.
+ ***********************************************************/
+bool OcclusionCuller::IsOccluded(int index) const
+{
+	if ((index < 0) || (index >= (int)m_occluded.size()))
+	{
+		return(false);
+	}
+
+	return(m_occluded[index] != 0);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the counters and the
+ *  worker time of the last cull.
+ ***********************************************************/
+const OcclusionCuller::OCCLUSION_STATS& OcclusionCuller::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method is used for getting the number of levels in
+ *  the depth pyramid.
+ ***********************************************************/
+int OcclusionCuller::GetLevelCount() const
+{
+	return((int)m_maxDepthLevels.size());
+}
+
+/***********************************************************
+ *  GetMinDepthLevel()
+ *
+ *  This method is used for getting the nearest depth of
+ *  every texel of a pyramid level.
+ ***********************************************************/
+const std::vector<float>& OcclusionCuller::GetMinDepthLevel(int level) const
+{
+	level = std::max(0, std::min(level, GetLevelCount() - 1));
+	return(m_minDepthLevels[level]);
+}
+
+/***********************************************************
+ *  GetMaxDepthLevel()
+ *
+ *  This method is used for getting the farthest depth of
+ *  every texel of a pyramid level.
+ ***********************************************************/
+const std::vector<float>& OcclusionCuller::GetMaxDepthLevel(int level) const
+{
+	level = std::max(0, std::min(level, GetLevelCount() - 1));
+	return(m_maxDepthLevels[level]);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for running a cull on the worker
+ *  thread.  The occluders are rasterized, the pyramid is
+ *  built from the depth buffer, and then every box that
+ *  passed the frustum test is tested against the pyramid.
+ ***********************************************************/
+void OcclusionCuller::Cull()
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	std::fill(m_depthBuffer.begin(), m_depthBuffer.end(), FAR_DEPTH);
+	int triangles = 0;
+	for (int i = 0; i < m_occluders.size(); i++)
+	{
+		triangles += RasterizeOccluder(m_occluders[i]);
+	}
+	BuildPyramid();
+
+	int count = (NULL != m_pFrustumCuller) ? m_pFrustumCuller->GetCount() : 0;
+	int tested = 0;
+	int occluded = 0;
+	m_occluded.assign(count, 0);
+	if (count > 0)
+	{
+		FrustumCuller::BOUNDS_STREAMS streams = m_pFrustumCuller->GetStreams();
+		for (int i = 0; i < count; i++)
+		{
+			if ((m_pFrustumCuller->IsVisible(i) == false) || (m_pFrustumCuller->IsBounded(i) == false))
+			{
+				continue;
+			}
+
+			tested++;
+			glm::vec3 center = glm::vec3(streams.centerX[i], streams.centerY[i], streams.centerZ[i]);
+			glm::vec3 extent = glm::vec3(streams.extentX[i], streams.extentY[i], streams.extentZ[i]);
+			if (TestBounds(center, extent))
+			{
+				m_occluded[i] = 1;
+				occluded++;
+			}
+		}
+	}
+
+	std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+	m_stats.occluders = (int)m_occluders.size();
+	m_stats.rasterizedTriangles = triangles;
+	m_stats.testedObjects = tested;
+	m_stats.occludedObjects = occluded;
+	m_stats.cullMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+/***********************************************************
+ *  RasterizeOccluder()
+ *
+ *  This method is used for rasterizing the faces of an
+ *  occluder box.  For a box that is flat along an axis only
+ *  one of the two matching faces is drawn, since the other
+ *  one covers the same pixels.  Returns the number of
+ *  triangles that covered any area.
+ ***********************************************************/
+int OcclusionCuller::RasterizeOccluder(const OCCLUDER& occluder)
+{
+	glm::mat4 modelViewProjection = m_viewProjection * occluder.modelMatrix;
+	glm::vec4 corners[8];
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 local = glm::vec3(
+			(i & 1) ? occluder.localMax.x : occluder.localMin.x,
+			(i & 2) ? occluder.localMax.y : occluder.localMin.y,
+			(i & 4) ? occluder.localMax.z : occluder.localMin.z);
+		corners[i] = modelViewProjection * glm::vec4(local, 1.0f);
+	}
+
+	int triangles = 0;
+	for (int face = 0; face < 6; face++)
+	{
+		int axis = face / 2;
+		bool bFlat = (occluder.localMin[axis] == occluder.localMax[axis]);
+		if (bFlat && ((face % 2) == 1))
+		{
+			continue;
+		}
+
+		glm::vec4 triangle[3];
+		triangle[0] = corners[BOX_FACES[face][0]];
+		triangle[1] = corners[BOX_FACES[face][1]];
+		triangle[2] = corners[BOX_FACES[face][2]];
+		triangles += RasterizeClippedTriangle(triangle);
+		triangle[1] = corners[BOX_FACES[face][2]];
+		triangle[2] = corners[BOX_FACES[face][3]];
+		triangles += RasterizeClippedTriangle(triangle);
+	}
+
+	return(triangles);
+}
+
+/***********************************************************
+ *  RasterizeClippedTriangle()
+ *
+ *  This method is used for clipping a clip space triangle
+ *  against the near plane, so that the ground and other
+ *  occluders reaching behind the camera still hide what is
+ *  in front of it.  The rest is divided into screen space
+ *  and rasterized as a fan.
+ ***********************************************************/
+int OcclusionCuller::RasterizeClippedTriangle(const glm::vec4* clipVertices)
+{
+	glm::vec4 clipped[4];
+	int clippedCount = ClipNearPlane(clipVertices, 3, clipped);
+	if (clippedCount < 3)
+	{
+		return(0);
+	}
+
+	SCREEN_VERTEX screen[4];
+	for (int i = 0; i < clippedCount; i++)
+	{
+		if (clipped[i].w < MIN_CLIP_W)
+		{
+			return(0);
+		}
+
+		float inverseW = 1.0f / clipped[i].w;
+		screen[i].x = ((clipped[i].x * inverseW * 0.5f) + 0.5f) * (float)DEPTH_WIDTH;
+		screen[i].y = ((clipped[i].y * inverseW * 0.5f) + 0.5f) * (float)DEPTH_HEIGHT;
+		screen[i].z = clipped[i].z * inverseW;
+	}
+
+	int triangles = 0;
+	for (int i = 1; (i + 1) < clippedCount; i++)
+	{
+		if (RasterizeTriangle(screen[0], screen[i], screen[i + 1]))
+		{
+			triangles++;
+		}
+	}
+
+	return(triangles);
+}
+
+/***********************************************************
+ *  RasterizeTriangle()
+ *
+ *  This method is used for setting up the edge functions and
+ *  the depth plane of a screen space triangle and keeping
+ *  the nearest depth of the pixels whose centers it covers.
+ *  Both windings are drawn, since the inside of a box can
+ *  hide things as well as the outside.
+ ***********************************************************/
+bool OcclusionCuller::RasterizeTriangle(
+	const SCREEN_VERTEX& v0,
+	const SCREEN_VERTEX& v1,
+	const SCREEN_VERTEX& v2)
+{
+	float area = ((v1.x - v0.x) * (v2.y - v0.y)) - ((v1.y - v0.y) * (v2.x - v0.x));
+	if (std::fabs(area) < MIN_TRIANGLE_AREA)
+	{
+		return(false);
+	}
+
+	TRIANGLE_SETUP setup;
+	setup.minX = std::max(0, (int)std::floor(std::min(v0.x, std::min(v1.x, v2.x))));
+	setup.maxX = std::min(DEPTH_WIDTH - 1, (int)std::ceil(std::max(v0.x, std::max(v1.x, v2.x))));
+	setup.minY = std::max(0, (int)std::floor(std::min(v0.y, std::min(v1.y, v2.y))));
+	setup.maxY = std::min(DEPTH_HEIGHT - 1, (int)std::ceil(std::max(v0.y, std::max(v1.y, v2.y))));
+	if ((setup.minX > setup.maxX) || (setup.minY > setup.maxY))
+	{
+		return(false);
+	}
+
+	// edge i is opposite vertex i, and is positive inside the
+	// triangle once divided by the signed area
+	const SCREEN_VERTEX* vertices[3] = { &v0, &v1, &v2 };
+	float inverseArea = 1.0f / area;
+	for (int i = 0; i < 3; i++)
+	{
+		const SCREEN_VERTEX& a = *vertices[(i + 1) % 3];
+		const SCREEN_VERTEX& b = *vertices[(i + 2) % 3];
+		setup.edgeA[i] = (a.y - b.y) * inverseArea;
+		setup.edgeB[i] = (b.x - a.x) * inverseArea;
+		setup.edgeC[i] = ((a.x * b.y) - (a.y * b.x)) * inverseArea;
+	}
+
+	// the normalized edges are the barycentric weights, so the
+	// depth plane is their sum weighted by the vertex depths
+	setup.depthA = (setup.edgeA[0] * v0.z) + (setup.edgeA[1] * v1.z) + (setup.edgeA[2] * v2.z);
+	setup.depthB = (setup.edgeB[0] * v0.z) + (setup.edgeB[1] * v1.z) + (setup.edgeB[2] * v2.z);
+	setup.depthC = (setup.edgeC[0] * v0.z) + (setup.edgeC[1] * v1.z) + (setup.edgeC[2] * v2.z);
+
+#ifdef OCCLUSION_CULLER_X86
+	if (TransformBatch::GetSupportedKernel() >= TransformBatch::KERNEL_SSE)
+	{
+		RasterizeSSE(setup, m_depthBuffer.data(), DEPTH_WIDTH);
+		return(true);
+	}
+#endif
+	RasterizeScalar(setup, m_depthBuffer.data(), DEPTH_WIDTH);
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildPyramid()
+ *
+ *  This method is used for building the depth pyramid.  Each
+ *  level keeps the nearest and farthest depth of the 2x2
+ *  texels below it, down to a single texel.
+ ***********************************************************/
+void OcclusionCuller::BuildPyramid()
+{
+	int levels = 1;
+	while (((DEPTH_WIDTH >> (levels - 1)) > 1) || ((DEPTH_HEIGHT >> (levels - 1)) > 1))
+	{
+		levels++;
+	}
+
+	m_minDepthLevels.resize(levels);
+	m_maxDepthLevels.resize(levels);
+	m_minDepthLevels[0] = m_depthBuffer;
+	m_maxDepthLevels[0] = m_depthBuffer;
+
+	for (int level = 1; level < levels; level++)
+	{
+		int sourceWidth = std::max(1, DEPTH_WIDTH >> (level - 1));
+		int sourceHeight = std::max(1, DEPTH_HEIGHT >> (level - 1));
+		int width = std::max(1, DEPTH_WIDTH >> level);
+		int height = std::max(1, DEPTH_HEIGHT >> level);
+		const std::vector<float>& sourceMin = m_minDepthLevels[level - 1];
+		const std::vector<float>& sourceMax = m_maxDepthLevels[level - 1];
+		std::vector<float>& levelMin = m_minDepthLevels[level];
+		std::vector<float>& levelMax = m_maxDepthLevels[level];
+		levelMin.resize(width * height);
+		levelMax.resize(width * height);
+
+		for (int y = 0; y < height; y++)
+		{
+			int y0 = std::min(y * 2, sourceHeight - 1);
+			int y1 = std::min((y * 2) + 1, sourceHeight - 1);
+			for (int x = 0; x < width; x++)
+			{
+				int x0 = std::min(x * 2, sourceWidth - 1);
+				int x1 = std::min((x * 2) + 1, sourceWidth - 1);
+				int i00 = (y0 * sourceWidth) + x0;
+				int i01 = (y0 * sourceWidth) + x1;
+				int i10 = (y1 * sourceWidth) + x0;
+				int i11 = (y1 * sourceWidth) + x1;
+
+				levelMin[(y * width) + x] = std::min(
+					std::min(sourceMin[i00], sourceMin[i01]),
+					std::min(sourceMin[i10], sourceMin[i11]));
+				levelMax[(y * width) + x] = std::max(
+					std::max(sourceMax[i00], sourceMax[i01]),
+					std::max(sourceMax[i10], sourceMax[i11]));
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  TestBounds()
+ *
+ *  This method is used for testing a world box against the
+ *  depth pyramid.  The corners are projected to find the
+ *  pixels the box covers and its nearest depth, and the
+ *  coarsest level where that rectangle spans at most 2x2
+ *  texels is read.  When the box is not behind all of them,
+ *  but is behind some occluder depth, the next finer level
+ *  is read as well.  Boxes reaching past the near plane are
+ *  never occluded.
+ ***********************************************************/
+bool OcclusionCuller::TestBounds(const glm::vec3& center, const glm::vec3& extent) const
+{
+	float minX = 1.0e30f;
+	float minY = 1.0e30f;
+	float maxX = -1.0e30f;
+	float maxY = -1.0e30f;
+	float nearest = 1.0e30f;
+
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner = glm::vec3(
+			(i & 1) ? center.x + extent.x : center.x - extent.x,
+			(i & 2) ? center.y + extent.y : center.y - extent.y,
+			(i & 4) ? center.z + extent.z : center.z - extent.z);
+		glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.0f);
+		if ((clip.w < MIN_CLIP_W) || ((clip.z + clip.w) < 0.0f))
+		{
+			return(false);
+		}
+
+		float inverseW = 1.0f / clip.w;
+		float x = ((clip.x * inverseW * 0.5f) + 0.5f) * (float)DEPTH_WIDTH;
+		float y = ((clip.y * inverseW * 0.5f) + 0.5f) * (float)DEPTH_HEIGHT;
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, clip.z * inverseW);
+	}
+
+	// outside of the buffer, which the frustum test decides
+	if ((maxX < 0.0f) || (maxY < 0.0f) || (minX >= (float)DEPTH_WIDTH) || (minY >= (float)DEPTH_HEIGHT))
+	{
+		return(false);
+	}
+
+	int x0 = std::max(0, (int)std::floor(minX));
+	int y0 = std::max(0, (int)std::floor(minY));
+	int x1 = std::min(DEPTH_WIDTH - 1, (int)std::floor(maxX));
+	int y1 = std::min(DEPTH_HEIGHT - 1, (int)std::floor(maxY));
+
+	int level = 0;
+	while ((level < (GetLevelCount() - 1)) &&
+		((((x1 >> level) - (x0 >> level)) > 1) || (((y1 >> level) - (y0 >> level)) > 1)))
+	{
+		level++;
+	}
+
+	float nearestOccluder = 0.0f;
+	float farthestOccluder = 0.0f;
+	GetRectDepth(level, x0, y0, x1, y1, nearestOccluder, farthestOccluder);
+	if (nearest > farthestOccluder)
+	{
+		return(true);
+	}
+
+	// in front of every occluder depth, so visible for sure
+	if ((nearest <= nearestOccluder) || (level == 0))
+	{
+		return(false);
+	}
+
+	GetRectDepth(level - 1, x0, y0, x1, y1, nearestOccluder, farthestOccluder);
+
+	return(nearest > farthestOccluder);
+}
+
+/***********************************************************
+ *  GetRectDepth()
+ *
+ *  This method is used for reading the nearest and farthest
+ *  depth of the texels of a pyramid level that cover a
+ *  rectangle of full resolution pixels.
+ ***********************************************************/
+void OcclusionCuller::GetRectDepth(
+	int level,
+	int x0, int y0, int x1, int y1,
+	float& nearestDepth,
+	float& farthestDepth) const
+{
+	int width = std::max(1, DEPTH_WIDTH >> level);
+	int height = std::max(1, DEPTH_HEIGHT >> level);
+	int levelX0 = std::min(x0 >> level, width - 1);
+	int levelX1 = std::min(x1 >> level, width - 1);
+	int levelY0 = std::min(y0 >> level, height - 1);
+	int levelY1 = std::min(y1 >> level, height - 1);
+	const std::vector<float>& levelMin = m_minDepthLevels[level];
+	const std::vector<float>& levelMax = m_maxDepthLevels[level];
+
+	nearestDepth = FAR_DEPTH;
+	farthestDepth = -FAR_DEPTH;
+	for (int y = levelY0; y <= levelY1; y++)
+	{
+		for (int x = levelX0; x <= levelX1; x++)
+		{
+			nearestDepth = std::min(nearestDepth, levelMin[(y * width) + x]);
+			farthestDepth = std::max(farthestDepth, levelMax[(y * width) + x]);
+		}
+	}
+}
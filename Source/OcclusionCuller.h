@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.h
+// ============
+// rasterize large occluders into a low resolution depth buffer on a worker
+// thread and test the bounds of the scene objects against its depth pyramid
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrustumCuller.h"
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  OcclusionCuller
+ *
+ *  This class keeps a small software depth buffer.  Each
+ *  frame the boxes of a few large occluders, such as house
+ *  bodies and the ground, are rasterized into it with SSE,
+ *  and a pyramid holding the nearest and farthest depth of
+ *  every 2x2 block is built from it.  The world bounds of
+ *  the objects that passed the frustum test are then
+ *  projected to the screen and are occluded when they are
+ *  farther than every occluder depth they cover.
+ *
+ *  The work is done on a worker thread.  BeginCull() hands
+ *  the frame to the worker and returns, and FinishCull()
+ *  waits for the results.  The occluders and the frustum
+ *  culler must not be changed in between.
+ ***********************************************************/
+class OcclusionCuller
+{
+public:
+	// constructor - starts the worker thread
+	OcclusionCuller();
+	// destructor - stops the worker thread
+	~OcclusionCuller();
+
+	// size of the depth buffer, kept a power of two so every
+	// pyramid level halves evenly
+	static const int DEPTH_WIDTH = 256;
+	static const int DEPTH_HEIGHT = 128;
+
+	// counters and time of the last cull
+	struct OCCLUSION_STATS
+	{
+		int occluders;
+		int rasterizedTriangles;
+		int testedObjects;
+		int occludedObjects;
+		float cullMilliseconds;
+	};
+
+	// clear the occluders of the previous frame
+	void ClearOccluders();
+	// add a box occluder from its object space bounds and its
+	// model matrix - flat boxes are used for planes
+	void AddOccluder(
+		const glm::mat4& modelMatrix,
+		const glm::vec3& localMin,
+		const glm::vec3& localMax);
+	int GetOccluderCount() const;
+
+	// start culling the boxes that passed the frustum test on
+	// the worker thread
+	void BeginCull(const glm::mat4& viewProjection, const FrustumCuller* pFrustumCuller);
+	// wait for the worker thread to finish the cull
+	void FinishCull();
+
+	// true when the box was found hidden by the last cull
+	bool IsOccluded(int index) const;
+	const OCCLUSION_STATS& GetStats() const;
+
+	// nearest and farthest depth of a pyramid level, mostly
+	// for inspecting the buffer
+	int GetLevelCount() const;
+	const std::vector<float>& GetMinDepthLevel(int level) const;
+	const std::vector<float>& GetMaxDepthLevel(int level) const;
+
+private:
+	// occluder box in object space with its model matrix
+	struct OCCLUDER
+	{
+		glm::mat4 modelMatrix;
+		glm::vec3 localMin;
+		glm::vec3 localMax;
+	};
+
+	// triangle vertex after the perspective divide, in
+	// pixels with the normalized device depth
+	struct SCREEN_VERTEX
+	{
+		float x;
+		float y;
+		float z;
+	};
+
+	// occluders of the current frame
+	std::vector<OCCLUDER> m_occluders;
+	// input of the job handed to the worker
+	glm::mat4 m_viewProjection;
+	const FrustumCuller* m_pFrustumCuller;
+	// full resolution depth buffer
+	std::vector<float> m_depthBuffer;
+	// nearest and farthest depth of each level, level 0 being
+	// the depth buffer itself
+	std::vector<std::vector<float> > m_minDepthLevels;
+	std::vector<std::vector<float> > m_maxDepthLevels;
+	// result of the last cull, one entry per box
+	std::vector<unsigned char> m_occluded;
+	OCCLUSION_STATS m_stats;
+
+	// worker thread and its hand-off state
+	std::thread m_worker;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_bJobPending;
+	bool m_bJobRunning;
+	bool m_bQuit;
+
+	// loop of the worker thread
+	void WorkerMain();
+	// wait until the worker has no job
+	void WaitForWorker();
+	// rasterize the occluders, build the pyramid and test
+	void Cull();
+
+	// rasterize the twelve triangles of an occluder box
+	int RasterizeOccluder(const OCCLUDER& occluder);
+	// clip a clip space triangle against the near plane and
+	// rasterize what is left
+	int RasterizeClippedTriangle(const glm::vec4* clipVertices);
+	// rasterize a screen space triangle into the depth buffer,
+	// returns false for a triangle with no area
+	bool RasterizeTriangle(const SCREEN_VERTEX& v0, const SCREEN_VERTEX& v1, const SCREEN_VERTEX& v2);
+	// build the nearest and farthest depth pyramid
+	void BuildPyramid();
+	// true when the box is hidden behind the occluders
+	bool TestBounds(const glm::vec3& center, const glm::vec3& extent) const;
+	// nearest and farthest occluder depth over a rectangle of
+	// level 0 pixels, read from the texels of a pyramid level
+	void GetRectDepth(
+		int level,
+		int x0, int y0, int x1, int y1,
+		float& nearestDepth,
+		float& farthestDepth) const;
+};
@@ -0,0 +1,307 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// collect the draw packets for a frame and sort them by render state
+// so that redundant shader state changes can be skipped on submission
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of the global variables and defines
+namespace
+{
+	// bit layout of the packed sort key, from the most significant bit:
+	// translucent(1) | program(8) | texture slot(12) | material(12) | mesh(5) | lod(2) | sequence(24)
+	const int TRANSLUCENT_SHIFT = 63;
+	const int PROGRAM_SHIFT = 55;
+	const int TEXTURE_SHIFT = 43;
+	const int MATERIAL_SHIFT = 31;
+	const int MESH_SHIFT = 26;
+	const int LOD_SHIFT = 24;
+
+	const uint64_t PROGRAM_MASK = 0xFF;
+	const uint64_t TEXTURE_MASK = 0xFFF;
+	const uint64_t MATERIAL_MASK = 0xFFF;
+	const uint64_t MESH_MASK = 0x1F;
+	const uint64_t LOD_MASK = 0x3;
+	const uint64_t SEQUENCE_MASK = 0xFFFFFF;
+	const int SEQUENCE_BITS = 24;
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+	m_stats.packets = 0;
+	m_stats.drawCalls = 0;
+	m_stats.stateSwitches = 0;
+	m_stats.stateSwitchesSaved = 0;
+}
+
+/***********************************************************
+ *  ~RenderQueue()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderQueue::~RenderQueue()
+{
+	m_packets.clear();
+	m_sortedEntries.clear();
+	m_batchEntries.clear();
+	m_batches.clear();
+}
+
+/***********************************************************
+ *  MakeSortKey()
+ *
+ *  This method is used for packing the render state of a
+ *  draw into a 64-bit key.  The most expensive state to
+ *  change occupies the highest bits, so sorting the keys
+ *  groups draws that share a program, then a texture, then
+ *  a material, then a mesh and its detail level.  Unset
+ *  texture and material values (-1) sort ahead of every
+ *  valid index.
+ ***********************************************************/
+uint64_t RenderQueue::MakeSortKey(
+	bool bTranslucent,
+	unsigned int program,
+	int textureSlot,
+	int materialIndex,
+	int meshType,
+	int lod,
+	uint32_t sequence)
+{
+	uint64_t key = 0;
+
+	key |= (uint64_t)(bTranslucent ? 1 : 0) << TRANSLUCENT_SHIFT;
+	key |= ((uint64_t)program & PROGRAM_MASK) << PROGRAM_SHIFT;
+	key |= ((uint64_t)(textureSlot + 1) & TEXTURE_MASK) << TEXTURE_SHIFT;
+	key |= ((uint64_t)(materialIndex + 1) & MATERIAL_MASK) << MATERIAL_SHIFT;
+	key |= ((uint64_t)meshType & MESH_MASK) << MESH_SHIFT;
+	key |= ((uint64_t)lod & LOD_MASK) << LOD_SHIFT;
+	key |= (uint64_t)sequence & SEQUENCE_MASK;
+
+	return(key);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for emptying the queue and resetting
+ *  the state change counters at the start of a frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+	m_sortedEntries.clear();
+	m_batchEntries.clear();
+	m_batches.clear();
+
+	m_stats.packets = 0;
+	m_stats.drawCalls = 0;
+	m_stats.stateSwitches = 0;
+	m_stats.stateSwitchesSaved = 0;
+}
+
+/***********************************************************
+ *  Submit()
+ *
+ *  This method is used for adding a draw packet to the queue.
+ *  The submission order is folded into the key so that draws
+ *  with identical state keep their original ordering.
+ ***********************************************************/
+void RenderQueue::Submit(const DRAW_PACKET& packet)
+{
+	uint32_t sequence = (uint32_t)m_packets.size();
+
+	m_packets.push_back(packet);
+	m_packets.back().sortKey = MakeSortKey(
+		packet.bTranslucent,
+		packet.program,
+		packet.textureSlot,
+		packet.materialIndex,
+		packet.meshType,
+		packet.lod,
+		sequence);
+
+	m_stats.packets++;
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for ordering the queued packets by
+ *  their state key.  Only the small key/index pairs are
+ *  moved, the packets themselves stay in place.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	m_sortedEntries.resize(m_packets.size());
+	for (uint32_t i = 0; i < m_packets.size(); i++)
+	{
+		m_sortedEntries[i].key = m_packets[i].sortKey;
+		m_sortedEntries[i].index = i;
+	}
+
+	std::sort(
+		m_sortedEntries.begin(),
+		m_sortedEntries.end(),
+		[](const SORT_ENTRY& a, const SORT_ENTRY& b) { return(a.key < b.key); });
+}
+
+/***********************************************************
+ *  GetPacketCount()
+ *
+ *  This method is used for getting the number of packets
+ *  queued for the current frame.
+ ***********************************************************/
+int RenderQueue::GetPacketCount() const
+{
+	return((int)m_packets.size());
+}
+
+/***********************************************************
+ *  GetSortedPacket()
+ *
+ *  This method is used for getting a queued packet by its
+ *  position in the sorted order.
+ ***********************************************************/
+const RenderQueue::DRAW_PACKET& RenderQueue::GetSortedPacket(int index) const
+{
+	return(m_packets[m_sortedEntries[index].index]);
+}
+
+/***********************************************************
+ *  BuildInstanceBatches()
+ *
+ *  This method is used for grouping the queued packets into
+ *  runs that can be drawn with one instanced draw call.  The
+ *  packets are keyed without their material, since the
+ *  material index travels with the instance data, so every
+ *  packet sharing a program, texture, mesh and detail level
+ *  ends up in the same run in submission order.
+ ***********************************************************/
+void RenderQueue::BuildInstanceBatches()
+{
+	m_batchEntries.resize(m_packets.size());
+	for (uint32_t i = 0; i < m_packets.size(); i++)
+	{
+		m_batchEntries[i].key = MakeSortKey(
+			m_packets[i].bTranslucent,
+			m_packets[i].program,
+			m_packets[i].textureSlot,
+			-1,
+			m_packets[i].meshType,
+			m_packets[i].lod,
+			i);
+		m_batchEntries[i].index = i;
+	}
+
+	std::sort(
+		m_batchEntries.begin(),
+		m_batchEntries.end(),
+		[](const SORT_ENTRY& a, const SORT_ENTRY& b) { return(a.key < b.key); });
+
+	m_batches.clear();
+	for (int i = 0; i < m_batchEntries.size(); i++)
+	{
+		// a new batch starts whenever any state above the
+		// sequence bits differs from the previous packet
+		if ((i == 0) ||
+			((m_batchEntries[i].key >> SEQUENCE_BITS) != (m_batchEntries[i - 1].key >> SEQUENCE_BITS)))
+		{
+			const DRAW_PACKET& packet = m_packets[m_batchEntries[i].index];
+			INSTANCE_BATCH batch;
+			batch.program = packet.program;
+			batch.meshType = packet.meshType;
+			batch.lod = packet.lod;
+			batch.textureSlot = packet.textureSlot;
+			batch.bTranslucent = packet.bTranslucent;
+			batch.firstInstance = i;
+			batch.count = 0;
+			m_batches.push_back(batch);
+		}
+		m_batches.back().count++;
+	}
+}
+
+/***********************************************************
+ *  GetBatchCount()
+ *
+ *  This method is used for getting the number of instance
+ *  batches built for the current frame.
+ ***********************************************************/
+int RenderQueue::GetBatchCount() const
+{
+	return((int)m_batches.size());
+}
+
+/***********************************************************
+ *  GetBatch()
+ *
+ *  This method is used for getting an instance batch by its
+ *  position in the draw order.
+ ***********************************************************/
+const RenderQueue::INSTANCE_BATCH& RenderQueue::GetBatch(int index) const
+{
+	return(m_batches[index]);
+}
+
+/***********************************************************
+ *  GetBatchedPacket()
+ *
+ *  This method is used for getting a queued packet by its
+ *  position in the instance batch order.
+ ***********************************************************/
+const RenderQueue::DRAW_PACKET& RenderQueue::GetBatchedPacket(int index) const
+{
+	return(m_packets[m_batchEntries[index].index]);
+}
+
+/***********************************************************
+ *  CountStateChange()
+ *
+ *  This method is used for recording one piece of shader
+ *  state for a packet.  Unchanged state counts as a switch
+ *  that the immediate-mode draw sequence would have issued.
+ ***********************************************************/
+void RenderQueue::CountStateChange(bool bChanged)
+{
+	if (bChanged)
+	{
+		m_stats.stateSwitches++;
+	}
+	else
+	{
+		m_stats.stateSwitchesSaved++;
+	}
+}
+
+/***********************************************************
+ *  CountDrawCall()
+ *
+ *  This method is used for recording a draw call issued for
+ *  the queued packets.
+ ***********************************************************/
+void RenderQueue::CountDrawCall()
+{
+	m_stats.drawCalls++;
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the packet and state
+ *  change counters for the current frame.
+ ***********************************************************/
+const RenderQueue::QUEUE_STATS& RenderQueue::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// collect the draw packets for a frame and sort them by render state
+// so that redundant shader state changes can be skipped on submission
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// basic shape meshes that can be referenced by a draw packet
+enum MESH_TYPE
+{
+	MESH_BOX = 0,
+	MESH_PLANE,
+	MESH_PRISM,
+	MESH_CYLINDER
+};
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class holds the draw packets submitted during a
+ *  frame, sorts them by a packed 64-bit state key, and keeps
+ *  the per-frame counters for shader state changes.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor
+	RenderQueue();
+	// destructor
+	~RenderQueue();
+
+	// everything needed to issue one draw of a basic mesh
+	struct DRAW_PACKET
+	{
+		uint64_t sortKey;
+		unsigned int program;
+		int meshType;
+		int lod;				// detail level of the mesh, 0 for full detail
+		int textureSlot;		// -1 when the mesh is drawn with a flat color
+		int textureLayer;		// layer of the texture in the bound array
+		glm::vec4 textureRect;	// rectangle of the texture in its layer
+		int materialIndex;		// -1 when no material is applied
+		bool bTranslucent;		// drawn after all opaque packets
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		glm::mat4 model;
+	};
+
+	// run of packets that share everything but their instance data
+	struct INSTANCE_BATCH
+	{
+		unsigned int program;
+		int meshType;
+		int lod;
+		int textureSlot;
+		bool bTranslucent;
+		int firstInstance;		// position in the batch order
+		int count;
+	};
+
+	// per-frame state change counters
+	struct QUEUE_STATS
+	{
+		int packets;
+		int drawCalls;
+		int stateSwitches;
+		int stateSwitchesSaved;
+	};
+
+	// build the packed sort key for the passed in render state
+	static uint64_t MakeSortKey(
+		bool bTranslucent,
+		unsigned int program,
+		int textureSlot,
+		int materialIndex,
+		int meshType,
+		int lod,
+		uint32_t sequence);
+
+	// clear the queued packets and counters for a new frame
+	void Clear();
+	// add a draw packet to the queue
+	void Submit(const DRAW_PACKET& packet);
+	// sort the queued packets by their state key
+	void Sort();
+
+	// number of queued packets
+	int GetPacketCount() const;
+	// queued packet in sorted order
+	const DRAW_PACKET& GetSortedPacket(int index) const;
+
+	// group the queued packets into instance batches by program,
+	// texture and mesh - color, UV scale and material can differ
+	void BuildInstanceBatches();
+	// number of instance batches
+	int GetBatchCount() const;
+	// instance batch in draw order
+	const INSTANCE_BATCH& GetBatch(int index) const;
+	// queued packet by its position in the batch order
+	const DRAW_PACKET& GetBatchedPacket(int index) const;
+
+	// record whether a piece of shader state had to be changed
+	void CountStateChange(bool bChanged);
+	// record a draw call issued for the queued packets
+	void CountDrawCall();
+	// counters for the current frame
+	const QUEUE_STATS& GetStats() const;
+
+private:
+	// sort entry referencing a queued packet
+	struct SORT_ENTRY
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	// packets in submission order
+	std::vector<DRAW_PACKET> m_packets;
+	// packet references in sorted order
+	std::vector<SORT_ENTRY> m_sortedEntries;
+	// packet references in instance batch order
+	std::vector<SORT_ENTRY> m_batchEntries;
+	// instance batches in draw order
+	std::vector<INSTANCE_BATCH> m_batches;
+	// counters for the current frame
+	QUEUE_STATS m_stats;
+};
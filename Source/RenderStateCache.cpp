@@ -0,0 +1,413 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstatecache.cpp
+// ============
+// shadow the uniform values and the OpenGL fixed-function state that the
+// scene sets while drawing, and drop the calls that would not change them
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderStateCache.h"
+
+#include <cstring>
+#include <iostream>
+
+/***********************************************************
+ *  RenderStateCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderStateCache::RenderStateCache()
+{
+	m_pShaderUniforms = NULL;
+	m_pCurrentUniforms = NULL;
+	Invalidate();
+	BeginFrame();
+}
+
+/***********************************************************
+ *  ~RenderStateCache()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderStateCache::~RenderStateCache()
+{
+	m_pShaderUniforms = NULL;
+	m_pCurrentUniforms = NULL;
+	m_programUniforms.clear();
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  This method is used for setting the reflected uniforms
+ *  that the cached uniform setters write through.
+ ***********************************************************/
+void RenderStateCache::SetShaderUniforms(ShaderUniforms* pShaderUniforms)
+{
+	m_pShaderUniforms = pShaderUniforms;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for resetting the call counters at
+ *  the start of a frame.  The shadowed state is kept, so
+ *  values that carry over from the last frame are elided.
+ ***********************************************************/
+void RenderStateCache::BeginFrame()
+{
+	m_stats.issuedUniforms = 0;
+	m_stats.elidedUniforms = 0;
+	m_stats.issuedStates = 0;
+	m_stats.elidedStates = 0;
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the issued and elided
+ *  call counters of the current frame.
+ ***********************************************************/
+const RenderStateCache::STATE_STATS& RenderStateCache::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting all of the shadowed
+ *  state, so that the next call of every kind is issued.
+ ***********************************************************/
+void RenderStateCache::Invalidate()
+{
+	m_programUniforms.clear();
+	m_pCurrentUniforms = NULL;
+	m_bProgramValid = false;
+	m_currentProgram = 0;
+	m_bVertexArrayValid = false;
+	m_currentVertexArray = 0;
+	m_activeTextureUnit = -1;
+	for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+	{
+		m_textures[i].bValid = false;
+		m_textures[i].target = GL_TEXTURE_2D;
+		m_textures[i].textureID = 0;
+	}
+	m_capabilities.clear();
+	m_bBlendFuncValid = false;
+	m_blendSource = GL_ONE;
+	m_blendDestination = GL_ZERO;
+}
+
+/***********************************************************
+ *  InvalidateVertexArray()
+ *
+ *  This method is used for forgetting the bound vertex
+ *  array after code outside the cache has bound another.
+ ***********************************************************/
+void RenderStateCache::InvalidateVertexArray()
+{
+	m_bVertexArrayValid = false;
+}
+
+/***********************************************************
+ *  InvalidateTextures()
+ *
+ *  This method is used for forgetting the bound textures
+ *  and the active texture unit after code outside the cache
+ *  has bound other textures.
+ ***********************************************************/
+void RenderStateCache::InvalidateTextures()
+{
+	m_activeTextureUnit = -1;
+	for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+	{
+		m_textures[i].bValid = false;
+	}
+}
+
+/***********************************************************
+ *  CountState()
+ *
+ *  This method is used for counting a fixed-function call
+ *  as issued or elided.  The passed in value is returned.
+ ***********************************************************/
+bool RenderStateCache::CountState(bool bChanged)
+{
+	if (bChanged)
+	{
+		m_stats.issuedStates++;
+	}
+	else
+	{
+		m_stats.elidedStates++;
+	}
+
+	return(bChanged);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for making a shader program current.
+ *  Each program keeps its own uniform shadows, since OpenGL
+ *  keeps the uniform values per program.
+ ***********************************************************/
+void RenderStateCache::UseProgram(GLuint programID)
+{
+	if (CountState((m_bProgramValid == false) || (programID != m_currentProgram)))
+	{
+		glUseProgram(programID);
+		m_currentProgram = programID;
+		m_bProgramValid = true;
+		m_pCurrentUniforms = &m_programUniforms[programID];
+	}
+}
+
+/***********************************************************
+ *  BindVertexArray()
+ *
+ *  This method is used for binding a vertex array object.
+ ***********************************************************/
+void RenderStateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (CountState((m_bVertexArrayValid == false) || (vertexArray != m_currentVertexArray)))
+	{
+		glBindVertexArray(vertexArray);
+		m_currentVertexArray = vertexArray;
+		m_bVertexArrayValid = true;
+	}
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a texture to a texture
+ *  unit.  The active texture unit is only switched when a
+ *  texture actually has to be bound.  Units past the shadow
+ *  are bound without caching, and a negative unit is not a
+ *  texture unit at all.
+ ***********************************************************/
+void RenderStateCache::BindTexture(int textureUnit, GLenum target, GLuint textureID)
+{
+	if (textureUnit < 0)
+	{
+		std::cout << "WARNING: Texture unit " << textureUnit << " cannot be bound" << std::endl;
+		return;
+	}
+
+	if (textureUnit >= MAX_TEXTURE_UNITS)
+	{
+		glActiveTexture(GL_TEXTURE0 + textureUnit);
+		glBindTexture(target, textureID);
+		m_activeTextureUnit = textureUnit;
+		CountState(true);
+		return;
+	}
+
+	SHADOW_TEXTURE& shadow = m_textures[textureUnit];
+	if (CountState((shadow.bValid == false) || (shadow.target != target) || (shadow.textureID != textureID)))
+	{
+		if (m_activeTextureUnit != textureUnit)
+		{
+			glActiveTexture(GL_TEXTURE0 + textureUnit);
+			m_activeTextureUnit = textureUnit;
+		}
+		glBindTexture(target, textureID);
+		shadow.bValid = true;
+		shadow.target = target;
+		shadow.textureID = textureID;
+	}
+}
+
+/***********************************************************
+ *  Enable()
+ *
+ *  This method is used for enabling an OpenGL capability.
+ ***********************************************************/
+void RenderStateCache::Enable(GLenum capability)
+{
+	SetCapability(capability, true);
+}
+
+/***********************************************************
+ *  Disable()
+ *
+ *  This method is used for disabling an OpenGL capability.
+ ***********************************************************/
+void RenderStateCache::Disable(GLenum capability)
+{
+	SetCapability(capability, false);
+}
+
+/***********************************************************
+ *  SetCapability()
+ *
+ *  This method is used for enabling or disabling an OpenGL
+ *  capability when it differs from its shadow.
+ ***********************************************************/
+void RenderStateCache::SetCapability(GLenum capability, bool bEnabled)
+{
+	std::unordered_map<GLenum, bool>::iterator found = m_capabilities.find(capability);
+	if (CountState((found == m_capabilities.end()) || (found->second != bEnabled)))
+	{
+		if (bEnabled)
+		{
+			glEnable(capability);
+		}
+		else
+		{
+			glDisable(capability);
+		}
+		m_capabilities[capability] = bEnabled;
+	}
+}
+
+/***********************************************************
+ *  BlendFunc()
+ *
+ *  This method is used for setting the blend function.
+ ***********************************************************/
+void RenderStateCache::BlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+	if (CountState((m_bBlendFuncValid == false) ||
+		(sourceFactor != m_blendSource) ||
+		(destinationFactor != m_blendDestination)))
+	{
+		glBlendFunc(sourceFactor, destinationFactor);
+		m_blendSource = sourceFactor;
+		m_blendDestination = destinationFactor;
+		m_bBlendFuncValid = true;
+	}
+}
+
+/***********************************************************
+ *  UniformChanged()
+ *
+ *  This method is used for comparing a uniform value with
+ *  the last value set into its location in the program in
+ *  use.  When they differ the shadow is updated and true is
+ *  returned so that the caller issues the upload.  Missing
+ *  uniforms are never uploaded and are not counted.
+ ***********************************************************/
+bool RenderStateCache::UniformChanged(GLint location, const void* value, size_t size)
+{
+	if ((location < 0) || (NULL == m_pShaderUniforms))
+	{
+		return(false);
+	}
+
+	// the program was made current outside of the cache
+	if (NULL == m_pCurrentUniforms)
+	{
+		m_stats.issuedUniforms++;
+		return(true);
+	}
+
+	if (location >= (GLint)m_pCurrentUniforms->size())
+	{
+		SHADOW_UNIFORM empty;
+		empty.bValid = false;
+		m_pCurrentUniforms->resize(location + 1, empty);
+	}
+
+	SHADOW_UNIFORM& shadow = (*m_pCurrentUniforms)[location];
+	if ((shadow.bValid) && (std::memcmp(shadow.bytes, value, size) == 0))
+	{
+		m_stats.elidedUniforms++;
+		return(false);
+	}
+
+	std::memcpy(shadow.bytes, value, size);
+	shadow.bValid = true;
+	m_stats.issuedUniforms++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  setBoolValue()
+ ***********************************************************/
+void RenderStateCache::setBoolValue(const ShaderUniforms::UNIFORM_HANDLE& handle, bool value)
+{
+	setIntValue(handle, (int)value);
+}
+
+/***********************************************************
+ *  setIntValue()
+ ***********************************************************/
+void RenderStateCache::setIntValue(const ShaderUniforms::UNIFORM_HANDLE& handle, int value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setIntValue(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setFloatValue()
+ ***********************************************************/
+void RenderStateCache::setFloatValue(const ShaderUniforms::UNIFORM_HANDLE& handle, float value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setFloatValue(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setVec2Value()
+ ***********************************************************/
+void RenderStateCache::setVec2Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec2& value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setVec2Value(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setVec3Value()
+ ***********************************************************/
+void RenderStateCache::setVec3Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec3& value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setVec3Value(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setVec4Value()
+ ***********************************************************/
+void RenderStateCache::setVec4Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec4& value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setVec4Value(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setMat4Value()
+ ***********************************************************/
+void RenderStateCache::setMat4Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::mat4& value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setMat4Value(handle, value);
+	}
+}
+
+/***********************************************************
+ *  setSampler2DValue()
+ ***********************************************************/
+void RenderStateCache::setSampler2DValue(const ShaderUniforms::UNIFORM_HANDLE& handle, int value)
+{
+	if (UniformChanged(handle.location, &value, sizeof(value)))
+	{
+		m_pShaderUniforms->setSampler2DValue(handle, value);
+	}
+}
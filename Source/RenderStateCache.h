@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstatecache.h
+// ============
+// shadow the uniform values and the OpenGL fixed-function state that the
+// scene sets while drawing, and drop the calls that would not change them
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderUniforms.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  RenderStateCache
+ *
+ *  This class sits between the scene and the shader uniforms
+ *  and OpenGL.  It remembers the last value set into every
+ *  uniform of the program in use, the bound program, vertex
+ *  array and textures, and the enabled capabilities and the
+ *  blend function.  Calls that would set the value already
+ *  in place are elided, and the issued and elided calls are
+ *  counted for every frame.
+ ***********************************************************/
+class RenderStateCache
+{
+public:
+	// constructor
+	RenderStateCache();
+	// destructor
+	~RenderStateCache();
+
+	// issued and elided calls for the current frame
+	struct STATE_STATS
+	{
+		int issuedUniforms;
+		int elidedUniforms;
+		int issuedStates;
+		int elidedStates;
+	};
+
+	// set the uniforms that the cached setters write through
+	void SetShaderUniforms(ShaderUniforms* pShaderUniforms);
+
+	// start counting the calls of a new frame
+	void BeginFrame();
+	const STATE_STATS& GetStats() const;
+
+	// forget all of the shadowed state, for when other code
+	// has changed the OpenGL state directly
+	void Invalidate();
+	// forget the bound vertex array only
+	void InvalidateVertexArray();
+	// forget the bound textures and the active texture unit
+	void InvalidateTextures();
+
+	// fixed-function state
+	void UseProgram(GLuint programID);
+	void BindVertexArray(GLuint vertexArray);
+	void BindTexture(int textureUnit, GLenum target, GLuint textureID);
+	void Enable(GLenum capability);
+	void Disable(GLenum capability);
+	void BlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+
+	// uniforms of the program in use
+	void setBoolValue(const ShaderUniforms::UNIFORM_HANDLE& handle, bool value);
+	void setIntValue(const ShaderUniforms::UNIFORM_HANDLE& handle, int value);
+	void setFloatValue(const ShaderUniforms::UNIFORM_HANDLE& handle, float value);
+	void setVec2Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec2& value);
+	void setVec3Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec3& value);
+	void setVec4Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::vec4& value);
+	void setMat4Value(const ShaderUniforms::UNIFORM_HANDLE& handle, const glm::mat4& value);
+	void setSampler2DValue(const ShaderUniforms::UNIFORM_HANDLE& handle, int value);
+
+private:
+	// last value set into a uniform location, kept as raw
+	// bytes so that both floats and ints compare exactly
+	struct SHADOW_UNIFORM
+	{
+		bool bValid;
+		unsigned char bytes[sizeof(glm::mat4)];
+	};
+
+	// last texture bound to a texture unit
+	struct SHADOW_TEXTURE
+	{
+		bool bValid;
+		GLenum target;
+		GLuint textureID;
+	};
+
+	// number of texture units that are shadowed
+	static const int MAX_TEXTURE_UNITS = 32;
+
+	// pointer to the reflected uniforms of the shader program
+	ShaderUniforms* m_pShaderUniforms;
+
+	// shadowed uniform values of every used program, indexed
+	// by uniform location
+	std::unordered_map<GLuint, std::vector<SHADOW_UNIFORM> > m_programUniforms;
+	std::vector<SHADOW_UNIFORM>* m_pCurrentUniforms;
+
+	// shadowed fixed-function state
+	bool m_bProgramValid;
+	GLuint m_currentProgram;
+	bool m_bVertexArrayValid;
+	GLuint m_currentVertexArray;
+	int m_activeTextureUnit;
+	SHADOW_TEXTURE m_textures[MAX_TEXTURE_UNITS];
+	std::unordered_map<GLenum, bool> m_capabilities;
+	bool m_bBlendFuncValid;
+	GLenum m_blendSource;
+	GLenum m_blendDestination;
+
+	// counters for the current frame
+	STATE_STATS m_stats;
+
+	// true when the uniform value differs from its shadow,
+	// which is then updated
+	bool UniformChanged(GLint location, const void* value, size_t size);
+	// count a fixed-function call as issued or elided
+	bool CountState(bool bChanged);
+	// set a capability when it differs from its shadow
+	void SetCapability(GLenum capability, bool bEnabled);
+};
@@ -8,6 +8,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SceneManager.h"
+#include "ShapeGeometry.h"
+#include "FrameProfiler.h"
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -16,6 +18,10 @@
 
 #include <glm/gtx/transform.hpp>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 // declaration of global variables
 namespace
 {
@@ -23,7 +29,44 @@ namespace
 	const char* g_ColorValueName = "objectColor";
 	const char* g_TextureValueName = "objectTexture";
 	const char* g_UseTextureName = "bUseTexture";
+	const char* g_TextureLayerName = "textureLayer";
+	const char* g_TextureRectName = "textureRect";
+	const char* g_UseBindlessTexturesName = "bUseBindlessTextures";
 	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UseInstancingName = "bUseInstancing";
+	const char* g_UseDrawBufferName = "bUseDrawBuffer";
+	const char* g_MaterialIndexName = "materialIndex";
+	const char* g_MaterialBlockName = "MaterialBlock";
+	const char* g_ClusterTileSizeName = "clusterTileSize";
+	const char* g_ClusterDepthParamsName = "clusterDepthParams";
+
+	// range of the original scene lights - none, so they reach
+	// every cluster with no falloff, as they did before
+	const float SCENE_LIGHT_RANGE = 0.0f;
+
+	// smallest scale of a box, on every axis, and of a plane,
+	// across it, for the shape to be used as an occluder - the
+	// house bodies and the ground are above these
+	const float OCCLUDER_MIN_BOX_SIZE = 2.0f;
+	const float OCCLUDER_MIN_PLANE_SIZE = 5.0f;
+
+	// largest gap between a detail level and the true surface,
+	// in pixels, that is accepted
+	const float LOD_MAX_SCREEN_ERROR = 0.5f;
+	// a coarser level is only switched to once its error falls
+	// this far below the limit, so that objects near the limit
+	// do not pop back and forth
+	const float LOD_HYSTERESIS = 0.75f;
+
+	// most bytes of decoded texture images, with their
+	// mipmaps, uploaded in one frame
+	const size_t TEXTURE_UPLOAD_BUDGET = 8 * 1024 * 1024;
+	// default bytes the streamed texture levels may take,
+	// sized for the low-end targets
+	const size_t TEXTURE_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+	// space left between the copies of a replicated scene
+	const float REPLICA_GAP = 2.0f;
 }
 
 /***********************************************************
@@ -31,11 +74,36 @@ namespace
  *
  *  The constructor for the class
  ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
+SceneManager::SceneManager(ShaderManager *pShaderManager, ShaderUniforms *pShaderUniforms)
 {
 	m_pShaderManager = pShaderManager;
+	m_pShaderUniforms = pShaderUniforms;
 	m_basicMeshes = new ShapeMeshes();
+	m_instancedMeshes = new InstancedMeshes();
+	m_meshBuffer = new MeshMegaBuffer();
+	m_materialBuffer = new MaterialBuffer();
+	m_lightManager = new LightManager();
+	m_stateCache.SetShaderUniforms(pShaderUniforms);
+	m_instancedMeshes->SetStateCache(&m_stateCache);
+	m_meshBuffer->SetStateCache(&m_stateCache);
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_bViewTransformSet = false;
+	m_viewportWidth = 0;
+	m_viewportHeight = 0;
+	m_bUseInstancing = true;
+	m_bUseIndirectDraws = true;
+	m_bUseCulling = true;
+	m_bUseOcclusionCulling = true;
+	m_bOcclusionCullStarted = false;
+	m_bUseLod = true;
+	m_lodStats.fullTriangles = 0;
+	m_lodStats.drawnTriangles = 0;
+	m_lodStats.reducedObjects = 0;
 	m_loadedTextures = 0; // Initialize
+	m_placeholderTexture = -1;
+	m_textureStreamer.SetBudget(TEXTURE_MEMORY_BUDGET);
+	m_textureArrays.SetStreamedBudget(TEXTURE_MEMORY_BUDGET);
 }
 
 /***********************************************************
@@ -46,24 +114,243 @@ SceneManager::SceneManager(ShaderManager *pShaderManager)
 SceneManager::~SceneManager()
 {
 	m_pShaderManager = NULL;
+	m_pShaderUniforms = NULL;
 	delete m_basicMeshes;
 	m_basicMeshes = NULL;
+	delete m_instancedMeshes;
+	m_instancedMeshes = NULL;
+	delete m_meshBuffer;
+	m_meshBuffer = NULL;
+	delete m_materialBuffer;
+	m_materialBuffer = NULL;
+	delete m_lightManager;
+	m_lightManager = NULL;
+
+	// free the texture arrays while the context still exists
+	DestroyGLTextures();
+}
+
+/***********************************************************
+ *  FindCookedTexture()
+ *
+ *  This method is used for finding the block compressed
+ *  KTX2 file that the texture cooker made from an image
+ *  file.  It is only used when its source hash still
+ *  matches the hash of the image file, it has every mipmap
+ *  level and the context supports its block format.
+ ***********************************************************/
+bool SceneManager::FindCookedTexture(
+	const char* filename,
+	uint64_t sourceHash,
+	std::string& outPath,
+	KtxFile::KTX_INFO& outInfo) const
+{
+	outPath = KtxFile::GetCookedPath(filename);
+	if (KtxFile::ReadInfo(outPath.c_str(), outInfo) == false)
+	{
+		return(false);
+	}
+
+	if ((TextureLoader::GetCompressedFormat(outInfo.vkFormat) == 0) ||
+		(outInfo.levelCount != ImageMipmaps::GetLevelCount(outInfo.width, outInfo.height)))
+	{
+		return(false);
+	}
+
+	if ((sourceHash == 0) || (outInfo.sourceHash != sourceHash))
+	{
+		std::cout << "INFO: Cooked texture is out of date:" << outPath << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindLoadedTexture()
+ *
+ *  This method is used for answering a load of an image
+ *  file that is already loaded with the texture it made,
+ *  instead of decoding and uploading the file again.  The
+ *  tag of the load is pointed at that texture as well.
+ ***********************************************************/
+int SceneManager::FindLoadedTexture(const std::string& canonicalPath, uint64_t contentHash, const std::string& tag)
+{
+	if (contentHash == 0)
+	{
+		return(-1);
+	}
+
+	int textureHandle = m_textureRegistry.Acquire(canonicalPath, contentHash);
+	if (textureHandle >= 0)
+	{
+		m_textureHandles.emplace(tag, textureHandle);
+	}
+
+	return(textureHandle);
+}
+
+/***********************************************************
+ *  RegisterTexture()
+ *
+ *  This method is used for recording a texture handle with
+ *  its tag and the image file it was loaded from.  The
+ *  first texture loaded for a tag keeps the tag.
+ ***********************************************************/
+void SceneManager::RegisterTexture(
+	int textureHandle,
+	const std::string& tag,
+	const std::string& canonicalPath,
+	uint64_t contentHash,
+	bool bTranslucent,
+	bool bResident)
+{
+	TEXTURE_INFO textureInfo;
+	textureInfo.ID = 0;
+	textureInfo.tag = tag;
+	textureInfo.bTranslucent = bTranslucent;
+	textureInfo.bResident = bResident;
+	m_textureIDs.push_back(textureInfo);
+
+	m_textureRegistry.Register(textureHandle, canonicalPath, contentHash);
+	m_loadedTextures = m_textureRegistry.GetLiveCount();
+
+	m_textureHandles.emplace(tag, textureHandle);
+}
+
+/***********************************************************
+ *  ReleaseGLTexture()
+ *
+ *  This method is used for dropping a reference on a
+ *  texture.  Once the last reference is gone the texture
+ *  stops being drawn, its tags are forgotten and its layer
+ *  is freed for the next texture of its size, which deletes
+ *  its array texture when no other texture is left in it.
+ *  The objects that were drawn with it keep their color.
+ ***********************************************************/
+void SceneManager::ReleaseGLTexture(int textureHandle)
+{
+	if (m_textureRegistry.Release(textureHandle) == false)
+	{
+		return;
+	}
+
+	m_textureStreamer.RemoveTexture(textureHandle);
+	m_textureArrays.ReleaseImage(textureHandle);
+	m_textureIDs[textureHandle].ID = 0;
+	m_textureIDs[textureHandle].bResident = false;
+	m_loadedTextures = m_textureRegistry.GetLiveCount();
+
+	std::unordered_map<std::string, int>::iterator tagIter = m_textureHandles.begin();
+	while (tagIter != m_textureHandles.end())
+	{
+		if (tagIter->second == textureHandle)
+		{
+			tagIter = m_textureHandles.erase(tagIter);
+		}
+		else
+		{
+			++tagIter;
+		}
+	}
+
+	if (textureHandle == m_placeholderTexture)
+	{
+		m_placeholderTexture = -1;
+	}
+
+	for (int i = 0; i < (int)m_sceneObjects.size(); i++)
+	{
+		if (m_sceneObjects[i].textureHandle == textureHandle)
+		{
+			m_sceneObjects[i].textureHandle = -1;
+		}
+	}
+
+	// a deleted array is unbound behind the cache, so the
+	// arrays are bound again
+	m_stateCache.InvalidateTextures();
+	if (m_textureArrays.IsBindless() == false)
+	{
+		m_textureArrays.BindArrays(&m_stateCache);
+	}
+}
+
+/***********************************************************
+ *  ReleaseTexture()
+ *
+ *  This method is used for dropping the reference a texture
+ *  load took under a tag, such as when an object is given
+ *  another texture or a part of the scene is taken down.
+ *  The tag is forgotten right away, and the texture is
+ *  freed once no other tag holds it.  The textures still
+ *  held at shutdown are freed by DestroyGLTextures().
+ ***********************************************************/
+void SceneManager::ReleaseTexture(std::string textureTag)
+{
+	int textureHandle = FindTextureSlot(textureTag);
+	if (textureHandle < 0)
+	{
+		return;
+	}
+
+	m_textureHandles.erase(textureTag);
+	ReleaseGLTexture(textureHandle);
 }
 
 /***********************************************************
  *  CreateGLTexture()
  *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
+ *  This method is used for loading textures from image files
+ *  and adding them to the texture array of their size and
+ *  format.  An up to date cooked KTX2 file next to the image
+ *  is used instead when there is one, and an image file that
+ *  is already loaded returns its texture.  The array textures
+ *  themselves are created by BindGLTextures() once every
+ *  texture has been loaded.  The returned handle indexes
+ *  m_textureIDs, or is -1 when loading failed.
  ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+int SceneManager::CreateGLTexture(const char* filename, std::string tag)
 {
 	int width = 0;
 	int height = 0;
 	int colorChannels = 0;
-	GLuint textureID = 0;
+
+	std::string canonicalPath = TextureRegistry::GetCanonicalPath(filename);
+	uint64_t contentHash = KtxFile::HashFile(filename);
+	int loadedHandle = FindLoadedTexture(canonicalPath, contentHash, tag);
+	if (loadedHandle >= 0)
+	{
+		return(loadedHandle);
+	}
+
+	// small images are packed into an atlas page, which holds
+	// uncompressed texels, so their cooked files are not used
+	bool bAtlas = TextureLoader::ReadImageInfo(filename, width, height, colorChannels) &&
+		m_textureArrays.IsAtlasCandidate(width, height);
+
+	std::string cookedPath;
+	KtxFile::KTX_INFO cookedInfo;
+	if ((bAtlas == false) && FindCookedTexture(filename, contentHash, cookedPath, cookedInfo))
+	{
+		KtxFile::KTX_IMAGE cookedImage;
+		if (KtxFile::Read(cookedPath.c_str(), cookedImage))
+		{
+			int textureHandle = m_textureArrays.AddCompressedImage(
+				cookedImage.data.data(),
+				cookedImage.data.size(),
+				cookedImage.info.width,
+				cookedImage.info.height,
+				TextureLoader::GetCompressedFormat(cookedImage.info.vkFormat));
+			if (textureHandle >= 0)
+			{
+				std::cout << "Successfully loaded cooked texture:" << cookedPath << ", width:" << cookedImage.info.width << ", height:" << cookedImage.info.height << ", levels:" << cookedImage.info.levelCount << std::endl;
+				RegisterTexture(textureHandle, tag, canonicalPath, contentHash, (cookedImage.info.sourceChannels == 4), true);
+				return(textureHandle);
+			}
+		}
+		// fall back to the source image
+	}
 
 	// indicate to always flip images vertically when loaded
 	stbi_set_flip_vertically_on_load(true);
@@ -81,287 +368,1604 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 	{
 		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
 
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST); // AH: Noise Reduction
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
+		// copy the image into a layer of the matching array
+		int textureHandle = m_textureArrays.AddImage(image, width, height, colorChannels);
 
 		// free the image data from local memory
 		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+		if (textureHandle < 0)
+		{
+			return(-1);
+		}
 
 		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
+		RegisterTexture(textureHandle, tag, canonicalPath, contentHash, (colorChannels == 4), true);
 
-		return true;
+		return(textureHandle);
 	}
 
 	std::cout << "Could not load image:" << filename << std::endl;
 
 	// Error loading the image
-	return false;
+	return(-1);
+}
+
+/***********************************************************
+ *  LoadGLTextureAsync()
+ *
+ *  This method is used for loading a texture in the
+ *  background.  Only the image header is read here, to
+ *  reserve the layer of the texture; the image is decoded
+ *  on a worker thread and uploaded by a later frame, and
+ *  the placeholder texture is drawn until then.  A cooked
+ *  KTX2 file is preferred and an image file that is already
+ *  loaded returns its texture, as in CreateGLTexture().  An
+ *  image small enough for the atlas is loaded right away
+ *  instead, so it can be packed when the arrays are built.
+ *  The rest are streamed: only their small levels are
+ *  loaded at first, and the finer ones follow as the view
+ *  needs them.
+ *  The returned handle can be used right away, or is -1
+ *  when the image could not be read.
+ ***********************************************************/
+int SceneManager::LoadGLTextureAsync(const char* filename, std::string tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	std::string canonicalPath = TextureRegistry::GetCanonicalPath(filename);
+	uint64_t contentHash = KtxFile::HashFile(filename);
+	int loadedHandle = FindLoadedTexture(canonicalPath, contentHash, tag);
+	if (loadedHandle >= 0)
+	{
+		return(loadedHandle);
+	}
+
+	if (TextureLoader::ReadImageInfo(filename, width, height, colorChannels) &&
+		m_textureArrays.IsAtlasCandidate(width, height))
+	{
+		return(CreateGLTexture(filename, tag));
+	}
+
+	std::string cookedPath;
+	KtxFile::KTX_INFO cookedInfo;
+	if (FindCookedTexture(filename, contentHash, cookedPath, cookedInfo))
+	{
+		int textureHandle = m_textureArrays.ReserveStreamedImage(
+			cookedInfo.width,
+			cookedInfo.height,
+			cookedInfo.sourceChannels,
+			TextureLoader::GetCompressedFormat(cookedInfo.vkFormat));
+		if (textureHandle >= 0)
+		{
+			RegisterTexture(textureHandle, tag, canonicalPath, contentHash, (cookedInfo.sourceChannels == 4), false);
+			m_textureStreamer.AddTexture(
+				textureHandle, cookedPath, true,
+				cookedInfo.width, cookedInfo.height,
+				m_textureArrays, m_textureLoader);
+			return(textureHandle);
+		}
+	}
+
+	if (TextureLoader::ReadImageInfo(filename, width, height, colorChannels) == false)
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(-1);
+	}
+
+	int textureHandle = m_textureArrays.ReserveStreamedImage(width, height, colorChannels, 0);
+	if (textureHandle < 0)
+	{
+		return(-1);
+	}
+
+	// register the texture and associate it with the special tag string
+	RegisterTexture(textureHandle, tag, canonicalPath, contentHash, (colorChannels == 4), false);
+
+	m_textureStreamer.AddTexture(
+		textureHandle, filename, false,
+		width, height,
+		m_textureArrays, m_textureLoader);
+
+	return(textureHandle);
+}
+
+/***********************************************************
+ *  UpdateTextureStreaming()
+ *
+ *  This method is used for uploading the textures that the
+ *  worker threads have decoded, within the upload budget of
+ *  a frame, and making them resident.  A texture that could
+ *  not be decoded keeps using the placeholder.  The streamer
+ *  first evicts and requests levels for the densities the
+ *  last frame asked for.
+ ***********************************************************/
+void SceneManager::UpdateTextureStreaming()
+{
+	m_textureStreamer.Update(m_textureArrays, m_textureLoader);
+
+	if (m_textureLoader.GetPendingCount() == 0)
+	{
+		return;
+	}
+
+	std::vector<TextureLoader::UPLOAD_RESULT> results;
+	if (m_textureLoader.UploadCompleted(m_textureArrays, TEXTURE_UPLOAD_BUDGET, results) == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < results.size(); i++)
+	{
+		// the texture may have been released while it loaded
+		if (m_textureRegistry.GetRefCount(results[i].textureHandle) == 0)
+		{
+			continue;
+		}
+
+		TEXTURE_INFO& textureInfo = m_textureIDs[results[i].textureHandle];
+		if (m_textureStreamer.IsStreamed(results[i].textureHandle))
+		{
+			// a failed finer level leaves the base levels drawn
+			textureInfo.bResident = m_textureStreamer.OnUploaded(results[i], m_textureArrays);
+		}
+		else
+		{
+			textureInfo.bResident = results[i].bLoaded;
+		}
+		if (results[i].bLoaded == false)
+		{
+			std::cout << "Could not load image for texture:" << textureInfo.tag << std::endl;
+		}
+	}
+
+	// the uploads bound the arrays directly
+	m_stateCache.InvalidateTextures();
+	if (m_textureArrays.IsBindless() == false)
+	{
+		m_textureArrays.BindArrays(&m_stateCache);
+	}
+}
+
+/***********************************************************
+ *  RequestTextureLevel()
+ *
+ *  This method is used for asking the streamer for the
+ *  level of the texture of a visible object.  The texture
+ *  is taken to span the bounds of the object UVscale times
+ *  over, so the texture coordinates per pixel follow from
+ *  the projected diameter of the bounds.  An object the
+ *  camera is inside of asks for the finest level.
+ ***********************************************************/
+void SceneManager::RequestTextureLevel(int objectIndex, const glm::mat4& viewProjection, float pixelsPerUnit)
+{
+	const SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+	if ((m_textureStreamer.IsStreamed(object.textureHandle) == false) ||
+		(m_frustumCuller.IsBounded(objectIndex) == false))
+	{
+		return;
+	}
+
+	FrustumCuller::BOUNDS_STREAMS streams = m_frustumCuller.GetStreams();
+	glm::vec3 center = glm::vec3(streams.centerX[objectIndex], streams.centerY[objectIndex], streams.centerZ[objectIndex]);
+	glm::vec3 extent = glm::vec3(streams.extentX[objectIndex], streams.extentY[objectIndex], streams.extentZ[objectIndex]);
+	float projectedRadius = GetProjectedRadius(center, glm::length(extent), viewProjection, pixelsPerUnit);
+
+	float uvPerPixel = 0.0f;
+	if (projectedRadius >= 0.0f)
+	{
+		float projectedDiameter = std::max(2.0f * projectedRadius, 1.0f);
+		uvPerPixel = std::max(object.UVscale.x, object.UVscale.y) / projectedDiameter;
+	}
+
+	m_textureStreamer.RequestDensity(object.textureHandle, uvPerPixel);
+}
+
+/***********************************************************
+ *  GetPixelsPerUnit()
+ *
+ *  This method is used for getting the pixels covered by
+ *  one unit at a clip w of one, which is the same for the
+ *  perspective and orthographic matrices.  The viewport is
+ *  read from OpenGL the first time, unless it was set.
+ ***********************************************************/
+float SceneManager::GetPixelsPerUnit()
+{
+	if (m_viewportHeight <= 0)
+	{
+		GLint viewport[4] = { 0, 0, 0, 0 };
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		m_viewportWidth = viewport[2];
+		m_viewportHeight = viewport[3];
+	}
+
+	return(m_projectionMatrix[1][1] * 0.5f * (float)m_viewportHeight);
+}
+
+/***********************************************************
+ *  GetProjectedRadius()
+ *
+ *  This method is used for getting the radius in pixels of
+ *  a bounding sphere on the screen.  A perspective matrix
+ *  divides the size by the clip w of the center, and -1 is
+ *  returned when the camera is at or inside the sphere.  An
+ *  orthographic matrix has a clip w of one everywhere, so
+ *  the size does not depend on the distance.
+ ***********************************************************/
+float SceneManager::GetProjectedRadius(
+	const glm::vec3& center,
+	float radius,
+	const glm::mat4& viewProjection,
+	float pixelsPerUnit) const
+{
+	// perspective projections have -1 in the w row of column 2
+	if (m_projectionMatrix[2][3] == 0.0f)
+	{
+		return(radius * pixelsPerUnit);
+	}
+
+	float w = (viewProjection * glm::vec4(center, 1.0f)).w;
+	if (w <= radius)
+	{
+		return(-1.0f);
+	}
+
+	return((radius * pixelsPerUnit) / w);
+}
+
+/***********************************************************
+ *  ResolveTextureHandle()
+ *
+ *  This method is used for getting the texture to draw for
+ *  a texture handle, which is the placeholder texture while
+ *  the texture is still being loaded.
+ ***********************************************************/
+int SceneManager::ResolveTextureHandle(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_textureIDs.size()))
+	{
+		return(-1);
+	}
+	if (m_textureIDs[textureHandle].bResident)
+	{
+		return(textureHandle);
+	}
+
+	return(m_placeholderTexture);
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for creating the texture arrays from
+ *  the loaded textures and binding each array to the
+ *  OpenGL texture slot of its index.  When the context has
+ *  bindless textures the arrays are made resident instead,
+ *  and no slots are used.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_textureArrays.Build();
+
+	for (int i = 0; i < m_textureIDs.size(); i++)
+	{
+		m_textureIDs[i].ID = m_textureArrays.GetArrayID(m_textureArrays.GetArrayIndex(i));
+	}
+
+	// the arrays were bound directly while they were built
+	m_stateCache.Invalidate();
+
+	if (TextureArrays::IsBindlessSupported() && m_textureArrays.EnableBindless())
+	{
+		std::cout << "INFO: Sampling " << m_textureArrays.GetArrayCount()
+			<< " texture arrays through bindless handles" << std::endl;
+	}
+	else
+	{
+		m_textureArrays.BindArrays(&m_stateCache);
+	}
+
+	if (NULL != m_pShaderUniforms)
+	{
+		m_stateCache.setBoolValue(m_uniforms.useBindlessTextures, m_textureArrays.IsBindless());
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory of the
+ *  texture arrays, along with the images still waiting to
+ *  be uploaded, whatever references are still held.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	if (m_textureRegistry.GetLiveCount() > 0)
+	{
+		std::cout << "INFO: Destroying " << m_textureRegistry.GetLiveCount() << " textures, "
+			<< m_textureRegistry.GetDuplicateLoadCount() << " duplicate loads were shared" << std::endl;
+	}
+
+	m_textureLoader.CancelAll();
+	m_textureStreamer.Clear();
+	m_textureArrays.Destroy();
+	m_textureRegistry.Clear();
+	m_textureIDs.clear();
+	m_textureHandles.clear();
+	m_loadedTextures = 0;
+	m_placeholderTexture = -1;
+	m_stateCache.InvalidateTextures();
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(const std::string& tag)
+{
+	int textureID = -1;
+	int textureSlot = FindTextureSlot(tag);
+
+	if (textureSlot >= 0)
+	{
+		textureID = m_textureIDs[textureSlot].ID;
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const std::string& tag)
+{
+	int textureSlot = -1;
+
+	std::unordered_map<std::string, int>::const_iterator found = m_textureHandles.find(tag);
+	if (found != m_textureHandles.end())
+	{
+		textureSlot = found->second;
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material)
+{
+	int materialIndex = FindMaterialIndex(tag);
+	if (materialIndex < 0)
+	{
+		return(false);
+	}
+
+	material = m_objectMaterials[materialIndex];
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddObjectMaterial()
+ *
+ *  This method is used for adding a material to the defined
+ *  materials list and interning its tag.  The returned
+ *  handle is the index of the material in the material
+ *  buffer, and it stays the same for the life of the scene.
+ ***********************************************************/
+int SceneManager::AddObjectMaterial(const OBJECT_MATERIAL& material)
+{
+	int materialHandle = (int)m_objectMaterials.size();
+
+	m_objectMaterials.push_back(material);
+	m_materialHandles.emplace(material.tag, materialHandle);
+
+	return(materialHandle);
+}
+
+/***********************************************************
+ *  ResolveShaderUniforms()
+ *
+ *  This method is used for resolving the names of the
+ *  uniforms that are set while drawing into handles, once
+ *  after the shader program has been reflected, and making
+ *  the program current so the uniforms can be set.
+ ***********************************************************/
+void SceneManager::ResolveShaderUniforms()
+{
+	if (NULL != m_pShaderManager)
+	{
+		m_stateCache.UseProgram(m_pShaderManager->m_programID);
+	}
+
+	if (NULL == m_pShaderUniforms)
+	{
+		return;
+	}
+
+	m_uniforms.model = m_pShaderUniforms->GetHandle(g_ModelName);
+	m_uniforms.objectColor = m_pShaderUniforms->GetHandle(g_ColorValueName);
+	m_uniforms.objectTexture = m_pShaderUniforms->GetHandle(g_TextureValueName);
+	m_uniforms.useTexture = m_pShaderUniforms->GetHandle(g_UseTextureName);
+	m_uniforms.textureLayer = m_pShaderUniforms->GetHandle(g_TextureLayerName);
+	m_uniforms.textureRect = m_pShaderUniforms->GetHandle(g_TextureRectName);
+	m_uniforms.useBindlessTextures = m_pShaderUniforms->GetHandle(g_UseBindlessTexturesName);
+	m_uniforms.useLighting = m_pShaderUniforms->GetHandle(g_UseLightingName);
+	m_uniforms.useInstancing = m_pShaderUniforms->GetHandle(g_UseInstancingName);
+	m_uniforms.useDrawBuffer = m_pShaderUniforms->GetHandle(g_UseDrawBufferName);
+	m_uniforms.UVscale = m_pShaderUniforms->GetHandle("UVscale");
+	m_uniforms.materialIndex = m_pShaderUniforms->GetHandle(g_MaterialIndexName);
+	m_uniforms.clusterTileSize = m_pShaderUniforms->GetHandle(g_ClusterTileSizeName);
+	m_uniforms.clusterDepthParams = m_pShaderUniforms->GetHandle(g_ClusterDepthParamsName);
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	glm::mat4 modelView = Transform::ComposeModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	if (NULL != m_pShaderUniforms)
+	{
+		m_stateCache.setMat4Value(m_uniforms.model, modelView);
+	}
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	if (NULL != m_pShaderUniforms)
+	{
+		m_stateCache.setIntValue(m_uniforms.useTexture, false);
+		m_stateCache.setVec4Value(m_uniforms.objectColor, currentColor);
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	std::string textureTag)
+{
+	SetShaderTexture(FindTextureSlot(textureTag));
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture of a handle
+ *  returned by CreateGLTexture() into the shader, without
+ *  looking up the tag.  The texture coordinates are mapped
+ *  into the rectangle of the texture when it is in an atlas
+ *  page, so the UV scale set for the draw still tiles it.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureHandle)
+{
+	textureHandle = ResolveTextureHandle(textureHandle);
+	int textureUnit = m_textureArrays.GetTextureUnit(textureHandle);
+
+	if ((NULL != m_pShaderUniforms) && (textureHandle >= 0) && (textureUnit >= 0))
+	{
+		m_stateCache.setIntValue(m_uniforms.useTexture, true);
+		m_stateCache.setSampler2DValue(m_uniforms.objectTexture, textureUnit);
+		m_stateCache.setIntValue(m_uniforms.textureLayer, m_textureArrays.GetShaderLayer(textureHandle));
+		m_stateCache.setVec4Value(m_uniforms.textureRect, m_textureArrays.GetUVRect(textureHandle));
+	}
+	else if (NULL != m_pShaderUniforms)
+	{
+		// the texture has no unit to be sampled from
+		m_stateCache.setIntValue(m_uniforms.useTexture, false);
+	}
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	if (NULL != m_pShaderUniforms)
+	{
+		m_stateCache.setVec2Value(m_uniforms.UVscale, glm::vec2(u, v));
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting a material from the
+ *  material buffer for the next draw command.  The material
+ *  values are already in the shader, so only the index of
+ *  the material is passed in.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	std::string materialTag)
+{
+	SetShaderMaterial(FindMaterialIndex(materialTag));
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting the material of a
+ *  handle returned by AddObjectMaterial(), without looking
+ *  up the tag.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	int materialHandle)
+{
+	if ((materialHandle >= 0) && (NULL != m_pShaderUniforms))
+	{
+		m_stateCache.setIntValue(m_uniforms.materialIndex, materialHandle);
+	}
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a previously
+ *  defined material that is associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag)
+{
+	int materialIndex = -1;
+
+	std::unordered_map<std::string, int>::const_iterator found = m_materialHandles.find(tag);
+	if (found != m_materialHandles.end())
+	{
+		materialIndex = found->second;
+	}
+
+	return(materialIndex);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the basic shape mesh
+ *  referenced by a draw packet.
+ ***********************************************************/
+void SceneManager::DrawMesh(int meshType)
+{
+	switch (meshType)
+	{
+	case MESH_BOX:
+		m_basicMeshes->DrawBoxMesh();
+		break;
+	case MESH_PLANE:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case MESH_PRISM:
+		m_basicMeshes->DrawPrismMesh();
+		break;
+	case MESH_CYLINDER:
+		m_basicMeshes->DrawCylinderMesh();
+		break;
+	default:
+		break;
+	}
+
+	// the basic meshes bind their own vertex arrays
+	m_stateCache.InvalidateVertexArray();
+}
+
+/***********************************************************
+ *  AddSceneObject()
+ *
+ *  This method is used for adding a basic mesh along with
+ *  its transformations and shader settings to the scene.
+ *  An empty texture tag draws the mesh with the passed in
+ *  color instead.  The tags are resolved into handles here
+ *  so that drawing the object never compares strings.
+ ***********************************************************/
+void SceneManager::AddSceneObject(
+	int meshType,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ,
+	glm::vec4 color,
+	std::string textureTag,
+	glm::vec2 UVscale,
+	std::string materialTag)
+{
+	SCENE_OBJECT object;
+
+	object.meshType = meshType;
+	object.transform.SetScale(scaleXYZ);
+	object.transform.SetRotation(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+	object.transform.SetPosition(positionXYZ);
+	object.color = color;
+	object.textureHandle = (textureTag.length() > 0) ? FindTextureSlot(textureTag) : -1;
+	object.UVscale = UVscale;
+	object.materialHandle = FindMaterialIndex(materialTag);
+	object.lod = 0;
+	object.bOccluder = false;
+	if (meshType == MESH_BOX)
+	{
+		object.bOccluder =
+			(scaleXYZ.x >= OCCLUDER_MIN_BOX_SIZE) &&
+			(scaleXYZ.y >= OCCLUDER_MIN_BOX_SIZE) &&
+			(scaleXYZ.z >= OCCLUDER_MIN_BOX_SIZE);
+	}
+	else if (meshType == MESH_PLANE)
+	{
+		object.bOccluder =
+			(scaleXYZ.x >= OCCLUDER_MIN_PLANE_SIZE) &&
+			(scaleXYZ.z >= OCCLUDER_MIN_PLANE_SIZE);
+	}
+
+	m_sceneObjects.push_back(object);
+}
+
+/***********************************************************
+ *  ReplicateScene()
+ *
+ *  This method is used for repeating the defined scene
+ *  objects on a grid, so that the cost of the renderer can
+ *  be measured as the object count grows.  The first copy
+ *  is the original scene; the others are placed to its
+ *  right and behind it, spaced by the size of the scene.
+ ***********************************************************/
+void SceneManager::ReplicateScene(int copies)
+{
+	int baseCount = (int)m_sceneObjects.size();
+	if ((copies <= 1) || (baseCount == 0))
+	{
+		return;
+	}
+
+	// bounds of the original scene on the ground
+	glm::vec3 minXYZ = glm::vec3(FLT_MAX);
+	glm::vec3 maxXYZ = glm::vec3(-FLT_MAX);
+	for (int i = 0; i < baseCount; i++)
+	{
+		const MESH_BOUNDS& bounds = GetMeshBounds(m_sceneObjects[i].meshType);
+		if (bounds.bValid == false)
+		{
+			continue;
+		}
+		const glm::mat4& model = m_sceneObjects[i].transform.GetModelMatrix();
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec3 point = glm::vec3(
+				(corner & 1) ? bounds.maxXYZ.x : bounds.minXYZ.x,
+				(corner & 2) ? bounds.maxXYZ.y : bounds.minXYZ.y,
+				(corner & 4) ? bounds.maxXYZ.z : bounds.minXYZ.z);
+			glm::vec3 world = glm::vec3(model * glm::vec4(point, 1.0f));
+			minXYZ = glm::min(minXYZ, world);
+			maxXYZ = glm::max(maxXYZ, world);
+		}
+	}
+	if (minXYZ.x > maxXYZ.x)
+	{
+		return;
+	}
+
+	float spacingX = (maxXYZ.x - minXYZ.x) + REPLICA_GAP;
+	float spacingZ = (maxXYZ.z - minXYZ.z) + REPLICA_GAP;
+	int columns = (int)std::ceil(std::sqrt((float)copies));
+
+	m_sceneObjects.reserve((size_t)baseCount * copies);
+	for (int copy = 1; copy < copies; copy++)
+	{
+		glm::vec3 offset = glm::vec3(
+			(float)(copy % columns) * spacingX,
+			0.0f,
+			-(float)(copy / columns) * spacingZ);
+		for (int i = 0; i < baseCount; i++)
+		{
+			SCENE_OBJECT object = m_sceneObjects[i];
+			object.transform.SetPosition(object.transform.GetPosition() + offset);
+			m_sceneObjects.push_back(object);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetSceneObjectCount()
+ *
+ *  This method is used for getting the number of objects
+ *  in the scene.
+ ***********************************************************/
+int SceneManager::GetSceneObjectCount() const
+{
+	return((int)m_sceneObjects.size());
+}
+
+/***********************************************************
+ *  UpdateDirtyTransforms()
+ *
+ *  This method is used for composing the model matrices of
+ *  every scene object whose transformation changed since its
+ *  matrix was built.  The changed values are gathered into
+ *  the structure of arrays batch table so that the SIMD
+ *  kernels can compose them together.
+ ***********************************************************/
+void SceneManager::UpdateDirtyTransforms()
+{
+	m_transformBatch.Clear();
+	m_batchObjects.clear();
+
+	// objects added since the last frame need their bounds set
+	// even when their transformation was left at the defaults
+	int boundedObjects = m_frustumCuller.GetCount();
+	if (boundedObjects != m_sceneObjects.size())
+	{
+		m_frustumCuller.Resize(m_sceneObjects.size());
+	}
+	for (int i = boundedObjects; i < m_sceneObjects.size(); i++)
+	{
+		if (m_sceneObjects[i].transform.IsDirty() == false)
+		{
+			UpdateObjectBounds(i);
+		}
+	}
+
+	for (int i = 0; i < m_sceneObjects.size(); i++)
+	{
+		Transform& transform = m_sceneObjects[i].transform;
+		if (transform.IsDirty())
+		{
+			glm::vec3 rotationDegrees = transform.GetRotation();
+			m_transformBatch.Add(
+				transform.GetScale(),
+				rotationDegrees.x,
+				rotationDegrees.y,
+				rotationDegrees.z,
+				transform.GetPosition());
+			m_batchObjects.push_back(i);
+		}
+	}
+
+	if (m_batchObjects.size() == 0)
+	{
+		return;
+	}
+
+	m_batchMatrices.resize(m_batchObjects.size());
+	m_transformBatch.Compose(m_batchMatrices.data());
+
+	for (int i = 0; i < m_batchObjects.size(); i++)
+	{
+		m_sceneObjects[m_batchObjects[i]].transform.SetCachedModelMatrix(m_batchMatrices[i]);
+		UpdateObjectBounds(m_batchObjects[i]);
+	}
+}
+
+/***********************************************************
+ *  UpdateObjectBounds()
+ *
+ *  This method is used for setting the world bounding box
+ *  of a scene object from the object space box of its mesh
+ *  and its cached model matrix.  The mesh boxes are built
+ *  from the shape geometry the first time a type is used.
+ ***********************************************************/
+void SceneManager::UpdateObjectBounds(int objectIndex)
+{
+	SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+	const MESH_BOUNDS& bounds = GetMeshBounds(object.meshType);
+
+	if (bounds.bValid)
+	{
+		m_frustumCuller.SetBounds(
+			objectIndex,
+			object.transform.GetModelMatrix(),
+			bounds.minXYZ,
+			bounds.maxXYZ);
+	}
+	else
+	{
+		m_frustumCuller.SetUnbounded(objectIndex);
+	}
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the object space bounding
+ *  box of a mesh type.  The boxes are built from the shape
+ *  geometry the first time a type is used.
+ ***********************************************************/
+const SceneManager::MESH_BOUNDS& SceneManager::GetMeshBounds(int meshType)
+{
+	std::unordered_map<int, MESH_BOUNDS>::iterator found = m_meshBounds.find(meshType);
+	if (found == m_meshBounds.end())
+	{
+		MESH_BOUNDS bounds;
+		bounds.bValid = ShapeGeometry::GetMeshBounds(meshType, bounds.minXYZ, bounds.maxXYZ);
+		found = m_meshBounds.emplace(meshType, bounds).first;
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  IsObjectOpaque()
+ *
+ *  This method is used for checking that an object hides
+ *  everything behind it.  A texture with an alpha channel,
+ *  blended or cut out, or a flat color that is not fully
+ *  opaque lets the objects behind it show through.  The
+ *  texture the object is waiting for is checked as well as
+ *  the one drawn now, so an occluder does not change when
+ *  the texture finishes loading.
+ ***********************************************************/
+bool SceneManager::IsObjectOpaque(const SCENE_OBJECT& object) const
+{
+	if ((object.textureHandle >= 0) && (object.textureHandle < (int)m_textureIDs.size()))
+	{
+		int textureHandle = ResolveTextureHandle(object.textureHandle);
+		return((m_textureIDs[object.textureHandle].bTranslucent == false) &&
+			((textureHandle < 0) || (m_textureIDs[textureHandle].bTranslucent == false)));
+	}
+
+	return(object.color.a >= 1.0f);
+}
+
+/***********************************************************
+ *  BeginOcclusionCull()
+ *
+ *  This method is used for handing the occluders that passed
+ *  the frustum test to the occlusion culler and starting the
+ *  cull on its worker thread.  It is called once the frame
+ *  is submitted, and the next frame uses the results.  Only
+ *  opaque objects are used, so nothing seen through a cut
+ *  out or blended surface is culled.
+ ***********************************************************/
+void SceneManager::BeginOcclusionCull()
+{
+	m_occlusionCuller.ClearOccluders();
+	for (int i = 0; i < m_sceneObjects.size(); i++)
+	{
+		SCENE_OBJECT& object = m_sceneObjects[i];
+		if ((object.bOccluder == false) ||
+			(m_frustumCuller.IsVisible(i) == false) ||
+			(IsObjectOpaque(object) == false))
+		{
+			continue;
+		}
+
+		const MESH_BOUNDS& bounds = GetMeshBounds(object.meshType);
+		if (bounds.bValid)
+		{
+			m_occlusionCuller.AddOccluder(object.transform.GetModelMatrix(), bounds.minXYZ, bounds.maxXYZ);
+		}
+	}
+
+	m_occlusionCuller.BeginCull(m_projectionMatrix * m_viewMatrix, &m_frustumCuller);
+	m_bOcclusionCullStarted = true;
+}
+
+/***********************************************************
+ *  FinishOcclusionCull()
+ *
+ *  This method is used for collecting the occlusion cull
+ *  that the last frame started once it was submitted.  It
+ *  must be called before the bounds are changed, since the
+ *  worker thread reads them.  Returns false when no cull
+ *  was started, so there are no results to use.
+ ***********************************************************/
+bool SceneManager::FinishOcclusionCull()
+{
+	if (m_bOcclusionCullStarted == false)
+	{
+		return(false);
+	}
+
+	m_occlusionCuller.FinishCull();
+	m_bOcclusionCullStarted = false;
+
+	return(true);
+}
+
+/***********************************************************
+ *  SubmitDrawPacket()
+ *
+ *  This method is used for queueing a scene object for
+ *  drawing.  The cached model matrix of the object is used,
+ *  so no matrix math is done unless the object was moved,
+ *  and the interned handles are used instead of the tags.
+ ***********************************************************/
+void SceneManager::SubmitDrawPacket(SCENE_OBJECT& object)
+{
+	RenderQueue::DRAW_PACKET packet;
+
+	packet.sortKey = 0;
+	packet.program = (NULL != m_pShaderManager) ? m_pShaderManager->m_programID : 0;
+	packet.meshType = object.meshType;
+	packet.lod = object.lod;
+	packet.textureSlot = -1;
+	packet.textureLayer = 0;
+	packet.textureRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	packet.bTranslucent = false;
+	int textureHandle = ResolveTextureHandle(object.textureHandle);
+	if (textureHandle >= 0)
+	{
+		// -1 when the array has no texture unit, which draws the
+		// object in its flat color
+		packet.textureSlot = m_textureArrays.GetTextureUnit(textureHandle);
+		packet.textureLayer = m_textureArrays.GetShaderLayer(textureHandle);
+		packet.textureRect = m_textureArrays.GetUVRect(textureHandle);
+		packet.bTranslucent = m_textureIDs[textureHandle].bTranslucent;
+	}
+	packet.materialIndex = object.materialHandle;
+	packet.color = object.color;
+	packet.UVscale = object.UVscale;
+	packet.model = object.transform.GetModelMatrix();
+
+	m_renderQueue.Submit(packet);
+
+	m_lodStats.fullTriangles += m_instancedMeshes->GetTriangleCount(object.meshType, 0);
+	m_lodStats.drawnTriangles += m_instancedMeshes->GetTriangleCount(object.meshType, object.lod);
+	if (object.lod > 0)
+	{
+		m_lodStats.reducedObjects++;
+	}
+}
+
+/***********************************************************
+ *  FlushRenderQueue()
+ *
+ *  This method is used for sorting the queued draw packets
+ *  and drawing them.  Each piece of shader state is only set
+ *  when it differs from the previous packet; the color is
+ *  only used for untextured meshes and the UV scale only for
+ *  textured ones, so those are skipped when not needed.
+ ***********************************************************/
+void SceneManager::FlushRenderQueue()
+{
+	if (NULL == m_pShaderUniforms)
+	{
+		return;
+	}
+
+	// draw identical mesh and texture combinations together,
+	// from the shared mesh buffer when it was loaded
+	if (m_bUseInstancing)
+	{
+		if (m_bUseIndirectDraws && m_meshBuffer->IsLoaded())
+		{
+			FlushIndirectDraws();
+		}
+		else
+		{
+			FlushInstanceBatches();
+		}
+		return;
+	}
+
+	m_renderQueue.Sort();
+
+	// the last state set into the shader - reset every frame
+	// since the uniforms may be changed between frames
+	unsigned int currentProgram = 0;
+	int currentSlot = -2;
+	int currentLayer = -1;
+	glm::vec4 currentRect = glm::vec4(-1.0f);
+	int currentMaterial = -2;
+	glm::vec4 currentColor = glm::vec4(-1.0f);
+	glm::vec2 currentUVscale = glm::vec2(-1.0f);
+	bool bChanged = false;
+
+	for (int i = 0; i < m_renderQueue.GetPacketCount(); i++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = m_renderQueue.GetSortedPacket(i);
+
+		// a program change invalidates all of the tracked state
+		if (packet.program != currentProgram)
+		{
+			m_stateCache.UseProgram(packet.program);
+			currentProgram = packet.program;
+			currentSlot = -2;
+			currentLayer = -1;
+			currentRect = glm::vec4(-1.0f);
+			currentMaterial = -2;
+			currentColor = glm::vec4(-1.0f);
+			currentUVscale = glm::vec2(-1.0f);
+		}
+
+		m_stateCache.setMat4Value(m_uniforms.model, packet.model);
+
+		// texture slot, or flat color mode when there is no texture
+		bChanged = (packet.textureSlot != currentSlot);
+		if (bChanged)
+		{
+			if (packet.textureSlot < 0)
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, false);
+			}
+			else
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, true);
+				m_stateCache.setSampler2DValue(m_uniforms.objectTexture, packet.textureSlot);
+			}
+			currentSlot = packet.textureSlot;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		// layer of the texture in its array
+		bChanged = ((packet.textureSlot >= 0) && (packet.textureLayer != currentLayer));
+		if (bChanged)
+		{
+			m_stateCache.setIntValue(m_uniforms.textureLayer, packet.textureLayer);
+			currentLayer = packet.textureLayer;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		// rectangle of the texture in its layer
+		bChanged = ((packet.textureSlot >= 0) && (packet.textureRect != currentRect));
+		if (bChanged)
+		{
+			m_stateCache.setVec4Value(m_uniforms.textureRect, packet.textureRect);
+			currentRect = packet.textureRect;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		// object color
+		bChanged = ((packet.textureSlot < 0) && (packet.color != currentColor));
+		if (bChanged)
+		{
+			m_stateCache.setVec4Value(m_uniforms.objectColor, packet.color);
+			currentColor = packet.color;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		// texture UV scale
+		bChanged = ((packet.textureSlot >= 0) && (packet.UVscale != currentUVscale));
+		if (bChanged)
+		{
+			m_stateCache.setVec2Value(m_uniforms.UVscale, packet.UVscale);
+			currentUVscale = packet.UVscale;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		// object material
+		bChanged = ((packet.materialIndex >= 0) && (packet.materialIndex != currentMaterial));
+		if (bChanged)
+		{
+			m_stateCache.setIntValue(m_uniforms.materialIndex, packet.materialIndex);
+			currentMaterial = packet.materialIndex;
+		}
+		m_renderQueue.CountStateChange(bChanged);
+
+		DrawMesh(packet.meshType);
+		m_renderQueue.CountDrawCall();
+	}
+}
+
+/***********************************************************
+ *  FlushInstanceBatches()
+ *
+ *  This method is used for drawing the queued draw packets
+ *  as instance batches.  The model matrix, color, UV scale
+ *  and material index of every packet are uploaded together
+ *  into the instance buffer, so only the texture is set per
+ *  batch and each batch costs a single draw call.
+ ***********************************************************/
+void SceneManager::FlushInstanceBatches()
+{
+	m_renderQueue.BuildInstanceBatches();
+
+	int packetCount = m_renderQueue.GetPacketCount();
+	if (packetCount == 0)
+	{
+		return;
+	}
+
+	// gather the instance data in batch order
+	m_instanceData.resize(packetCount);
+	for (int i = 0; i < packetCount; i++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = m_renderQueue.GetBatchedPacket(i);
+		m_instanceData[i].model = packet.model;
+		m_instanceData[i].color = packet.color;
+		m_instanceData[i].UVscale = packet.UVscale;
+		m_instanceData[i].materialIndex = packet.materialIndex;
+		m_instanceData[i].textureLayer = packet.textureLayer;
+		m_instanceData[i].textureRect = packet.textureRect;
+	}
+	m_instancedMeshes->UploadInstances(m_instanceData.data(), packetCount);
+
+	unsigned int currentProgram = 0;
+	int currentSlot = -2;
+
+	for (int i = 0; i < m_renderQueue.GetBatchCount(); i++)
+	{
+		const RenderQueue::INSTANCE_BATCH& batch = m_renderQueue.GetBatch(i);
+
+		// a program change invalidates the tracked texture
+		if (batch.program != currentProgram)
+		{
+			m_stateCache.UseProgram(batch.program);
+			m_stateCache.setBoolValue(m_uniforms.useInstancing, true);
+			currentProgram = batch.program;
+			currentSlot = -2;
+		}
+
+		// texture slot, or flat color mode when there is no texture
+		bool bChanged = (batch.textureSlot != currentSlot);
+		if (bChanged)
+		{
+			if (batch.textureSlot < 0)
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, false);
+			}
+			else
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, true);
+				m_stateCache.setSampler2DValue(m_uniforms.objectTexture, batch.textureSlot);
+			}
+			currentSlot = batch.textureSlot;
+		}
+
+		// the texture is the only state checked per batch - the
+		// texture layer and rectangle, color, UV scale and
+		// material of every instance come from the instance
+		// buffer instead of uniforms
+		m_renderQueue.CountStateChange(bChanged);
+
+		m_instancedMeshes->DrawMeshLodInstanced(batch.meshType, batch.lod, batch.firstInstance, batch.count);
+		m_renderQueue.CountDrawCall();
+	}
+
+	m_stateCache.setBoolValue(m_uniforms.useInstancing, false);
+}
+
+/***********************************************************
+ *  FlushIndirectDraws()
+ *
+ *  This method is used for drawing the instance batches
+ *  from the shared mesh buffer.  The values of every packet
+ *  go into the draw buffer and every batch becomes one
+ *  indirect command, so all of the batches between two
+ *  texture changes are drawn by a single multi-draw call.
+ ***********************************************************/
+void SceneManager::FlushIndirectDraws()
+{
+	m_renderQueue.BuildInstanceBatches();
+
+	int packetCount = m_renderQueue.GetPacketCount();
+	int batchCount = m_renderQueue.GetBatchCount();
+	if ((packetCount == 0) || (batchCount == 0))
+	{
+		return;
+	}
+
+	// gather the draw data in batch order
+	m_drawData.resize(packetCount);
+	for (int i = 0; i < packetCount; i++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = m_renderQueue.GetBatchedPacket(i);
+		m_drawData[i].model = packet.model;
+		m_drawData[i].color = packet.color;
+		m_drawData[i].UVscale = packet.UVscale;
+		m_drawData[i].materialIndex = packet.materialIndex;
+		m_drawData[i].textureLayer = packet.textureLayer;
+		m_drawData[i].textureRect = packet.textureRect;
+	}
+	m_meshBuffer->UploadDraws(m_drawData.data(), packetCount);
+
+	// one command per batch - the base instance points the
+	// draw index of the batch at its first packet
+	m_drawCommands.resize(batchCount);
+	for (int i = 0; i < batchCount; i++)
+	{
+		const RenderQueue::INSTANCE_BATCH& batch = m_renderQueue.GetBatch(i);
+		const MeshMegaBuffer::MESH_RANGE& range = m_meshBuffer->GetMeshRange(batch.meshType, batch.lod);
+		m_drawCommands[i].count = range.indexCount;
+		m_drawCommands[i].instanceCount = batch.count;
+		m_drawCommands[i].firstIndex = range.firstIndex;
+		m_drawCommands[i].baseVertex = range.baseVertex;
+		m_drawCommands[i].baseInstance = batch.firstInstance;
+	}
+	m_meshBuffer->UploadCommands(m_drawCommands.data(), batchCount);
+
+	unsigned int currentProgram = 0;
+	int currentSlot = -2;
+	int first = 0;
+
+	while (first < batchCount)
+	{
+		const RenderQueue::INSTANCE_BATCH& batch = m_renderQueue.GetBatch(first);
+
+		// a program change invalidates the tracked texture
+		if (batch.program != currentProgram)
+		{
+			m_stateCache.UseProgram(batch.program);
+			m_stateCache.setBoolValue(m_uniforms.useDrawBuffer, true);
+			currentProgram = batch.program;
+			currentSlot = -2;
+		}
+
+		// texture slot, or flat color mode when there is no texture
+		bool bChanged = (batch.textureSlot != currentSlot);
+		if (bChanged)
+		{
+			if (batch.textureSlot < 0)
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, false);
+			}
+			else
+			{
+				m_stateCache.setIntValue(m_uniforms.useTexture, true);
+				m_stateCache.setSampler2DValue(m_uniforms.objectTexture, batch.textureSlot);
+			}
+			currentSlot = batch.textureSlot;
+		}
+
+		// extend the run over the following batches that use
+		// the same program and texture
+		int last = first + 1;
+		while ((last < batchCount) &&
+			(m_renderQueue.GetBatch(last).program == batch.program) &&
+			(m_renderQueue.GetBatch(last).textureSlot == batch.textureSlot))
+		{
+			last++;
+		}
+
+		// the texture is the only state checked per run - the
+		// texture layer and rectangle, color, UV scale and
+		// material of every packet come from the draw buffer
+		// instead of uniforms
+		m_renderQueue.CountStateChange(bChanged);
+
+		m_meshBuffer->MultiDraw(first, last - first);
+		m_renderQueue.CountDrawCall();
+
+		first = last;
+	}
+
+	m_stateCache.setBoolValue(m_uniforms.useDrawBuffer, false);
+}
+
+/***********************************************************
+ *  UploadMaterialTable()
+ *
+ *  This method is used for packing every defined material
+ *  into the std140 material buffer of the shader.  Draws and
+ *  instances then select their material by its index, which
+ *  is the position of the material in m_objectMaterials.
+ ***********************************************************/
+void SceneManager::UploadMaterialTable()
+{
+	if (NULL == m_pShaderManager)
+	{
+		return;
+	}
+
+	std::vector<MaterialBuffer::GPU_MATERIAL> table(m_objectMaterials.size());
+	for (int i = 0; i < m_objectMaterials.size(); i++)
+	{
+		table[i].ambientColor = m_objectMaterials[i].ambientColor;
+		table[i].ambientStrength = m_objectMaterials[i].ambientStrength;
+		table[i].diffuseColor = m_objectMaterials[i].diffuseColor;
+		table[i].shininess = m_objectMaterials[i].shininess;
+		table[i].specularColor = m_objectMaterials[i].specularColor;
+		table[i].padding = 0.0f;
+	}
+
+	m_materialBuffer->Upload(table.data(), (int)table.size());
+	m_materialBuffer->BindToProgram(m_pShaderManager->m_programID, g_MaterialBlockName);
+}
+
+/***********************************************************
+ *  UpdateLightClusters()
+ *
+ *  This method is used for assigning the scene lights to
+ *  the clusters of the current view, and passing the values
+ *  the shader needs to find the cluster of a fragment.
+ ***********************************************************/
+void SceneManager::UpdateLightClusters()
+{
+	if ((m_bViewTransformSet == false) || (NULL == m_pShaderUniforms))
+	{
+		return;
+	}
+
+	if (m_viewportHeight <= 0)
+	{
+		GetPixelsPerUnit();
+	}
+
+	m_lightManager->UpdateClusters(m_viewMatrix, m_projectionMatrix, m_viewportWidth, m_viewportHeight);
+	m_stateCache.setVec2Value(m_uniforms.clusterTileSize, m_lightManager->GetClusterTileSize());
+	m_stateCache.setVec2Value(m_uniforms.clusterDepthParams, m_lightManager->GetClusterDepthParams());
+}
+
+/***********************************************************
+ *  SetViewTransform()
+ *
+ *  This method is used for setting the camera matrices of
+ *  the current frame, which the light clusters are built
+ *  from.
+ ***********************************************************/
+void SceneManager::SetViewTransform(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+	m_bViewTransformSet = true;
+}
+
+/***********************************************************
+ *  SetViewportSize()
+ *
+ *  This method is used for setting the size of the viewport
+ *  the scene is drawn into, which the light clusters and
+ *  the sizes of the objects on the screen are found with.
+ *  The size is kept, so the viewport is not read back from
+ *  OpenGL every frame.
+ ***********************************************************/
+void SceneManager::SetViewportSize(int width, int height)
+{
+	m_viewportWidth = width;
+	m_viewportHeight = height;
+}
+
+/***********************************************************
+ *  GetLightManager()
+ *
+ *  This method is used for getting the light sources of the
+ *  scene, so that more lights can be added to it.
+ ***********************************************************/
+LightManager* SceneManager::GetLightManager()
+{
+	return(m_lightManager);
+}
+
+/***********************************************************
+ *  SetInstancingEnabled()
+ *
+ *  This method is used for switching between instanced
+ *  batches and one draw call per scene object.
+ ***********************************************************/
+void SceneManager::SetInstancingEnabled(bool bEnabled)
+{
+	m_bUseInstancing = bEnabled;
 }
 
 /***********************************************************
- *  BindGLTextures()
+ *  SetIndirectDrawEnabled()
  *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
+ *  This method is used for switching the instance batches
+ *  between multi-draw indirect from the shared mesh buffer
+ *  and one instanced draw call per batch.  Multi-draw is
+ *  only used when the context supports it.
  ***********************************************************/
-void SceneManager::BindGLTextures()
+void SceneManager::SetIndirectDrawEnabled(bool bEnabled)
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
+	m_bUseIndirectDraws = bEnabled;
 }
 
 /***********************************************************
- *  DestroyGLTextures()
+ *  SetCullingEnabled()
  *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
+ *  This method is used for switching between submitting only
+ *  the objects inside the view frustum and submitting all of
+ *  the scene objects.
  ***********************************************************/
-void SceneManager::DestroyGLTextures()
+void SceneManager::SetCullingEnabled(bool bEnabled)
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glDeleteTextures(1, &m_textureIDs[i].ID); // AH Updated: Gen -> Delete
-	}
+	m_bUseCulling = bEnabled;
 }
 
 /***********************************************************
- *  FindTextureID()
+ *  SelectObjectLods()
  *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
+ *  This method is used for picking the detail level of each
+ *  scene object from its size on the screen.  The error of a
+ *  level, scaled by the radius of the object bounds, is
+ *  projected into pixels, and the coarsest level that stays
+ *  under LOD_MAX_SCREEN_ERROR is used.  Levels coarser than
+ *  the current one have to pass a tighter limit.  Only the
+ *  instanced meshes have detail levels, so single draws and
+ *  frames without camera matrices use the full detail.
  ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
+void SceneManager::SelectObjectLods()
 {
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
+	bool bSelect = (m_bUseLod && m_bUseInstancing && m_bViewTransformSet);
+
+	float pixelsPerUnit = bSelect ? GetPixelsPerUnit() : 0.0f;
+	glm::mat4 viewProjection = m_projectionMatrix * m_viewMatrix;
+	FrustumCuller::BOUNDS_STREAMS streams = m_frustumCuller.GetStreams();
 
-	while ((index < m_loadedTextures) && (bFound == false))
+	for (int i = 0; i < m_sceneObjects.size(); i++)
 	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
+		SCENE_OBJECT& object = m_sceneObjects[i];
+		int lodCount = ShapeGeometry::GetLodCount(object.meshType);
+		if ((bSelect == false) || (lodCount <= 1) || (m_frustumCuller.IsBounded(i) == false))
 		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
+			object.lod = 0;
+			continue;
 		}
-		else
-			index++;
-	}
 
-	return(textureID);
-}
+		glm::vec3 center = glm::vec3(streams.centerX[i], streams.centerY[i], streams.centerZ[i]);
+		glm::vec3 extent = glm::vec3(streams.extentX[i], streams.extentY[i], streams.extentZ[i]);
+		float projectedRadius = GetProjectedRadius(center, glm::length(extent), viewProjection, pixelsPerUnit);
 
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
+		// the camera is at or inside the bounds
+		if (projectedRadius < 0.0f)
+		{
+			object.lod = 0;
+			continue;
+		}
 
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
+		int lod = 0;
+		for (int level = lodCount - 1; level > 0; level--)
 		{
-			textureSlot = index;
-			bFound = true;
+			float limit = LOD_MAX_SCREEN_ERROR;
+			if (level > object.lod)
+			{
+				limit *= LOD_HYSTERESIS;
+			}
+			if ((ShapeGeometry::GetLodError(object.meshType, level) * projectedRadius) <= limit)
+			{
+				lod = level;
+				break;
+			}
 		}
-		else
-			index++;
+		object.lod = lod;
 	}
-
-	return(textureSlot);
 }
 
 /***********************************************************
- *  FindMaterial()
+ *  SetLodEnabled()
  *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
+ *  This method is used for switching between drawing the
+ *  curved meshes at a detail level picked from their size
+ *  on the screen and always drawing them at full detail.
  ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+void SceneManager::SetLodEnabled(bool bEnabled)
 {
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
+	m_bUseLod = bEnabled;
 }
 
 /***********************************************************
- *  SetTransformations()
+ *  GetLodStats()
  *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  This method is used for getting the number of triangles
+ *  the queued objects of the last frame have at full detail
+ *  and at their picked detail levels.
  ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
+const SceneManager::LOD_STATS& SceneManager::GetLodStats() const
 {
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
+	return(m_lodStats);
 }
 
 /***********************************************************
- *  SetShaderColor()
+ *  SetOcclusionCullingEnabled()
  *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
+ *  This method is used for switching between skipping the
+ *  objects hidden behind the large occluders and drawing
+ *  every object inside the view frustum.
  ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
+void SceneManager::SetOcclusionCullingEnabled(bool bEnabled)
 {
-	// variables for this method
-	glm::vec4 currentColor;
+	m_bUseOcclusionCulling = bEnabled;
+}
 
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
+/***********************************************************
+ *  GetOcclusionStats()
+ *
+ *  This method is used for getting the occluders, the tested
+ *  and hidden scene objects and the worker time of the
+ *  occlusion culling of the last frame.
+ ***********************************************************/
+const OcclusionCuller::OCCLUSION_STATS& SceneManager::GetOcclusionStats() const
+{
+	return(m_occlusionCuller.GetStats());
+}
 
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
+/***********************************************************
+ *  GetCullStats()
+ *
+ *  This method is used for getting the number of scene
+ *  objects that were tested and found visible by the frustum
+ *  culling of the last frame.
+ ***********************************************************/
+const FrustumCuller::CULL_STATS& SceneManager::GetCullStats() const
+{
+	return(m_frustumCuller.GetStats());
 }
 
 /***********************************************************
- *  SetShaderTexture()
+ *  GetRenderStateStats()
  *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
+ *  This method is used for getting the number of uniform
+ *  and OpenGL state calls that were issued and elided while
+ *  rendering the last frame.
  ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
+const RenderStateCache::STATE_STATS& SceneManager::GetRenderStateStats() const
 {
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
+	return(m_stateCache.GetStats());
+}
 
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
+/***********************************************************
+ *  SetTextureMemoryBudget()
+ *
+ *  This method is used for setting how many bytes the
+ *  mipmap levels of the streamed textures may take.  Levels
+ *  over a lowered budget are evicted by the next frame.
+ *  Arrays that cannot be sparse hold every level they
+ *  store, so they are fitted to the budget only when they
+ *  are built and are not changed by setting it later.
+ ***********************************************************/
+void SceneManager::SetTextureMemoryBudget(size_t budgetBytes)
+{
+	m_textureStreamer.SetBudget(budgetBytes);
+	m_textureArrays.SetStreamedBudget(budgetBytes);
 }
 
 /***********************************************************
- *  SetTextureUVScale()
+ *  GetTextureStreamingStats()
  *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
+ *  This method is used for getting the resident, loading
+ *  and allocated bytes of the streamed textures against the
+ *  budget, along with their resident levels.
  ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
+const TextureStreamer::STREAMING_STATS& SceneManager::GetTextureStreamingStats() const
 {
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
+	return(m_textureStreamer.GetStats());
 }
 
 /***********************************************************
- *  SetShaderMaterial()
+ *  GetRenderQueueStats()
  *
- *  This method is used for passing the material values
- *  into the shader.
+ *  This method is used for getting the draw packet and state
+ *  change counters for the last rendered frame.
  ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
+const RenderQueue::QUEUE_STATS& SceneManager::GetRenderQueueStats() const
 {
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
+	return(m_renderQueue.GetStats());
 }
 
 /******************************************************************************/
@@ -388,7 +1992,7 @@ void SceneManager::DefineObjectMaterials()
 	goldMaterial.specularColor = glm::vec3(0.6f, 0.5f, 0.4f);
 	goldMaterial.shininess = 22.0;
 	goldMaterial.tag = "gold";
-	m_objectMaterials.push_back(goldMaterial);
+	AddObjectMaterial(goldMaterial);
 	//------------------------------------------------------
 	OBJECT_MATERIAL		cementMaterial;
 	//
@@ -398,7 +2002,7 @@ void SceneManager::DefineObjectMaterials()
 	cementMaterial.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
 	cementMaterial.shininess = 0.5;
 	cementMaterial.tag = "cement";
-	m_objectMaterials.push_back(cementMaterial);
+	AddObjectMaterial(cementMaterial);
 	//------------------------------------------------------
 	OBJECT_MATERIAL		woodMaterial;
 	//
@@ -408,7 +2012,7 @@ void SceneManager::DefineObjectMaterials()
 	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.2f);
 	woodMaterial.shininess = 0.3;
 	woodMaterial.tag = "wood";
-	m_objectMaterials.push_back(woodMaterial);
+	AddObjectMaterial(woodMaterial);
 	//------------------------------------------------------
 	OBJECT_MATERIAL		tileMaterial;
 	//
@@ -418,7 +2022,7 @@ void SceneManager::DefineObjectMaterials()
 	tileMaterial.specularColor = glm::vec3(0.4f, 0.5f, 0.6f);
 	tileMaterial.shininess = 25.0;
 	tileMaterial.tag = "tile";
-	m_objectMaterials.push_back(tileMaterial);
+	AddObjectMaterial(tileMaterial);
 	//------------------------------------------------------
 	OBJECT_MATERIAL		glassMaterial;
 	//
@@ -428,7 +2032,7 @@ void SceneManager::DefineObjectMaterials()
 	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
 	glassMaterial.shininess = 85.0;
 	glassMaterial.tag = "glass";
-	m_objectMaterials.push_back(glassMaterial);
+	AddObjectMaterial(glassMaterial);
 	//------------------------------------------------------
 	OBJECT_MATERIAL		clayMaterial;
 	//
@@ -438,7 +2042,10 @@ void SceneManager::DefineObjectMaterials()
 	clayMaterial.specularColor = glm::vec3(0.2f, 0.2f, 0.4f);
 	clayMaterial.shininess = 0.5;
 	clayMaterial.tag = "clay";
-	m_objectMaterials.push_back(clayMaterial);
+	AddObjectMaterial(clayMaterial);
+
+	// pack the defined materials into the shader material buffer
+	UploadMaterialTable();
 }
 
 /***********************************************************
@@ -448,39 +2055,47 @@ void SceneManager::DefineObjectMaterials()
 void SceneManager::SetupSceneLights()
 {
 	// Main Light (neutral)
-	m_pShaderManager->setVec3Value("lightSources[0].position", 3.0f, 14.0f, 0.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.05f);
+	m_lightManager->AddPointLight(
+		glm::vec3(3.0f, 14.0f, 0.0f),		// position
+		glm::vec3(0.01f, 0.01f, 0.01f),		// ambient color
+		glm::vec3(0.4f, 0.4f, 0.4f),		// diffuse color
+		glm::vec3(0.0f, 0.0f, 0.0f),		// specular color
+		32.0f,								// focal strength
+		0.05f,								// specular intensity
+		SCENE_LIGHT_RANGE);
 
 	// Key light 1 (neutral)
-	m_pShaderManager->setVec3Value("lightSources[1].position", -3.0f, 14.0f, 0.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.05f);
+	m_lightManager->AddPointLight(
+		glm::vec3(-3.0f, 14.0f, 0.0f),
+		glm::vec3(0.01f, 0.01f, 0.01f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		32.0f,
+		0.05f,
+		SCENE_LIGHT_RANGE);
 
 	// Key light 2 (cool tone)
-	m_pShaderManager->setVec3Value("lightSources[2].position", 0.6f, 5.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 12.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.5f);
+	m_lightManager->AddPointLight(
+		glm::vec3(0.6f, 5.0f, 6.0f),
+		glm::vec3(0.01f, 0.01f, 0.01f),
+		glm::vec3(0.3f, 0.3f, 0.3f),
+		glm::vec3(0.3f, 0.3f, 0.3f),
+		12.0f,
+		0.5f,
+		SCENE_LIGHT_RANGE);
 
 	// Add warm spotlight to mimic sun
-	m_pShaderManager->setVec3Value("lightSources[3].position", 3.0f, 2.0f, 1.0f);
-	m_pShaderManager->setVec3Value("lightSources[3].ambientColor", 0.1f, 0.0f, 0.0f);
-	m_pShaderManager->setVec3Value("lightSources[3].diffuseColor", 1.0f, 0.3f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[3].specularColor", 0.5f, 0.2f, 0.3f);
-	m_pShaderManager->setFloatValue("lightSources[3].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[3].specularIntensity", 1.0f);
+	m_lightManager->AddPointLight(
+		glm::vec3(3.0f, 2.0f, 1.0f),
+		glm::vec3(0.1f, 0.0f, 0.0f),
+		glm::vec3(1.0f, 0.3f, 0.4f),
+		glm::vec3(0.5f, 0.2f, 0.3f),
+		32.0f,
+		1.0f,
+		SCENE_LIGHT_RANGE);
 
 	// Enable lighting
-	m_pShaderManager->setBoolValue("bUseLighting", true);
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
 }
 
 /**********************************************************
@@ -492,6 +2107,8 @@ void SceneManager::SetupSceneLights()
  ***********************************************************/
 void SceneManager::PrepareScene()
 {
+	ResolveShaderUniforms();
+
 	LoadSceneTextures();      // 1
 	DefineObjectMaterials();  // 2
 	SetupSceneLights();       // 3
@@ -501,6 +2118,40 @@ void SceneManager::PrepareScene()
 	m_basicMeshes->LoadBoxMesh();
 	m_basicMeshes->LoadPrismMesh();
 	m_basicMeshes->LoadCylinderMesh();
+
+	// load the instanced versions of the same meshes
+	m_instancedMeshes->LoadPlaneMesh();
+	m_instancedMeshes->LoadBoxMesh();
+	m_instancedMeshes->LoadPrismMesh();
+	m_instancedMeshes->LoadCylinderMesh();
+
+	// pack the same meshes into one buffer for multi-draw
+	// indirect, when the context has it
+	if (MeshMegaBuffer::IsSupported())
+	{
+		m_meshBuffer->LoadMeshes();
+	}
+
+	// define the static objects of the scene
+	DefineSceneObjects();
+
+#ifdef _DEBUG
+	// make sure the batch transform kernels agree with the
+	// matrices that SetTransformations() builds
+	float maxError = 0.0f;
+	bool bKernelsValid = TransformBatch::ValidateKernels(1.0e-5f, &maxError);
+	std::cout << "INFO: Transform batch kernel: "
+		<< TransformBatch::GetKernelName(TransformBatch::GetSupportedKernel())
+		<< (bKernelsValid ? ", validated" : ", FAILED validation")
+		<< " (max error " << maxError << ")" << std::endl;
+
+	// make sure the SIMD frustum tests agree with the scalar one
+	int cullMismatches = 0;
+	bool bCullValid = FrustumCuller::ValidateKernels(&cullMismatches);
+	std::cout << "INFO: Frustum cull kernels "
+		<< (bCullValid ? "validated" : "FAILED validation")
+		<< " (" << cullMismatches << " mismatches)" << std::endl;
+#endif
 }
 
 /***********************************************************
@@ -513,38 +2164,47 @@ void SceneManager::PrepareScene()
 void SceneManager::LoadSceneTextures()
 {
 	/*** STUDENTS - add the code BELOW for loading the textures that ***/
-	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
-	/*** 16 textures can be loaded per scene. Refer to the code in   ***/
-	/*** the OpenGL Sample for help.                                 ***/
+	/*** will be used for mapping to objects in the 3D scene. They   ***/
+	/*** are grouped into texture arrays by size and format, so the  ***/
+	/*** number of textures is not limited by the texture slots.     ***/
 	// 
 	// @author Anthony Hackman
 	// @date 10/5/2025
 	// 
-	// Ex. Usage;	bReturn = CreateGLTexture("../../<PATH>.ext", "<TAG>");
-	bool bReturn = false;
-	bReturn = CreateGLTexture("../../Utilities/textures/green_grass.jpg", "green_grass");
-	bReturn = CreateGLTexture("../../Utilities/textures/grey_concrete.jpg", "grey_concrete");
-	bReturn = CreateGLTexture("../../Utilities/textures/roofing.jpg", "roofing");
-	bReturn = CreateGLTexture("../../Utilities/textures/pavers.jpg", "pavers");
-	bReturn = CreateGLTexture("../../Utilities/textures/missing_texture.jpg", "missing_texture");
-	bReturn = CreateGLTexture("../../Utilities/textures/256_mystic_blue_siding_wood_texture-seamless.jpg", "mystic_blue_siding_wood_texture_seamless");
-	bReturn = CreateGLTexture("../../Utilities/textures/52_wood_fence_cut_out_texture.png", "wood_fence_cut_out_texture");
-	bReturn = CreateGLTexture("../../Utilities/textures/18_bark_texture-seamless.jpg", "bark_texture_seamless");
+	// Ex. Usage;	LoadGLTextureAsync("../../<PATH>.ext", "<TAG>");
+	// the tag is interned, and the returned handle can be kept
+	// and passed to SetShaderTexture() to skip the lookup
+
+	// the placeholder is loaded right away, since it is drawn
+	// in place of every texture that is still loading
+	m_placeholderTexture = CreateGLTexture("../../Utilities/textures/missing_texture.jpg", "missing_texture");
+
+	// the rest are decoded in the background
+	LoadGLTextureAsync("../../Utilities/textures/green_grass.jpg", "green_grass");
+	LoadGLTextureAsync("../../Utilities/textures/grey_concrete.jpg", "grey_concrete");
+	LoadGLTextureAsync("../../Utilities/textures/roofing.jpg", "roofing");
+	LoadGLTextureAsync("../../Utilities/textures/pavers.jpg", "pavers");
+	LoadGLTextureAsync("../../Utilities/textures/256_mystic_blue_siding_wood_texture-seamless.jpg", "mystic_blue_siding_wood_texture_seamless");
+	LoadGLTextureAsync("../../Utilities/textures/52_wood_fence_cut_out_texture.png", "wood_fence_cut_out_texture");
+	LoadGLTextureAsync("../../Utilities/textures/18_bark_texture-seamless.jpg", "bark_texture_seamless");
 
 	// After the texture image data is loaded into memory, 
-	// the loaded textures need to be bound to texture slots using:
+	// the texture arrays need to be built and bound using:
 	BindGLTextures();
 	// 
-	// there are a total of 16 available slots for scene textures
+	// each texture array uses one slot, or none when bindless,
+	// and the background textures are uploaded into their
+	// arrays as they finish, a few per frame
 }
 
 /***********************************************************
- *  RenderScene()
+ *  DefineSceneObjects()
  *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for defining the transformations and
+ *  shader settings of every basic mesh in the 3D scene.  The
+ *  objects are static, so this only needs to be done once.
  ***********************************************************/
-void SceneManager::RenderScene()
+void SceneManager::DefineSceneObjects()
 {
 	// declare the variables for the transformations
 	glm::vec3 scaleXYZ;
@@ -572,24 +2232,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 1.0f, 8.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // grey
-	SetShaderTexture("missing_texture");
-	SetTextureUVScale(1.0f, 1.0f);	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// grey
+		"missing_texture",
+		glm::vec2(1.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// GROUND PLANE 	**********************************************//
@@ -608,24 +2262,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.3, 0.6, 0.3, 1);
-	SetShaderTexture("green_grass");
-	SetTextureUVScale(20.0f, 10.0f);	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.3f, 0.6f, 0.3f, 1.0f),
+		"green_grass",
+		glm::vec2(20.0f, 10.0f),
+		"clay");
 	/******************************************************************/
 
 	// Cylinder 	**************************************************//
@@ -644,24 +2292,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-5.0f, 0.0f, 5.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_CYLINDER,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.3, 0.6, 0.3, 1);
-	SetShaderTexture("bark_texture_seamless");
-	SetTextureUVScale(1.0f, 7.0f);	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.3f, 0.6f, 0.3f, 1.0f),
+		"bark_texture_seamless",
+		glm::vec2(1.0f, 7.0f),
+		"wood");
 	/******************************************************************/
 
 	// DRIVEWAY PLANE	**********************************************//
@@ -680,24 +2322,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 0.01f, 5.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.6, 0.6, 0.6, 1);
-	SetShaderTexture("grey_concrete");
-	SetTextureUVScale(1.0f, 5.0f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.6f, 0.6f, 0.6f, 1.0f),
+		"grey_concrete",
+		glm::vec2(1.0f, 5.0f),
+		"cement");
 	/******************************************************************/
 
 	// GARAGE ====================================================================================
@@ -718,24 +2354,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 1.0f, -1.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	SetTextureUVScale(1.0f, 0.75f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"mystic_blue_siding_wood_texture_seamless",
+		glm::vec2(1.0f, 0.75f),
+		"clay");
 	/******************************************************************/
 
 	// GARAGE BOX: 2 (ABOVE GARAGE) **********************************//
@@ -754,24 +2384,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 2.5f, -0.51f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	SetTextureUVScale(1.0f, 0.5f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"mystic_blue_siding_wood_texture_seamless",
+		glm::vec2(1.0f, 0.5f),
+		"clay");
 	/******************************************************************/
 	
 	// GARAGE ROOF: (LOWER)	******************************************//
@@ -790,24 +2414,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-1.99f, 2.5f, -0.5f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PRISM,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("roofing");
-	SetTextureUVScale(2.0f, 3.0f);	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"roofing",
+		glm::vec2(2.0f, 3.0f),
+		"cement");
 	/******************************************************************/
 
 	// GARAGE ROOF: 2 (TOP) ******************************************//
@@ -826,24 +2444,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.25f, 3.5f, -0.25f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PRISM,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("roofing");
-	SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"roofing",
+		glm::vec2(2.0f, 3.0f),
+		"cement");
 	/******************************************************************/
 
 	// GARAGE ROOF: 2 (TOP INNER) ************************************//
@@ -862,25 +2474,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.25f, 3.49f, -0.25); // float to fix clipping
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PRISM,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-
-	SetShaderColor(0.4f, 0.4f, 0.4f, 1); // gray
-	//SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	//SetTextureUVScale(1.0f, 1.0f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.4f, 0.4f, 1.0f),	// gray
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"clay");
 	/******************************************************************/
 
 	// HOUSE	 ====================================================================================
@@ -901,24 +2506,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(2.0f, 1.0f, 0.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	SetTextureUVScale(1.0f, 1.0f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"mystic_blue_siding_wood_texture_seamless",
+		glm::vec2(1.0f, 1.0f),
+		"clay");
 	/******************************************************************/
 
 	// HOUSE ROOF - triangular prism		**************************//
@@ -937,24 +2536,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(2.0f, 3.5f, 0.5f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PRISM,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.5, 0.5, 1); // gray
-	SetShaderTexture("roofing");
-	SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),	// gray
+		"roofing",
+		glm::vec2(2.0f, 3.0f),
+		"cement");
 	/******************************************************************/
 
 	// HOUSE ROOF INNER						**************************//
@@ -973,24 +2566,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(2.0f, 3.49f, 0.5f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PRISM,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4f, 0.4f, 0.4f, 1); // gray
-	//SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	//SetTextureUVScale(1.0f, 1.0f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.4f, 0.4f, 1.0f),	// gray
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"clay");
 	/******************************************************************/
 
 	// WINDOW							 *****************************//
@@ -1009,24 +2596,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(3.0f, 1.5f, 2.51f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4f, 0.4f, 0.4f, 1); // grey
-	//SetShaderTexture("");
-	//SetTextureUVScale(1.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.4f, 0.4f, 1.0f),	// grey
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"glass");
 	/******************************************************************/
 
 	// DOOR								 *****************************//
@@ -1045,24 +2626,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(0.5f, 1.4f, 2.51f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4f, 0.4f, 0.4f, 1); // grey
-	//SetShaderTexture("");
-	//SetTextureUVScale(1.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.4f, 0.4f, 1.0f),	// grey
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"wood");
 	/******************************************************************/
 
 	// GARAGE DOOR						 *****************************//
@@ -1081,24 +2656,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 1.0f, 0.51f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4f, 0.4f, 0.4f, 1); // gray
-	//SetShaderTexture("mystic_blue_siding_wood_texture_seamless");
-	//SetTextureUVScale(1.0f, 1.0f);	// Tile
-
-	// Give material for shader/lighting
-	SetShaderMaterial("clay");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.4f, 0.4f, 1.0f),	// gray
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"clay");
 	/******************************************************************/
 
 	// PORCH BOX			******************************************//
@@ -1117,25 +2686,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(2.0f, 0.0f, 3.0f); // Under the roof Overhang
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-
-	//SetShaderTexture("roofing");
-	//SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-	
-	// Give material for shader/lighting
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"wood");
 	/******************************************************************/
 
 	// PILLAR (LEFT) 		******************************************//
@@ -1154,25 +2716,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-0.5f, 1.2f, 3.4f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1); // light
-
-	//SetShaderTexture("roofing");
-	//SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),	// light
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// PILLAR (Middle) 		******************************************//
@@ -1191,25 +2746,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(1.5f, 1.2f, 3.4f); // Under the roof Overhang
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1); // light
-
-	//SetShaderTexture("roofing");
-	// //SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),	// light
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// PILLAR (Right) 		******************************************//
@@ -1228,25 +2776,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(4.5f, 1.2f, 3.4f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_BOX,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1); // light
-
-	//SetShaderTexture("roofing");
-	// //SetTextureUVScale(2.0f, 3.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),	// light
+		"",
+		glm::vec2(1.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// FENCE ====================================================================================
@@ -1267,24 +2808,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-6.0f, 0.5f, 0.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-	SetShaderTexture("wood_fence_cut_out_texture");
-	SetTextureUVScale(2.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"wood_fence_cut_out_texture",
+		glm::vec2(2.0f, 1.0f),
+		"wood");
 	/******************************************************************/
 	
 	// PLANE 2	(Left Connecting 1-3) ********************************//
@@ -1303,24 +2838,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-9.0f, 0.5f, -5.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-	SetShaderTexture("wood_fence_cut_out_texture");
-	SetTextureUVScale(5.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"wood_fence_cut_out_texture",
+		glm::vec2(5.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// PLANE 3	(Back Connecting 2-4) ********************************//
@@ -1339,24 +2868,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(-2.0f, 0.5f, -10.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-	SetShaderTexture("wood_fence_cut_out_texture");
-	SetTextureUVScale(5.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"wood_fence_cut_out_texture",
+		glm::vec2(5.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 
 	// PLANE 4	(Right Connecting 3-5) *******************************//
@@ -1375,24 +2898,18 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(5.0f, 0.5f, -5.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-	SetShaderTexture("wood_fence_cut_out_texture");
-	SetTextureUVScale(5.0f, 1.0f); 	// Set tiling
-
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"wood_fence_cut_out_texture",
+		glm::vec2(5.0f, 1.0f),
+		"cement");
 	/******************************************************************/
 	
 	// PLANE 5	(Right Connecting House) *****************************//
@@ -1411,23 +2928,126 @@ void SceneManager::RenderScene()
 	// set the XYZ position for the mesh
 	positionXYZ = glm::vec3(3.5f, 0.5f, 0.0f);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
+	// add the mesh with its transformations and shader settings
+	AddSceneObject(
+		MESH_PLANE,
 		scaleXYZ,
 		XrotationDegrees,
 		YrotationDegrees,
 		ZrotationDegrees,
-		positionXYZ);
+		positionXYZ,
+		glm::vec4(0.4f, 0.3f, 0.3f, 1.0f),	// Red
+		"wood_fence_cut_out_texture",
+		glm::vec2(1.0f, 1.0f),
+		"cement");
+	/******************************************************************/
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// start a new frame of draw packets
+	m_renderQueue.Clear();
+	m_stateCache.BeginFrame();
+	Transform::ResetRebuildCount();
+	m_lodStats.fullTriangles = 0;
+	m_lodStats.drawnTriangles = 0;
+	m_lodStats.reducedObjects = 0;
+
+	// swap in the textures that finished loading
+	PROFILE_SECTION_BEGIN(SECTION_TEXTURE_STREAMING);
+	UpdateTextureStreaming();
+	PROFILE_SECTION_END(SECTION_TEXTURE_STREAMING);
+
+	// the transforms, culling, lights and detail levels are
+	// timed together as the visibility of the frame
+	PROFILE_SECTION_BEGIN(SECTION_VISIBILITY);
+
+	// enable z-depth - only issued when it is not already on
+	m_stateCache.Enable(GL_DEPTH_TEST);
+
+	// the occlusion cull started after the last frame was
+	// submitted has run during its swap and the updates since,
+	// and the worker thread is done with the bounds once it
+	// is collected
+	bool bCull = (m_bUseCulling && m_bViewTransformSet);
+	bool bOcclusionCull = (bCull && m_bUseOcclusionCulling);
+	bool bOcclusionResults = FinishOcclusionCull() && bOcclusionCull;
+
+	// compose the matrices of any objects that were changed
+	UpdateDirtyTransforms();
+
+	// objects moved since the cull may have come out from
+	// behind the occluders, and moved occluders may uncover
+	// anything, so those are not trusted to the old results
+	m_movedSinceCull.assign(m_sceneObjects.size(), 0);
+	for (int i = 0; i < m_batchObjects.size(); i++)
+	{
+		m_movedSinceCull[m_batchObjects[i]] = 1;
+		if (m_sceneObjects[m_batchObjects[i]].bOccluder)
+		{
+			bOcclusionResults = false;
+		}
+	}
 
-	SetShaderColor(0.4, 0.3, 0.3, 1); // Red
-	SetShaderTexture("wood_fence_cut_out_texture");
-	SetTextureUVScale(1.0f, 1.0f); 	// Set tiling
+	// test the object bounds against the planes of the view -
+	// the planes come from the matrices, so the orthographic
+	// projection is culled the same way as the perspective one
+	if (bCull)
+	{
+		m_frustumCuller.SetViewProjection(m_projectionMatrix * m_viewMatrix);
+		m_frustumCuller.Cull();
+	}
 
-	// Give material for shader/lighting
-	SetShaderMaterial("cement");
+	// find the lights that reach each cluster of the view
+	UpdateLightClusters();
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	SetTextureUVScale(1.0f, 1.0f);	// Reset tiling to default
-	/******************************************************************/
+	// pick the mesh detail levels
+	SelectObjectLods();
+	PROFILE_SECTION_END(SECTION_VISIBILITY);
+
+	PROFILE_SECTION_BEGIN(SECTION_SUBMIT);
+
+	// scale of the texel density asked for by the streamed
+	// textures, found the same way as for the detail levels
+	float pixelsPerUnit = m_bViewTransformSet ? GetPixelsPerUnit() : 0.0f;
+	glm::mat4 viewProjection = m_projectionMatrix * m_viewMatrix;
+
+	// queue every visible scene object with its cached
+	// transformations - objects the last cull found behind the
+	// occluders are skipped as well, unless they moved since
+	for (int i = 0; i < m_sceneObjects.size(); i++)
+	{
+		if ((bCull == false) || m_frustumCuller.IsVisible(i))
+		{
+			if ((bOcclusionResults == false) || m_movedSinceCull[i] || (m_occlusionCuller.IsOccluded(i) == false))
+			{
+				SubmitDrawPacket(m_sceneObjects[i]);
+				if (m_bViewTransformSet)
+				{
+					RequestTextureLevel(i, viewProjection, pixelsPerUnit);
+				}
+			}
+		}
+	}
+
+	PROFILE_SECTION_END(SECTION_SUBMIT);
+
+	// sort the queued packets by render state and draw them
+	PROFILE_SECTION_BEGIN(SECTION_DRAW);
+	FlushRenderQueue();
+	PROFILE_SECTION_END(SECTION_DRAW);
+
+	// rasterize the occluders and test the objects behind them
+	// on the worker thread for the next frame, while the GPU
+	// draws this one and the window swaps it
+	if (bOcclusionCull)
+	{
+		BeginOcclusionCull();
+	}
 }
\ No newline at end of file
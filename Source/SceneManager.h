@@ -10,9 +10,25 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
 #include "ShapeMeshes.h"
+#include "InstancedMeshes.h"
+#include "MeshMegaBuffer.h"
+#include "TextureArrays.h"
+#include "TextureLoader.h"
+#include "TextureRegistry.h"
+#include "TextureStreamer.h"
+#include "MaterialBuffer.h"
+#include "LightManager.h"
+#include "RenderQueue.h"
+#include "RenderStateCache.h"
+#include "Transform.h"
+#include "TransformBatch.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /***********************************************************
@@ -25,15 +41,19 @@ class SceneManager
 {
 public:
 	// constructor
-	SceneManager(ShaderManager *pShaderManager);
+	SceneManager(ShaderManager *pShaderManager, ShaderUniforms *pShaderUniforms);
 	// destructor
 	~SceneManager();
 
-	// properties for loaded texture access
+	// properties for loaded texture access - the ID is the
+	// texture array that holds the texture, and a texture that
+	// is still being loaded is not resident
 	struct TEXTURE_INFO
 	{
 		std::string tag;
 		uint32_t ID;
+		bool bTranslucent;
+		bool bResident;
 	};
 
 	struct OBJECT_MATERIAL
@@ -46,29 +66,254 @@ public:
 		std::string tag;
 	};
 
+	// basic mesh placed in the scene with its shader settings -
+	// the texture and material are interned handles, -1 for none
+	struct SCENE_OBJECT
+	{
+		int meshType;
+		Transform transform;
+		glm::vec4 color;
+		int textureHandle;
+		glm::vec2 UVscale;
+		int materialHandle;
+		// true for large boxes and planes that hide what is behind
+		bool bOccluder;
+		// detail level of the mesh picked for the current view
+		int lod;
+	};
+
+	// triangles of the queued objects at full detail and at
+	// their picked detail levels
+	struct LOD_STATS
+	{
+		int fullTriangles;
+		int drawnTriangles;
+		int reducedObjects;
+	};
+
 private:
+	// handles of the uniforms that are set while drawing
+	struct SCENE_UNIFORMS
+	{
+		ShaderUniforms::UNIFORM_HANDLE model;
+		ShaderUniforms::UNIFORM_HANDLE objectColor;
+		ShaderUniforms::UNIFORM_HANDLE objectTexture;
+		ShaderUniforms::UNIFORM_HANDLE useTexture;
+		ShaderUniforms::UNIFORM_HANDLE textureLayer;
+		ShaderUniforms::UNIFORM_HANDLE textureRect;
+		ShaderUniforms::UNIFORM_HANDLE useBindlessTextures;
+		ShaderUniforms::UNIFORM_HANDLE useLighting;
+		ShaderUniforms::UNIFORM_HANDLE useInstancing;
+		ShaderUniforms::UNIFORM_HANDLE useDrawBuffer;
+		ShaderUniforms::UNIFORM_HANDLE UVscale;
+		ShaderUniforms::UNIFORM_HANDLE materialIndex;
+		ShaderUniforms::UNIFORM_HANDLE clusterTileSize;
+		ShaderUniforms::UNIFORM_HANDLE clusterDepthParams;
+	};
+
+	// object space bounding box of a basic shape mesh type
+	struct MESH_BOUNDS
+	{
+		bool bValid;
+		glm::vec3 minXYZ;
+		glm::vec3 maxXYZ;
+	};
+
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the reflected uniforms of the shader program
+	ShaderUniforms* m_pShaderUniforms;
+	// uniform handles resolved once in PrepareScene()
+	SCENE_UNIFORMS m_uniforms;
 	// pointer to basic shapes object
 	ShapeMeshes* m_basicMeshes;
+	// pointer to instanced basic shapes object
+	InstancedMeshes* m_instancedMeshes;
+	// pointer to the shared buffer of all basic shapes
+	MeshMegaBuffer* m_meshBuffer;
+	// pointer to the uniform buffer of the object materials
+	MaterialBuffer* m_materialBuffer;
+	// pointer to the clustered light sources of the scene
+	LightManager* m_lightManager;
+	// camera matrices of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	bool m_bViewTransformSet;
+	// size of the viewport the scene is drawn into, 0 until it
+	// is set or read from OpenGL
+	int m_viewportWidth;
+	int m_viewportHeight;
+	// true when identical mesh and texture draws are instanced
+	bool m_bUseInstancing;
+	// true when the batches are drawn from the shared mesh
+	// buffer with multi-draw indirect, where supported
+	bool m_bUseIndirectDraws;
+	// true when objects outside the view frustum are skipped
+	bool m_bUseCulling;
+	// true when objects hidden behind the occluders are skipped
+	bool m_bUseOcclusionCulling;
+	// true when an occlusion cull was started by the last
+	// frame, whose results the next frame uses
+	bool m_bOcclusionCullStarted;
+	// true when curved meshes are drawn at a detail level that
+	// matches their size on the screen
+	bool m_bUseLod;
+	LOD_STATS m_lodStats;
+	// instance data gathered for the current frame
+	std::vector<InstancedMeshes::INSTANCE_DATA> m_instanceData;
+	// draw data and indirect commands gathered for the frame
+	std::vector<MeshMegaBuffer::GPU_DRAW_DATA> m_drawData;
+	std::vector<MeshMegaBuffer::DRAW_COMMAND> m_drawCommands;
 	// total number of loaded textures
 	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
+	// loaded textures info, indexed by texture handle
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// array textures holding the loaded textures
+	TextureArrays m_textureArrays;
+	// loaded image files and the references on their textures
+	TextureRegistry m_textureRegistry;
+	// worker threads decoding the textures loaded in the
+	// background
+	TextureLoader m_textureLoader;
+	// mipmap levels of the background textures kept resident
+	// within the texture memory budget
+	TextureStreamer m_textureStreamer;
+	// texture drawn in place of textures that are not resident
+	int m_placeholderTexture;
 	// defined object materials
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// intern tables from tag to texture and material handle
+	std::unordered_map<std::string, int> m_textureHandles;
+	std::unordered_map<std::string, int> m_materialHandles;
+	// static objects that make up the scene
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// batch table for composing the changed object matrices
+	TransformBatch m_transformBatch;
+	std::vector<int> m_batchObjects;
+	std::vector<glm::mat4> m_batchMatrices;
+	// world bounds of the scene objects, in the same order
+	FrustumCuller m_frustumCuller;
+	// bounds of each mesh type, built the first time it is used
+	std::unordered_map<int, MESH_BOUNDS> m_meshBounds;
+	// software depth buffer culling run on a worker thread
+	OcclusionCuller m_occlusionCuller;
+	// objects moved since the running occlusion cull started,
+	// which are drawn whatever it finds
+	std::vector<unsigned char> m_movedSinceCull;
+	// draw packets queued for the current frame
+	RenderQueue m_renderQueue;
+	// shadow of the uniform and OpenGL state set while drawing
+	RenderStateCache m_stateCache;
 
 	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
+	int CreateGLTexture(const char* filename, std::string tag);
+	// queue a texture image to be loaded in the background
+	int LoadGLTextureAsync(const char* filename, std::string tag);
+	// find the cooked texture of an image file, when it is
+	// up to date and the context can sample its format
+	bool FindCookedTexture(
+		const char* filename,
+		uint64_t sourceHash,
+		std::string& outPath,
+		KtxFile::KTX_INFO& outInfo) const;
+	// texture already loaded from an image file, with a
+	// reference added and the tag pointed at it, or -1
+	int FindLoadedTexture(const std::string& canonicalPath, uint64_t contentHash, const std::string& tag);
+	// drop a reference on a texture, freeing it with the last
+	void ReleaseGLTexture(int textureHandle);
+	// upload the textures decoded since the last frame
+	void UpdateTextureStreaming();
+	// ask for the texture level a visible object needs
+	void RequestTextureLevel(int objectIndex, const glm::mat4& viewProjection, float pixelsPerUnit);
+	// pixels covered by one unit at a clip w of one
+	float GetPixelsPerUnit();
+	// radius in pixels of a sphere on the screen, or -1 when
+	// the camera is inside of it
+	float GetProjectedRadius(
+		const glm::vec3& center,
+		float radius,
+		const glm::mat4& viewProjection,
+		float pixelsPerUnit) const;
+	// texture to draw for a handle, the placeholder until the
+	// texture is resident
+	int ResolveTextureHandle(int textureHandle) const;
+	// build the texture arrays and bind them to slots in memory
 	void BindGLTextures();
 	// free the loaded OpenGL textures
 	void DestroyGLTextures();
 	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
+	int FindTextureID(const std::string& tag);
+	int FindMaterialIndex(const std::string& tag);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// add a basic mesh with its transformations and shader settings
+	void AddSceneObject(
+		int meshType,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ,
+		glm::vec4 color,
+		std::string textureTag,
+		glm::vec2 UVscale,
+		std::string materialTag);
+	// compose the matrices of all changed objects in one batch
+	void UpdateDirtyTransforms();
+	// set the world bounds of a scene object from its matrix
+	void UpdateObjectBounds(int objectIndex);
+	// object space bounds of a mesh type
+	const MESH_BOUNDS& GetMeshBounds(int meshType);
+	// true when nothing behind the object shows through it
+	bool IsObjectOpaque(const SCENE_OBJECT& object) const;
+	// hand the visible occluders to the occlusion culler for
+	// the next frame
+	void BeginOcclusionCull();
+	// wait for the occlusion cull started by the last frame
+	// and check which of its results still hold
+	bool FinishOcclusionCull();
+	// pick the detail level of every scene object
+	void SelectObjectLods();
+	// queue a scene object for drawing
+	void SubmitDrawPacket(SCENE_OBJECT& object);
+	// sort the queued draw packets and draw them
+	void FlushRenderQueue();
+	// draw the queued draw packets as instance batches
+	void FlushInstanceBatches();
+	// draw the instance batches with multi-draw indirect
+	void FlushIndirectDraws();
+	// assign the lights to the clusters of the current view
+	void UpdateLightClusters();
+	// draw the basic shape mesh of a draw packet
+	void DrawMesh(int meshType);
+
+protected:
+	// the per-draw helpers, which the micro-benchmarks reach
+	// through a derived class
+
+	// resolve the per-draw uniform names into handles and
+	// make the shader program current
+	void ResolveShaderUniforms();
+	// register a texture handle under its tag and its file
+	void RegisterTexture(
+		int textureHandle,
+		const std::string& tag,
+		const std::string& canonicalPath,
+		uint64_t contentHash,
+		bool bTranslucent,
+		bool bResident);
+	// find a loaded texture slot by tag
+	int FindTextureSlot(const std::string& tag);
 	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
+	// add a material and intern its tag
+	int AddObjectMaterial(const OBJECT_MATERIAL& material);
 
 	// set the transformation values 
 	// into the transform buffer
@@ -79,13 +324,6 @@ private:
 		float ZrotationDegrees,
 		glm::vec3 positionXYZ);
 
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
 public:
 
 	// The following methods are for the students to 
@@ -93,12 +331,24 @@ public:
 	void PrepareScene();
 	void RenderScene();
 
+	// define the static objects of the 3D scene
+	void DefineSceneObjects();
+	// repeat the defined objects on a grid, copies times in all
+	void ReplicateScene(int copies);
+	// number of objects in the scene
+	int GetSceneObjectCount() const;
+
 	// loads textures from image files // 10-5-2025 AH
 	void LoadSceneTextures();
+	// drop the texture loaded under a tag, which is freed with
+	// its last tag and leaves its objects untextured
+	void ReleaseTexture(std::string textureTag);
 
 	// set the texture data into the shader
 	void SetShaderTexture(
 		std::string textureTag);
+	void SetShaderTexture(
+		int textureHandle);
 
 	// set the UV scale for the texture mapping
 	void SetTextureUVScale(
@@ -110,7 +360,45 @@ public:
 	// set the object material into the shader
 	void SetShaderMaterial(
 		std::string materialTag);
+	void SetShaderMaterial(
+		int materialHandle);
+
+	// pack all defined materials into the shader material buffer
+	void UploadMaterialTable();
+
+	// switch between instanced batches and single draws
+	void SetInstancingEnabled(bool bEnabled);
+	// switch multi-draw indirect of the batches on or off
+	void SetIndirectDrawEnabled(bool bEnabled);
+	// switch frustum culling of the scene objects on or off
+	void SetCullingEnabled(bool bEnabled);
+	// switch occlusion culling of the scene objects on or off
+	void SetOcclusionCullingEnabled(bool bEnabled);
+	// switch the detail level selection on or off
+	void SetLodEnabled(bool bEnabled);
 
 	// pre-set light sources for 3D scene
 	void SetupSceneLights();
+	// light sources of the scene, for adding more lights
+	LightManager* GetLightManager();
+
+	// set the camera matrices used for the current frame
+	void SetViewTransform(const glm::mat4& view, const glm::mat4& projection);
+	// set the size of the viewport the scene is drawn into
+	void SetViewportSize(int width, int height);
+
+	// draw packet and state change counters for the last frame
+	const RenderQueue::QUEUE_STATS& GetRenderQueueStats() const;
+	// issued and elided state calls for the last frame
+	const RenderStateCache::STATE_STATS& GetRenderStateStats() const;
+	// tested and visible scene objects for the last frame
+	const FrustumCuller::CULL_STATS& GetCullStats() const;
+	// occluders and hidden scene objects for the last frame
+	const OcclusionCuller::OCCLUSION_STATS& GetOcclusionStats() const;
+	// triangles before and after the detail level selection
+	const LOD_STATS& GetLodStats() const;
+	// bytes the streamed texture levels may take
+	void SetTextureMemoryBudget(size_t budgetBytes);
+	// residency of the streamed textures and the budget
+	const TextureStreamer::STREAMING_STATS& GetTextureStreamingStats() const;
 };
\ No newline at end of file
@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.cpp
+// ============
+// reflect the active uniforms of a linked shader program once, and set
+// them through pre-resolved handles instead of uniform name strings
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderUniforms.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+
+/***********************************************************
+ *  ShaderUniforms()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderUniforms::ShaderUniforms()
+{
+	m_programID = 0;
+}
+
+/***********************************************************
+ *  ~ShaderUniforms()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShaderUniforms::~ShaderUniforms()
+{
+	m_uniforms.clear();
+	m_uniformIndex.clear();
+}
+
+/***********************************************************
+ *  Reflect()
+ *
+ *  This method is used for building the uniform table from
+ *  the active uniforms of a linked program.  Arrays of basic
+ *  types are reported once as "name[0]", so every element is
+ *  added under its own name as well.  The number of uniforms
+ *  in the table is returned.
+ ***********************************************************/
+int ShaderUniforms::Reflect(GLuint programID)
+{
+	m_programID = programID;
+	m_uniforms.clear();
+	m_uniformIndex.clear();
+
+	GLint activeUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &activeUniforms);
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> nameBuffer(maxNameLength + 1);
+
+	for (GLint i = 0; i < activeUniforms; i++)
+	{
+		GLsizei nameLength = 0;
+		GLint size = 0;
+		GLenum type = GL_NONE;
+		glGetActiveUniform(programID, (GLuint)i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+
+		std::string name(nameBuffer.data(), nameLength);
+		GLint location = glGetUniformLocation(programID, name.c_str());
+
+		// uniforms in blocks have no location and are skipped
+		if (location < 0)
+		{
+			continue;
+		}
+
+		AddUniform(name, location, type, size);
+
+		// arrays of basic types - add the bare name and each element
+		size_t bracket = name.rfind("[0]");
+		if ((bracket != std::string::npos) && (bracket + 3 == name.length()))
+		{
+			std::string baseName = name.substr(0, bracket);
+			AddUniform(baseName, location, type, size);
+			for (GLint element = 1; element < size; element++)
+			{
+				std::string elementName = baseName + "[" + std::to_string(element) + "]";
+				GLint elementLocation = glGetUniformLocation(programID, elementName.c_str());
+				AddUniform(elementName, elementLocation, type, 1);
+			}
+		}
+	}
+
+	std::cout << "INFO: Reflected " << m_uniforms.size() << " shader uniforms" << std::endl;
+
+	return((int)m_uniforms.size());
+}
+
+/***********************************************************
+ *  AddUniform()
+ *
+ *  This method is used for adding a uniform to the table.
+ ***********************************************************/
+void ShaderUniforms::AddUniform(const std::string& name, GLint location, GLenum type, GLint size)
+{
+	UNIFORM_INFO info;
+	info.name = name;
+	info.location = location;
+	info.type = type;
+	info.size = size;
+
+	m_uniformIndex[name] = (int)m_uniforms.size();
+	m_uniforms.push_back(info);
+}
+
+/***********************************************************
+ *  GetProgramID()
+ *
+ *  This method is used for getting the program that the
+ *  uniform table was built from.
+ ***********************************************************/
+GLuint ShaderUniforms::GetProgramID() const
+{
+	return(m_programID);
+}
+
+/***********************************************************
+ *  GetHandle()
+ *
+ *  This method is used for resolving a uniform name into a
+ *  handle.  Names that are not active in the program give a
+ *  handle with a location of -1, the same as OpenGL would.
+ ***********************************************************/
+ShaderUniforms::UNIFORM_HANDLE ShaderUniforms::GetHandle(const std::string& name) const
+{
+	UNIFORM_HANDLE handle;
+	handle.location = -1;
+	handle.type = GL_NONE;
+
+	std::unordered_map<std::string, int>::const_iterator found = m_uniformIndex.find(name);
+	if (found != m_uniformIndex.end())
+	{
+		handle.location = m_uniforms[found->second].location;
+		handle.type = m_uniforms[found->second].type;
+	}
+
+	return(handle);
+}
+
+/***********************************************************
+ *  IsValid()
+ *
+ *  This method is used for checking whether a handle refers
+ *  to an active uniform.
+ ***********************************************************/
+bool ShaderUniforms::IsValid(const UNIFORM_HANDLE& handle)
+{
+	return(handle.location >= 0);
+}
+
+/***********************************************************
+ *  GetUniforms()
+ *
+ *  This method is used for getting every uniform found by
+ *  the last reflection.
+ ***********************************************************/
+const std::vector<ShaderUniforms::UNIFORM_INFO>& ShaderUniforms::GetUniforms() const
+{
+	return(m_uniforms);
+}
+
+/***********************************************************
+ *  setBoolValue()
+ ***********************************************************/
+void ShaderUniforms::setBoolValue(const UNIFORM_HANDLE& handle, bool value) const
+{
+	glUniform1i(handle.location, (int)value);
+}
+
+/***********************************************************
+ *  setIntValue()
+ ***********************************************************/
+void ShaderUniforms::setIntValue(const UNIFORM_HANDLE& handle, int value) const
+{
+	glUniform1i(handle.location, value);
+}
+
+/***********************************************************
+ *  setFloatValue()
+ ***********************************************************/
+void ShaderUniforms::setFloatValue(const UNIFORM_HANDLE& handle, float value) const
+{
+	glUniform1f(handle.location, value);
+}
+
+/***********************************************************
+ *  setVec2Value()
+ ***********************************************************/
+void ShaderUniforms::setVec2Value(const UNIFORM_HANDLE& handle, const glm::vec2& value) const
+{
+	glUniform2fv(handle.location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setVec3Value()
+ ***********************************************************/
+void ShaderUniforms::setVec3Value(const UNIFORM_HANDLE& handle, const glm::vec3& value) const
+{
+	glUniform3fv(handle.location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setVec4Value()
+ ***********************************************************/
+void ShaderUniforms::setVec4Value(const UNIFORM_HANDLE& handle, const glm::vec4& value) const
+{
+	glUniform4fv(handle.location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setMat4Value()
+ ***********************************************************/
+void ShaderUniforms::setMat4Value(const UNIFORM_HANDLE& handle, const glm::mat4& value) const
+{
+	glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setSampler2DValue()
+ ***********************************************************/
+void ShaderUniforms::setSampler2DValue(const UNIFORM_HANDLE& handle, int value) const
+{
+	glUniform1i(handle.location, value);
+}
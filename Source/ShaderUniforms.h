@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.h
+// ============
+// reflect the active uniforms of a linked shader program once, and set
+// them through pre-resolved handles instead of uniform name strings
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  ShaderUniforms
+ *
+ *  This class builds a table of the active uniforms of the
+ *  program loaded by ShaderManager.  Names are resolved into
+ *  handles once at startup, and the setters take the handle
+ *  so no string hashing or glGetUniformLocation() happens on
+ *  the per-frame path.  Like the ShaderManager setters, the
+ *  program must be in use when a value is set.
+ ***********************************************************/
+class ShaderUniforms
+{
+public:
+	// constructor
+	ShaderUniforms();
+	// destructor
+	~ShaderUniforms();
+
+	// pre-resolved uniform - a location of -1 is ignored by
+	// OpenGL, so setting a missing uniform is harmless
+	struct UNIFORM_HANDLE
+	{
+		GLint location;
+		GLenum type;
+	};
+
+	// uniform reported by the program
+	struct UNIFORM_INFO
+	{
+		std::string name;
+		GLint location;
+		GLenum type;
+		GLint size;
+	};
+
+	// build the uniform table from a linked program
+	int Reflect(GLuint programID);
+	// program the table was built from
+	GLuint GetProgramID() const;
+
+	// resolve a uniform name into a handle
+	UNIFORM_HANDLE GetHandle(const std::string& name) const;
+	// true when the handle refers to an active uniform
+	static bool IsValid(const UNIFORM_HANDLE& handle);
+	// every uniform found by the last reflection
+	const std::vector<UNIFORM_INFO>& GetUniforms() const;
+
+	// set uniform values through a pre-resolved handle
+	void setBoolValue(const UNIFORM_HANDLE& handle, bool value) const;
+	void setIntValue(const UNIFORM_HANDLE& handle, int value) const;
+	void setFloatValue(const UNIFORM_HANDLE& handle, float value) const;
+	void setVec2Value(const UNIFORM_HANDLE& handle, const glm::vec2& value) const;
+	void setVec3Value(const UNIFORM_HANDLE& handle, const glm::vec3& value) const;
+	void setVec4Value(const UNIFORM_HANDLE& handle, const glm::vec4& value) const;
+	void setMat4Value(const UNIFORM_HANDLE& handle, const glm::mat4& value) const;
+	void setSampler2DValue(const UNIFORM_HANDLE& handle, int value) const;
+
+private:
+	// program the table was built from
+	GLuint m_programID;
+	// every active uniform of the program
+	std::vector<UNIFORM_INFO> m_uniforms;
+	// uniform name to index in m_uniforms
+	std::unordered_map<std::string, int> m_uniformIndex;
+
+	// add a uniform to the table under the passed in name
+	void AddUniform(const std::string& name, GLint location, GLenum type, GLint size);
+};
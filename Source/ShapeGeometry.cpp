@@ -0,0 +1,415 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.cpp
+// ============
+// build the vertex and index data of the basic shapes on the CPU so the
+// data can be uploaded into buffers that are owned outside ShapeMeshes
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+
+#include <cmath>
+
+// declaration of the global variables and defines
+namespace
+{
+	const float PI = 3.14159265358979323846f;
+
+	// cylinder sides of each detail level
+	const int CYLINDER_LOD_SIDES[ShapeGeometry::MAX_LOD_COUNT] = { ShapeGeometry::CYLINDER_SIDES, 18, 10, 6 };
+}
+
+/***********************************************************
+ *  BuildMesh()
+ *
+ *  This method is used for building the full detail geometry
+ *  of one of the basic shape mesh types.  False is returned
+ *  for a type that has no geometry builder.
+ ***********************************************************/
+bool ShapeGeometry::BuildMesh(int meshType, GEOMETRY& geometry)
+{
+	return(BuildMeshLod(meshType, 0, geometry));
+}
+
+/***********************************************************
+ *  BuildMeshLod()
+ *
+ *  This method is used for building one detail level of a
+ *  basic shape mesh type.  Shapes with a single level ignore
+ *  the passed in level.  False is returned for a type that
+ *  has no geometry builder or a level that does not exist.
+ ***********************************************************/
+bool ShapeGeometry::BuildMeshLod(int meshType, int lod, GEOMETRY& geometry)
+{
+	geometry.vertices.clear();
+	geometry.indices.clear();
+
+	if ((lod < 0) || (lod >= GetLodCount(meshType)))
+	{
+		return(false);
+	}
+
+	switch (meshType)
+	{
+	case MESH_BOX:
+		BuildBox(geometry);
+		break;
+	case MESH_PLANE:
+		BuildPlane(geometry);
+		break;
+	case MESH_PRISM:
+		BuildPrism(geometry);
+		break;
+	case MESH_CYLINDER:
+		BuildCylinder(geometry, GetCylinderLodSides(lod));
+		break;
+	default:
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetLodCount()
+ *
+ *  This method is used for getting the number of detail
+ *  levels of a mesh type.  Only the curved shapes have more
+ *  than one, since the flat ones are already minimal.
+ ***********************************************************/
+int ShapeGeometry::GetLodCount(int meshType)
+{
+	switch (meshType)
+	{
+	case MESH_CYLINDER:
+		return(MAX_LOD_COUNT);
+	case MESH_BOX:
+	case MESH_PLANE:
+	case MESH_PRISM:
+		return(1);
+	default:
+		return(0);
+	}
+}
+
+/***********************************************************
+ *  GetLodError()
+ *
+ *  This method is used for getting how far a detail level
+ *  strays from the true surface, as a fraction of the shape
+ *  radius.  For a circle cut into n sides this is the gap
+ *  between the arc and the middle of a side, 1 - cos(pi/n).
+ ***********************************************************/
+float ShapeGeometry::GetLodError(int meshType, int lod)
+{
+	if ((lod < 0) || (lod >= GetLodCount(meshType)))
+	{
+		return(0.0f);
+	}
+
+	switch (meshType)
+	{
+	case MESH_CYLINDER:
+		return(1.0f - std::cos(PI / (float)GetCylinderLodSides(lod)));
+	default:
+		return(0.0f);
+	}
+}
+
+/***********************************************************
+ *  GetCylinderLodSides()
+ *
+ *  This method is used for getting the number of sides of a
+ *  cylinder detail level.
+ ***********************************************************/
+int ShapeGeometry::GetCylinderLodSides(int lod)
+{
+	if (lod < 0)
+	{
+		lod = 0;
+	}
+	if (lod >= MAX_LOD_COUNT)
+	{
+		lod = MAX_LOD_COUNT - 1;
+	}
+
+	return(CYLINDER_LOD_SIDES[lod]);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the object space bounding
+ *  box of one of the basic shape mesh types, taken from the
+ *  vertices of its geometry.  False is returned for a type
+ *  that has no geometry builder.
+ ***********************************************************/
+bool ShapeGeometry::GetMeshBounds(int meshType, glm::vec3& minXYZ, glm::vec3& maxXYZ)
+{
+	GEOMETRY geometry;
+	if ((BuildMesh(meshType, geometry) == false) || (geometry.vertices.size() == 0))
+	{
+		return(false);
+	}
+
+	minXYZ = geometry.vertices[0].position;
+	maxXYZ = geometry.vertices[0].position;
+	for (int i = 1; i < geometry.vertices.size(); i++)
+	{
+		minXYZ = glm::min(minXYZ, geometry.vertices[i].position);
+		maxXYZ = glm::max(maxXYZ, geometry.vertices[i].position);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for building a 2x2 plane on the XZ
+ *  plane that faces up the Y axis.
+ ***********************************************************/
+void ShapeGeometry::BuildPlane(GEOMETRY& geometry)
+{
+	AddQuad(
+		geometry,
+		glm::vec3(-1.0f, 0.0f, 1.0f),
+		glm::vec3(1.0f, 0.0f, 1.0f),
+		glm::vec3(1.0f, 0.0f, -1.0f),
+		glm::vec3(-1.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used for building a unit cube centered on
+ *  the origin.  Every face has its own vertices so that the
+ *  normals and texture coordinates stay flat per face.
+ ***********************************************************/
+void ShapeGeometry::BuildBox(GEOMETRY& geometry)
+{
+	// front (+Z)
+	AddQuad(geometry,
+		glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f),
+		glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, 0.5f),
+		glm::vec3(0.0f, 0.0f, 1.0f));
+	// back (-Z)
+	AddQuad(geometry,
+		glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f),
+		glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(0.5f, 0.5f, -0.5f),
+		glm::vec3(0.0f, 0.0f, -1.0f));
+	// left (-X)
+	AddQuad(geometry,
+		glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, 0.5f),
+		glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, -0.5f),
+		glm::vec3(-1.0f, 0.0f, 0.0f));
+	// right (+X)
+	AddQuad(geometry,
+		glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, -0.5f),
+		glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f),
+		glm::vec3(1.0f, 0.0f, 0.0f));
+	// top (+Y)
+	AddQuad(geometry,
+		glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(0.5f, 0.5f, 0.5f),
+		glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(-0.5f, 0.5f, -0.5f),
+		glm::vec3(0.0f, 1.0f, 0.0f));
+	// bottom (-Y)
+	AddQuad(geometry,
+		glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, -0.5f, -0.5f),
+		glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, -0.5f, 0.5f),
+		glm::vec3(0.0f, -1.0f, 0.0f));
+}
+
+/***********************************************************
+ *  BuildPrism()
+ *
+ *  This method is used for building a unit triangular prism.
+ *  The triangle lies on the YZ plane with its ridge at +Z,
+ *  and it is extruded along the X axis.
+ ***********************************************************/
+void ShapeGeometry::BuildPrism(GEOMETRY& geometry)
+{
+	glm::vec3 left0 = glm::vec3(-0.5f, -0.5f, -0.5f);
+	glm::vec3 left1 = glm::vec3(-0.5f, 0.5f, -0.5f);
+	glm::vec3 left2 = glm::vec3(-0.5f, 0.0f, 0.5f);
+	glm::vec3 right0 = glm::vec3(0.5f, -0.5f, -0.5f);
+	glm::vec3 right1 = glm::vec3(0.5f, 0.5f, -0.5f);
+	glm::vec3 right2 = glm::vec3(0.5f, 0.0f, 0.5f);
+
+	// triangle ends
+	AddTriangle(geometry,
+		left1, left0, left2,
+		glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.5f, 1.0f),
+		glm::vec3(-1.0f, 0.0f, 0.0f));
+	AddTriangle(geometry,
+		right0, right1, right2,
+		glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.5f, 1.0f),
+		glm::vec3(1.0f, 0.0f, 0.0f));
+
+	// base and the two sloped sides
+	AddQuad(geometry, left1, right1, right0, left0, glm::vec3(0.0f, 0.0f, -1.0f));
+	AddQuad(geometry, left0, right0, right2, left2, glm::normalize(glm::vec3(0.0f, -1.0f, 0.5f)));
+	AddQuad(geometry, right1, left1, left2, right2, glm::normalize(glm::vec3(0.0f, 1.0f, 0.5f)));
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method is used for building a cylinder with a radius
+ *  of 1 and a height of 1 that stands on the XZ plane.  The
+ *  passed in number of sides controls the tessellation.
+ ***********************************************************/
+void ShapeGeometry::BuildCylinder(GEOMETRY& geometry, int sides)
+{
+	const float TWO_PI = 6.28318530717958647692f;
+
+	if (sides < 3)
+	{
+		sides = 3;
+	}
+
+	// sides - one column of vertices per step, the seam
+	// is duplicated so the texture wraps once around
+	uint32_t firstSide = (uint32_t)geometry.vertices.size();
+	for (int i = 0; i <= sides; i++)
+	{
+		float u = (float)i / (float)sides;
+		float angle = u * TWO_PI;
+		glm::vec3 normal = glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+
+		VERTEX bottom;
+		bottom.position = glm::vec3(normal.x, 0.0f, normal.z);
+		bottom.normal = normal;
+		bottom.textureCoordinate = glm::vec2(u, 0.0f);
+		VERTEX top;
+		top.position = glm::vec3(normal.x, 1.0f, normal.z);
+		top.normal = normal;
+		top.textureCoordinate = glm::vec2(u, 1.0f);
+
+		geometry.vertices.push_back(bottom);
+		geometry.vertices.push_back(top);
+	}
+	for (int i = 0; i < sides; i++)
+	{
+		uint32_t b0 = firstSide + (i * 2);
+		uint32_t t0 = b0 + 1;
+		uint32_t b1 = b0 + 2;
+		uint32_t t1 = b0 + 3;
+
+		geometry.indices.push_back(b0);
+		geometry.indices.push_back(t0);
+		geometry.indices.push_back(b1);
+		geometry.indices.push_back(b1);
+		geometry.indices.push_back(t0);
+		geometry.indices.push_back(t1);
+	}
+
+	// top and bottom caps as triangle fans around a center vertex
+	for (int cap = 0; cap < 2; cap++)
+	{
+		float height = (cap == 0) ? 1.0f : 0.0f;
+		glm::vec3 normal = glm::vec3(0.0f, (cap == 0) ? 1.0f : -1.0f, 0.0f);
+		uint32_t center = (uint32_t)geometry.vertices.size();
+
+		VERTEX centerVertex;
+		centerVertex.position = glm::vec3(0.0f, height, 0.0f);
+		centerVertex.normal = normal;
+		centerVertex.textureCoordinate = glm::vec2(0.5f, 0.5f);
+		geometry.vertices.push_back(centerVertex);
+
+		for (int i = 0; i <= sides; i++)
+		{
+			float angle = ((float)i / (float)sides) * TWO_PI;
+			VERTEX rim;
+			rim.position = glm::vec3(std::cos(angle), height, std::sin(angle));
+			rim.normal = normal;
+			rim.textureCoordinate = glm::vec2(
+				0.5f + (0.5f * std::cos(angle)),
+				0.5f + (0.5f * std::sin(angle)));
+			geometry.vertices.push_back(rim);
+		}
+		for (int i = 0; i < sides; i++)
+		{
+			// wind the fan so that both caps face outward
+			geometry.indices.push_back(center);
+			if (cap == 0)
+			{
+				geometry.indices.push_back(center + 2 + i);
+				geometry.indices.push_back(center + 1 + i);
+			}
+			else
+			{
+				geometry.indices.push_back(center + 1 + i);
+				geometry.indices.push_back(center + 2 + i);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  AddQuad()
+ *
+ *  This method is used for appending a quad, given counter
+ *  clockwise, as two triangles with texture coordinates that
+ *  cover the whole texture.
+ ***********************************************************/
+void ShapeGeometry::AddQuad(
+	GEOMETRY& geometry,
+	glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3,
+	glm::vec3 normal)
+{
+	uint32_t first = (uint32_t)geometry.vertices.size();
+	glm::vec3 positions[4] = { p0, p1, p2, p3 };
+	glm::vec2 textureCoordinates[4] = {
+		glm::vec2(0.0f, 0.0f),
+		glm::vec2(1.0f, 0.0f),
+		glm::vec2(1.0f, 1.0f),
+		glm::vec2(0.0f, 1.0f) };
+
+	for (int i = 0; i < 4; i++)
+	{
+		VERTEX vertex;
+		vertex.position = positions[i];
+		vertex.normal = normal;
+		vertex.textureCoordinate = textureCoordinates[i];
+		geometry.vertices.push_back(vertex);
+	}
+
+	geometry.indices.push_back(first + 0);
+	geometry.indices.push_back(first + 1);
+	geometry.indices.push_back(first + 2);
+	geometry.indices.push_back(first + 0);
+	geometry.indices.push_back(first + 2);
+	geometry.indices.push_back(first + 3);
+}
+
+/***********************************************************
+ *  AddTriangle()
+ *
+ *  This method is used for appending a single triangle.
+ ***********************************************************/
+void ShapeGeometry::AddTriangle(
+	GEOMETRY& geometry,
+	glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+	glm::vec2 uv0, glm::vec2 uv1, glm::vec2 uv2,
+	glm::vec3 normal)
+{
+	uint32_t first = (uint32_t)geometry.vertices.size();
+	glm::vec3 positions[3] = { p0, p1, p2 };
+	glm::vec2 textureCoordinates[3] = { uv0, uv1, uv2 };
+
+	for (int i = 0; i < 3; i++)
+	{
+		VERTEX vertex;
+		vertex.position = positions[i];
+		vertex.normal = normal;
+		vertex.textureCoordinate = textureCoordinates[i];
+		geometry.vertices.push_back(vertex);
+	}
+
+	geometry.indices.push_back(first + 0);
+	geometry.indices.push_back(first + 1);
+	geometry.indices.push_back(first + 2);
+}
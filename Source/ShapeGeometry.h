@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.h
+// ============
+// build the vertex and index data of the basic shapes on the CPU so the
+// data can be uploaded into buffers that are owned outside ShapeMeshes
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderQueue.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  ShapeGeometry
+ *
+ *  This class builds the interleaved vertex data (position,
+ *  normal, texture coordinate) and triangle indices of the
+ *  basic shapes.  The shapes use the same object space as
+ *  the ShapeMeshes primitives they stand in for:
+ *
+ *    plane    - 2x2 on the XZ plane facing +Y
+ *    box      - unit cube centered on the origin
+ *    prism    - unit triangular prism along X, ridge at +Z
+ *    cylinder - radius 1, height 1, base on the XZ plane
+ *
+ *  Curved shapes are built at several levels of detail,
+ *  level 0 being the full tessellation.
+ ***********************************************************/
+class ShapeGeometry
+{
+public:
+	// interleaved vertex matching the ShapeMeshes attribute layout
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	// CPU-side data of a shape
+	struct GEOMETRY
+	{
+		std::vector<VERTEX> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	// number of sides used for the full detail cylinder
+	static const int CYLINDER_SIDES = 36;
+	// most detail levels built for any mesh type
+	static const int MAX_LOD_COUNT = 4;
+
+	// build the geometry of a basic shape mesh type
+	static bool BuildMesh(int meshType, GEOMETRY& geometry);
+	// build one detail level of a basic shape mesh type
+	static bool BuildMeshLod(int meshType, int lod, GEOMETRY& geometry);
+	// number of detail levels of a mesh type, 1 for flat shapes
+	static int GetLodCount(int meshType);
+	// largest distance between a detail level and the true
+	// surface, relative to the radius of the shape
+	static float GetLodError(int meshType, int lod);
+	// number of cylinder sides used for a detail level
+	static int GetCylinderLodSides(int lod);
+	// object space bounding box of a basic shape mesh type
+	static bool GetMeshBounds(int meshType, glm::vec3& minXYZ, glm::vec3& maxXYZ);
+
+	static void BuildPlane(GEOMETRY& geometry);
+	static void BuildBox(GEOMETRY& geometry);
+	static void BuildPrism(GEOMETRY& geometry);
+	static void BuildCylinder(GEOMETRY& geometry, int sides);
+
+private:
+	// append a quad with a flat normal as two triangles
+	static void AddQuad(
+		GEOMETRY& geometry,
+		glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3,
+		glm::vec3 normal);
+	// append a triangle with a flat normal
+	static void AddTriangle(
+		GEOMETRY& geometry,
+		glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+		glm::vec2 uv0, glm::vec2 uv1, glm::vec2 uv2,
+		glm::vec3 normal);
+};
@@ -0,0 +1,1567 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.cpp
+// ============
+// group the scene textures by size and format into 2D array textures, so a
+// draw selects its texture by a layer index instead of a texture unit
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArrays.h"
+#include "AtlasPacker.h"
+#include "ImageMipmaps.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// the layer and the array index share the value the
+	// shader reads when the arrays are bindless
+	const int BINDLESS_LAYER_BITS = 16;
+	const int BINDLESS_LAYER_MASK = (1 << BINDLESS_LAYER_BITS) - 1;
+	// the finest level a streamed texture may sample sits
+	// above the array index, which leaves 8 bits for that
+	const int MIN_LEVEL_SHIFT = 24;
+	const int BINDLESS_ARRAY_MASK = (1 << (MIN_LEVEL_SHIFT - BINDLESS_LAYER_BITS)) - 1;
+
+	// texels of wrapped border around every atlas image, and
+	// the mipmap levels where that border is still at least
+	// one texel wide - rectangles are aligned to the gutter so
+	// they stay on whole texels down to the last level
+	const int ATLAS_GUTTER = 8;
+	const int ATLAS_LEVEL_COUNT = 4;
+
+	// a streamed array that cannot be sparse keeps at least
+	// the levels of this size, which the streamer loads first
+	const int MIN_STORED_LEVEL_SIZE = 64;
+
+	// bind an array on the active unit to update it, and get
+	// the array that was bound there, so it can be put back
+	// for the draws that sample that unit
+	GLuint BindArrayForUpdate(GLuint textureID)
+	{
+		GLint previousID = 0;
+		glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &previousID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+		return((GLuint)previousID);
+	}
+}
+
+/***********************************************************
+ *  TextureArrays()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureArrays::TextureArrays()
+{
+	m_maxLayers = 0;
+	m_maxTextureUnits = 0;
+	m_streamedBudget = 0;
+	m_handleBuffer = 0;
+	m_bBindless = false;
+	m_bUseAtlas = true;
+}
+
+/***********************************************************
+ *  ~TextureArrays()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureArrays::~TextureArrays()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsBindlessSupported()
+ *
+ *  This method is used for checking that the context can
+ *  sample textures from bindless handles read out of a
+ *  shader storage buffer.
+ ***********************************************************/
+bool TextureArrays::IsBindlessSupported()
+{
+	if (GLEW_ARB_bindless_texture == GL_FALSE)
+	{
+		return(false);
+	}
+
+	return((GLEW_VERSION_4_3 != GL_FALSE) || (GLEW_ARB_shader_storage_buffer_object != GL_FALSE));
+}
+
+/***********************************************************
+ *  IsSparseSupported()
+ *
+ *  This method is used for checking that the context can
+ *  allocate sparse textures, whose pages are committed one
+ *  mipmap level at a time.  They need immutable storage.
+ ***********************************************************/
+bool TextureArrays::IsSparseSupported()
+{
+	if (GLEW_ARB_sparse_texture == GL_FALSE)
+	{
+		return(false);
+	}
+
+	return((GLEW_VERSION_4_2 != GL_FALSE) || (GLEW_ARB_texture_storage != GL_FALSE));
+}
+
+/***********************************************************
+ *  CanAllocateSparse()
+ *
+ *  This method is used for checking that an array of this
+ *  format can be sparse, and that its size is a whole
+ *  number of the first virtual page size of the format,
+ *  which sparse storage requires.
+ ***********************************************************/
+bool TextureArrays::CanAllocateSparse(GLenum internalFormat, int width, int height)
+{
+	if (IsSparseSupported() == false)
+	{
+		return(false);
+	}
+
+	GLint pageSizeCount = 0;
+	glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internalFormat, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &pageSizeCount);
+	if (pageSizeCount <= 0)
+	{
+		return(false);
+	}
+
+	GLint pageWidth = 0;
+	GLint pageHeight = 0;
+	glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internalFormat, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &pageWidth);
+	glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internalFormat, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &pageHeight);
+
+	return((pageWidth > 0) && (pageHeight > 0) &&
+		((width % pageWidth) == 0) && ((height % pageHeight) == 0));
+}
+
+/***********************************************************
+ *  FindArray()
+ *
+ *  This method is used for finding an array that holds
+ *  images of the same size and format and still has a free
+ *  layer.  The layers of released textures are taken first,
+ *  in built streamed arrays as well, since their levels are
+ *  uploaded after Build() anyway; otherwise an array that
+ *  has not been built yet grows by a layer.  A new array is
+ *  added when there is none.  The compressed format is 0 for
+ *  arrays of uncompressed images.  Streamed images never
+ *  share an array with the others, since their arrays may
+ *  be sparse.
+ ***********************************************************/
+int TextureArrays::FindArray(int width, int height, int colorChannels, GLenum compressedFormat, bool bStreamed)
+{
+	if (m_maxLayers == 0)
+	{
+		GLint maxLayers = 0;
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+		// 256 layers is the least any context offers
+		m_maxLayers = (maxLayers > 0) ? maxLayers : 256;
+		if (m_maxLayers > BINDLESS_LAYER_MASK)
+		{
+			m_maxLayers = BINDLESS_LAYER_MASK;
+		}
+	}
+
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		const TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if ((textureArray.freeLayers.size() > 0) &&
+			((textureArray.textureID == 0) || textureArray.bStreamed) &&
+			(textureArray.width == width) &&
+			(textureArray.height == height) &&
+			(textureArray.colorChannels == colorChannels) &&
+			(textureArray.compressedFormat == compressedFormat) &&
+			(textureArray.bAtlas == false) &&
+			(textureArray.bStreamed == bStreamed))
+		{
+			return(i);
+		}
+	}
+
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		const TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if ((textureArray.textureID == 0) &&
+			(textureArray.width == width) &&
+			(textureArray.height == height) &&
+			(textureArray.colorChannels == colorChannels) &&
+			(textureArray.compressedFormat == compressedFormat) &&
+			(textureArray.bAtlas == false) &&
+			(textureArray.bStreamed == bStreamed) &&
+			(textureArray.liveTextures == textureArray.layerCount) &&
+			(textureArray.layerCount < m_maxLayers))
+		{
+			return(i);
+		}
+	}
+
+	TEXTURE_ARRAY textureArray;
+	textureArray.width = width;
+	textureArray.height = height;
+	textureArray.colorChannels = colorChannels;
+	textureArray.compressedFormat = compressedFormat;
+	textureArray.layerCount = 0;
+	textureArray.liveTextures = 0;
+	textureArray.levelCount = ImageMipmaps::GetLevelCount(width, height);
+	textureArray.bAtlas = false;
+	textureArray.bStreamed = bStreamed;
+	textureArray.bSparse = false;
+	textureArray.tailLevel = textureArray.levelCount;
+	textureArray.bSharedTail = false;
+	textureArray.firstLevel = 0;
+	textureArray.textureID = 0;
+	textureArray.bindlessHandle = 0;
+	m_arrays.push_back(textureArray);
+
+	return((int)m_arrays.size() - 1);
+}
+
+/***********************************************************
+ *  AddImage()
+ *
+ *  This method is used for adding a decoded image to the
+ *  array of its size and format, or to the atlas when it is
+ *  small.  The pixels are copied, so the caller can free
+ *  the image right away.
+ ***********************************************************/
+int TextureArrays::AddImage(const unsigned char* pixels, int width, int height, int colorChannels)
+{
+	if (NULL == pixels)
+	{
+		return(-1);
+	}
+
+	if (IsAtlasCandidate(width, height) && ((colorChannels == 3) || (colorChannels == 4)))
+	{
+		// the page is placed by Build(), so the texture has no
+		// array until then
+		TEXTURE_LOCATION location;
+		location.arrayIndex = -1;
+		location.layer = 0;
+		location.minLevel = 0;
+		location.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		m_locations.push_back(location);
+
+		ATLAS_IMAGE atlasImage;
+		atlasImage.textureHandle = (int)m_locations.size() - 1;
+		atlasImage.width = width;
+		atlasImage.height = height;
+		atlasImage.rgbaPixels.resize((size_t)width * height * 4);
+		for (size_t i = 0; i < (size_t)width * height; i++)
+		{
+			atlasImage.rgbaPixels[(i * 4) + 0] = pixels[(i * colorChannels) + 0];
+			atlasImage.rgbaPixels[(i * 4) + 1] = pixels[(i * colorChannels) + 1];
+			atlasImage.rgbaPixels[(i * 4) + 2] = pixels[(i * colorChannels) + 2];
+			atlasImage.rgbaPixels[(i * 4) + 3] = (colorChannels == 4) ? pixels[(i * colorChannels) + 3] : 255;
+		}
+		m_atlasImages.push_back(atlasImage);
+
+		return(atlasImage.textureHandle);
+	}
+
+	int textureHandle = ReserveImage(width, height, colorChannels);
+	if (textureHandle < 0)
+	{
+		return(-1);
+	}
+
+	const TEXTURE_LOCATION& location = m_locations[textureHandle];
+	size_t imageSize = (size_t)width * height * colorChannels;
+	m_arrays[location.arrayIndex].pendingLayers[location.layer].assign(pixels, pixels + imageSize);
+
+	return(textureHandle);
+}
+
+/***********************************************************
+ *  ReserveImage()
+ *
+ *  This method is used for reserving a layer for an image
+ *  of the given size and format without its pixels.  The
+ *  layer holds no image until UploadLevel() fills it.
+ ***********************************************************/
+int TextureArrays::ReserveImage(int width, int height, int colorChannels)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return(-1);
+	}
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		return(-1);
+	}
+
+	return(ReserveLayer(width, height, colorChannels, 0, false));
+}
+
+/***********************************************************
+ *  AddCompressedImage()
+ *
+ *  This method is used for adding a block compressed image
+ *  to the array of its size and format.  The data must hold
+ *  every mipmap level down to 1x1, largest first, and is
+ *  copied, so the caller can free it right away.
+ ***********************************************************/
+int TextureArrays::AddCompressedImage(
+	const unsigned char* data,
+	size_t dataSize,
+	int width,
+	int height,
+	GLenum compressedFormat)
+{
+	if (NULL == data)
+	{
+		return(-1);
+	}
+
+	size_t chainSize = 0;
+	int levelCount = ImageMipmaps::GetLevelCount(width, height);
+	for (int level = 0; level < levelCount; level++)
+	{
+		chainSize += GetCompressedLevelSize(
+			compressedFormat,
+			std::max(width >> level, 1),
+			std::max(height >> level, 1));
+	}
+	if ((chainSize == 0) || (dataSize != chainSize))
+	{
+		return(-1);
+	}
+
+	int textureHandle = ReserveCompressedImage(width, height, compressedFormat);
+	if (textureHandle < 0)
+	{
+		return(-1);
+	}
+
+	const TEXTURE_LOCATION& location = m_locations[textureHandle];
+	m_arrays[location.arrayIndex].pendingLayers[location.layer].assign(data, data + dataSize);
+
+	return(textureHandle);
+}
+
+/***********************************************************
+ *  ReserveCompressedImage()
+ *
+ *  This method is used for reserving a layer for a block
+ *  compressed image without its data.  The layer holds no
+ *  image until UploadCompressedLevel() fills every level.
+ ***********************************************************/
+int TextureArrays::ReserveCompressedImage(int width, int height, GLenum compressedFormat)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return(-1);
+	}
+	if (GetCompressedLevelSize(compressedFormat, 1, 1) == 0)
+	{
+		std::cout << "Not implemented to handle compressed format 0x" << std::hex << compressedFormat << std::dec << std::endl;
+		return(-1);
+	}
+
+	int colorChannels = (compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? 3 : 4;
+
+	return(ReserveLayer(width, height, colorChannels, compressedFormat, false));
+}
+
+/***********************************************************
+ *  ReserveStreamedImage()
+ *
+ *  This method is used for reserving a layer for an image
+ *  whose mipmap levels are streamed in and out after
+ *  Build(), with UploadLevel() or UploadCompressedLevel().
+ *  The array is sparse when the context and the format
+ *  allow it, so the pages of a level must be committed with
+ *  CommitLevels() before it is uploaded.
+ ***********************************************************/
+int TextureArrays::ReserveStreamedImage(int width, int height, int colorChannels, GLenum compressedFormat)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return(-1);
+	}
+	if (compressedFormat != 0)
+	{
+		if (GetCompressedLevelSize(compressedFormat, 1, 1) == 0)
+		{
+			std::cout << "Not implemented to handle compressed format 0x" << std::hex << compressedFormat << std::dec << std::endl;
+			return(-1);
+		}
+		colorChannels = (compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? 3 : 4;
+	}
+	else if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		return(-1);
+	}
+
+	return(ReserveLayer(width, height, colorChannels, compressedFormat, true));
+}
+
+/***********************************************************
+ *  ReserveLayer()
+ *
+ *  This method is used for giving an image a released layer
+ *  of the array of its size and format, or the next one.
+ ***********************************************************/
+int TextureArrays::ReserveLayer(int width, int height, int colorChannels, GLenum compressedFormat, bool bStreamed)
+{
+	int arrayIndex = FindArray(width, height, colorChannels, compressedFormat, bStreamed);
+	TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+
+	TEXTURE_LOCATION location;
+	location.arrayIndex = arrayIndex;
+	location.minLevel = 0;
+	location.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	if (textureArray.freeLayers.size() > 0)
+	{
+		location.layer = textureArray.freeLayers.back();
+		textureArray.freeLayers.pop_back();
+		// a built array dropped its image copies, so one that
+		// was deleted needs the entries back to be built again
+		if ((textureArray.textureID == 0) && (textureArray.pendingLayers.size() < textureArray.layerCount))
+		{
+			textureArray.pendingLayers.resize(textureArray.layerCount);
+		}
+	}
+	else
+	{
+		location.layer = textureArray.layerCount;
+		textureArray.pendingLayers.push_back(std::vector<unsigned char>());
+		textureArray.layerCount++;
+	}
+	textureArray.liveTextures++;
+	m_locations.push_back(location);
+
+	return((int)m_locations.size() - 1);
+}
+
+/***********************************************************
+ *  GetTextureCount()
+ *
+ *  This method is used for getting the number of images
+ *  that have been added.
+ ***********************************************************/
+int TextureArrays::GetTextureCount() const
+{
+	return((int)m_locations.size());
+}
+
+/***********************************************************
+ *  SetAtlasEnabled()
+ *
+ *  This method is used for turning the packing of small
+ *  images into atlas pages on or off, for the images added
+ *  from then on.
+ ***********************************************************/
+void TextureArrays::SetAtlasEnabled(bool bEnable)
+{
+	m_bUseAtlas = bEnable;
+}
+
+/***********************************************************
+ *  SetStreamedBudget()
+ *
+ *  This method is used for setting how many bytes the
+ *  streamed arrays that cannot be sparse may allocate.  It
+ *  applies to the arrays built afterwards.
+ ***********************************************************/
+void TextureArrays::SetStreamedBudget(size_t budgetBytes)
+{
+	m_streamedBudget = budgetBytes;
+}
+
+/***********************************************************
+ *  IsAtlasCandidate()
+ *
+ *  This method is used for checking whether an image of
+ *  this size is packed into the atlas when it is added.
+ ***********************************************************/
+bool TextureArrays::IsAtlasCandidate(int width, int height) const
+{
+	return(m_bUseAtlas &&
+		(width > 0) && (height > 0) &&
+		(width <= ATLAS_MAX_IMAGE_SIZE) && (height <= ATLAS_MAX_IMAGE_SIZE));
+}
+
+/***********************************************************
+ *  PackAtlasImages()
+ *
+ *  This method is used for packing the waiting atlas images
+ *  into as few pages as they fit, tallest first, and adding
+ *  the pages as the layers of a new atlas array for Build()
+ *  to upload.  Every image is placed with its gutter on a
+ *  rectangle aligned to the gutter size, and the gutter is
+ *  filled with the texels across the opposite edge, so a
+ *  repeating texture filters across its edges the same way
+ *  it would on its own.
+ ***********************************************************/
+void TextureArrays::PackAtlasImages()
+{
+	if (m_atlasImages.empty())
+	{
+		return;
+	}
+
+	// tallest first keeps the skyline low
+	std::vector<int> order(m_atlasImages.size());
+	for (int i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [this](int first, int second)
+		{
+			return(m_atlasImages[first].height > m_atlasImages[second].height);
+		});
+
+	TEXTURE_ARRAY atlasArray;
+	atlasArray.width = ATLAS_PAGE_SIZE;
+	atlasArray.height = ATLAS_PAGE_SIZE;
+	atlasArray.colorChannels = 4;
+	atlasArray.compressedFormat = 0;
+	atlasArray.layerCount = 0;
+	atlasArray.liveTextures = 0;
+	atlasArray.levelCount = std::min(ATLAS_LEVEL_COUNT, ImageMipmaps::GetLevelCount(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE));
+	atlasArray.bAtlas = true;
+	atlasArray.bStreamed = false;
+	atlasArray.bSparse = false;
+	atlasArray.tailLevel = atlasArray.levelCount;
+	atlasArray.bSharedTail = false;
+	atlasArray.firstLevel = 0;
+	atlasArray.textureID = 0;
+	atlasArray.bindlessHandle = 0;
+
+	const int arrayIndex = (int)m_arrays.size();
+	const size_t pageBytes = (size_t)ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4;
+	std::vector<AtlasPacker> pages;
+
+	for (int i = 0; i < order.size(); i++)
+	{
+		const ATLAS_IMAGE& atlasImage = m_atlasImages[order[i]];
+		int paddedWidth = ((atlasImage.width + (2 * ATLAS_GUTTER) + ATLAS_GUTTER - 1) / ATLAS_GUTTER) * ATLAS_GUTTER;
+		int paddedHeight = ((atlasImage.height + (2 * ATLAS_GUTTER) + ATLAS_GUTTER - 1) / ATLAS_GUTTER) * ATLAS_GUTTER;
+
+		int page = 0;
+		int x = 0;
+		int y = 0;
+		while ((page < pages.size()) && (pages[page].Insert(paddedWidth, paddedHeight, x, y) == false))
+		{
+			page++;
+		}
+		if (page == pages.size())
+		{
+			pages.push_back(AtlasPacker());
+			pages[page].Reset(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+			pages[page].Insert(paddedWidth, paddedHeight, x, y);
+			atlasArray.pendingLayers.push_back(std::vector<unsigned char>(pageBytes, 0));
+		}
+
+		// copy the image with its wrapped gutter into the page
+		unsigned char* pagePixels = atlasArray.pendingLayers[page].data();
+		for (int row = 0; row < paddedHeight; row++)
+		{
+			int sourceRow = (row - ATLAS_GUTTER + (atlasImage.height * 2)) % atlasImage.height;
+			for (int column = 0; column < paddedWidth; column++)
+			{
+				int sourceColumn = (column - ATLAS_GUTTER + (atlasImage.width * 2)) % atlasImage.width;
+				memcpy(
+					&pagePixels[((((size_t)y + row) * ATLAS_PAGE_SIZE) + x + column) * 4],
+					&atlasImage.rgbaPixels[(((size_t)sourceRow * atlasImage.width) + sourceColumn) * 4],
+					4);
+			}
+		}
+
+		TEXTURE_LOCATION& location = m_locations[atlasImage.textureHandle];
+		location.arrayIndex = arrayIndex;
+		location.layer = page;
+		location.uvRect = glm::vec4(
+			(float)(x + ATLAS_GUTTER) / ATLAS_PAGE_SIZE,
+			(float)(y + ATLAS_GUTTER) / ATLAS_PAGE_SIZE,
+			(float)atlasImage.width / ATLAS_PAGE_SIZE,
+			(float)atlasImage.height / ATLAS_PAGE_SIZE);
+		atlasArray.liveTextures++;
+	}
+
+	atlasArray.layerCount = (int)pages.size();
+	m_arrays.push_back(atlasArray);
+
+	float occupancy = 0.0f;
+	for (int page = 0; page < pages.size(); page++)
+	{
+		occupancy += pages[page].GetOccupancy();
+	}
+	std::cout << "INFO: Packed " << m_atlasImages.size() << " small textures into "
+		<< pages.size() << " atlas pages, " << (int)((occupancy * 100.0f) / pages.size())
+		<< "% filled" << std::endl;
+
+	m_atlasImages.clear();
+}
+
+/***********************************************************
+ *  GetArrayLevelSize()
+ *
+ *  This method is used for getting the bytes of one mipmap
+ *  level of every layer of an array.
+ ***********************************************************/
+size_t TextureArrays::GetArrayLevelSize(const TEXTURE_ARRAY& textureArray, int level)
+{
+	int levelWidth = std::max(textureArray.width >> level, 1);
+	int levelHeight = std::max(textureArray.height >> level, 1);
+	size_t levelSize = (size_t)levelWidth * levelHeight * textureArray.colorChannels;
+	if (textureArray.compressedFormat != 0)
+	{
+		levelSize = GetCompressedLevelSize(textureArray.compressedFormat, levelWidth, levelHeight);
+	}
+
+	return(levelSize * textureArray.layerCount);
+}
+
+/***********************************************************
+ *  FitStreamedArrays()
+ *
+ *  This method is used for deciding which of the streamed
+ *  arrays about to be built can be sparse.  The others hold
+ *  every level they store whatever is resident, so levels
+ *  cannot be evicted from them.  Instead, while they would
+ *  take more than the budget, the finest stored level of
+ *  the one where that frees the most is dropped.  Levels
+ *  down to MIN_STORED_LEVEL_SIZE are always kept, so the
+ *  budget can still be exceeded.
+ ***********************************************************/
+void TextureArrays::FitStreamedArrays()
+{
+	size_t allocatedBytes = 0;
+	std::vector<int> fittedArrays;
+	for (int i = 0; i < (int)m_arrays.size(); i++)
+	{
+		TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if ((textureArray.bStreamed == false) || ((textureArray.textureID != 0) && textureArray.bSparse))
+		{
+			continue;
+		}
+
+		if (textureArray.textureID == 0)
+		{
+			if (textureArray.liveTextures == 0)
+			{
+				continue;
+			}
+
+			GLenum storageFormat = textureArray.compressedFormat;
+			if (storageFormat == 0)
+			{
+				storageFormat = (textureArray.colorChannels == 4) ? GL_RGBA8 : GL_RGB8;
+			}
+			textureArray.bSparse = CanAllocateSparse(storageFormat, textureArray.width, textureArray.height);
+			if (textureArray.bSparse)
+			{
+				continue;
+			}
+			textureArray.firstLevel = 0;
+			fittedArrays.push_back(i);
+		}
+
+		for (int level = textureArray.firstLevel; level < textureArray.levelCount; level++)
+		{
+			allocatedBytes += GetArrayLevelSize(textureArray, level);
+		}
+	}
+
+	while ((m_streamedBudget > 0) && (allocatedBytes > m_streamedBudget))
+	{
+		int bestArray = -1;
+		size_t bestBytes = 0;
+		for (int i = 0; i < (int)fittedArrays.size(); i++)
+		{
+			const TEXTURE_ARRAY& textureArray = m_arrays[fittedArrays[i]];
+			int nextLevel = textureArray.firstLevel + 1;
+			if ((nextLevel >= textureArray.levelCount) ||
+				(std::max(textureArray.width >> nextLevel, textureArray.height >> nextLevel) < MIN_STORED_LEVEL_SIZE))
+			{
+				continue;
+			}
+
+			size_t levelBytes = GetArrayLevelSize(textureArray, textureArray.firstLevel);
+			if (levelBytes > bestBytes)
+			{
+				bestArray = fittedArrays[i];
+				bestBytes = levelBytes;
+			}
+		}
+
+		if (bestArray < 0)
+		{
+			break;
+		}
+		m_arrays[bestArray].firstLevel++;
+		allocatedBytes -= bestBytes;
+	}
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for creating an array texture for
+ *  every array that is still waiting for one, allocating
+ *  every mipmap level, uploading the images it already has
+ *  one layer at a time and generating their mipmaps.
+ *  Compressed images already carry their mipmaps, so their
+ *  levels are uploaded one by one instead.  Streamed arrays
+ *  are given sparse immutable storage when they can have
+ *  it, with no pages committed, and the others may go
+ *  without their finest levels to fit the budget.  Arrays
+ *  that were already built are left alone, so more images
+ *  can be added and built later.
+ ***********************************************************/
+bool TextureArrays::Build()
+{
+	bool bBuilt = false;
+
+	PackAtlasImages();
+	FitStreamedArrays();
+
+	// the rows of RGB images are not always 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if ((textureArray.textureID != 0) || (textureArray.liveTextures == 0))
+		{
+			continue;
+		}
+
+		GLint internalFormat = (textureArray.colorChannels == 4) ? GL_RGBA8 : GL_RGB8;
+		GLenum format = (textureArray.colorChannels == 4) ? GL_RGBA : GL_RGB;
+
+		glGenTextures(1, &textureArray.textureID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.textureID);
+
+		// set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// set texture filtering parameters
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST); // AH: Noise Reduction
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		// FitStreamedArrays() decided whether it is sparse
+		GLenum storageFormat = (textureArray.compressedFormat != 0) ? textureArray.compressedFormat : internalFormat;
+		if (textureArray.bSparse)
+		{
+			// only the address space is reserved, the pages of
+			// each level are committed as it is streamed in
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+			glTexStorage3D(
+				GL_TEXTURE_2D_ARRAY, textureArray.levelCount, storageFormat,
+				textureArray.width, textureArray.height, textureArray.layerCount);
+
+			GLint sparseLevels = 0;
+			glGetTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_NUM_SPARSE_LEVELS_ARB, &sparseLevels);
+			textureArray.tailLevel = std::min(std::max((int)sparseLevels, 0), textureArray.levelCount);
+
+			// without full array mipmaps the mip tail of every
+			// layer is a single allocation, and freeing it for
+			// one layer would free it for all of them - it is
+			// committed here for the whole array and kept
+			GLboolean bFullArrayMipmaps = GL_FALSE;
+			glGetBooleanv(GL_SPARSE_TEXTURE_FULL_ARRAY_CUBE_MIPMAPS_ARB, &bFullArrayMipmaps);
+			textureArray.bSharedTail = (bFullArrayMipmaps == GL_FALSE);
+			if (textureArray.bSharedTail && (textureArray.tailLevel < textureArray.levelCount))
+			{
+				glTexPageCommitmentARB(
+					GL_TEXTURE_2D_ARRAY, textureArray.tailLevel,
+					0, 0, 0,
+					std::max(textureArray.width >> textureArray.tailLevel, 1),
+					std::max(textureArray.height >> textureArray.tailLevel, 1),
+					textureArray.layerCount,
+					GL_TRUE);
+			}
+		}
+
+		// allocate every stored level, since reserved layers are
+		// uploaded level by level later
+		for (int level = textureArray.firstLevel; (level < textureArray.levelCount) && (textureArray.bSparse == false); level++)
+		{
+			int levelWidth = std::max(textureArray.width >> level, 1);
+			int levelHeight = std::max(textureArray.height >> level, 1);
+			int storedLevel = level - textureArray.firstLevel;
+			if (textureArray.compressedFormat != 0)
+			{
+				size_t levelSize = GetCompressedLevelSize(textureArray.compressedFormat, levelWidth, levelHeight);
+				glCompressedTexImage3D(
+					GL_TEXTURE_2D_ARRAY, storedLevel, textureArray.compressedFormat,
+					levelWidth, levelHeight, textureArray.layerCount,
+					0, (GLsizei)(levelSize * textureArray.layerCount), NULL);
+			}
+			else
+			{
+				glTexImage3D(
+					GL_TEXTURE_2D_ARRAY, storedLevel, internalFormat,
+					levelWidth, levelHeight, textureArray.layerCount,
+					0, format, GL_UNSIGNED_BYTE, NULL);
+			}
+		}
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, textureArray.levelCount - textureArray.firstLevel - 1);
+
+		int uploadedLayers = 0;
+		for (int layer = 0; layer < textureArray.pendingLayers.size(); layer++)
+		{
+			const std::vector<unsigned char>& pending = textureArray.pendingLayers[layer];
+			if (pending.empty())
+			{
+				continue;
+			}
+
+			if (textureArray.compressedFormat != 0)
+			{
+				size_t offset = 0;
+				for (int level = 0; level < textureArray.levelCount; level++)
+				{
+					int levelWidth = std::max(textureArray.width >> level, 1);
+					int levelHeight = std::max(textureArray.height >> level, 1);
+					size_t levelSize = GetCompressedLevelSize(textureArray.compressedFormat, levelWidth, levelHeight);
+					glCompressedTexSubImage3D(
+						GL_TEXTURE_2D_ARRAY, level,
+						0, 0, layer,
+						levelWidth, levelHeight, 1,
+						textureArray.compressedFormat, (GLsizei)levelSize, &pending[offset]);
+					offset += levelSize;
+				}
+			}
+			else
+			{
+				glTexSubImage3D(
+					GL_TEXTURE_2D_ARRAY, 0,
+					0, 0, layer,
+					textureArray.width, textureArray.height, 1,
+					format, GL_UNSIGNED_BYTE, pending.data());
+				uploadedLayers++;
+			}
+		}
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		if (uploadedLayers > 0)
+		{
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		}
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		// the images are on the GPU now
+		std::vector<std::vector<unsigned char> >().swap(textureArray.pendingLayers);
+
+		const char* formatName = (textureArray.colorChannels == 4) ? " RGBA" : " RGB";
+		switch (textureArray.compressedFormat)
+		{
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+			formatName = " BC1";
+			break;
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			formatName = " BC3";
+			break;
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+			formatName = " BC7";
+			break;
+		}
+		std::cout << "INFO: Texture array " << i << " holds " << textureArray.layerCount
+			<< " layers of " << textureArray.width << "x" << textureArray.height
+			<< formatName << (textureArray.bAtlas ? " atlas pages" : "")
+			<< (textureArray.bSparse ? " sparse" : (textureArray.bStreamed ? " streamed" : "")) << std::endl;
+		if (textureArray.bStreamed && (textureArray.bSparse == false))
+		{
+			std::cout << "WARNING: Texture array " << i
+				<< " cannot be sparse, so its levels are never evicted";
+			if (textureArray.firstLevel > 0)
+			{
+				std::cout << " and its finest " << textureArray.firstLevel
+					<< " levels are dropped to fit the texture memory budget";
+			}
+			std::cout << std::endl;
+		}
+
+		bBuilt = true;
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// arrays added since the handles were uploaded need to be
+	// made resident as well
+	if (bBuilt && m_bBindless)
+	{
+		EnableBindless();
+	}
+
+	return(bBuilt);
+}
+
+/***********************************************************
+ *  EnableBindless()
+ *
+ *  This method is used for making every built array
+ *  resident and uploading the handles into the shader
+ *  storage buffer, indexed by the array index.  The shader
+ *  layer only has room for so many array indices, and past
+ *  that the arrays would be mixed up, so bindless sampling
+ *  is turned off instead and the arrays must be bound.
+ ***********************************************************/
+bool TextureArrays::EnableBindless()
+{
+	if ((IsBindlessSupported() == false) || (m_arrays.size() == 0))
+	{
+		return(false);
+	}
+
+	if (m_arrays.size() > BINDLESS_ARRAY_MASK + 1)
+	{
+		std::cout << "WARNING: " << m_arrays.size() << " texture arrays but only "
+			<< (BINDLESS_ARRAY_MASK + 1) << " can be addressed bindless, binding them instead" << std::endl;
+		m_bBindless = false;
+		return(false);
+	}
+
+	std::vector<GLuint64> handles(m_arrays.size(), 0);
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if ((textureArray.textureID != 0) && (textureArray.bindlessHandle == 0))
+		{
+			textureArray.bindlessHandle = glGetTextureHandleARB(textureArray.textureID);
+			glMakeTextureHandleResidentARB(textureArray.bindlessHandle);
+		}
+		handles[i] = textureArray.bindlessHandle;
+	}
+
+	if (m_handleBuffer == 0)
+	{
+		glGenBuffers(1, &m_handleBuffer);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_handleBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, handles.size() * sizeof(GLuint64), handles.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HANDLE_BINDING_POINT, m_handleBuffer);
+
+	m_bBindless = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsBindless()
+ *
+ *  This method is used for checking whether the arrays are
+ *  sampled through their bindless handles.
+ ***********************************************************/
+bool TextureArrays::IsBindless() const
+{
+	return(m_bBindless);
+}
+
+/***********************************************************
+ *  UploadLevel()
+ *
+ *  This method is used for uploading one mipmap level of a
+ *  layer into its built array.  When a pixel unpack buffer
+ *  is bound, pixels is an offset into that buffer and the
+ *  copy does not stall the caller.  Atlas pages hold no
+ *  reserved layers.  The array bound to the active unit is
+ *  put back afterwards, since the draws sample it.  A level
+ *  the array dropped to fit the budget is skipped.
+ ***********************************************************/
+bool TextureArrays::UploadLevel(
+	int textureHandle,
+	int level,
+	int width,
+	int height,
+	int colorChannels,
+	const void* pixels)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(false);
+	}
+
+	const TEXTURE_LOCATION& location = m_locations[textureHandle];
+	if (location.arrayIndex < 0)
+	{
+		return(false);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[location.arrayIndex];
+	if ((textureArray.textureID == 0) ||
+		(level < 0) || (level >= textureArray.levelCount) ||
+		(width != std::max(textureArray.width >> level, 1)) ||
+		(height != std::max(textureArray.height >> level, 1)) ||
+		(colorChannels != textureArray.colorChannels) ||
+		(textureArray.compressedFormat != 0) ||
+		textureArray.bAtlas)
+	{
+		return(false);
+	}
+	if (level < textureArray.firstLevel)
+	{
+		return(true);
+	}
+
+	GLenum format = (textureArray.colorChannels == 4) ? GL_RGBA : GL_RGB;
+
+	GLuint previousID = BindArrayForUpdate(textureArray.textureID);
+	glTexSubImage3D(
+		GL_TEXTURE_2D_ARRAY, level - textureArray.firstLevel,
+		0, 0, location.layer,
+		width, height, 1,
+		format, GL_UNSIGNED_BYTE, pixels);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, previousID);
+
+	return(true);
+}
+
+/***********************************************************
+ *  UploadCompressedLevel()
+ *
+ *  This method is used for uploading one mipmap level of a
+ *  compressed layer into its built array.  Like UploadLevel()
+ *  the data may be an offset into the bound pixel unpack
+ *  buffer, and a dropped level is skipped.
+ ***********************************************************/
+bool TextureArrays::UploadCompressedLevel(
+	int textureHandle,
+	int level,
+	int width,
+	int height,
+	size_t dataSize,
+	const void* data)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(false);
+	}
+
+	const TEXTURE_LOCATION& location = m_locations[textureHandle];
+	if (location.arrayIndex < 0)
+	{
+		return(false);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[location.arrayIndex];
+	if ((textureArray.textureID == 0) ||
+		(textureArray.compressedFormat == 0) ||
+		(level < 0) || (level >= textureArray.levelCount) ||
+		(width != std::max(textureArray.width >> level, 1)) ||
+		(height != std::max(textureArray.height >> level, 1)) ||
+		(dataSize != GetCompressedLevelSize(textureArray.compressedFormat, width, height)))
+	{
+		return(false);
+	}
+	if (level < textureArray.firstLevel)
+	{
+		return(true);
+	}
+
+	GLuint previousID = BindArrayForUpdate(textureArray.textureID);
+	glCompressedTexSubImage3D(
+		GL_TEXTURE_2D_ARRAY, level - textureArray.firstLevel,
+		0, 0, location.layer,
+		width, height, 1,
+		textureArray.compressedFormat, (GLsizei)dataSize, data);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, previousID);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetCompressedLevelSize()
+ *
+ *  This method is used for getting the bytes of one level
+ *  of a block compressed format, which stores every 4x4
+ *  block of texels in 8 or 16 bytes.  Unknown formats have
+ *  a size of 0.
+ ***********************************************************/
+size_t TextureArrays::GetCompressedLevelSize(GLenum compressedFormat, int width, int height)
+{
+	size_t blockBytes = 0;
+	switch (compressedFormat)
+	{
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		blockBytes = 8;
+		break;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		blockBytes = 16;
+		break;
+	}
+
+	return(((size_t)(width + 3) / 4) * ((size_t)(height + 3) / 4) * blockBytes);
+}
+
+/***********************************************************
+ *  CommitLevels()
+ *
+ *  This method is used for committing or freeing the pages
+ *  of the levels firstLevel to endLevel - 1 of a layer in a
+ *  sparse array.  Whole levels are committed, which needs
+ *  no alignment to the page size.  The levels of the mip
+ *  tail share their pages, so the tail is committed as a
+ *  whole when the range reaches it, unless the layers share
+ *  one tail that was committed with the array.  Arrays that
+ *  are not sparse hold every level already, so nothing is
+ *  done.  Like the uploads, the binding of the active unit
+ *  is put back afterwards.
+ ***********************************************************/
+bool TextureArrays::CommitLevels(int textureHandle, int firstLevel, int endLevel, bool bCommit)
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if (arrayIndex < 0)
+	{
+		return(false);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	if ((textureArray.bSparse == false) || (textureArray.textureID == 0))
+	{
+		return(true);
+	}
+
+	firstLevel = std::max(firstLevel, 0);
+	endLevel = std::min(endLevel, textureArray.levelCount);
+	if (textureArray.bSharedTail)
+	{
+		endLevel = std::min(endLevel, textureArray.tailLevel);
+	}
+	else if (endLevel > textureArray.tailLevel)
+	{
+		firstLevel = std::min(firstLevel, textureArray.tailLevel);
+		endLevel = textureArray.tailLevel + 1;
+	}
+
+	GLuint previousID = BindArrayForUpdate(textureArray.textureID);
+	for (int level = firstLevel; level < endLevel; level++)
+	{
+		glTexPageCommitmentARB(
+			GL_TEXTURE_2D_ARRAY, level,
+			0, 0, m_locations[textureHandle].layer,
+			std::max(textureArray.width >> level, 1),
+			std::max(textureArray.height >> level, 1),
+			1,
+			bCommit ? GL_TRUE : GL_FALSE);
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, previousID);
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReleaseImage()
+ *
+ *  This method is used for freeing the layer of a texture
+ *  that is no longer used.  Single layers cannot be freed
+ *  on the GPU, so the array texture is deleted once the
+ *  last of its textures is released, and an array that was
+ *  not built yet drops the image copy right away.  The layer
+ *  is kept for the next image of the same size and format.
+ *  Atlas pages keep their texels until the whole page array
+ *  goes.  The pages of a layer in a sparse array are freed
+ *  at once.
+ ***********************************************************/
+bool TextureArrays::ReleaseImage(int textureHandle)
+{
+	for (int i = 0; i < m_atlasImages.size(); i++)
+	{
+		if (m_atlasImages[i].textureHandle == textureHandle)
+		{
+			m_atlasImages.erase(m_atlasImages.begin() + i);
+			return(true);
+		}
+	}
+
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()) ||
+		(m_locations[textureHandle].arrayIndex < 0))
+	{
+		return(false);
+	}
+
+	CommitLevels(textureHandle, 0, GetLevelCount(textureHandle), false);
+
+	TEXTURE_LOCATION& location = m_locations[textureHandle];
+	TEXTURE_ARRAY& textureArray = m_arrays[location.arrayIndex];
+	if ((textureArray.bAtlas == false) && (location.layer < textureArray.pendingLayers.size()))
+	{
+		std::vector<unsigned char>().swap(textureArray.pendingLayers[location.layer]);
+	}
+	if (textureArray.bAtlas == false)
+	{
+		textureArray.freeLayers.push_back(location.layer);
+	}
+	textureArray.liveTextures--;
+
+	if ((textureArray.liveTextures == 0) && (textureArray.textureID != 0))
+	{
+		if (textureArray.bindlessHandle != 0)
+		{
+			glMakeTextureHandleNonResidentARB(textureArray.bindlessHandle);
+			textureArray.bindlessHandle = 0;
+		}
+		glDeleteTextures(1, &textureArray.textureID);
+		textureArray.textureID = 0;
+		// the array is built afresh if its layers are reused
+		textureArray.bSparse = false;
+		textureArray.tailLevel = textureArray.levelCount;
+		textureArray.bSharedTail = false;
+		textureArray.firstLevel = 0;
+
+		std::cout << "INFO: Texture array " << location.arrayIndex << " released" << std::endl;
+
+		// clear the handle of the deleted array
+		if (m_bBindless)
+		{
+			EnableBindless();
+		}
+	}
+
+	location.arrayIndex = -1;
+	location.layer = 0;
+	location.minLevel = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BindArrays()
+ *
+ *  This method is used for binding every built array to the
+ *  texture unit matching its index.  The arrays past the
+ *  last unit are not bound, and GetTextureUnit() gives -1
+ *  for their textures so they are drawn in their flat color
+ *  rather than sampling whatever is bound to another unit.
+ ***********************************************************/
+bool TextureArrays::BindArrays(RenderStateCache* pStateCache)
+{
+	if (m_maxTextureUnits == 0)
+	{
+		GLint maxUnits = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+		// 16 units is the least any context offers
+		m_maxTextureUnits = (maxUnits > 0) ? maxUnits : 16;
+	}
+
+	int arrayCount = (int)m_arrays.size();
+	if (arrayCount > m_maxTextureUnits)
+	{
+		std::cout << "WARNING: " << arrayCount << " texture arrays but only "
+			<< m_maxTextureUnits << " texture units, the textures of the other "
+			<< (arrayCount - m_maxTextureUnits) << " arrays are drawn untextured" << std::endl;
+	}
+
+	for (int i = 0; (i < arrayCount) && (i < m_maxTextureUnits); i++)
+	{
+		if (NULL != pStateCache)
+		{
+			pStateCache->BindTexture(i, GL_TEXTURE_2D_ARRAY, m_arrays[i].textureID);
+		}
+		else
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].textureID);
+		}
+	}
+
+	return(arrayCount <= m_maxTextureUnits);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for deleting the array textures and
+ *  forgetting every added image.
+ ***********************************************************/
+void TextureArrays::Destroy()
+{
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		if (m_arrays[i].bindlessHandle != 0)
+		{
+			glMakeTextureHandleNonResidentARB(m_arrays[i].bindlessHandle);
+		}
+		if (m_arrays[i].textureID != 0)
+		{
+			glDeleteTextures(1, &m_arrays[i].textureID);
+		}
+	}
+	if (m_handleBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_handleBuffer);
+		m_handleBuffer = 0;
+	}
+
+	m_arrays.clear();
+	m_locations.clear();
+	m_atlasImages.clear();
+	m_bBindless = false;
+}
+
+/***********************************************************
+ *  GetArrayCount()
+ *
+ *  This method is used for getting the number of arrays.
+ ***********************************************************/
+int TextureArrays::GetArrayCount() const
+{
+	return((int)m_arrays.size());
+}
+
+/***********************************************************
+ *  GetArrayID()
+ *
+ *  This method is used for getting the OpenGL texture of an
+ *  array, which is 0 until the array is built.
+ ***********************************************************/
+GLuint TextureArrays::GetArrayID(int arrayIndex) const
+{
+	if ((arrayIndex < 0) || (arrayIndex >= m_arrays.size()))
+	{
+		return(0);
+	}
+
+	return(m_arrays[arrayIndex].textureID);
+}
+
+/***********************************************************
+ *  GetArrayIndex()
+ *
+ *  This method is used for getting the array that holds a
+ *  texture, or -1 for an unknown handle.
+ ***********************************************************/
+int TextureArrays::GetArrayIndex(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(-1);
+	}
+
+	return(m_locations[textureHandle].arrayIndex);
+}
+
+/***********************************************************
+ *  GetLayer()
+ *
+ *  This method is used for getting the layer that holds a
+ *  texture inside its array.
+ ***********************************************************/
+int TextureArrays::GetLayer(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(0);
+	}
+
+	return(m_locations[textureHandle].layer);
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method is used for getting the number of mipmap
+ *  levels of the array that holds a texture.
+ ***********************************************************/
+int TextureArrays::GetLevelCount(int textureHandle) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if (arrayIndex < 0)
+	{
+		return(0);
+	}
+
+	return(m_arrays[arrayIndex].levelCount);
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the bytes one mipmap
+ *  level of a texture takes, as it is uploaded.
+ ***********************************************************/
+size_t TextureArrays::GetLevelSize(int textureHandle, int level) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if ((arrayIndex < 0) || (level < 0) || (level >= m_arrays[arrayIndex].levelCount))
+	{
+		return(0);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	int levelWidth = std::max(textureArray.width >> level, 1);
+	int levelHeight = std::max(textureArray.height >> level, 1);
+	if (textureArray.compressedFormat != 0)
+	{
+		return(GetCompressedLevelSize(textureArray.compressedFormat, levelWidth, levelHeight));
+	}
+
+	return((size_t)levelWidth * levelHeight * textureArray.colorChannels);
+}
+
+/***********************************************************
+ *  GetFirstStoredLevel()
+ *
+ *  This method is used for getting the finest mipmap level
+ *  the array of a texture stores.  It is above zero only
+ *  when the array cannot be sparse and its finest levels
+ *  were dropped to fit the budget.
+ ***********************************************************/
+int TextureArrays::GetFirstStoredLevel(int textureHandle) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if (arrayIndex < 0)
+	{
+		return(0);
+	}
+
+	return(m_arrays[arrayIndex].firstLevel);
+}
+
+/***********************************************************
+ *  IsSparse()
+ *
+ *  This method is used for checking whether the levels of a
+ *  texture only take memory once they are committed.  This
+ *  is known once its array is built.
+ ***********************************************************/
+bool TextureArrays::IsSparse(int textureHandle) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if (arrayIndex < 0)
+	{
+		return(false);
+	}
+
+	return(m_arrays[arrayIndex].bSparse);
+}
+
+/***********************************************************
+ *  GetTailLevel()
+ *
+ *  This method is used for getting the first level of the
+ *  mip tail of a sparse texture.  The levels from there on
+ *  are too small for a page of their own and are committed
+ *  together.
+ ***********************************************************/
+int TextureArrays::GetTailLevel(int textureHandle) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if (arrayIndex < 0)
+	{
+		return(0);
+	}
+
+	return(m_arrays[arrayIndex].tailLevel);
+}
+
+/***********************************************************
+ *  SetMinLevel()
+ *
+ *  This method is used for setting the finest mipmap level
+ *  the shader samples for a texture, so that the levels
+ *  above it can be left empty.  It takes effect for draws
+ *  that read GetShaderLayer() afterwards.
+ ***********************************************************/
+void TextureArrays::SetMinLevel(int textureHandle, int level)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return;
+	}
+
+	m_locations[textureHandle].minLevel = std::min(std::max(level, 0), MAX_MIN_LEVEL);
+}
+
+/***********************************************************
+ *  GetMinLevel()
+ *
+ *  This method is used for getting the finest mipmap level
+ *  the shader samples for a texture.
+ ***********************************************************/
+int TextureArrays::GetMinLevel(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(0);
+	}
+
+	return(m_locations[textureHandle].minLevel);
+}
+
+/***********************************************************
+ *  GetTextureUnit()
+ *
+ *  This method is used for getting the texture unit that
+ *  the sampler must use for a texture, which is the index
+ *  of its array.  Draws are batched by this value, so even
+ *  with bindless arrays every draw samples a single array
+ *  and the handle it reads stays uniform across the draw.
+ *  An array past the last texture unit has no unit to be
+ *  sampled from, so -1 is returned for its textures.
+ ***********************************************************/
+int TextureArrays::GetTextureUnit(int textureHandle) const
+{
+	int arrayIndex = GetArrayIndex(textureHandle);
+	if ((m_bBindless == false) && (m_maxTextureUnits > 0) && (arrayIndex >= m_maxTextureUnits))
+	{
+		return(-1);
+	}
+
+	return(arrayIndex);
+}
+
+/***********************************************************
+ *  GetShaderLayer()
+ *
+ *  This method is used for getting the layer value that the
+ *  shader reads for a texture.  When the arrays are bindless
+ *  the array index is packed above the layer, so the shader
+ *  can look up the handle of the array as well.  The finest
+ *  level to sample is packed above both, counted from the
+ *  finest level the array stores.
+ ***********************************************************/
+int TextureArrays::GetShaderLayer(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(0);
+	}
+
+	const TEXTURE_LOCATION& location = m_locations[textureHandle];
+	if (location.arrayIndex < 0)
+	{
+		return(0);
+	}
+	int minLevel = std::max(location.minLevel - m_arrays[location.arrayIndex].firstLevel, 0);
+	int shaderLayer = location.layer | (minLevel << MIN_LEVEL_SHIFT);
+	if (m_bBindless)
+	{
+		shaderLayer |= (location.arrayIndex & BINDLESS_ARRAY_MASK) << BINDLESS_LAYER_BITS;
+	}
+
+	return(shaderLayer);
+}
+
+/***********************************************************
+ *  GetUVRect()
+ *
+ *  This method is used for getting the rectangle of a
+ *  texture inside its layer as an offset and a size in
+ *  texture coordinates.  The shader wraps the texture
+ *  coordinates of a draw into this rectangle.
+ ***********************************************************/
+glm::vec4 TextureArrays::GetUVRect(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_locations.size()))
+	{
+		return(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+	}
+
+	return(m_locations[textureHandle].uvRect);
+}
@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.h
+// ============
+// group the scene textures by size and format into 2D array textures, so a
+// draw selects its texture by a layer index instead of a texture unit
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderStateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TextureArrays
+ *
+ *  This class collects decoded images and places each one
+ *  in a layer of a GL_TEXTURE_2D_ARRAY holding only images
+ *  of the same width, height and format.  The images are
+ *  kept in memory until Build() creates the array textures,
+ *  so the number of layers of every array is known before
+ *  its storage is allocated.  A layer can also be reserved
+ *  from the image size alone and have its pixels uploaded
+ *  later, one mipmap level at a time.  Block compressed
+ *  images get arrays of their own, with every level given
+ *  up front since they cannot have mipmaps generated.
+ *
+ *  Small uncompressed images are packed into shared atlas
+ *  pages instead, whatever their size, so textures of many
+ *  sizes still share one array.  Each one is surrounded by
+ *  a gutter of its own texels wrapped around, wide enough
+ *  for the mipmap levels the atlas arrays keep, and the
+ *  shader maps the texture coordinates into its rectangle
+ *  of the page with GetUVRect().
+ *
+ *  Streamed textures get arrays of their own, allocated as
+ *  sparse textures where the context has them, so each
+ *  mipmap level of a layer only takes memory once its pages
+ *  are committed.  The shader never samples a level finer
+ *  than the first one set with SetMinLevel(), so the levels
+ *  above it may hold nothing.
+ *
+ *  Each array is bound to its own texture unit.  Where the
+ *  bindless texture extension exists, the arrays are made
+ *  resident instead and their handles are read from a
+ *  shader storage buffer, so no texture unit is used at
+ *  all.  Either way a draw passes one integer to the shader,
+ *  returned by GetShaderLayer().
+ ***********************************************************/
+class TextureArrays
+{
+public:
+	// constructor
+	TextureArrays();
+	// destructor
+	~TextureArrays();
+
+	// shader storage buffer binding point of the bindless
+	// texture handles
+	static const GLuint HANDLE_BINDING_POINT = 5;
+	// size of an atlas page, and the largest image size that
+	// is packed into the atlas
+	static const int ATLAS_PAGE_SIZE = 1024;
+	static const int ATLAS_MAX_IMAGE_SIZE = 256;
+
+	// finest level that can be clamped in the shader
+	static const int MAX_MIN_LEVEL = 15;
+
+	// true when the context has bindless textures
+	static bool IsBindlessSupported();
+	// true when the context has sparse textures
+	static bool IsSparseSupported();
+
+	// add a decoded image with 3 or 4 color channels, returns
+	// the texture handle or -1 when the image is not usable
+	int AddImage(const unsigned char* pixels, int width, int height, int colorChannels);
+	// reserve a layer for an image whose pixels are uploaded
+	// after Build() with UploadLevel()
+	int ReserveImage(int width, int height, int colorChannels);
+	// add a block compressed image with its full mipmap chain
+	// in data, largest level first, returns the texture handle
+	int AddCompressedImage(
+		const unsigned char* data,
+		size_t dataSize,
+		int width,
+		int height,
+		GLenum compressedFormat);
+	// reserve a layer for a block compressed image whose levels
+	// are uploaded after Build() with UploadCompressedLevel()
+	int ReserveCompressedImage(int width, int height, GLenum compressedFormat);
+	// reserve a layer for a streamed image, uncompressed when
+	// the compressed format is 0, in an array that is sparse
+	// where the context allows
+	int ReserveStreamedImage(int width, int height, int colorChannels, GLenum compressedFormat);
+	// number of added images
+	int GetTextureCount() const;
+	// pack small images into atlas pages, on by default
+	void SetAtlasEnabled(bool bEnable);
+	// bytes the streamed arrays that cannot be sparse may
+	// allocate when they are built, 0 for no limit
+	void SetStreamedBudget(size_t budgetBytes);
+	// true when an image of this size would be packed
+	bool IsAtlasCandidate(int width, int height) const;
+
+	// create the array textures from the added images and
+	// free the image copies
+	bool Build();
+	// make the arrays resident and upload their handles, so
+	// they can be sampled without binding them - false when
+	// there are more arrays than the shader can address
+	bool EnableBindless();
+	bool IsBindless() const;
+	// upload one mipmap level of a reserved layer - pixels may
+	// be an offset into the bound pixel unpack buffer
+	bool UploadLevel(
+		int textureHandle,
+		int level,
+		int width,
+		int height,
+		int colorChannels,
+		const void* pixels);
+	// upload one mipmap level of a reserved compressed layer
+	bool UploadCompressedLevel(
+		int textureHandle,
+		int level,
+		int width,
+		int height,
+		size_t dataSize,
+		const void* data);
+	// bytes of one compressed level of this size
+	static size_t GetCompressedLevelSize(GLenum compressedFormat, int width, int height);
+	// commit or free the pages of a range of levels of a
+	// layer - always succeeds for arrays that are not sparse
+	bool CommitLevels(int textureHandle, int firstLevel, int endLevel, bool bCommit);
+	// free the layer of a texture, and delete its array once
+	// none of its layers is in use
+	bool ReleaseImage(int textureHandle);
+	// bind every array to the texture unit of its index, false
+	// when some arrays are past the last unit
+	bool BindArrays(RenderStateCache* pStateCache);
+	// delete the array textures
+	void Destroy();
+
+	// number of array textures
+	int GetArrayCount() const;
+	// OpenGL texture of an array
+	GLuint GetArrayID(int arrayIndex) const;
+	// array and layer of a texture, the array index is -1
+	// once the texture is released
+	int GetArrayIndex(int textureHandle) const;
+	int GetLayer(int textureHandle) const;
+	// number of mipmap levels of the array holding a texture
+	int GetLevelCount(int textureHandle) const;
+	// bytes of one mipmap level of a texture
+	size_t GetLevelSize(int textureHandle, int level) const;
+	// finest level of a texture its array stores, above 0
+	// when the finest levels were dropped to fit the budget
+	int GetFirstStoredLevel(int textureHandle) const;
+	// true when the array holding a texture is sparse
+	bool IsSparse(int textureHandle) const;
+	// first level of the mip tail, which is committed as a
+	// whole - the level count when the array is not sparse
+	int GetTailLevel(int textureHandle) const;
+	// finest level the shader samples for a texture
+	void SetMinLevel(int textureHandle, int level);
+	int GetMinLevel(int textureHandle) const;
+	// texture unit the sampler of a texture must be set to, -1
+	// when its array could not be bound to one
+	int GetTextureUnit(int textureHandle) const;
+	// layer value the shader reads for a texture - the array
+	// index is packed above the layer when bindless, and the
+	// finest level to sample above that
+	int GetShaderLayer(int textureHandle) const;
+	// offset and size of a texture in its layer, in texture
+	// coordinates - the whole layer unless it is in an atlas
+	glm::vec4 GetUVRect(int textureHandle) const;
+
+private:
+	// one array texture and the images waiting for it, with
+	// an empty entry for every reserved layer - atlas arrays
+	// hold one page per layer and count every texture on it
+	struct TEXTURE_ARRAY
+	{
+		int width;
+		int height;
+		int colorChannels;
+		GLenum compressedFormat;
+		int layerCount;
+		int liveTextures;
+		int levelCount;
+		bool bAtlas;
+		bool bStreamed;
+		bool bSparse;
+		int tailLevel;
+		// true when the layers share one mip tail, which is then
+		// committed with the array and never freed
+		bool bSharedTail;
+		// finest level stored, which is level 0 of the array
+		// texture - only a streamed array that cannot be sparse
+		// drops levels, to fit the budget
+		int firstLevel;
+		GLuint textureID;
+		GLuint64 bindlessHandle;
+		std::vector<std::vector<unsigned char> > pendingLayers;
+		// layers of released textures, given out again before
+		// the array grows
+		std::vector<int> freeLayers;
+	};
+
+	// place of a texture in the arrays
+	struct TEXTURE_LOCATION
+	{
+		int arrayIndex;
+		int layer;
+		int minLevel;
+		glm::vec4 uvRect;
+	};
+
+	// small image waiting to be packed into an atlas page
+	struct ATLAS_IMAGE
+	{
+		int textureHandle;
+		int width;
+		int height;
+		std::vector<unsigned char> rgbaPixels;
+	};
+
+	std::vector<TEXTURE_ARRAY> m_arrays;
+	std::vector<TEXTURE_LOCATION> m_locations;
+	std::vector<ATLAS_IMAGE> m_atlasImages;
+	bool m_bUseAtlas;
+	// most layers an array may hold, queried on first use
+	int m_maxLayers;
+	// texture units the arrays are bound to, queried on the
+	// first bind
+	int m_maxTextureUnits;
+	// bytes the streamed arrays that cannot be sparse may take
+	size_t m_streamedBudget;
+	// bindless handle buffer, when the arrays are resident
+	GLuint m_handleBuffer;
+	bool m_bBindless;
+
+	// find an array with room for an image of this size and
+	// format, or add one
+	int FindArray(int width, int height, int colorChannels, GLenum compressedFormat, bool bStreamed);
+	// bytes of one mipmap level of every layer of an array
+	static size_t GetArrayLevelSize(const TEXTURE_ARRAY& textureArray, int level);
+	// pick which streamed arrays are sparse, and drop the
+	// finest levels of the others until they fit the budget
+	void FitStreamedArrays();
+	// place an image in a new layer of its array
+	int ReserveLayer(int width, int height, int colorChannels, GLenum compressedFormat, bool bStreamed);
+	// true when an array of this format and size can be
+	// allocated as a sparse texture
+	static bool CanAllocateSparse(GLenum internalFormat, int width, int height);
+	// pack the waiting atlas images into the pages of a new
+	// atlas array
+	void PackAtlasImages();
+};
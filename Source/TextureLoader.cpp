@@ -0,0 +1,456 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture images and build their mipmaps on worker threads, then
+// stream them into the texture arrays through a pixel buffer object
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// most worker threads used for decoding - one core is
+	// left to the render thread
+	const unsigned int MAX_WORKER_THREADS = 4;
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_pendingCount = 0;
+	m_generation = 0;
+	m_bQuit = false;
+	m_pixelBuffer = 0;
+
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	unsigned int workerCount = (hardwareThreads > 1) ? (hardwareThreads - 1) : 1;
+	workerCount = std::min(workerCount, MAX_WORKER_THREADS);
+
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerMain, this));
+	}
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bQuit = true;
+		m_jobs.clear();
+	}
+	m_condition.notify_all();
+
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		if (m_workers[i].joinable())
+		{
+			m_workers[i].join();
+		}
+	}
+
+	if (m_pixelBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_pixelBuffer);
+		m_pixelBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  ReadImageInfo()
+ *
+ *  This method is used for reading the size and number of
+ *  color channels of an image file from its header, which
+ *  is enough to reserve its texture layer.
+ ***********************************************************/
+bool TextureLoader::ReadImageInfo(const char* filename, int& width, int& height, int& colorChannels)
+{
+	width = 0;
+	height = 0;
+	colorChannels = 0;
+
+	return(stbi_info(filename, &width, &height, &colorChannels) != 0);
+}
+
+/***********************************************************
+ *  GetCompressedFormat()
+ *
+ *  This method is used for getting the OpenGL format that
+ *  matches the block format of a cooked texture.  BC1 and
+ *  BC3 need the S3TC extension and BC7 needs OpenGL 4.2 or
+ *  the BPTC extension.
+ ***********************************************************/
+GLenum TextureLoader::GetCompressedFormat(uint32_t vkFormat)
+{
+	switch (vkFormat)
+	{
+	case KtxFile::VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		if (GLEW_EXT_texture_compression_s3tc != GL_FALSE)
+		{
+			return(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+		}
+		break;
+	case KtxFile::VK_FORMAT_BC3_UNORM_BLOCK:
+		if (GLEW_EXT_texture_compression_s3tc != GL_FALSE)
+		{
+			return(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		}
+		break;
+	case KtxFile::VK_FORMAT_BC7_UNORM_BLOCK:
+		if ((GLEW_VERSION_4_2 != GL_FALSE) || (GLEW_ARB_texture_compression_bptc != GL_FALSE))
+		{
+			return(GL_COMPRESSED_RGBA_BPTC_UNORM);
+		}
+		break;
+	}
+
+	return(0);
+}
+
+/***********************************************************
+ *  QueueImage()
+ *
+ *  This method is used for queuing an image file to be
+ *  decoded by the next free worker thread.  A cooked file
+ *  is only read, not decoded.
+ ***********************************************************/
+void TextureLoader::QueueImage(int textureHandle, const std::string& filename, bool bCooked)
+{
+	QueueLevels(textureHandle, filename, bCooked, 0, -1);
+}
+
+/***********************************************************
+ *  QueueLevels()
+ *
+ *  This method is used for queuing an image file of which
+ *  only a range of mipmap levels is uploaded.  The whole
+ *  image is still decoded, but the other levels are freed
+ *  before it waits for the upload.  An end level of -1
+ *  keeps every level from the first one on.
+ ***********************************************************/
+void TextureLoader::QueueLevels(
+	int textureHandle,
+	const std::string& filename,
+	bool bCooked,
+	int firstLevel,
+	int endLevel)
+{
+	LOAD_JOB job;
+	job.textureHandle = textureHandle;
+	job.filename = filename;
+	job.bCooked = bCooked;
+	job.firstLevel = firstLevel;
+	job.endLevel = endLevel;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		job.generation = m_generation;
+		m_jobs.push_back(job);
+		m_pendingCount++;
+	}
+	m_condition.notify_one();
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of images
+ *  that have not been uploaded yet.
+ ***********************************************************/
+int TextureLoader::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return(m_pendingCount);
+}
+
+/***********************************************************
+ *  CancelAll()
+ *
+ *  This method is used for dropping every image that has
+ *  not been uploaded, for when the textures they were meant
+ *  for are destroyed.  Images that a worker is decoding
+ *  right now are dropped when it finishes.
+ ***********************************************************/
+void TextureLoader::CancelAll()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_pendingCount -= (int)(m_jobs.size() + m_loadedImages.size());
+	m_jobs.clear();
+	m_loadedImages.clear();
+	m_generation++;
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is used for running a worker thread, which
+ *  decodes queued images until the loader is destroyed.
+ *  The images are flipped with the setting of the thread,
+ *  since the global one is also set by the render thread.
+ ***********************************************************/
+void TextureLoader::WorkerMain()
+{
+	stbi_set_flip_vertically_on_load_thread(true);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true)
+	{
+		while (m_jobs.empty() && (m_bQuit == false))
+		{
+			m_condition.wait(lock);
+		}
+		if (m_bQuit)
+		{
+			break;
+		}
+
+		LOAD_JOB job = m_jobs.front();
+		m_jobs.pop_front();
+		lock.unlock();
+
+		LOADED_IMAGE image;
+		DecodeImage(job, image);
+
+		lock.lock();
+		if (job.generation == m_generation)
+		{
+			m_loadedImages.push_back(std::move(image));
+		}
+		else
+		{
+			m_pendingCount--;
+		}
+	}
+}
+
+/***********************************************************
+ *  DecodeImage()
+ *
+ *  This method is used for decoding an image file and
+ *  building its mipmap chain, or for reading the levels of
+ *  a cooked texture.  A file that cannot be read is still
+ *  reported, with bLoaded cleared.
+ ***********************************************************/
+void TextureLoader::DecodeImage(const LOAD_JOB& job, LOADED_IMAGE& image)
+{
+	image.textureHandle = job.textureHandle;
+	image.firstLevel = 0;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+	image.compressedFormat = 0;
+	image.bLoaded = false;
+
+	if (job.bCooked)
+	{
+		KtxFile::KTX_IMAGE cookedImage;
+		if (KtxFile::Read(job.filename.c_str(), cookedImage))
+		{
+			image.width = cookedImage.info.width;
+			image.height = cookedImage.info.height;
+			image.colorChannels = cookedImage.info.sourceChannels;
+			image.compressedFormat = GetCompressedFormat(cookedImage.info.vkFormat);
+			image.pixels.swap(cookedImage.data);
+			image.levels.swap(cookedImage.levels);
+			image.bLoaded = (image.compressedFormat != 0);
+			KeepLevels(image, job.firstLevel, job.endLevel);
+		}
+		return;
+	}
+
+	unsigned char* pixels = stbi_load(
+		job.filename.c_str(),
+		&image.width,
+		&image.height,
+		&image.colorChannels,
+		0);
+
+	if (NULL == pixels)
+	{
+		return;
+	}
+
+	image.pixels.assign(pixels, pixels + ((size_t)image.width * image.height * image.colorChannels));
+	stbi_image_free(pixels);
+
+	ImageMipmaps::Generate(image.pixels, image.width, image.height, image.colorChannels, image.levels);
+	image.bLoaded = true;
+	KeepLevels(image, job.firstLevel, job.endLevel);
+}
+
+/***********************************************************
+ *  KeepLevels()
+ *
+ *  This method is used for dropping the levels of a decoded
+ *  image outside firstLevel to endLevel - 1.  The levels
+ *  are stored largest first, so the kept ones are a single
+ *  run of bytes that is moved to the front of the pixels.
+ ***********************************************************/
+void TextureLoader::KeepLevels(LOADED_IMAGE& image, int firstLevel, int endLevel)
+{
+	int levelCount = (int)image.levels.size();
+	if ((endLevel < 0) || (endLevel > levelCount))
+	{
+		endLevel = levelCount;
+	}
+	firstLevel = std::max(firstLevel, 0);
+	if ((firstLevel == 0) && (endLevel == levelCount))
+	{
+		return;
+	}
+	if (firstLevel >= endLevel)
+	{
+		image.bLoaded = false;
+		return;
+	}
+
+	size_t startOffset = image.levels[firstLevel].offset;
+	size_t endOffset = image.levels[endLevel - 1].offset + image.levels[endLevel - 1].size;
+
+	std::vector<unsigned char> keptPixels(image.pixels.begin() + startOffset, image.pixels.begin() + endOffset);
+	std::vector<ImageMipmaps::MIP_LEVEL> keptLevels(image.levels.begin() + firstLevel, image.levels.begin() + endLevel);
+	for (int i = 0; i < keptLevels.size(); i++)
+	{
+		keptLevels[i].offset -= startOffset;
+	}
+
+	image.pixels.swap(keptPixels);
+	image.levels.swap(keptLevels);
+	image.firstLevel = firstLevel;
+}
+
+/***********************************************************
+ *  UploadCompleted()
+ *
+ *  This method is used for handing the decoded images to
+ *  the texture arrays.  Each image is copied into the pixel
+ *  buffer through a mapping of fresh storage, orphaning the
+ *  previous storage so the copy never waits on an upload
+ *  still in flight, and every mipmap level is then read
+ *  from the buffer into its layer.  It must be called on
+ *  the thread that owns the context,
+ *  after the arrays have been built.
+ ***********************************************************/
+int TextureLoader::UploadCompleted(
+	TextureArrays& textureArrays,
+	size_t byteBudget,
+	std::vector<UPLOAD_RESULT>& outResults)
+{
+	std::vector<LOADED_IMAGE> images;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		size_t budgetUsed = 0;
+		while ((m_loadedImages.empty() == false) &&
+			((images.empty()) || ((budgetUsed + m_loadedImages.front().pixels.size()) <= byteBudget)))
+		{
+			budgetUsed += m_loadedImages.front().pixels.size();
+			images.push_back(std::move(m_loadedImages.front()));
+			m_loadedImages.pop_front();
+		}
+		m_pendingCount -= (int)images.size();
+	}
+
+	if (images.empty())
+	{
+		return(0);
+	}
+
+	if (m_pixelBuffer == 0)
+	{
+		glGenBuffers(1, &m_pixelBuffer);
+	}
+
+	// the rows of the smaller levels are not 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+
+	for (int i = 0; i < images.size(); i++)
+	{
+		const LOADED_IMAGE& image = images[i];
+
+		UPLOAD_RESULT result;
+		result.textureHandle = image.textureHandle;
+		result.bLoaded = image.bLoaded;
+		result.firstLevel = image.firstLevel;
+		result.endLevel = std::min(
+			image.firstLevel + (int)image.levels.size(),
+			textureArrays.GetLevelCount(image.textureHandle));
+
+		if (image.bLoaded)
+		{
+			// the new storage is not used by any upload yet, so it
+			// is mapped without waiting and written in place
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, image.pixels.size(), NULL, GL_STREAM_DRAW);
+			void* mapped = glMapBufferRange(
+				GL_PIXEL_UNPACK_BUFFER,
+				0,
+				image.pixels.size(),
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+			if (NULL != mapped)
+			{
+				memcpy(mapped, image.pixels.data(), image.pixels.size());
+				result.bLoaded = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+			}
+			else
+			{
+				result.bLoaded = false;
+			}
+
+			result.bLoaded = result.bLoaded && (result.endLevel > result.firstLevel);
+			for (int level = result.firstLevel; (level < result.endLevel) && result.bLoaded; level++)
+			{
+				const ImageMipmaps::MIP_LEVEL& mipLevel = image.levels[level - image.firstLevel];
+				if (image.compressedFormat != 0)
+				{
+					result.bLoaded = textureArrays.UploadCompressedLevel(
+						image.textureHandle,
+						level,
+						mipLevel.width,
+						mipLevel.height,
+						mipLevel.size,
+						(const void*)mipLevel.offset);
+				}
+				else
+				{
+					result.bLoaded = textureArrays.UploadLevel(
+						image.textureHandle,
+						level,
+						mipLevel.width,
+						mipLevel.height,
+						image.colorChannels,
+						(const void*)mipLevel.offset);
+				}
+			}
+		}
+
+		outResults.push_back(result);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	return((int)images.size());
+}
@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture images and build their mipmaps on worker threads, then
+// stream them into the texture arrays through a pixel buffer object
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureArrays.h"
+#include "ImageMipmaps.h"
+#include "KtxFile.h"
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class keeps a small pool of worker threads that
+ *  decode queued image files and build their mipmap chains
+ *  with a box filter, so the main thread never waits on
+ *  stb_image or on glGenerateMipmap.  Cooked KTX2 files are
+ *  read as they are, since they already hold every level.
+ *
+ *  The decoded images wait in a queue until the main thread
+ *  calls UploadCompleted(), which copies them into a pixel
+ *  buffer object and from there into the layers reserved
+ *  for them in the texture arrays.  Each call stops once its
+ *  byte budget is used, so a burst of finished images is
+ *  spread over several frames.  A job may ask for only a
+ *  range of the mipmap levels, as the texture streamer does;
+ *  the rest are dropped on the worker before the upload.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor - starts the worker threads
+	TextureLoader();
+	// destructor - stops the worker threads
+	~TextureLoader();
+
+	// outcome of an image handed to the texture arrays, with
+	// the range of levels that was uploaded
+	struct UPLOAD_RESULT
+	{
+		int textureHandle;
+		bool bLoaded;
+		int firstLevel;
+		int endLevel;
+	};
+
+	// read the size and format of an image file from its
+	// header, without decoding the pixels
+	static bool ReadImageInfo(const char* filename, int& width, int& height, int& colorChannels);
+	// OpenGL format of a cooked texture, or 0 when the
+	// context cannot sample it
+	static GLenum GetCompressedFormat(uint32_t vkFormat);
+
+	// queue an image file, or a cooked texture, to be read
+	// into the layer reserved for a texture handle
+	void QueueImage(int textureHandle, const std::string& filename, bool bCooked);
+	// queue an image to have only the levels firstLevel to
+	// endLevel - 1 read into the layer of a texture handle
+	void QueueLevels(
+		int textureHandle,
+		const std::string& filename,
+		bool bCooked,
+		int firstLevel,
+		int endLevel);
+	// images that are queued, decoding or waiting for upload
+	int GetPendingCount() const;
+	// drop every queued and decoded image, and the images
+	// still decoding once they finish
+	void CancelAll();
+
+	// upload decoded images until byteBudget bytes have been
+	// sent, always at least one, and report each of them
+	int UploadCompleted(
+		TextureArrays& textureArrays,
+		size_t byteBudget,
+		std::vector<UPLOAD_RESULT>& outResults);
+
+private:
+	// image file waiting for a worker
+	struct LOAD_JOB
+	{
+		int textureHandle;
+		std::string filename;
+		bool bCooked;
+		int firstLevel;
+		int endLevel;
+		int generation;
+	};
+
+	// decoded image with its mipmap levels, the first of
+	// which is level firstLevel of the texture
+	struct LOADED_IMAGE
+	{
+		int textureHandle;
+		int firstLevel;
+		int width;
+		int height;
+		int colorChannels;
+		GLenum compressedFormat;
+		bool bLoaded;
+		std::vector<unsigned char> pixels;
+		std::vector<ImageMipmaps::MIP_LEVEL> levels;
+	};
+
+	// worker threads and the queues they share
+	std::vector<std::thread> m_workers;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<LOAD_JOB> m_jobs;
+	std::deque<LOADED_IMAGE> m_loadedImages;
+	int m_pendingCount;
+	// bumped by CancelAll(), so images decoded for an older
+	// generation are dropped
+	int m_generation;
+	bool m_bQuit;
+	// staging buffer of the uploads
+	GLuint m_pixelBuffer;
+
+	// loop of the worker threads
+	void WorkerMain();
+	// decode an image file and build its mipmaps, or read
+	// the levels of a cooked texture
+	void DecodeImage(const LOAD_JOB& job, LOADED_IMAGE& image);
+	// keep only the levels of an image that a job asked for
+	static void KeepLevels(LOADED_IMAGE& image, int firstLevel, int endLevel);
+};
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureregistry.cpp
+// ============
+// remember which image files have been loaded as textures and how many
+// users each texture has, so a file is only ever loaded once
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureRegistry.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+/***********************************************************
+ *  TextureRegistry()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureRegistry::TextureRegistry()
+{
+	m_liveCount = 0;
+	m_duplicateLoads = 0;
+}
+
+/***********************************************************
+ *  GetCanonicalPath()
+ *
+ *  This method is used for turning an image path into the
+ *  one spelling that every path to the same file shares.
+ *  The file does not have to exist, and the path is kept
+ *  as it is when it cannot be resolved.
+ ***********************************************************/
+std::string TextureRegistry::GetCanonicalPath(const char* filename)
+{
+	std::error_code error;
+	std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, error);
+	if (error)
+	{
+		return(std::string(filename));
+	}
+
+	return(canonicalPath.generic_string());
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for building the lookup key of a
+ *  path and the hash of its contents.
+ ***********************************************************/
+std::string TextureRegistry::MakeKey(const std::string& canonicalPath, uint64_t contentHash)
+{
+	char hashText[32];
+	snprintf(hashText, sizeof(hashText), "#%016llx", (unsigned long long)contentHash);
+
+	return(canonicalPath + hashText);
+}
+
+/***********************************************************
+ *  Acquire()
+ *
+ *  This method is used for finding a texture that was
+ *  already loaded from the same file with the same contents.
+ *  A found texture gets one more reference, and the load is
+ *  reported as a duplicate.
+ ***********************************************************/
+int TextureRegistry::Acquire(const std::string& canonicalPath, uint64_t contentHash)
+{
+	std::unordered_map<std::string, int>::const_iterator found =
+		m_handles.find(MakeKey(canonicalPath, contentHash));
+	if (found == m_handles.end())
+	{
+		return(-1);
+	}
+
+	TEXTURE_ENTRY& entry = m_entries[found->second];
+	entry.refCount++;
+	m_duplicateLoads++;
+
+	std::cout << "INFO: Texture already loaded:" << canonicalPath
+		<< ", handle:" << found->second << ", references:" << entry.refCount << std::endl;
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for recording a texture that was
+ *  just loaded, held by the single user that loaded it.
+ ***********************************************************/
+void TextureRegistry::Register(int textureHandle, const std::string& canonicalPath, uint64_t contentHash)
+{
+	if (textureHandle < 0)
+	{
+		return;
+	}
+
+	if (textureHandle >= m_entries.size())
+	{
+		TEXTURE_ENTRY emptyEntry;
+		emptyEntry.refCount = 0;
+		m_entries.resize(textureHandle + 1, emptyEntry);
+	}
+
+	TEXTURE_ENTRY& entry = m_entries[textureHandle];
+	if (entry.refCount > 0)
+	{
+		return;
+	}
+
+	entry.key = MakeKey(canonicalPath, contentHash);
+	entry.refCount = 1;
+	m_handles[entry.key] = textureHandle;
+	m_liveCount++;
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for dropping a reference on a
+ *  texture.  When the last reference is dropped the texture
+ *  is forgotten, so loading the file again loads it anew.
+ ***********************************************************/
+bool TextureRegistry::Release(int textureHandle)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_entries.size()))
+	{
+		return(false);
+	}
+
+	TEXTURE_ENTRY& entry = m_entries[textureHandle];
+	if (entry.refCount <= 0)
+	{
+		return(false);
+	}
+
+	entry.refCount--;
+	if (entry.refCount > 0)
+	{
+		return(false);
+	}
+
+	m_handles.erase(entry.key);
+	entry.key.clear();
+	m_liveCount--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting every texture, for
+ *  when all of them are destroyed at once.
+ ***********************************************************/
+void TextureRegistry::Clear()
+{
+	m_entries.clear();
+	m_handles.clear();
+	m_liveCount = 0;
+}
+
+/***********************************************************
+ *  GetRefCount()
+ *
+ *  This method is used for getting the number of users
+ *  holding a texture.
+ ***********************************************************/
+int TextureRegistry::GetRefCount(int textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_entries.size()))
+	{
+		return(0);
+	}
+
+	return(m_entries[textureHandle].refCount);
+}
+
+/***********************************************************
+ *  GetLiveCount()
+ *
+ *  This method is used for getting the number of textures
+ *  that are still held by a user.
+ ***********************************************************/
+int TextureRegistry::GetLiveCount() const
+{
+	return(m_liveCount);
+}
+
+/***********************************************************
+ *  GetDuplicateLoadCount()
+ *
+ *  This method is used for getting the number of loads that
+ *  found their texture already loaded.
+ ***********************************************************/
+int TextureRegistry::GetDuplicateLoadCount() const
+{
+	return(m_duplicateLoads);
+}
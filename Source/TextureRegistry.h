@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureregistry.h
+// ============
+// remember which image files have been loaded as textures and how many
+// users each texture has, so a file is only ever loaded once
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TextureRegistry
+ *
+ *  This class keys every loaded texture by the canonical
+ *  path of its image file together with a hash of the file
+ *  contents, so the same file reached through a different
+ *  relative path is still found, while a file that changed
+ *  on disk is loaded again.
+ *
+ *  Loading a file that is already registered hands back the
+ *  existing texture handle with one more reference and is
+ *  counted as a duplicate load.  Release() drops a
+ *  reference and reports when the last one is gone, so the
+ *  owner can free the GPU memory of the texture right then.
+ ***********************************************************/
+class TextureRegistry
+{
+public:
+	// constructor
+	TextureRegistry();
+
+	// absolute form of an image path with the . and ..
+	// parts resolved
+	static std::string GetCanonicalPath(const char* filename);
+
+	// texture already loaded from this file and contents, with
+	// a reference added, or -1 when it has not been loaded
+	int Acquire(const std::string& canonicalPath, uint64_t contentHash);
+	// record a newly loaded texture with a single reference
+	void Register(int textureHandle, const std::string& canonicalPath, uint64_t contentHash);
+	// drop a reference, true when it was the last one
+	bool Release(int textureHandle);
+	// forget every texture
+	void Clear();
+
+	// references held on a texture, 0 once it is released
+	int GetRefCount(int textureHandle) const;
+	// textures with at least one reference
+	int GetLiveCount() const;
+	// loads that were answered with an existing texture
+	int GetDuplicateLoadCount() const;
+
+private:
+	// a loaded texture and the users holding it
+	struct TEXTURE_ENTRY
+	{
+		std::string key;
+		int refCount;
+	};
+
+	// entries indexed by texture handle
+	std::vector<TEXTURE_ENTRY> m_entries;
+	// texture handle of every registered path and hash
+	std::unordered_map<std::string, int> m_handles;
+	int m_liveCount;
+	int m_duplicateLoads;
+
+	// lookup key of a path and content hash
+	static std::string MakeKey(const std::string& canonicalPath, uint64_t contentHash);
+};
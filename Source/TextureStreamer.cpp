@@ -0,0 +1,553 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.cpp
+// ============
+// keep only the mipmap levels of the scene textures that the view needs
+// resident, within a memory budget, streaming finer levels in as objects
+// come closer and evicting the least recently used ones
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ *  TextureStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureStreamer::TextureStreamer()
+{
+	m_budgetBytes = 0;
+	m_frame = 0;
+	m_stats = STREAMING_STATS();
+}
+
+/***********************************************************
+ *  SetBudget()
+ *
+ *  This method is used for setting how many bytes the
+ *  resident and loading levels of the streamed textures may
+ *  take.  The base levels are kept even when they alone go
+ *  over the budget.  A lower budget evicts levels on the
+ *  next Update().
+ ***********************************************************/
+void TextureStreamer::SetBudget(size_t budgetBytes)
+{
+	m_budgetBytes = budgetBytes;
+	m_stats.budgetBytes = budgetBytes;
+}
+
+/***********************************************************
+ *  GetBudget()
+ *
+ *  This method is used for getting the memory budget of the
+ *  streamed levels.
+ ***********************************************************/
+size_t TextureStreamer::GetBudget() const
+{
+	return(m_budgetBytes);
+}
+
+/***********************************************************
+ *  AddTexture()
+ *
+ *  This method is used for streaming a texture whose layer
+ *  was reserved with ReserveStreamedImage().  The levels no
+ *  larger than BASE_LEVEL_SIZE are queued right away; their
+ *  pages are committed by the first Update() after the
+ *  array is built, which happens before any upload.
+ ***********************************************************/
+bool TextureStreamer::AddTexture(
+	int textureHandle,
+	const std::string& filename,
+	bool bCooked,
+	int width,
+	int height,
+	TextureArrays& textureArrays,
+	TextureLoader& textureLoader)
+{
+	int levelCount = textureArrays.GetLevelCount(textureHandle);
+	if ((textureHandle < 0) || (levelCount <= 0))
+	{
+		return(false);
+	}
+
+	if (textureHandle >= m_textures.size())
+	{
+		STREAMED_TEXTURE unused;
+		unused.bActive = false;
+		m_textures.resize(textureHandle + 1, unused);
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[textureHandle];
+	texture.bActive = true;
+	texture.filename = filename;
+	texture.bCooked = bCooked;
+	texture.width = width;
+	texture.height = height;
+	texture.levelCount = levelCount;
+	texture.residentLevel = levelCount;
+	texture.wantedLevel = levelCount;
+	texture.lastUsedFrame = m_frame;
+	texture.levelSizes.resize(levelCount);
+	for (int level = 0; level < levelCount; level++)
+	{
+		texture.levelSizes[level] = textureArrays.GetLevelSize(textureHandle, level);
+	}
+
+	// the finest level that is still no larger than the
+	// base size, and never coarser than the shader can clamp to
+	texture.baseLevel = levelCount - 1;
+	while ((texture.baseLevel > 0) &&
+		(std::max(width >> (texture.baseLevel - 1), height >> (texture.baseLevel - 1)) <= BASE_LEVEL_SIZE))
+	{
+		texture.baseLevel--;
+	}
+	texture.baseLevel = std::min(texture.baseLevel, TextureArrays::MAX_MIN_LEVEL);
+
+	texture.loadFirstLevel = texture.baseLevel;
+	texture.loadEndLevel = levelCount;
+	texture.bLoadCommitted = false;
+	textureLoader.QueueLevels(textureHandle, filename, bCooked, texture.loadFirstLevel, texture.loadEndLevel);
+
+	return(true);
+}
+
+/***********************************************************
+ *  RemoveTexture()
+ *
+ *  This method is used for no longer streaming a texture.
+ *  Its pages are freed by the texture arrays along with its
+ *  layer, and a load still running for it is ignored.
+ ***********************************************************/
+void TextureStreamer::RemoveTexture(int textureHandle)
+{
+	if (IsStreamed(textureHandle))
+	{
+		m_textures[textureHandle].bActive = false;
+		m_textures[textureHandle].levelSizes.clear();
+	}
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting every streamed
+ *  texture, for when the texture arrays are destroyed.
+ ***********************************************************/
+void TextureStreamer::Clear()
+{
+	m_textures.clear();
+	m_frame = 0;
+	m_stats = STREAMING_STATS();
+	m_stats.budgetBytes = m_budgetBytes;
+}
+
+/***********************************************************
+ *  IsStreamed()
+ *
+ *  This method is used for checking whether the levels of a
+ *  texture are managed by the streamer.
+ ***********************************************************/
+bool TextureStreamer::IsStreamed(int textureHandle) const
+{
+	return((textureHandle >= 0) && (textureHandle < m_textures.size()) && m_textures[textureHandle].bActive);
+}
+
+/***********************************************************
+ *  RequestDensity()
+ *
+ *  This method is used for asking for the level a visible
+ *  object needs.  uvPerPixel is how far the texture
+ *  coordinates move from one pixel to the next, so the
+ *  texels per pixel of level 0 are that times the texture
+ *  size, and each level halves them.  The finest level
+ *  asked for in a frame wins, and asking marks the texture
+ *  as used for the eviction order.
+ ***********************************************************/
+void TextureStreamer::RequestDensity(int textureHandle, float uvPerPixel)
+{
+	if (IsStreamed(textureHandle) == false)
+	{
+		return;
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[textureHandle];
+	float texelsPerPixel = uvPerPixel * (float)std::max(texture.width, texture.height);
+	int level = 0;
+	if (texelsPerPixel > 1.0f)
+	{
+		level = std::min((int)std::floor(std::log2(texelsPerPixel)), texture.levelCount - 1);
+	}
+
+	texture.wantedLevel = std::min(texture.wantedLevel, level);
+	texture.lastUsedFrame = m_frame;
+}
+
+/***********************************************************
+ *  OnUploaded()
+ *
+ *  This method is used for recording the levels that the
+ *  texture loader uploaded for a streamed texture, and
+ *  letting the shader sample them.  A failed load frees the
+ *  pages committed for it, outside the mip tail, which the
+ *  base levels share.
+ ***********************************************************/
+bool TextureStreamer::OnUploaded(const TextureLoader::UPLOAD_RESULT& result, TextureArrays& textureArrays)
+{
+	if (IsStreamed(result.textureHandle) == false)
+	{
+		return(false);
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[result.textureHandle];
+	if (result.bLoaded && (result.endLevel >= texture.residentLevel))
+	{
+		// a level the array dropped was skipped by the upload
+		int firstLevel = std::max(result.firstLevel, textureArrays.GetFirstStoredLevel(result.textureHandle));
+		m_stats.loadedLevels += std::max(texture.residentLevel - firstLevel, 0);
+		texture.residentLevel = std::min(texture.residentLevel, firstLevel);
+	}
+	else if (texture.bLoadCommitted && (texture.residentLevel < texture.levelCount))
+	{
+		int tailLevel = textureArrays.GetTailLevel(result.textureHandle);
+		textureArrays.CommitLevels(
+			result.textureHandle,
+			texture.loadFirstLevel,
+			std::min(texture.loadEndLevel, tailLevel),
+			false);
+	}
+
+	texture.loadFirstLevel = -1;
+	texture.loadEndLevel = -1;
+	texture.bLoadCommitted = false;
+
+	bool bResident = (texture.residentLevel < texture.levelCount);
+	textureArrays.SetMinLevel(result.textureHandle, bResident ? texture.residentLevel : 0);
+
+	return(bResident);
+}
+
+/***********************************************************
+ *  GetRangeSize()
+ *
+ *  This method is used for adding up the bytes of a range
+ *  of levels of a texture.
+ ***********************************************************/
+size_t TextureStreamer::GetRangeSize(const STREAMED_TEXTURE& texture, int firstLevel, int endLevel)
+{
+	size_t rangeSize = 0;
+	for (int level = std::max(firstLevel, 0); level < std::min(endLevel, texture.levelCount); level++)
+	{
+		rangeSize += texture.levelSizes[level];
+	}
+
+	return(rangeSize);
+}
+
+/***********************************************************
+ *  GetUsedBytes()
+ *
+ *  This method is used for adding up the bytes of the
+ *  resident levels and of the levels being loaded, which
+ *  are what the budget limits.  Textures in arrays that are
+ *  not sparse hold all of their levels anyway, so they are
+ *  left out.
+ ***********************************************************/
+size_t TextureStreamer::GetUsedBytes(const TextureArrays& textureArrays) const
+{
+	size_t usedBytes = 0;
+	for (int i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& texture = m_textures[i];
+		if ((texture.bActive == false) || (textureArrays.IsSparse(i) == false))
+		{
+			continue;
+		}
+
+		usedBytes += GetRangeSize(texture, texture.residentLevel, texture.levelCount);
+		if (texture.loadFirstLevel >= 0)
+		{
+			usedBytes += GetRangeSize(texture, texture.loadFirstLevel, texture.loadEndLevel);
+		}
+	}
+
+	return(usedBytes);
+}
+
+/***********************************************************
+ *  EvictOne()
+ *
+ *  This method is used for evicting the finest resident
+ *  level of one texture.  Only textures in sparse arrays
+ *  that are not loading and hold levels above their base
+ *  levels can be picked, and only when the last frame did
+ *  not use them or they hold more detail than it asked for.
+ *  The least recently used one goes first, the larger level
+ *  on a tie.
+ ***********************************************************/
+bool TextureStreamer::EvictOne(int keepHandle, TextureArrays& textureArrays)
+{
+	int victim = -1;
+	for (int i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& texture = m_textures[i];
+		if ((i == keepHandle) ||
+			(texture.bActive == false) ||
+			(texture.loadFirstLevel >= 0) ||
+			(texture.residentLevel >= texture.baseLevel) ||
+			(textureArrays.IsSparse(i) == false))
+		{
+			continue;
+		}
+		if ((texture.lastUsedFrame == m_frame) && (texture.residentLevel >= texture.wantedLevel))
+		{
+			continue;
+		}
+
+		if (victim < 0)
+		{
+			victim = i;
+			continue;
+		}
+
+		const STREAMED_TEXTURE& best = m_textures[victim];
+		if ((texture.lastUsedFrame < best.lastUsedFrame) ||
+			((texture.lastUsedFrame == best.lastUsedFrame) &&
+			 (texture.levelSizes[texture.residentLevel] > best.levelSizes[best.residentLevel])))
+		{
+			victim = i;
+		}
+	}
+
+	if (victim < 0)
+	{
+		return(false);
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[victim];
+	int level = texture.residentLevel;
+	texture.residentLevel++;
+	textureArrays.SetMinLevel(victim, texture.residentLevel);
+	if (level < textureArrays.GetTailLevel(victim))
+	{
+		textureArrays.CommitLevels(victim, level, level + 1, false);
+	}
+	m_stats.evictedLevels++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for acting on the densities asked
+ *  for since the last update.  Loads queued before their
+ *  array was built get their pages committed first.  Then
+ *  the textures missing the most levels load them, a few
+ *  per update, evicting other levels to stay in the budget
+ *  or settling for a coarser level when nothing more can
+ *  be evicted.  The wanted levels start over afterwards.
+ ***********************************************************/
+void TextureStreamer::Update(TextureArrays& textureArrays, TextureLoader& textureLoader)
+{
+	std::vector<int> candidates;
+	for (int i = 0; i < m_textures.size(); i++)
+	{
+		STREAMED_TEXTURE& texture = m_textures[i];
+		if (texture.bActive == false)
+		{
+			continue;
+		}
+
+		bool bBuilt = (textureArrays.GetArrayID(textureArrays.GetArrayIndex(i)) != 0);
+		if ((texture.loadFirstLevel >= 0) && (texture.bLoadCommitted == false) && bBuilt)
+		{
+			textureArrays.CommitLevels(i, texture.loadFirstLevel, texture.loadEndLevel, true);
+			texture.bLoadCommitted = true;
+		}
+
+		if (bBuilt &&
+			(texture.loadFirstLevel < 0) &&
+			(texture.residentLevel < texture.levelCount) &&
+			(texture.wantedLevel < texture.residentLevel))
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	// the textures furthest from their wanted level first
+	std::sort(candidates.begin(), candidates.end(), [this](int first, int second)
+		{
+			const STREAMED_TEXTURE& firstTexture = m_textures[first];
+			const STREAMED_TEXTURE& secondTexture = m_textures[second];
+			int firstGap = firstTexture.residentLevel - firstTexture.wantedLevel;
+			int secondGap = secondTexture.residentLevel - secondTexture.wantedLevel;
+			if (firstGap != secondGap)
+			{
+				return(firstGap > secondGap);
+			}
+			return(first < second);
+		});
+
+	int loads = 0;
+	int budgetLimited = 0;
+	for (int i = 0; (i < candidates.size()) && (loads < MAX_LOADS_PER_UPDATE); i++)
+	{
+		int textureHandle = candidates[i];
+		STREAMED_TEXTURE& texture = m_textures[textureHandle];
+
+		// the levels of an array that is not sparse are held
+		// already, so loading them costs no more memory, but
+		// the ones it dropped cannot be loaded at all
+		int targetLevel = texture.wantedLevel;
+		bool bBudgeted = textureArrays.IsSparse(textureHandle);
+		if (bBudgeted == false)
+		{
+			targetLevel = std::max(targetLevel, textureArrays.GetFirstStoredLevel(textureHandle));
+		}
+		while (bBudgeted && (targetLevel < texture.residentLevel))
+		{
+			size_t neededBytes = GetRangeSize(texture, targetLevel, texture.residentLevel);
+			while (((GetUsedBytes(textureArrays) + neededBytes) > m_budgetBytes) && EvictOne(textureHandle, textureArrays))
+			{
+			}
+			if ((GetUsedBytes(textureArrays) + neededBytes) <= m_budgetBytes)
+			{
+				break;
+			}
+			targetLevel++;
+		}
+
+		if (targetLevel > texture.wantedLevel)
+		{
+			budgetLimited++;
+		}
+		if (targetLevel >= texture.residentLevel)
+		{
+			continue;
+		}
+
+		texture.loadFirstLevel = targetLevel;
+		texture.loadEndLevel = texture.residentLevel;
+		textureArrays.CommitLevels(textureHandle, texture.loadFirstLevel, texture.loadEndLevel, true);
+		texture.bLoadCommitted = true;
+		textureLoader.QueueLevels(
+			textureHandle,
+			texture.filename,
+			texture.bCooked,
+			texture.loadFirstLevel,
+			texture.loadEndLevel);
+		loads++;
+	}
+
+	// a lowered budget, or base levels that arrived, can leave
+	// more resident than the budget allows
+	while ((GetUsedBytes(textureArrays) > m_budgetBytes) && EvictOne(-1, textureArrays))
+	{
+	}
+
+	m_stats.budgetLimitedTextures = budgetLimited;
+	UpdateStats(textureArrays);
+
+	for (int i = 0; i < m_textures.size(); i++)
+	{
+		m_textures[i].wantedLevel = m_textures[i].levelCount;
+	}
+	m_frame++;
+}
+
+/***********************************************************
+ *  UpdateStats()
+ *
+ *  This method is used for adding up the residency of every
+ *  streamed texture.  Arrays that are not sparse hold all
+ *  of their stored levels whatever is resident, and in sparse ones
+ *  a committed mip tail holds all of its levels.
+ ***********************************************************/
+void TextureStreamer::UpdateStats(const TextureArrays& textureArrays)
+{
+	m_stats.budgetBytes = m_budgetBytes;
+	m_stats.residentBytes = 0;
+	m_stats.loadingBytes = 0;
+	m_stats.allocatedBytes = 0;
+	m_stats.streamedTextures = 0;
+	m_stats.residentLevels = 0;
+	m_stats.totalLevels = 0;
+	m_stats.loadingTextures = 0;
+
+	for (int i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& texture = m_textures[i];
+		if (texture.bActive == false)
+		{
+			continue;
+		}
+
+		m_stats.streamedTextures++;
+		m_stats.totalLevels += texture.levelCount;
+		m_stats.residentLevels += texture.levelCount - texture.residentLevel;
+		m_stats.residentBytes += GetRangeSize(texture, texture.residentLevel, texture.levelCount);
+
+		int committedLevel = texture.residentLevel;
+		if (texture.loadFirstLevel >= 0)
+		{
+			m_stats.loadingTextures++;
+			m_stats.loadingBytes += GetRangeSize(texture, texture.loadFirstLevel, texture.loadEndLevel);
+			if (texture.bLoadCommitted)
+			{
+				committedLevel = std::min(committedLevel, texture.loadFirstLevel);
+			}
+		}
+
+		if (textureArrays.IsSparse(i) == false)
+		{
+			m_stats.allocatedBytes += GetRangeSize(texture, textureArrays.GetFirstStoredLevel(i), texture.levelCount);
+		}
+		else if (committedLevel < texture.levelCount)
+		{
+			committedLevel = std::min(committedLevel, textureArrays.GetTailLevel(i));
+			m_stats.allocatedBytes += GetRangeSize(texture, committedLevel, texture.levelCount);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetResidency()
+ *
+ *  This method is used for getting the resident, wanted and
+ *  base levels of a streamed texture.  The wanted level is
+ *  the one asked for since the last update.
+ ***********************************************************/
+bool TextureStreamer::GetResidency(int textureHandle, RESIDENCY_INFO& outInfo) const
+{
+	if (IsStreamed(textureHandle) == false)
+	{
+		return(false);
+	}
+
+	const STREAMED_TEXTURE& texture = m_textures[textureHandle];
+	outInfo.levelCount = texture.levelCount;
+	outInfo.residentLevel = texture.residentLevel;
+	outInfo.wantedLevel = texture.wantedLevel;
+	outInfo.baseLevel = texture.baseLevel;
+	outInfo.bLoading = (texture.loadFirstLevel >= 0);
+	outInfo.residentBytes = GetRangeSize(texture, texture.residentLevel, texture.levelCount);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the residency and budget
+ *  figures of the last update, with the levels loaded and
+ *  evicted since the start.
+ ***********************************************************/
+const TextureStreamer::STREAMING_STATS& TextureStreamer::GetStats() const
+{
+	return(m_stats);
+}
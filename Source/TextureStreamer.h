@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.h
+// ============
+// keep only the mipmap levels of the scene textures that the view needs
+// resident, within a memory budget, streaming finer levels in as objects
+// come closer and evicting the least recently used ones
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureArrays.h"
+#include "TextureLoader.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureStreamer
+ *
+ *  This class decides which mipmap levels of the streamed
+ *  textures are resident.  A texture starts with only its
+ *  small levels, the ones no larger than BASE_LEVEL_SIZE
+ *  plus the mip tail of a sparse array, and those are never
+ *  evicted.  Every frame the scene reports the texel density
+ *  each visible object needs with RequestDensity(), and the
+ *  next Update() loads the missing finer levels through the
+ *  texture loader.
+ *
+ *  The resident levels of a texture are always one run from
+ *  its resident level down to the smallest.  When loading
+ *  would go over the budget, the finest level of the least
+ *  recently used texture is evicted first, or of a texture
+ *  holding more detail than it was asked for; when nothing
+ *  can be evicted the request is made coarser instead.  The
+ *  shader is kept off the missing levels by the minimum
+ *  level set in the texture arrays, and the pages of the
+ *  missing levels are freed.
+ *
+ *  Only textures in sparse arrays count against the budget.
+ *  An array that is not sparse holds every level it stores
+ *  whatever is resident, so evicting from it would free
+ *  nothing; those textures load the levels they are asked
+ *  for and are never evicted.  Such an array may store
+ *  fewer levels to fit the budget when it is built, and
+ *  its textures never load the levels it dropped.
+ ***********************************************************/
+class TextureStreamer
+{
+public:
+	// constructor
+	TextureStreamer();
+
+	// largest level size kept resident from the start
+	static const int BASE_LEVEL_SIZE = 64;
+	// most loads started by one Update()
+	static const int MAX_LOADS_PER_UPDATE = 4;
+
+	// residency of one streamed texture
+	struct RESIDENCY_INFO
+	{
+		int levelCount;
+		// finest resident level, levelCount before the first
+		// levels have arrived
+		int residentLevel;
+		// finest level asked for by the last frame
+		int wantedLevel;
+		// coarsest level that is never evicted
+		int baseLevel;
+		bool bLoading;
+		size_t residentBytes;
+	};
+
+	// residency of all streamed textures and the budget
+	struct STREAMING_STATS
+	{
+		size_t budgetBytes;
+		// bytes of the resident levels
+		size_t residentBytes;
+		// bytes of the levels being loaded
+		size_t loadingBytes;
+		// bytes of GPU memory held, where the stored levels
+		// of arrays that are not sparse are held in full
+		size_t allocatedBytes;
+		int streamedTextures;
+		int residentLevels;
+		int totalLevels;
+		int loadingTextures;
+		// textures whose wanted level did not fit the budget
+		int budgetLimitedTextures;
+		// levels loaded and evicted since the start
+		int loadedLevels;
+		int evictedLevels;
+	};
+
+	// bytes of the streamed levels that may be resident
+	void SetBudget(size_t budgetBytes);
+	size_t GetBudget() const;
+
+	// stream a texture reserved with ReserveStreamedImage(),
+	// starting the load of its small levels
+	bool AddTexture(
+		int textureHandle,
+		const std::string& filename,
+		bool bCooked,
+		int width,
+		int height,
+		TextureArrays& textureArrays,
+		TextureLoader& textureLoader);
+	// stop streaming a texture that was released
+	void RemoveTexture(int textureHandle);
+	// forget every texture
+	void Clear();
+	// true when a texture is streamed
+	bool IsStreamed(int textureHandle) const;
+
+	// ask for the level that samples about one texel per pixel
+	// when a texture coordinate step of one covers uvPerPixel
+	void RequestDensity(int textureHandle, float uvPerPixel);
+	// record uploaded levels, true once the texture has its
+	// base levels resident
+	bool OnUploaded(const TextureLoader::UPLOAD_RESULT& result, TextureArrays& textureArrays);
+	// evict and load levels for the densities asked for since
+	// the last update - call once a frame, before uploading
+	void Update(TextureArrays& textureArrays, TextureLoader& textureLoader);
+
+	// residency of a texture, false when it is not streamed
+	bool GetResidency(int textureHandle, RESIDENCY_INFO& outInfo) const;
+	// residency and budget figures of the last update
+	const STREAMING_STATS& GetStats() const;
+
+private:
+	// one streamed texture
+	struct STREAMED_TEXTURE
+	{
+		bool bActive;
+		std::string filename;
+		bool bCooked;
+		int width;
+		int height;
+		int levelCount;
+		int baseLevel;
+		int residentLevel;
+		int wantedLevel;
+		// levels being loaded, and whether their pages are
+		// committed yet - the array may not be built when the
+		// load is queued
+		int loadFirstLevel;
+		int loadEndLevel;
+		bool bLoadCommitted;
+		int lastUsedFrame;
+		std::vector<size_t> levelSizes;
+	};
+
+	// entries indexed by texture handle
+	std::vector<STREAMED_TEXTURE> m_textures;
+	size_t m_budgetBytes;
+	int m_frame;
+	STREAMING_STATS m_stats;
+
+	// bytes of the levels first to end - 1 of a texture
+	static size_t GetRangeSize(const STREAMED_TEXTURE& texture, int firstLevel, int endLevel);
+	// evict the finest level of the best candidate other than
+	// keepHandle, false when there is none
+	bool EvictOne(int keepHandle, TextureArrays& textureArrays);
+	// bytes of the resident and loading levels of the
+	// textures in sparse arrays
+	size_t GetUsedBytes(const TextureArrays& textureArrays) const;
+	// refresh the statistics
+	void UpdateStats(const TextureArrays& textureArrays);
+};
@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+// transform.cpp
+// ============
+// store the position, rotation and scale of a scene object and cache
+// the composed model matrix until one of the values changes
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Transform.h"
+
+#include <glm/gtx/transform.hpp>
+
+int Transform::s_rebuildCount = 0;
+
+/***********************************************************
+ *  Transform()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Transform::Transform()
+{
+	m_scaleXYZ = glm::vec3(1.0f, 1.0f, 1.0f);
+	m_rotationDegrees = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_modelMatrix = glm::mat4(1.0f);
+	m_bDirty = false;
+}
+
+/***********************************************************
+ *  SetScale()
+ *
+ *  This method is used for setting the XYZ scale.
+ ***********************************************************/
+void Transform::SetScale(glm::vec3 scaleXYZ)
+{
+	if (scaleXYZ != m_scaleXYZ)
+	{
+		m_scaleXYZ = scaleXYZ;
+		m_bDirty = true;
+	}
+}
+
+/***********************************************************
+ *  SetRotation()
+ *
+ *  This method is used for setting the XYZ rotation degrees.
+ ***********************************************************/
+void Transform::SetRotation(
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees)
+{
+	glm::vec3 rotationDegrees = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+
+	if (rotationDegrees != m_rotationDegrees)
+	{
+		m_rotationDegrees = rotationDegrees;
+		m_bDirty = true;
+	}
+}
+
+/***********************************************************
+ *  SetPosition()
+ *
+ *  This method is used for setting the XYZ position.
+ ***********************************************************/
+void Transform::SetPosition(glm::vec3 positionXYZ)
+{
+	if (positionXYZ != m_positionXYZ)
+	{
+		m_positionXYZ = positionXYZ;
+		m_bDirty = true;
+	}
+}
+
+/***********************************************************
+ *  GetScale()
+ *
+ *  This method is used for getting the XYZ scale.
+ ***********************************************************/
+glm::vec3 Transform::GetScale() const
+{
+	return(m_scaleXYZ);
+}
+
+/***********************************************************
+ *  GetRotation()
+ *
+ *  This method is used for getting the XYZ rotation degrees.
+ ***********************************************************/
+glm::vec3 Transform::GetRotation() const
+{
+	return(m_rotationDegrees);
+}
+
+/***********************************************************
+ *  GetPosition()
+ *
+ *  This method is used for getting the XYZ position.
+ ***********************************************************/
+glm::vec3 Transform::GetPosition() const
+{
+	return(m_positionXYZ);
+}
+
+/***********************************************************
+ *  GetModelMatrix()
+ *
+ *  This method is used for getting the model matrix.  The
+ *  matrix is composed again only if a transformation value
+ *  was changed since it was last built.
+ ***********************************************************/
+const glm::mat4& Transform::GetModelMatrix()
+{
+	if (m_bDirty)
+	{
+		m_modelMatrix = ComposeModelMatrix(
+			m_scaleXYZ,
+			m_rotationDegrees.x,
+			m_rotationDegrees.y,
+			m_rotationDegrees.z,
+			m_positionXYZ);
+		m_bDirty = false;
+		s_rebuildCount++;
+	}
+
+	return(m_modelMatrix);
+}
+
+/***********************************************************
+ *  IsDirty()
+ *
+ *  This method is used for checking whether the model matrix needs to be
+ *  rebuilt before it is used.
+ ***********************************************************/
+bool Transform::IsDirty() const
+{
+	return(m_bDirty);
+}
+
+/***********************************************************
+ *  SetCachedModelMatrix()
+ *
+ *  This method is used for storing a model matrix that was
+ *  composed outside of the class from the current values.
+ *  It counts as a rebuild and clears the dirty flag.
+ ***********************************************************/
+void Transform::SetCachedModelMatrix(const glm::mat4& modelMatrix)
+{
+	m_modelMatrix = modelMatrix;
+	m_bDirty = false;
+	s_rebuildCount++;
+}
+
+/***********************************************************
+ *  ComposeModelMatrix()
+ *
+ *  This method is used for building the model matrix from
+ *  the passed in transformation values.
+ ***********************************************************/
+glm::mat4 Transform::ComposeModelMatrix(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 modelView;
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	modelView = translation * rotationX * rotationY * rotationZ * scale;
+
+	return(modelView);
+}
+
+/***********************************************************
+ *  GetRebuildCount()
+ *
+ *  This method is used for getting the number of model matrices rebuilt
+ *  since the counter was last reset.
+ ***********************************************************/
+int Transform::GetRebuildCount()
+{
+	return(s_rebuildCount);
+}
+
+/***********************************************************
+ *  ResetRebuildCount()
+ *
+ *  This method is used for resetting the rebuild counter at the start
+ *  of a frame.
+ ***********************************************************/
+void Transform::ResetRebuildCount()
+{
+	s_rebuildCount = 0;
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// transform.h
+// ============
+// store the position, rotation and scale of a scene object and cache
+// the composed model matrix until one of the values changes
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  Transform
+ *
+ *  This class holds the transformation values of an object
+ *  and the model matrix composed from them.  The matrix is
+ *  only rebuilt after a value has been changed.
+ ***********************************************************/
+class Transform
+{
+public:
+	// constructor
+	Transform();
+
+	// set the transformation values - marks the matrix dirty
+	// only when the passed in value differs from the current one
+	void SetScale(glm::vec3 scaleXYZ);
+	void SetRotation(
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees);
+	void SetPosition(glm::vec3 positionXYZ);
+
+	// get the transformation values
+	glm::vec3 GetScale() const;
+	glm::vec3 GetRotation() const;
+	glm::vec3 GetPosition() const;
+
+	// get the model matrix, rebuilding it first when dirty
+	const glm::mat4& GetModelMatrix();
+	// true when the model matrix needs to be rebuilt
+	bool IsDirty() const;
+	// store a model matrix composed elsewhere for the current
+	// values, such as by a TransformBatch kernel
+	void SetCachedModelMatrix(const glm::mat4& modelMatrix);
+
+	// build a model matrix from transformation values
+	static glm::mat4 ComposeModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// number of model matrices rebuilt since the last reset
+	static int GetRebuildCount();
+	// reset the rebuild counter at the start of a frame
+	static void ResetRebuildCount();
+
+private:
+	// transformation values
+	glm::vec3 m_scaleXYZ;
+	glm::vec3 m_rotationDegrees;
+	glm::vec3 m_positionXYZ;
+	// cached model matrix
+	glm::mat4 m_modelMatrix;
+	// true when the values changed since the matrix was built
+	bool m_bDirty;
+
+	// number of model matrices rebuilt since the last reset
+	static int s_rebuildCount;
+};
@@ -0,0 +1,707 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbatch.cpp
+// ============
+// compose the model matrices of many objects at once from structure of
+// arrays transformation streams, using SSE or AVX2 when available
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformBatch.h"
+#include "Transform.h"
+
+#include <cmath>
+#include <cstdint>
+
+// the SIMD kernels are only built for x86 targets
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define TRANSFORM_BATCH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// allow the AVX2 kernel to be compiled without enabling AVX2
+// for the whole translation unit - it is only called after
+// the CPU has been checked at runtime
+#if defined(TRANSFORM_BATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE
+#define TARGET_AVX2
+#endif
+
+// declaration of the global variables and defines
+namespace
+{
+	// number of floats in one model matrix
+	const int MATRIX_FLOATS = 16;
+
+	const float DEGREES_TO_RADIANS = 0.01745329251994329577f;
+	const float TWO_OVER_PI = 0.63661977236758134308f;
+
+	// pi/2 split in three parts for an accurate range reduction
+	const float PIO2_1 = 1.5703125f;
+	const float PIO2_2 = 4.837512969970703125e-4f;
+	const float PIO2_3 = 7.54978995489188216e-8f;
+
+	// minimax polynomial coefficients on [-pi/4, pi/4]
+	const float SIN_C1 = -1.6666654611e-1f;
+	const float SIN_C2 = 8.3321608736e-3f;
+	const float SIN_C3 = -1.9515295891e-4f;
+	const float COS_C1 = 4.166664568298827e-2f;
+	const float COS_C2 = -1.388731625493765e-3f;
+	const float COS_C3 = 2.443315711809948e-5f;
+
+	// kernel picked for the running CPU, -1 until checked
+	int g_SupportedKernel = -1;
+
+	/***********************************************************
+	 *  ComposeScalar()
+	 *
+	 *  Compose the model matrices one object at a time.  The
+	 *  rotation product is expanded so the result matches
+	 *  T * Rx * Ry * Rz * S without the matrix multiplies.
+	 ***********************************************************/
+	void ComposeScalar(
+		const TransformBatch::TRANSFORM_STREAMS& streams,
+		int first,
+		int count,
+		float* pOut)
+	{
+		for (int i = first; i < count; i++)
+		{
+			float ax = streams.rotationX[i] * DEGREES_TO_RADIANS;
+			float ay = streams.rotationY[i] * DEGREES_TO_RADIANS;
+			float az = streams.rotationZ[i] * DEGREES_TO_RADIANS;
+			float ca = std::cos(ax);
+			float sa = std::sin(ax);
+			float cb = std::cos(ay);
+			float sb = std::sin(ay);
+			float cc = std::cos(az);
+			float sc = std::sin(az);
+			float sx = streams.scaleX[i];
+			float sy = streams.scaleY[i];
+			float sz = streams.scaleZ[i];
+			float* m = pOut + (i * MATRIX_FLOATS);
+
+			// column 0
+			m[0] = (cb * cc) * sx;
+			m[1] = (ca * sc + sa * sb * cc) * sx;
+			m[2] = (sa * sc - ca * sb * cc) * sx;
+			m[3] = 0.0f;
+			// column 1
+			m[4] = (-cb * sc) * sy;
+			m[5] = (ca * cc - sa * sb * sc) * sy;
+			m[6] = (sa * cc + ca * sb * sc) * sy;
+			m[7] = 0.0f;
+			// column 2
+			m[8] = sb * sz;
+			m[9] = (-sa * cb) * sz;
+			m[10] = (ca * cb) * sz;
+			m[11] = 0.0f;
+			// column 3
+			m[12] = streams.positionX[i];
+			m[13] = streams.positionY[i];
+			m[14] = streams.positionZ[i];
+			m[15] = 1.0f;
+		}
+	}
+
+#ifdef TRANSFORM_BATCH_X86
+	/***********************************************************
+	 *  SinCosSSE()
+	 *
+	 *  Sine and cosine of four angles in radians.
+	 ***********************************************************/
+	TARGET_SSE void SinCosSSE(__m128 x, __m128* pSin, __m128* pCos)
+	{
+		// reduce the angle to [-pi/4, pi/4] and keep the quadrant
+		__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+		__m128 q = _mm_cvtepi32_ps(quadrant);
+		__m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(PIO2_1)));
+		r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIO2_2)));
+		r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIO2_3)));
+		__m128 z = _mm_mul_ps(r, r);
+
+		// polynomial approximations on the reduced range
+		__m128 sinPoly = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(SIN_C3)), _mm_set1_ps(SIN_C2));
+		sinPoly = _mm_add_ps(_mm_mul_ps(z, sinPoly), _mm_set1_ps(SIN_C1));
+		sinPoly = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), sinPoly));
+		__m128 cosPoly = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(COS_C3)), _mm_set1_ps(COS_C2));
+		cosPoly = _mm_add_ps(_mm_mul_ps(z, cosPoly), _mm_set1_ps(COS_C1));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(z, z), cosPoly);
+		cosPoly = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, _mm_set1_ps(0.5f))), cosPoly);
+
+		// odd quadrants swap sine and cosine
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+			_mm_and_si128(quadrant, _mm_set1_epi32(1)),
+			_mm_set1_epi32(1)));
+		__m128 sinValue = _mm_or_ps(_mm_and_ps(swap, cosPoly), _mm_andnot_ps(swap, sinPoly));
+		__m128 cosValue = _mm_or_ps(_mm_and_ps(swap, sinPoly), _mm_andnot_ps(swap, cosPoly));
+
+		// quadrants 2 and 3 negate the sine, 1 and 2 the cosine
+		__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+		__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+		*pSin = _mm_xor_ps(sinValue, sinSign);
+		*pCos = _mm_xor_ps(cosValue, cosSign);
+	}
+
+	/***********************************************************
+	 *  StoreColumnsSSE()
+	 *
+	 *  Transpose one matrix column held across four objects
+	 *  and store it into each of the four output matrices.
+	 ***********************************************************/
+	TARGET_SSE void StoreColumnsSSE(
+		__m128 x, __m128 y, __m128 z, __m128 w,
+		float* pOut,
+		int column)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(pOut + (0 * MATRIX_FLOATS) + (column * 4), x);
+		_mm_storeu_ps(pOut + (1 * MATRIX_FLOATS) + (column * 4), y);
+		_mm_storeu_ps(pOut + (2 * MATRIX_FLOATS) + (column * 4), z);
+		_mm_storeu_ps(pOut + (3 * MATRIX_FLOATS) + (column * 4), w);
+	}
+
+	/***********************************************************
+	 *  ComposeSSE()
+	 *
+	 *  Compose the model matrices four objects at a time.
+	 ***********************************************************/
+	TARGET_SSE void ComposeSSE(
+		const TransformBatch::TRANSFORM_STREAMS& streams,
+		int count,
+		float* pOut)
+	{
+		const __m128 toRadians = _mm_set1_ps(DEGREES_TO_RADIANS);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		int i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 sa, ca, sb, cb, sc, cc;
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(streams.rotationX + i), toRadians), &sa, &ca);
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(streams.rotationY + i), toRadians), &sb, &cb);
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(streams.rotationZ + i), toRadians), &sc, &cc);
+
+			__m128 sx = _mm_loadu_ps(streams.scaleX + i);
+			__m128 sy = _mm_loadu_ps(streams.scaleY + i);
+			__m128 sz = _mm_loadu_ps(streams.scaleZ + i);
+			__m128 sasb = _mm_mul_ps(sa, sb);
+			__m128 casb = _mm_mul_ps(ca, sb);
+
+			// rotation matrix rows of Rx * Ry * Rz
+			__m128 r00 = _mm_mul_ps(cb, cc);
+			__m128 r10 = _mm_add_ps(_mm_mul_ps(ca, sc), _mm_mul_ps(sasb, cc));
+			__m128 r20 = _mm_sub_ps(_mm_mul_ps(sa, sc), _mm_mul_ps(casb, cc));
+			__m128 r01 = _mm_sub_ps(zero, _mm_mul_ps(cb, sc));
+			__m128 r11 = _mm_sub_ps(_mm_mul_ps(ca, cc), _mm_mul_ps(sasb, sc));
+			__m128 r21 = _mm_add_ps(_mm_mul_ps(sa, cc), _mm_mul_ps(casb, sc));
+			__m128 r02 = sb;
+			__m128 r12 = _mm_sub_ps(zero, _mm_mul_ps(sa, cb));
+			__m128 r22 = _mm_mul_ps(ca, cb);
+
+			float* pMatrices = pOut + (i * MATRIX_FLOATS);
+			StoreColumnsSSE(_mm_mul_ps(r00, sx), _mm_mul_ps(r10, sx), _mm_mul_ps(r20, sx), zero, pMatrices, 0);
+			StoreColumnsSSE(_mm_mul_ps(r01, sy), _mm_mul_ps(r11, sy), _mm_mul_ps(r21, sy), zero, pMatrices, 1);
+			StoreColumnsSSE(_mm_mul_ps(r02, sz), _mm_mul_ps(r12, sz), _mm_mul_ps(r22, sz), zero, pMatrices, 2);
+			StoreColumnsSSE(
+				_mm_loadu_ps(streams.positionX + i),
+				_mm_loadu_ps(streams.positionY + i),
+				_mm_loadu_ps(streams.positionZ + i),
+				one,
+				pMatrices,
+				3);
+		}
+
+		// the remaining objects that do not fill a register
+		ComposeScalar(streams, i, count, pOut);
+	}
+
+	/***********************************************************
+	 *  SinCosAVX2()
+	 *
+	 *  Sine and cosine of eight angles in radians.
+	 ***********************************************************/
+	TARGET_AVX2 void SinCosAVX2(__m256 x, __m256* pSin, __m256* pCos)
+	{
+		// reduce the angle to [-pi/4, pi/4] and keep the quadrant
+		__m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)));
+		__m256 q = _mm256_cvtepi32_ps(quadrant);
+		__m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_1)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_2)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_3)));
+		__m256 z = _mm256_mul_ps(r, r);
+
+		// polynomial approximations on the reduced range
+		__m256 sinPoly = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(SIN_C3)), _mm256_set1_ps(SIN_C2));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(z, sinPoly), _mm256_set1_ps(SIN_C1));
+		sinPoly = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), sinPoly));
+		__m256 cosPoly = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(COS_C3)), _mm256_set1_ps(COS_C2));
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(z, cosPoly), _mm256_set1_ps(COS_C1));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(z, z), cosPoly);
+		cosPoly = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), cosPoly);
+
+		// odd quadrants swap sine and cosine
+		__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+			_mm256_and_si256(quadrant, _mm256_set1_epi32(1)),
+			_mm256_set1_epi32(1)));
+		__m256 sinValue = _mm256_blendv_ps(sinPoly, cosPoly, swap);
+		__m256 cosValue = _mm256_blendv_ps(cosPoly, sinPoly, swap);
+
+		// quadrants 2 and 3 negate the sine, 1 and 2 the cosine
+		__m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+			_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+		__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+			_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+		*pSin = _mm256_xor_ps(sinValue, sinSign);
+		*pCos = _mm256_xor_ps(cosValue, cosSign);
+	}
+
+	/***********************************************************
+	 *  StoreColumnsAVX2()
+	 *
+	 *  Transpose one matrix column held across eight objects
+	 *  and store it into each of the eight output matrices.
+	 ***********************************************************/
+	TARGET_AVX2 void StoreColumnsAVX2(
+		__m256 x, __m256 y, __m256 z, __m256 w,
+		float* pOut,
+		int column)
+	{
+		// 4x4 transpose inside each 128-bit half - the low half
+		// holds objects 0 to 3 and the high half objects 4 to 7
+		__m256 t0 = _mm256_unpacklo_ps(x, y);
+		__m256 t1 = _mm256_unpackhi_ps(x, y);
+		__m256 t2 = _mm256_unpacklo_ps(z, w);
+		__m256 t3 = _mm256_unpackhi_ps(z, w);
+		__m256 c0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 c1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 c2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 c3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+		float* pColumn = pOut + (column * 4);
+		_mm_storeu_ps(pColumn + (0 * MATRIX_FLOATS), _mm256_castps256_ps128(c0));
+		_mm_storeu_ps(pColumn + (1 * MATRIX_FLOATS), _mm256_castps256_ps128(c1));
+		_mm_storeu_ps(pColumn + (2 * MATRIX_FLOATS), _mm256_castps256_ps128(c2));
+		_mm_storeu_ps(pColumn + (3 * MATRIX_FLOATS), _mm256_castps256_ps128(c3));
+		_mm_storeu_ps(pColumn + (4 * MATRIX_FLOATS), _mm256_extractf128_ps(c0, 1));
+		_mm_storeu_ps(pColumn + (5 * MATRIX_FLOATS), _mm256_extractf128_ps(c1, 1));
+		_mm_storeu_ps(pColumn + (6 * MATRIX_FLOATS), _mm256_extractf128_ps(c2, 1));
+		_mm_storeu_ps(pColumn + (7 * MATRIX_FLOATS), _mm256_extractf128_ps(c3, 1));
+	}
+
+	/***********************************************************
+	 *  ComposeAVX2()
+	 *
+	 *  Compose the model matrices eight objects at a time.
+	 ***********************************************************/
+	TARGET_AVX2 void ComposeAVX2(
+		const TransformBatch::TRANSFORM_STREAMS& streams,
+		int count,
+		float* pOut)
+	{
+		const __m256 toRadians = _mm256_set1_ps(DEGREES_TO_RADIANS);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		int i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 sa, ca, sb, cb, sc, cc;
+			SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(streams.rotationX + i), toRadians), &sa, &ca);
+			SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(streams.rotationY + i), toRadians), &sb, &cb);
+			SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(streams.rotationZ + i), toRadians), &sc, &cc);
+
+			__m256 sx = _mm256_loadu_ps(streams.scaleX + i);
+			__m256 sy = _mm256_loadu_ps(streams.scaleY + i);
+			__m256 sz = _mm256_loadu_ps(streams.scaleZ + i);
+			__m256 sasb = _mm256_mul_ps(sa, sb);
+			__m256 casb = _mm256_mul_ps(ca, sb);
+
+			// rotation matrix rows of Rx * Ry * Rz
+			__m256 r00 = _mm256_mul_ps(cb, cc);
+			__m256 r10 = _mm256_add_ps(_mm256_mul_ps(ca, sc), _mm256_mul_ps(sasb, cc));
+			__m256 r20 = _mm256_sub_ps(_mm256_mul_ps(sa, sc), _mm256_mul_ps(casb, cc));
+			__m256 r01 = _mm256_sub_ps(zero, _mm256_mul_ps(cb, sc));
+			__m256 r11 = _mm256_sub_ps(_mm256_mul_ps(ca, cc), _mm256_mul_ps(sasb, sc));
+			__m256 r21 = _mm256_add_ps(_mm256_mul_ps(sa, cc), _mm256_mul_ps(casb, sc));
+			__m256 r02 = sb;
+			__m256 r12 = _mm256_sub_ps(zero, _mm256_mul_ps(sa, cb));
+			__m256 r22 = _mm256_mul_ps(ca, cb);
+
+			float* pMatrices = pOut + (i * MATRIX_FLOATS);
+			StoreColumnsAVX2(_mm256_mul_ps(r00, sx), _mm256_mul_ps(r10, sx), _mm256_mul_ps(r20, sx), zero, pMatrices, 0);
+			StoreColumnsAVX2(_mm256_mul_ps(r01, sy), _mm256_mul_ps(r11, sy), _mm256_mul_ps(r21, sy), zero, pMatrices, 1);
+			StoreColumnsAVX2(_mm256_mul_ps(r02, sz), _mm256_mul_ps(r12, sz), _mm256_mul_ps(r22, sz), zero, pMatrices, 2);
+			StoreColumnsAVX2(
+				_mm256_loadu_ps(streams.positionX + i),
+				_mm256_loadu_ps(streams.positionY + i),
+				_mm256_loadu_ps(streams.positionZ + i),
+				one,
+				pMatrices,
+				3);
+		}
+
+		// the remaining objects that do not fill a register
+		ComposeScalar(streams, i, count, pOut);
+	}
+
+	/***********************************************************
+	 *  CpuSupportsSSE2()
+	 *
+	 *  Check the CPUID feature bits for SSE2.
+	 ***********************************************************/
+	bool CpuSupportsSSE2()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return((info[3] & (1 << 26)) != 0);
+#else
+		return(__builtin_cpu_supports("sse2") != 0);
+#endif
+	}
+
+	/***********************************************************
+	 *  CpuSupportsAVX2()
+	 *
+	 *  AVX2 also needs the operating system to save the YMM
+	 *  registers, which is checked through XGETBV.
+	 ***********************************************************/
+	bool CpuSupportsAVX2()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return(false);
+		}
+		__cpuid(info, 1);
+		bool bOSXSave = ((info[2] & (1 << 27)) != 0);
+		bool bAVX = ((info[2] & (1 << 28)) != 0);
+		if ((bOSXSave == false) || (bAVX == false))
+		{
+			return(false);
+		}
+		if ((_xgetbv(0) & 0x6) != 0x6)
+		{
+			return(false);
+		}
+		__cpuidex(info, 7, 0);
+		return((info[1] & (1 << 5)) != 0);
+#else
+		return(__builtin_cpu_supports("avx2") != 0);
+#endif
+	}
+#endif // TRANSFORM_BATCH_X86
+
+	/***********************************************************
+	 *  NextRandom()
+	 *
+	 *  Small deterministic generator for the kernel validation,
+	 *  returns a value between minValue and maxValue.
+	 ***********************************************************/
+	float NextRandom(uint32_t& state, float minValue, float maxValue)
+	{
+		state = (state * 1664525u) + 1013904223u;
+		float unit = (float)(state >> 8) / (float)(1u << 24);
+		return(minValue + (unit * (maxValue - minValue)));
+	}
+}
+
+/***********************************************************
+ *  TransformBatch()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformBatch::TransformBatch()
+{
+}
+
+/***********************************************************
+ *  ~TransformBatch()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TransformBatch::~TransformBatch()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every object from the
+ *  transformation table.
+ ***********************************************************/
+void TransformBatch::Clear()
+{
+	m_scaleX.clear();
+	m_scaleY.clear();
+	m_scaleZ.clear();
+	m_rotationX.clear();
+	m_rotationY.clear();
+	m_rotationZ.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for appending the transformation
+ *  values of an object to the table.  The index of the
+ *  object in the table is returned.
+ ***********************************************************/
+int TransformBatch::Add(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	m_scaleX.push_back(scaleXYZ.x);
+	m_scaleY.push_back(scaleXYZ.y);
+	m_scaleZ.push_back(scaleXYZ.z);
+	m_rotationX.push_back(XrotationDegrees);
+	m_rotationY.push_back(YrotationDegrees);
+	m_rotationZ.push_back(ZrotationDegrees);
+	m_positionX.push_back(positionXYZ.x);
+	m_positionY.push_back(positionXYZ.y);
+	m_positionZ.push_back(positionXYZ.z);
+
+	return((int)m_scaleX.size() - 1);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of objects
+ *  in the transformation table.
+ ***********************************************************/
+int TransformBatch::GetCount() const
+{
+	return((int)m_scaleX.size());
+}
+
+/***********************************************************
+ *  GetStreams()
+ *
+ *  This method is used for getting the streams that point
+ *  at the columns of the transformation table.
+ ***********************************************************/
+TransformBatch::TRANSFORM_STREAMS TransformBatch::GetStreams() const
+{
+	TRANSFORM_STREAMS streams;
+
+	streams.scaleX = m_scaleX.data();
+	streams.scaleY = m_scaleY.data();
+	streams.scaleZ = m_scaleZ.data();
+	streams.rotationX = m_rotationX.data();
+	streams.rotationY = m_rotationY.data();
+	streams.rotationZ = m_rotationZ.data();
+	streams.positionX = m_positionX.data();
+	streams.positionY = m_positionY.data();
+	streams.positionZ = m_positionZ.data();
+
+	return(streams);
+}
+
+/***********************************************************
+ *  Compose()
+ *
+ *  This method is used for composing the model matrices of
+ *  every object in the table into the passed in array.
+ ***********************************************************/
+void TransformBatch::Compose(glm::mat4* outMatrices) const
+{
+	ComposeModelMatrices(GetStreams(), GetCount(), outMatrices);
+}
+
+/***********************************************************
+ *  ComposeModelMatrices()
+ *
+ *  This method is used for composing count model matrices
+ *  with the widest kernel supported by the running CPU.
+ ***********************************************************/
+void TransformBatch::ComposeModelMatrices(
+	const TRANSFORM_STREAMS& streams,
+	int count,
+	glm::mat4* outMatrices)
+{
+	ComposeModelMatrices(GetSupportedKernel(), streams, count, outMatrices);
+}
+
+/***********************************************************
+ *  ComposeModelMatrices()
+ *
+ *  This method is used for composing count model matrices
+ *  with the passed in kernel.  Kernels that cannot run on
+ *  this CPU fall back to the scalar code.
+ ***********************************************************/
+void TransformBatch::ComposeModelMatrices(
+	KERNEL_TYPE kernel,
+	const TRANSFORM_STREAMS& streams,
+	int count,
+	glm::mat4* outMatrices)
+{
+	if ((count <= 0) || (NULL == outMatrices))
+	{
+		return;
+	}
+
+	float* pOut = &outMatrices[0][0][0];
+
+	if (kernel > GetSupportedKernel())
+	{
+		kernel = KERNEL_SCALAR;
+	}
+
+	switch (kernel)
+	{
+#ifdef TRANSFORM_BATCH_X86
+	case KERNEL_AVX2:
+		ComposeAVX2(streams, count, pOut);
+		break;
+	case KERNEL_SSE:
+		ComposeSSE(streams, count, pOut);
+		break;
+#endif
+	default:
+		ComposeScalar(streams, 0, count, pOut);
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetSupportedKernel()
+ *
+ *  This method is used for getting the widest kernel that
+ *  the running CPU supports.  The CPU is only checked once.
+ ***********************************************************/
+TransformBatch::KERNEL_TYPE TransformBatch::GetSupportedKernel()
+{
+	if (g_SupportedKernel < 0)
+	{
+		g_SupportedKernel = KERNEL_SCALAR;
+#ifdef TRANSFORM_BATCH_X86
+		if (CpuSupportsAVX2())
+		{
+			g_SupportedKernel = KERNEL_AVX2;
+		}
+		else if (CpuSupportsSSE2())
+		{
+			g_SupportedKernel = KERNEL_SSE;
+		}
+#endif
+	}
+
+	return((KERNEL_TYPE)g_SupportedKernel);
+}
+
+/***********************************************************
+ *  GetKernelName()
+ *
+ *  This method is used for getting a printable kernel name.
+ ***********************************************************/
+const char* TransformBatch::GetKernelName(KERNEL_TYPE kernel)
+{
+	switch (kernel)
+	{
+	case KERNEL_AVX2:
+		return("AVX2");
+	case KERNEL_SSE:
+		return("SSE");
+	default:
+		return("scalar");
+	}
+}
+
+/***********************************************************
+ *  ValidateKernels()
+ *
+ *  This method is used for checking every kernel supported
+ *  by the running CPU against the glm composition used by
+ *  SetTransformations().  The largest difference, relative
+ *  to the magnitude of the reference element, is returned
+ *  through maxError.
+ ***********************************************************/
+bool TransformBatch::ValidateKernels(float tolerance, float* maxError)
+{
+	// an odd count so that the scalar tail of each kernel runs
+	const int VALIDATION_COUNT = 1027;
+
+	TransformBatch batch;
+	std::vector<glm::mat4> reference(VALIDATION_COUNT);
+	std::vector<glm::mat4> result(VALIDATION_COUNT);
+	uint32_t state = 330;
+	float largestError = 0.0f;
+
+	for (int i = 0; i < VALIDATION_COUNT; i++)
+	{
+		glm::vec3 scaleXYZ = glm::vec3(
+			NextRandom(state, 0.01f, 20.0f),
+			NextRandom(state, 0.01f, 20.0f),
+			NextRandom(state, 0.01f, 20.0f));
+		float XrotationDegrees = NextRandom(state, -360.0f, 360.0f);
+		float YrotationDegrees = NextRandom(state, -360.0f, 360.0f);
+		float ZrotationDegrees = NextRandom(state, -360.0f, 360.0f);
+		glm::vec3 positionXYZ = glm::vec3(
+			NextRandom(state, -100.0f, 100.0f),
+			NextRandom(state, -100.0f, 100.0f),
+			NextRandom(state, -100.0f, 100.0f));
+
+		batch.Add(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
+		reference[i] = Transform::ComposeModelMatrix(
+			scaleXYZ,
+			XrotationDegrees,
+			YrotationDegrees,
+			ZrotationDegrees,
+			positionXYZ);
+	}
+
+	for (int kernel = KERNEL_SCALAR; kernel <= GetSupportedKernel(); kernel++)
+	{
+		ComposeModelMatrices((KERNEL_TYPE)kernel, batch.GetStreams(), VALIDATION_COUNT, result.data());
+
+		for (int i = 0; i < VALIDATION_COUNT; i++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					float expected = reference[i][column][row];
+					float error = std::fabs(result[i][column][row] - expected);
+					float magnitude = std::fabs(expected);
+					if (magnitude > 1.0f)
+					{
+						error /= magnitude;
+					}
+					if (error > largestError)
+					{
+						largestError = error;
+					}
+				}
+			}
+		}
+	}
+
+	if (NULL != maxError)
+	{
+		*maxError = largestError;
+	}
+
+	return(largestError <= tolerance);
+}
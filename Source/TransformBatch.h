@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbatch.h
+// ============
+// compose the model matrices of many objects at once from structure of
+// arrays transformation streams, using SSE or AVX2 when available
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TransformBatch
+ *
+ *  This class holds a structure of arrays table of object
+ *  transformations and composes their model matrices in the
+ *  same order as SceneManager::SetTransformations():
+ *  translation * rotationX * rotationY * rotationZ * scale
+ *
+ *  The widest kernel supported by the running CPU is picked
+ *  the first time a batch is composed, falling back to the
+ *  scalar code when SSE or AVX2 are not available.
+ ***********************************************************/
+class TransformBatch
+{
+public:
+	// constructor
+	TransformBatch();
+	// destructor
+	~TransformBatch();
+
+	// kernels that can compose a batch of model matrices
+	enum KERNEL_TYPE
+	{
+		KERNEL_SCALAR = 0,
+		KERNEL_SSE,
+		KERNEL_AVX2
+	};
+
+	// transformation streams for a batch - rotations in degrees
+	struct TRANSFORM_STREAMS
+	{
+		const float* scaleX;
+		const float* scaleY;
+		const float* scaleZ;
+		const float* rotationX;
+		const float* rotationY;
+		const float* rotationZ;
+		const float* positionX;
+		const float* positionY;
+		const float* positionZ;
+	};
+
+	// clear all of the transformations from the table
+	void Clear();
+	// add the transformation values of an object to the table
+	int Add(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	// number of objects in the table
+	int GetCount() const;
+	// streams referencing the table columns
+	TRANSFORM_STREAMS GetStreams() const;
+	// compose the model matrices of every object in the table
+	void Compose(glm::mat4* outMatrices) const;
+
+	// compose the model matrices for count objects with the best kernel
+	static void ComposeModelMatrices(
+		const TRANSFORM_STREAMS& streams,
+		int count,
+		glm::mat4* outMatrices);
+	// compose the model matrices for count objects with a specific kernel
+	static void ComposeModelMatrices(
+		KERNEL_TYPE kernel,
+		const TRANSFORM_STREAMS& streams,
+		int count,
+		glm::mat4* outMatrices);
+
+	// widest kernel supported by the running CPU
+	static KERNEL_TYPE GetSupportedKernel();
+	// printable name of a kernel
+	static const char* GetKernelName(KERNEL_TYPE kernel);
+
+	// compare every supported kernel against the glm composition,
+	// returns false when any element differs by more than tolerance
+	static bool ValidateKernels(float tolerance, float* maxError);
+
+private:
+	// table columns
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+};
@@ -22,6 +22,7 @@ namespace
 	const int WINDOW_HEIGHT = 800;
 	const char* g_ViewName = "view";
 	const char* g_ProjectionName = "projection";
+	const char* g_ViewPositionName = "viewPosition";
 
 	// camera object used for viewing and interacting with
 	// the 3D scene
@@ -31,17 +32,31 @@ namespace
 	float gLastX = WINDOW_WIDTH / 2.0f;
 	float gLastY = WINDOW_HEIGHT / 2.0f;
 	bool gFirstMouse = true;
+	// mouse and scroll input received since the last update,
+	// which is applied and recorded by the next update
+	float gPendingXOffset = 0.0f;
+	float gPendingYOffset = 0.0f;
+	float gPendingScroll = 0.0f;
 
 	// movement speed of the camera
 	float gMovementSpeed = 2.5f; // Default movement speed
 
-	// time between current frame and last frame
+	// time step of the current camera update
 	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
 
 	// the following variable is false when orthographic projection
 	// is off and true when it is on
 	bool bOrthographicProjection = false;
+
+	// log the camera input is recorded into, NULL when the
+	// input is not being recorded
+	InputLog* g_pInputRecording = nullptr;
+	// true while a recording drives the camera in place of
+	// the mouse and keyboard
+	bool gReplayingInput = false;
+	// keys pressed in the last frame, so the projection is
+	// toggled once for each press
+	uint32_t gLastKeys = 0;
 }
 
 /***********************************************************
@@ -54,7 +69,15 @@ ViewManager::ViewManager(
 {
 	// initialize the member variables
 	m_pShaderManager = pShaderManager;
+	m_pShaderUniforms = NULL;
 	m_pWindow = NULL;
+	m_viewWidth = WINDOW_WIDTH;
+	m_viewHeight = WINDOW_HEIGHT;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_replayEvent = 0;
+	m_replayFrame = 0;
+	m_replayKeys = 0;
 	g_pCamera = new Camera();
 	// default camera view parameters
 	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
@@ -64,6 +87,10 @@ ViewManager::ViewManager(
 
 	// Increase mouse sensitivity QOL
 	g_pCamera->MouseSensitivity = 0.05f; 	// default 0.01f
+
+	m_previousPosition = g_pCamera->Position;
+	m_previousFront = g_pCamera->Front;
+	m_previousUp = g_pCamera->Up;
 }
 
 /***********************************************************
@@ -75,7 +102,10 @@ ViewManager::~ViewManager()
 {
 	// free up allocated memory
 	m_pShaderManager = NULL;
+	m_pShaderUniforms = NULL;
 	m_pWindow = NULL;
+	g_pInputRecording = NULL;
+	gReplayingInput = false;
 	if (NULL != g_pCamera)
 	{
 		delete g_pCamera;
@@ -100,7 +130,7 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 		NULL, NULL);
 	if (window == NULL)
 	{
-		std::cout << "Failed to create GLFW window" << std::endl;
+		std::cout << "Failed to create GLFW window - an OpenGL 4.4 core profile context is required" << std::endl;
 		glfwTerminate();
 		return NULL;
 	}
@@ -124,14 +154,46 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 	return(window);
 }
 
+/***********************************************************
+ *  InitializeOffscreenView()
+ *
+ *  This method is used in place of CreateDisplayWindow()
+ *  when the scene is rendered into a framebuffer object
+ *  with no window.  The projection uses the size of the
+ *  framebuffer, and with no keyboard to follow, the camera
+ *  only moves when it is driven directly or replayed.
+ ***********************************************************/
+void ViewManager::InitializeOffscreenView(int width, int height)
+{
+	m_pWindow = NULL;
+	if ((width > 0) && (height > 0))
+	{
+		m_viewWidth = width;
+		m_viewHeight = height;
+	}
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
 /***********************************************************
  *  Mouse_Position_Callback()
  *
  *  This method is automatically called from GLFW whenever
  *  the mouse is moved within the active GLFW display window.
+ *  The offsets are held for the next update, so the camera
+ *  only turns inside the updates that are recorded and
+ *  replayed.
  ***********************************************************/
 void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
 {
+	// a replayed recording drives the camera in place of the mouse
+	if (gReplayingInput)
+	{
+		return;
+	}
+
 	// when the first mouse move event is received, this needs to be recorded so that
 	// all subsequent mouse moves can correctly calculate the X position offset and Y
 	// position offset for proper operation
@@ -151,21 +213,27 @@ void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos,
 	gLastY = yMousePos;
 
 	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+	// in the next update
+	gPendingXOffset += xOffset;
+	gPendingYOffset += yOffset;
 }
 
 /***********************************************************
 *	Add scroll callback to zoom in and out
 *
 *  This method is automatically called from GLFW whenever
-*  the scroll wheel is moved.
+*  the scroll wheel is moved.  The step is held for the
+*  next update, like the mouse offsets.
 ***********************************************************/
 void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
 {
-	// Adjust movement speed with scroll wheel
-	gMovementSpeed += static_cast<float>(yoffset);
-	if (gMovementSpeed < 0.1f) gMovementSpeed = 0.1f;	// Prevent negative/zero speed
-	if (gMovementSpeed > 20.0f) gMovementSpeed = 20.0f; // Clamp to a reasonable max
+	// a replayed recording drives the camera in place of the mouse
+	if (gReplayingInput)
+	{
+		return;
+	}
+
+	gPendingScroll += static_cast<float>(yoffset);
 }
 
 /***********************************************************
@@ -188,46 +256,232 @@ void ViewManager::ProcessKeyboardEvents()
 		return;
 	}
 
+	// gather the pressed keys, so that they can be recorded
+	// and replayed
+	uint32_t keys = 0;
+	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_FORWARD;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_BACKWARD;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_LEFT;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_RIGHT;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_UP;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_DOWN;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	{
+		keys |= InputLog::KEY_PROJECTION;
+	}
+
+	ApplyKeyboardInput(keys);
+}
+
+/***********************************************************
+ *  ApplyMouseMovement()
+ *
+ *  This method is used for turning the camera by mouse
+ *  offsets, live or from a replayed recording.
+ ***********************************************************/
+void ViewManager::ApplyMouseMovement(float xOffset, float yOffset)
+{
+	if (NULL != g_pInputRecording)
+	{
+		g_pInputRecording->AddMouseMove(xOffset, yOffset);
+	}
+
+	if (NULL != g_pCamera)
+	{
+		g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+	}
+}
+
+/***********************************************************
+ *  ApplyScroll()
+ *
+ *  This method is used for changing the movement speed by
+ *  a scroll wheel step, live or from a replayed recording.
+ ***********************************************************/
+void ViewManager::ApplyScroll(float yOffset)
+{
+	if (NULL != g_pInputRecording)
+	{
+		g_pInputRecording->AddScroll(yOffset);
+	}
+
+	// Adjust movement speed with scroll wheel
+	gMovementSpeed += yOffset;
+	if (gMovementSpeed < 0.1f) gMovementSpeed = 0.1f;	// Prevent negative/zero speed
+	if (gMovementSpeed > 20.0f) gMovementSpeed = 20.0f; // Clamp to a reasonable max
+}
+
+/***********************************************************
+ *  ApplyKeyboardInput()
+ *
+ *  This method is used for moving the camera by the keys
+ *  pressed in this frame, live or from a replayed
+ *  recording, over the time step of the frame.
+ ***********************************************************/
+void ViewManager::ApplyKeyboardInput(uint32_t keys)
+{
+	if (NULL != g_pInputRecording)
+	{
+		g_pInputRecording->SetKeys(keys);
+	}
+
+	// if the camera object is null, then exit this method
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
 	// process camera zooming in and out
 	// Use gMovementSpeed instead of a fixed value
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+	if (keys & InputLog::KEY_FORWARD)
 	{
 		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime * gMovementSpeed);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+	if (keys & InputLog::KEY_BACKWARD)
 	{
 		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime * gMovementSpeed);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+	if (keys & InputLog::KEY_LEFT)
 	{
 		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime * gMovementSpeed);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+	if (keys & InputLog::KEY_RIGHT)
 	{
 		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime * gMovementSpeed);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+	if (keys & InputLog::KEY_UP)
 	{
 		g_pCamera->ProcessKeyboard(UP, gDeltaTime * gMovementSpeed);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+	if (keys & InputLog::KEY_DOWN)
 	{
 		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime * gMovementSpeed);
 	}
 
-	// Toggle POV (Perspective, Orthographic)
-	static bool bPKeyWasPressed = false;
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	// Toggle POV (Perspective, Orthographic) once for each press
+	if ((keys & InputLog::KEY_PROJECTION) && !(gLastKeys & InputLog::KEY_PROJECTION))
 	{
-		if (!bPKeyWasPressed)
+		bOrthographicProjection = !bOrthographicProjection; // Toggle View
+	}
+	gLastKeys = keys;
+}
+
+/***********************************************************
+ *  ReplayInputFrame()
+ *
+ *  This method is used for applying the recorded input of
+ *  the next update.  The time step comes from the recording
+ *  rather than the clock, so the camera follows exactly the
+ *  recorded path however long the frames take to render.
+ ***********************************************************/
+void ViewManager::ReplayInputFrame()
+{
+	const std::vector<InputLog::INPUT_EVENT>& events = m_inputLog.GetEvents();
+
+	// nothing moves once the recording has run out
+	gDeltaTime = 0.0f;
+	while (m_replayEvent < events.size())
+	{
+		const InputLog::INPUT_EVENT& event = events[m_replayEvent];
+		m_replayEvent++;
+
+		if (event.type == InputLog::EVENT_MOUSE_MOVE)
+		{
+			ApplyMouseMovement(event.x, event.y);
+		}
+		else if (event.type == InputLog::EVENT_SCROLL)
+		{
+			ApplyScroll(event.x);
+		}
+		else if (event.type == InputLog::EVENT_KEYS)
+		{
+			m_replayKeys = event.keys;
+		}
+		else if (event.type == InputLog::EVENT_FRAME)
 		{
-			bOrthographicProjection = !bOrthographicProjection; // Toggle View
-			bPKeyWasPressed = true;
+			gDeltaTime = event.x;
+			m_replayFrame++;
+			break;
 		}
 	}
+
+	ApplyKeyboardInput(m_replayKeys);
+}
+
+/***********************************************************
+ *  UpdateView()
+ *
+ *  This method is used for moving the camera by the input
+ *  of one update.  The updates run at a fixed rate, so the
+ *  camera moves the same way whatever the frame rate, and
+ *  the camera before the update is kept for blending the
+ *  frames that fall between updates.  The mouse and scroll
+ *  input gathered by the callbacks is applied here along
+ *  with the keys, so all of it lands in the update that is
+ *  recorded and is replayed in the same place.
+ ***********************************************************/
+void ViewManager::UpdateView(float stepSeconds)
+{
+	m_previousPosition = g_pCamera->Position;
+	m_previousFront = g_pCamera->Front;
+	m_previousUp = g_pCamera->Up;
+
+	if (gReplayingInput)
+	{
+		// the window can still be closed during the replay
+		if ((NULL != m_pWindow) && (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS))
+		{
+			glfwSetWindowShouldClose(m_pWindow, true);
+		}
+
+		ReplayInputFrame();
+	}
 	else
 	{
-		bPKeyWasPressed = false;
+		gDeltaTime = stepSeconds;
+
+		if ((gPendingXOffset != 0.0f) || (gPendingYOffset != 0.0f))
+		{
+			ApplyMouseMovement(gPendingXOffset, gPendingYOffset);
+			gPendingXOffset = 0.0f;
+			gPendingYOffset = 0.0f;
+		}
+		if (gPendingScroll != 0.0f)
+		{
+			ApplyScroll(gPendingScroll);
+			gPendingScroll = 0.0f;
+		}
+
+		// process any keyboard events that may be waiting in the 
+		// event queue
+		if (NULL != m_pWindow)
+		{
+			ProcessKeyboardEvents();
+		}
+	}
+
+	// end the recorded update with the time step it used
+	if (NULL != g_pInputRecording)
+	{
+		g_pInputRecording->AddFrame(gDeltaTime);
 	}
 }
 
@@ -236,30 +490,72 @@ void ViewManager::ProcessKeyboardEvents()
  *
  *  This method is used for preparing the 3D scene by loading
  *  the shapes, textures in memory to support the 3D scene 
- *  rendering
+ *  rendering.  The camera is blended from before the last
+ *  update to after it by the interpolation factor, and a
+ *  factor of 1 uses the camera as it is.
  ***********************************************************/
-void ViewManager::PrepareSceneView()
+void ViewManager::PrepareSceneView(float interpolation)
 {
 	glm::mat4 view;
 	glm::mat4 projection;
+	glm::vec3 viewPosition = g_pCamera->Position;
 
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
+	// get the current view matrix from the camera, or from the
+	// camera part of the way through the last update
+	if (interpolation >= 1.0f)
+	{
+		view = g_pCamera->GetViewMatrix();
+	}
+	else
+	{
+		float blend = (interpolation > 0.0f) ? interpolation : 0.0f;
+		viewPosition = glm::mix(m_previousPosition, g_pCamera->Position, blend);
+		glm::vec3 front = glm::normalize(glm::mix(m_previousFront, g_pCamera->Front, blend));
+		glm::vec3 up = glm::normalize(glm::mix(m_previousUp, g_pCamera->Up, blend));
+		view = glm::lookAt(viewPosition, viewPosition + front, up);
+	}
 
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
+	// define the current projection matrix
+	projection = BuildProjectionMatrix();
 
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
+	// keep the matrices for the scene culling and lighting
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	// if the shader uniforms have been resolved
+	if (NULL != m_pShaderUniforms)
+	{
+		// set the view matrix into the shader for proper rendering
+		m_pShaderUniforms->setMat4Value(m_viewHandle, view);
+		// set the view matrix into the shader for proper rendering
+		m_pShaderUniforms->setMat4Value(m_projectionHandle, projection);
+		// set the view position of the camera into the shader for proper rendering
+		m_pShaderUniforms->setVec3Value(m_viewPositionHandle, viewPosition);
+	}
+	// otherwise fall back to setting the uniforms by name
+	else if (NULL != m_pShaderManager)
+	{
+		m_pShaderManager->setMat4Value(g_ViewName, view);
+		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+		m_pShaderManager->setVec3Value(g_ViewPositionName, viewPosition);
+	}
+}
+
+/***********************************************************
+ *  BuildProjectionMatrix()
+ *
+ *  This method is used for building the orthographic or
+ *  perspective projection matrix for the size of the view
+ *  and the zoom of the camera.
+ ***********************************************************/
+glm::mat4 ViewManager::BuildProjectionMatrix() const
+{
+	glm::mat4 projection;
 
-	// define the current projection matrix
 	if (bOrthographicProjection)
 	{
 		float orthoScale = 10.0f;
-		float aspect = (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT;
+		float aspect = (GLfloat)m_viewWidth / (GLfloat)m_viewHeight;
 		projection = glm::ortho(
 			-orthoScale * aspect,
 			orthoScale * aspect,
@@ -273,20 +569,168 @@ void ViewManager::PrepareSceneView()
 	{
 		projection = glm::perspective(
 			glm::radians(g_pCamera->Zoom),
-			(GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT,
+			(GLfloat)m_viewWidth / (GLfloat)m_viewHeight,
 			0.1f,
 			100.0f
 		);
 	}
 
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
+	return(projection);
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  This method is used for resolving the names of the view
+ *  uniforms into handles.  The view manager is created
+ *  before the shaders are loaded, so this is called once
+ *  the shader program has been reflected.
+ ***********************************************************/
+void ViewManager::SetShaderUniforms(ShaderUniforms* pShaderUniforms)
+{
+	m_pShaderUniforms = pShaderUniforms;
+	if (NULL != m_pShaderUniforms)
 	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		m_viewHandle = m_pShaderUniforms->GetHandle(g_ViewName);
+		m_projectionHandle = m_pShaderUniforms->GetHandle(g_ProjectionName);
+		m_viewPositionHandle = m_pShaderUniforms->GetHandle(g_ViewPositionName);
+	}
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *
+ *  This method is used for getting the view matrix that was
+ *  set into the shader for the current frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewMatrix() const
+{
+	return(m_viewMatrix);
+}
+
+/***********************************************************
+ *  GetProjectionMatrix()
+ *
+ *  This method is used for getting the projection matrix
+ *  that was set into the shader for the current frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetProjectionMatrix() const
+{
+	return(m_projectionMatrix);
+}
+
+/***********************************************************
+ *  GetCamera()
+ *
+ *  This method is used for getting the camera the view is
+ *  built from, so a recorded path can move it in place of
+ *  the mouse and keyboard.
+ ***********************************************************/
+Camera* ViewManager::GetCamera() const
+{
+	return(g_pCamera);
+}
+
+/***********************************************************
+ *  StartInputRecording()
+ *
+ *  This method is used for recording the input applied to
+ *  the camera from now on, along with the camera and view
+ *  settings it starts from.
+ ***********************************************************/
+void ViewManager::StartInputRecording()
+{
+	InputLog::VIEW_STATE state;
+	state.position = g_pCamera->Position;
+	state.front = g_pCamera->Front;
+	state.up = g_pCamera->Up;
+	state.right = g_pCamera->Right;
+	state.worldUp = g_pCamera->WorldUp;
+	state.yaw = g_pCamera->Yaw;
+	state.pitch = g_pCamera->Pitch;
+	state.cameraSpeed = g_pCamera->MovementSpeed;
+	state.mouseSensitivity = g_pCamera->MouseSensitivity;
+	state.zoom = g_pCamera->Zoom;
+	state.movementSpeed = gMovementSpeed;
+	state.bOrthographic = bOrthographicProjection;
+
+	gReplayingInput = false;
+	gLastKeys = 0;
+	m_inputLog.Clear();
+	m_inputLog.SetStartState(state);
+	g_pInputRecording = &m_inputLog;
+}
+
+/***********************************************************
+ *  SaveInputRecording()
+ *
+ *  This method is used for writing the input recorded so
+ *  far to a file.
+ ***********************************************************/
+bool ViewManager::SaveInputRecording(const std::string& filename) const
+{
+	return(m_inputLog.Write(filename));
+}
+
+/***********************************************************
+ *  StartInputReplay()
+ *
+ *  This method is used for reading a recording and driving
+ *  the camera from it in place of the mouse and keyboard.
+ *  The camera and view are put back to where the recording
+ *  started, so every replay follows the same path.
+ ***********************************************************/
+bool ViewManager::StartInputReplay(const std::string& filename)
+{
+	g_pInputRecording = NULL;
+	gReplayingInput = false;
+	if (m_inputLog.Read(filename) == false)
+	{
+		return(false);
 	}
+
+	const InputLog::VIEW_STATE& state = m_inputLog.GetStartState();
+	g_pCamera->Position = state.position;
+	g_pCamera->Front = state.front;
+	g_pCamera->Up = state.up;
+	g_pCamera->Right = state.right;
+	g_pCamera->WorldUp = state.worldUp;
+	g_pCamera->Yaw = state.yaw;
+	g_pCamera->Pitch = state.pitch;
+	g_pCamera->MovementSpeed = state.cameraSpeed;
+	g_pCamera->MouseSensitivity = state.mouseSensitivity;
+	g_pCamera->Zoom = state.zoom;
+	gMovementSpeed = state.movementSpeed;
+	bOrthographicProjection = state.bOrthographic;
+
+	gDeltaTime = 0.0f;
+	gLastKeys = 0;
+	m_previousPosition = g_pCamera->Position;
+	m_previousFront = g_pCamera->Front;
+	m_previousUp = g_pCamera->Up;
+	m_replayEvent = 0;
+	m_replayFrame = 0;
+	m_replayKeys = 0;
+	gReplayingInput = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsInputReplayFinished()
+ *
+ *  This method is used for checking whether every frame of
+ *  the replayed recording has been used.
+ ***********************************************************/
+bool ViewManager::IsInputReplayFinished() const
+{
+	return(gReplayingInput && (m_replayFrame >= m_inputLog.GetFrameCount()));
+}
+
+/***********************************************************
+ *  GetInputReplayFrameCount()
+ ***********************************************************/
+int ViewManager::GetInputReplayFrameCount() const
+{
+	return(gReplayingInput ? m_inputLog.GetFrameCount() : 0);
 }
\ No newline at end of file
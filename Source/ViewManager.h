@@ -10,6 +10,8 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "InputLog.h"
 #include "camera.h"
 
 // GLFW library
@@ -33,16 +35,75 @@ public:
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
+	// pointer to the reflected uniforms of the shader program
+	ShaderUniforms* m_pShaderUniforms;
+	// uniform handles resolved once the shaders are loaded
+	ShaderUniforms::UNIFORM_HANDLE m_viewHandle;
+	ShaderUniforms::UNIFORM_HANDLE m_projectionHandle;
+	ShaderUniforms::UNIFORM_HANDLE m_viewPositionHandle;
+	// matrices set into the shader by the last PrepareSceneView()
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// active OpenGL display window, NULL when rendering offscreen
 	GLFWwindow* m_pWindow;
+	// size of the rendered view, used for the aspect ratio
+	int m_viewWidth;
+	int m_viewHeight;
+	// input being recorded, or the recording being replayed
+	InputLog m_inputLog;
+	// next event and frame of the replayed recording
+	size_t m_replayEvent;
+	int m_replayFrame;
+	// keys held in the replayed recording
+	uint32_t m_replayKeys;
+	// camera before the last update, blended toward the
+	// camera after it when a frame falls between updates
+	glm::vec3 m_previousPosition;
+	glm::vec3 m_previousFront;
+	glm::vec3 m_previousUp;
 
 	// process keyboard events for interaction with the 3D scene
 	void ProcessKeyboardEvents();
+	// apply input to the camera, recording it when a
+	// recording is running
+	static void ApplyMouseMovement(float xOffset, float yOffset);
+	static void ApplyScroll(float yOffset);
+	static void ApplyKeyboardInput(uint32_t keys);
+	// apply the recorded input of the next replayed frame
+	void ReplayInputFrame();
 
 public:
+	// resolve the view uniform names into handles
+	void SetShaderUniforms(ShaderUniforms* pShaderUniforms);
+
 	// create the initial OpenGL display window
 	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	// render into a framebuffer of the given size with no window
+	void InitializeOffscreenView(int width, int height);
 	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+	// move the camera by the input of one fixed time step
+	void UpdateView(float stepSeconds);
+	// prepare the conversion from 3D object display to 2D scene
+	// display, blending the camera between the last two updates
+	void PrepareSceneView(float interpolation);
+	// projection matrix for the view size and the camera zoom
+	glm::mat4 BuildProjectionMatrix() const;
+
+	// view and projection matrices of the current frame
+	const glm::mat4& GetViewMatrix() const;
+	const glm::mat4& GetProjectionMatrix() const;
+	// camera the view is built from, for driving it directly
+	Camera* GetCamera() const;
+
+	// record the camera input from the current view on
+	void StartInputRecording();
+	// write the input recorded so far to a file
+	bool SaveInputRecording(const std::string& filename) const;
+	// drive the camera from a recording in place of the live
+	// input, starting from the view it was recorded from
+	bool StartInputReplay(const std::string& filename);
+	// true once every frame of the replayed recording is used
+	bool IsInputReplayFinished() const;
+	// frames in the replayed recording
+	int GetInputReplayFrameCount() const;
 };
\ No newline at end of file
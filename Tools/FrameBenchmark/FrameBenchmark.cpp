@@ -0,0 +1,510 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.cpp
+// ============
+// benchmark that renders the scene along a fixed camera path and reports the
+// frame times, draw calls and triangles as JSON, so that changes to the
+// renderer can be compared run against run
+//
+// the benchmark is its own console target, built by the CMakeLists.txt in
+// this folder from this file together with every Source file except
+// MainCode.cpp and the Utilities shader and mesh sources - it links GLEW,
+// GLFW and libEGL for the headless context, and is run from the project
+// folder so the shaders and textures are found as they are by the scene
+//
+// usage: FrameBenchmark [--frames N] [--warmup N] [--size WIDTHxHEIGHT]
+//                       [--copies N] [--window] [--output result.json]
+//   --frames  number of measured frames, 600 by default
+//   --warmup  frames rendered first and not measured, 60 by default, so the
+//             textures have streamed in before the timing starts
+//   --size    framebuffer size, 1280x720 by default
+//   --copies  number of copies of the scene, laid out on a grid - about 24
+//             objects each, so 4200 copies give 100k objects
+//   --window  render into a hidden GLFW window instead of headless
+//   --output  write the JSON to a file instead of the console
+// headless rendering through EGL is used where it is available, otherwise a
+// hidden GLFW window
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "HeadlessContext.h"
+
+// declaration of the global variables and defines
+namespace
+{
+	// benchmark options from the command line
+	struct BENCHMARK_OPTIONS
+	{
+		int frameCount;
+		int warmupFrames;
+		int width;
+		int height;
+		int copies;
+		bool bUseWindow;
+		std::string outputFilename;
+	};
+
+	// one point of the camera path, looking at the target
+	struct CAMERA_KEY
+	{
+		glm::vec3 position;
+		glm::vec3 target;
+	};
+
+	// closed loop around the house, passing the front porch,
+	// the fence corner and over the roof - the path is fixed so
+	// every run sees the same views
+	const CAMERA_KEY CAMERA_PATH[] =
+	{
+		{ glm::vec3(0.0f, 5.0f, 12.0f),    glm::vec3(0.0f, 2.0f, 0.0f) },
+		{ glm::vec3(9.0f, 3.0f, 8.0f),     glm::vec3(1.0f, 2.0f, 0.0f) },
+		{ glm::vec3(13.0f, 6.0f, -4.0f),   glm::vec3(0.0f, 1.5f, -2.0f) },
+		{ glm::vec3(4.0f, 12.0f, -14.0f),  glm::vec3(0.0f, 2.0f, 0.0f) },
+		{ glm::vec3(-10.0f, 4.0f, -9.0f),  glm::vec3(-2.0f, 1.0f, -2.0f) },
+		{ glm::vec3(-13.0f, 2.5f, 3.0f),   glm::vec3(-2.0f, 2.0f, 0.0f) },
+		{ glm::vec3(-5.0f, 2.0f, 9.0f),    glm::vec3(-2.0f, 1.5f, 3.0f) }
+	};
+	const int CAMERA_KEY_COUNT = sizeof(CAMERA_PATH) / sizeof(CAMERA_PATH[0]);
+
+	// measured values of one frame
+	struct FRAME_SAMPLE
+	{
+		double frameMs;
+		int drawCalls;
+		int triangles;
+		int visibleObjects;
+	};
+
+	HeadlessContext* g_HeadlessContext = NULL;
+	GLFWwindow* g_Window = NULL;
+	ShaderManager* g_ShaderManager = NULL;
+	ShaderUniforms* g_ShaderUniforms = NULL;
+	ViewManager* g_ViewManager = NULL;
+	SceneManager* g_SceneManager = NULL;
+}
+
+// Function declarations
+bool ParseCommandLine(int argc, char* argv[], BENCHMARK_OPTIONS& options);
+bool CreateContext(const BENCHMARK_OPTIONS& options);
+void SetCameraOnPath(Camera* pCamera, float pathTime);
+FRAME_SAMPLE RenderFrame();
+double Percentile(const std::vector<double>& sorted, double fraction);
+void WriteResults(std::ostream& output, const BENCHMARK_OPTIONS& options, const std::vector<FRAME_SAMPLE>& samples);
+
+/***********************************************************
+ *  main()
+ *
+ *  This function gets called after the application has been
+ *  launched.  It loads the scene, renders the warmup frames
+ *  and then the measured frames along the camera path, and
+ *  writes the results.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	BENCHMARK_OPTIONS options;
+	if (ParseCommandLine(argc, argv, options) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	g_ShaderManager = new ShaderManager();
+	g_ViewManager = new ViewManager(g_ShaderManager);
+	if (CreateContext(options) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	g_ViewManager->InitializeOffscreenView(options.width, options.height);
+
+	g_ShaderManager->LoadShaders(
+		"shaders/vertexShader.glsl",
+		"shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+
+	g_ShaderUniforms = new ShaderUniforms();
+	g_ShaderUniforms->Reflect(g_ShaderManager->m_programID);
+	g_ViewManager->SetShaderUniforms(g_ShaderUniforms);
+
+	// load the scene the same way as the application, then
+	// repeat it for the scaling runs
+	g_SceneManager = new SceneManager(g_ShaderManager, g_ShaderUniforms);
+	g_SceneManager->PrepareScene();
+	g_SceneManager->SetViewportSize(options.width, options.height);
+	g_SceneManager->ReplicateScene(options.copies);
+
+	Camera* pCamera = g_ViewManager->GetCamera();
+	int totalFrames = options.warmupFrames + options.frameCount;
+	std::vector<FRAME_SAMPLE> samples;
+	samples.reserve(options.frameCount);
+
+	for (int frame = 0; frame < totalFrames; frame++)
+	{
+		// the warmup frames go around the path once quickly, so
+		// the textures of every view have been requested
+		float pathTime = 0.0f;
+		if (frame < options.warmupFrames)
+		{
+			pathTime = (float)frame / (float)options.warmupFrames;
+		}
+		else
+		{
+			pathTime = (float)(frame - options.warmupFrames) / (float)options.frameCount;
+		}
+		SetCameraOnPath(pCamera, pathTime);
+
+		FRAME_SAMPLE sample = RenderFrame();
+		if (frame >= options.warmupFrames)
+		{
+			samples.push_back(sample);
+		}
+	}
+
+	if (options.outputFilename.empty())
+	{
+		WriteResults(std::cout, options, samples);
+	}
+	else
+	{
+		std::ofstream output(options.outputFilename.c_str());
+		if (!output)
+		{
+			std::cout << "Could not write results:" << options.outputFilename << std::endl;
+		}
+		else
+		{
+			WriteResults(output, options, samples);
+			std::cout << "INFO: Saved the results to " << options.outputFilename << std::endl;
+		}
+	}
+
+	// clear the allocated objects while the context is current
+	delete g_SceneManager;
+	g_SceneManager = NULL;
+	delete g_ViewManager;
+	g_ViewManager = NULL;
+	delete g_ShaderUniforms;
+	g_ShaderUniforms = NULL;
+	delete g_ShaderManager;
+	g_ShaderManager = NULL;
+	if (NULL != g_HeadlessContext)
+	{
+		delete g_HeadlessContext;
+		g_HeadlessContext = NULL;
+	}
+	if (NULL != g_Window)
+	{
+		glfwDestroyWindow(g_Window);
+		glfwTerminate();
+		g_Window = NULL;
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *  ParseCommandLine()
+ *
+ *  This function is used to read the benchmark options.
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[], BENCHMARK_OPTIONS& options)
+{
+	options.frameCount = 600;
+	options.warmupFrames = 60;
+	options.width = 1280;
+	options.height = 720;
+	options.copies = 1;
+	options.bUseWindow = false;
+	options.outputFilename.clear();
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool bHasValue = (i + 1 < argc);
+		if ((strcmp(argv[i], "--frames") == 0) && bHasValue)
+		{
+			options.frameCount = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--warmup") == 0) && bHasValue)
+		{
+			options.warmupFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--size") == 0) && bHasValue)
+		{
+			if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+			{
+				options.width = 0;
+			}
+		}
+		else if ((strcmp(argv[i], "--copies") == 0) && bHasValue)
+		{
+			options.copies = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--window") == 0)
+		{
+			options.bUseWindow = true;
+		}
+		else if ((strcmp(argv[i], "--output") == 0) && bHasValue)
+		{
+			options.outputFilename = argv[++i];
+		}
+		else
+		{
+			std::cout << "Unknown option:" << argv[i] << std::endl;
+			std::cout << "Usage: " << argv[0]
+				<< " [--frames N] [--warmup N] [--size WIDTHxHEIGHT] [--copies N] [--window] [--output result.json]"
+				<< std::endl;
+			return(false);
+		}
+	}
+
+	if ((options.frameCount <= 0) || (options.warmupFrames < 0) ||
+		(options.width <= 0) || (options.height <= 0) || (options.copies <= 0))
+	{
+		std::cout << "The frame count, size and copies must be positive" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateContext()
+ *
+ *  This function is used to create the OpenGL context and
+ *  the framebuffer the frames are rendered into.  The
+ *  headless context is tried first, unless a window was
+ *  asked for, and a hidden window is the fallback.
+ ***********************************************************/
+bool CreateContext(const BENCHMARK_OPTIONS& options)
+{
+	GLenum GLEWInitResult = GLEW_OK;
+
+	if (options.bUseWindow == false)
+	{
+		g_HeadlessContext = new HeadlessContext();
+		if (g_HeadlessContext->Create())
+		{
+			// glewInit() needs GLX, which the headless context has not
+			glewExperimental = GL_TRUE;
+			GLEWInitResult = glewContextInit();
+			if ((GLEW_OK == GLEWInitResult) &&
+				g_HeadlessContext->CreateFramebuffer(options.width, options.height))
+			{
+				std::cout << "INFO: Rendering headless on " << glGetString(GL_RENDERER) << std::endl;
+				return(true);
+			}
+		}
+		delete g_HeadlessContext;
+		g_HeadlessContext = NULL;
+		std::cout << "INFO: Headless rendering is not available, using a hidden window" << std::endl;
+	}
+
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	g_Window = glfwCreateWindow(options.width, options.height, "FrameBenchmark", NULL, NULL);
+	if (g_Window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return(false);
+	}
+	glfwMakeContextCurrent(g_Window);
+	// never wait for the display between frames
+	glfwSwapInterval(0);
+
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return(false);
+	}
+	glViewport(0, 0, options.width, options.height);
+	std::cout << "INFO: Rendering to a hidden window on " << glGetString(GL_RENDERER) << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetCameraOnPath()
+ *
+ *  This function is used to move the camera to a point of
+ *  the closed path, where a path time of 0 to 1 goes around
+ *  it once.  The position and the target follow Catmull-Rom
+ *  splines through the keys.
+ ***********************************************************/
+void SetCameraOnPath(Camera* pCamera, float pathTime)
+{
+	float keyTime = (pathTime - (float)(int)pathTime) * CAMERA_KEY_COUNT;
+	int key = (int)keyTime;
+	float t = keyTime - (float)key;
+	float t2 = t * t;
+	float t3 = t2 * t;
+
+	const CAMERA_KEY& p0 = CAMERA_PATH[(key + CAMERA_KEY_COUNT - 1) % CAMERA_KEY_COUNT];
+	const CAMERA_KEY& p1 = CAMERA_PATH[key % CAMERA_KEY_COUNT];
+	const CAMERA_KEY& p2 = CAMERA_PATH[(key + 1) % CAMERA_KEY_COUNT];
+	const CAMERA_KEY& p3 = CAMERA_PATH[(key + 2) % CAMERA_KEY_COUNT];
+
+	// Catmull-Rom basis weights
+	float w0 = 0.5f * (-t3 + 2.0f * t2 - t);
+	float w1 = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+	float w2 = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+	float w3 = 0.5f * (t3 - t2);
+
+	glm::vec3 position = w0 * p0.position + w1 * p1.position + w2 * p2.position + w3 * p3.position;
+	glm::vec3 target = w0 * p0.target + w1 * p1.target + w2 * p2.target + w3 * p3.target;
+
+	pCamera->Position = position;
+	pCamera->Front = glm::normalize(target - position);
+	pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+/***********************************************************
+ *  RenderFrame()
+ *
+ *  This function is used to render one frame through the
+ *  same calls as the application loop, and to wait for the
+ *  GPU so the frame time covers all of its work.
+ ***********************************************************/
+FRAME_SAMPLE RenderFrame()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	g_ViewManager->PrepareSceneView(1.0f);
+	g_SceneManager->SetViewTransform(
+		g_ViewManager->GetViewMatrix(),
+		g_ViewManager->GetProjectionMatrix());
+	g_SceneManager->RenderScene();
+
+	if (NULL != g_HeadlessContext)
+	{
+		g_HeadlessContext->FinishFrame();
+	}
+	else
+	{
+		glfwSwapBuffers(g_Window);
+		glFinish();
+		glfwPollEvents();
+	}
+
+	FRAME_SAMPLE sample;
+	sample.frameMs = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+	sample.drawCalls = g_SceneManager->GetRenderQueueStats().drawCalls;
+	sample.triangles = g_SceneManager->GetLodStats().drawnTriangles;
+	sample.visibleObjects = g_SceneManager->GetRenderQueueStats().packets;
+
+	return(sample);
+}
+
+/***********************************************************
+ *  Percentile()
+ *
+ *  This function is used to get a percentile of sorted
+ *  values, by the nearest rank.
+ ***********************************************************/
+double Percentile(const std::vector<double>& sorted, double fraction)
+{
+	if (sorted.empty())
+	{
+		return(0.0);
+	}
+
+	size_t rank = (size_t)(fraction * (double)sorted.size() + 0.999999);
+	rank = std::min(std::max(rank, (size_t)1), sorted.size());
+
+	return(sorted[rank - 1]);
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This function is used to write the frame time statistics
+ *  and the per-frame averages of the draw calls, triangles
+ *  and visible objects as JSON.
+ ***********************************************************/
+void WriteResults(std::ostream& output, const BENCHMARK_OPTIONS& options, const std::vector<FRAME_SAMPLE>& samples)
+{
+	std::vector<double> frameTimes;
+	double totalMs = 0.0;
+	double drawCalls = 0.0;
+	double triangles = 0.0;
+	double visibleObjects = 0.0;
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		frameTimes.push_back(samples[i].frameMs);
+		totalMs += samples[i].frameMs;
+		drawCalls += samples[i].drawCalls;
+		triangles += samples[i].triangles;
+		visibleObjects += samples[i].visibleObjects;
+	}
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	double count = (samples.empty()) ? 1.0 : (double)samples.size();
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+
+	char buffer[1024];
+	snprintf(buffer, sizeof(buffer),
+		"{\n"
+		"  \"renderer\": \"%s\",\n"
+		"  \"headless\": %s,\n"
+		"  \"width\": %d,\n"
+		"  \"height\": %d,\n"
+		"  \"frames\": %d,\n"
+		"  \"copies\": %d,\n"
+		"  \"objects\": %d,\n"
+		"  \"frameTimeMs\": {\n"
+		"    \"mean\": %.4f,\n"
+		"    \"min\": %.4f,\n"
+		"    \"p50\": %.4f,\n"
+		"    \"p95\": %.4f,\n"
+		"    \"p99\": %.4f,\n"
+		"    \"max\": %.4f\n"
+		"  },\n"
+		"  \"drawCallsPerFrame\": %.1f,\n"
+		"  \"trianglesPerFrame\": %.1f,\n"
+		"  \"visibleObjectsPerFrame\": %.1f\n"
+		"}\n",
+		(NULL != renderer) ? (const char*)renderer : "unknown",
+		(NULL != g_HeadlessContext) ? "true" : "false",
+		options.width,
+		options.height,
+		(int)samples.size(),
+		options.copies,
+		g_SceneManager->GetSceneObjectCount(),
+		totalMs / count,
+		frameTimes.empty() ? 0.0 : frameTimes.front(),
+		Percentile(frameTimes, 0.50),
+		Percentile(frameTimes, 0.95),
+		Percentile(frameTimes, 0.99),
+		frameTimes.empty() ? 0.0 : frameTimes.back(),
+		drawCalls / count,
+		triangles / count,
+		visibleObjects / count);
+
+	output << buffer;
+}
@@ -0,0 +1,384 @@
+///////////////////////////////////////////////////////////////////////////////
+// microbenchmark.cpp
+// ============
+// small benchmark harness in the style of Google Benchmark - benchmarks are
+// functions taking a state object, registered with BENCHMARK(), and run for
+// enough iterations to fill a minimum time
+//
+// the harness and the benchmarks are their own console target, built and
+// run as a test by the CMakeLists.txt in this folder from the files in this
+// folder together with every Source file except MainCode.cpp and
+// HeadlessContext.cpp and the Utilities mesh sources.  The Mock folder goes
+// on the include path before Utilities, so the scene is built against the
+// mock ShaderManager, and no OpenGL context is created - GLEW, GLFW and
+// OpenGL are linked only for their entry points, which MockGL replaces
+//
+// usage: MicroBenchmark [--benchmark_filter=TEXT] [--benchmark_min_time=S]
+//                       [--benchmark_format=json]
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+#include "MockGL.h"
+
+#include <iostream>         // error handling and output
+#include <cstdio>
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>
+
+// declaration of the global variables and defines
+namespace
+{
+	// most iterations of one run
+	const int64_t MAX_ITERATIONS = 1000000000;
+	// default time a run has to take to be reported
+	const double DEFAULT_MIN_TIME = 0.5;
+
+	// result of the last run of one benchmark and argument
+	struct BENCHMARK_RESULT
+	{
+		std::string name;
+		int64_t iterations;
+		double realNs;
+		double cpuNs;
+		double itemsPerSecond;
+		std::string label;
+	};
+
+	/***********************************************************
+	 *  GetBenchmarks()
+	 *
+	 *  The registered benchmarks, created on first use since
+	 *  they are registered from static initializers.
+	 ***********************************************************/
+	std::vector<MicroBenchmark::Benchmark*>& GetBenchmarks()
+	{
+		static std::vector<MicroBenchmark::Benchmark*> benchmarks;
+		return(benchmarks);
+	}
+
+	/***********************************************************
+	 *  RunOne()
+	 *
+	 *  Run a benchmark with growing iteration counts until a
+	 *  run takes the minimum time, the way Google Benchmark
+	 *  predicts the count from the previous run.
+	 ***********************************************************/
+	BENCHMARK_RESULT RunOne(const MicroBenchmark::Benchmark& benchmark, int64_t arg, bool bHasArg, double minTime)
+	{
+		BENCHMARK_RESULT result;
+		result.name = benchmark.m_name;
+		if (bHasArg)
+		{
+			result.name += "/" + std::to_string(arg);
+		}
+
+		int64_t iterations = 1;
+		while (true)
+		{
+			BenchmarkState state(iterations, arg);
+			benchmark.m_function(state);
+			double seconds = state.GetRealSeconds();
+			double cpuSeconds = state.GetCpuSeconds();
+
+			if ((seconds >= minTime) || (iterations >= MAX_ITERATIONS))
+			{
+				result.iterations = iterations;
+				result.realNs = seconds * 1.0e9 / (double)iterations;
+				result.cpuNs = cpuSeconds * 1.0e9 / (double)iterations;
+				result.itemsPerSecond = (seconds > 0.0) ? (double)state.GetItemsProcessed() / seconds : 0.0;
+				result.label = state.GetLabel();
+				break;
+			}
+
+			// aim past the minimum time, and grow at least tenfold
+			// while the runs are too short to predict from
+			double multiplier = (seconds > minTime / 10.0) ? (minTime * 1.4 / seconds) : 10.0;
+			int64_t next = (int64_t)((double)iterations * multiplier);
+			iterations = (next > iterations) ? next : iterations + 1;
+			if (iterations > MAX_ITERATIONS)
+			{
+				iterations = MAX_ITERATIONS;
+			}
+		}
+
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  BenchmarkState()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BenchmarkState::BenchmarkState(int64_t iterations, int64_t arg)
+{
+	m_iterations = iterations;
+	m_remaining = iterations;
+	m_arg = arg;
+	m_itemsProcessed = 0;
+	m_bStarted = false;
+	m_cpuStart = 0;
+	m_realSeconds = 0.0;
+	m_cpuSeconds = 0.0;
+}
+
+/***********************************************************
+ *  KeepRunning()
+ *
+ *  This method is used for counting down the iterations.
+ ***********************************************************/
+bool BenchmarkState::KeepRunning()
+{
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		m_cpuStart = std::clock();
+		m_startTime = std::chrono::steady_clock::now();
+	}
+
+	if (m_remaining > 0)
+	{
+		m_remaining--;
+		return(true);
+	}
+
+	m_realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+	m_cpuSeconds = (double)(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetRealSeconds()
+ *
+ *  This method is used for getting the time the loop took.
+ ***********************************************************/
+double BenchmarkState::GetRealSeconds() const
+{
+	return(m_realSeconds);
+}
+
+/***********************************************************
+ *  GetCpuSeconds()
+ *
+ *  This method is used for getting the CPU time of the loop.
+ ***********************************************************/
+double BenchmarkState::GetCpuSeconds() const
+{
+	return(m_cpuSeconds);
+}
+
+/***********************************************************
+ *  iterations()
+ *
+ *  This method is used for getting the iterations of the
+ *  run.
+ ***********************************************************/
+int64_t BenchmarkState::iterations() const
+{
+	return(m_iterations);
+}
+
+/***********************************************************
+ *  range()
+ *
+ *  This method is used for getting the argument of the run,
+ *  under the name Google Benchmark uses - only one argument
+ *  is supported.
+ ***********************************************************/
+int64_t BenchmarkState::range(int index) const
+{
+	return((index == 0) ? m_arg : 0);
+}
+
+/***********************************************************
+ *  SetItemsProcessed()
+ ***********************************************************/
+void BenchmarkState::SetItemsProcessed(int64_t items)
+{
+	m_itemsProcessed = items;
+}
+
+/***********************************************************
+ *  GetItemsProcessed()
+ ***********************************************************/
+int64_t BenchmarkState::GetItemsProcessed() const
+{
+	return(m_itemsProcessed);
+}
+
+/***********************************************************
+ *  SetLabel()
+ ***********************************************************/
+void BenchmarkState::SetLabel(const std::string& label)
+{
+	m_label = label;
+}
+
+/***********************************************************
+ *  GetLabel()
+ ***********************************************************/
+const std::string& BenchmarkState::GetLabel() const
+{
+	return(m_label);
+}
+
+/***********************************************************
+ *  Benchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MicroBenchmark::Benchmark::Benchmark(const char* name, BENCHMARK_FUNCTION function)
+{
+	m_name = name;
+	m_function = function;
+}
+
+/***********************************************************
+ *  Arg()
+ *
+ *  This method is used for adding an argument the benchmark
+ *  is run with.
+ ***********************************************************/
+MicroBenchmark::Benchmark* MicroBenchmark::Benchmark::Arg(int64_t arg)
+{
+	m_args.push_back(arg);
+	return(this);
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for adding a benchmark to the list.
+ *  The benchmarks live until the program exits.
+ ***********************************************************/
+MicroBenchmark::Benchmark* MicroBenchmark::Register(const char* name, BENCHMARK_FUNCTION function)
+{
+	Benchmark* benchmark = new Benchmark(name, function);
+	GetBenchmarks().push_back(benchmark);
+	return(benchmark);
+}
+
+/***********************************************************
+ *  RunBenchmarks()
+ *
+ *  This method is used for running every benchmark whose
+ *  name contains the filter, once per argument, and writing
+ *  a table of the times or the same values as JSON.
+ ***********************************************************/
+int MicroBenchmark::RunBenchmarks(int argc, char* argv[])
+{
+	std::string filter;
+	double minTime = DEFAULT_MIN_TIME;
+	bool bJson = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strncmp(argv[i], "--benchmark_filter=", 19) == 0)
+		{
+			filter = argv[i] + 19;
+		}
+		else if (strncmp(argv[i], "--benchmark_min_time=", 21) == 0)
+		{
+			minTime = atof(argv[i] + 21);
+		}
+		else if (strcmp(argv[i], "--benchmark_format=json") == 0)
+		{
+			bJson = true;
+		}
+		else
+		{
+			std::cout << "Unknown option:" << argv[i] << std::endl;
+			std::cout << "Usage: " << argv[0]
+				<< " [--benchmark_filter=TEXT] [--benchmark_min_time=SECONDS] [--benchmark_format=json]"
+				<< std::endl;
+			return(EXIT_FAILURE);
+		}
+	}
+	if (minTime <= 0.0)
+	{
+		minTime = DEFAULT_MIN_TIME;
+	}
+
+	if (bJson)
+	{
+		printf("{\n  \"benchmarks\": [");
+	}
+	else
+	{
+		printf("%-44s %13s %13s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+		printf("%s\n", std::string(85, '-').c_str());
+	}
+
+	bool bFirst = true;
+	std::vector<Benchmark*>& benchmarks = GetBenchmarks();
+	for (size_t i = 0; i < benchmarks.size(); i++)
+	{
+		const Benchmark& benchmark = *benchmarks[i];
+		if (!filter.empty() && (benchmark.m_name.find(filter) == std::string::npos))
+		{
+			continue;
+		}
+
+		size_t runCount = benchmark.m_args.empty() ? 1 : benchmark.m_args.size();
+		for (size_t run = 0; run < runCount; run++)
+		{
+			bool bHasArg = !benchmark.m_args.empty();
+			BENCHMARK_RESULT result = RunOne(benchmark, bHasArg ? benchmark.m_args[run] : 0, bHasArg, minTime);
+
+			if (bJson)
+			{
+				printf("%s\n    {\"name\": \"%s\", \"iterations\": %lld, \"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"ns\", \"items_per_second\": %.1f, \"label\": \"%s\"}",
+					bFirst ? "" : ",",
+					result.name.c_str(),
+					(long long)result.iterations,
+					result.realNs,
+					result.cpuNs,
+					result.itemsPerSecond,
+					result.label.c_str());
+			}
+			else
+			{
+				printf("%-44s %10.2f ns %10.2f ns %12lld",
+					result.name.c_str(),
+					result.realNs,
+					result.cpuNs,
+					(long long)result.iterations);
+				if (result.itemsPerSecond > 0.0)
+				{
+					printf(" %10.3fM items/s", result.itemsPerSecond / 1.0e6);
+				}
+				if (!result.label.empty())
+				{
+					printf(" %s", result.label.c_str());
+				}
+				printf("\n");
+			}
+			fflush(stdout);
+			bFirst = false;
+		}
+	}
+
+	if (bJson)
+	{
+		printf("\n  ]\n}\n");
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *  main()
+ *
+ *  This function gets called after the application has been
+ *  launched.  The OpenGL entry points are pointed at the
+ *  mock before any benchmark runs.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	MockGL::Install();
+
+	return(MicroBenchmark::RunBenchmarks(argc, argv));
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// microbenchmark.h
+// ============
+// small benchmark harness in the style of Google Benchmark - benchmarks are
+// functions taking a state object, registered with BENCHMARK(), and run for
+// enough iterations to fill a minimum time
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/***********************************************************
+ *  BenchmarkState
+ *
+ *  This class is passed to a benchmark function, which runs
+ *  the measured code once for every pass of its loop:
+ *
+ *      while (state.KeepRunning()) { ... }
+ *
+ *  Only the loop is timed, so the setup before it is free.
+ *  The harness calls the function with growing iteration
+ *  counts until a run takes the minimum time, and reports
+ *  the time of one iteration of the last run.
+ ***********************************************************/
+class BenchmarkState
+{
+public:
+	BenchmarkState(int64_t iterations, int64_t arg);
+
+	// true while iterations are left - the first call starts
+	// the timer and the last one stops it
+	bool KeepRunning();
+	// seconds the loop took on the clock and on the CPU
+	double GetRealSeconds() const;
+	double GetCpuSeconds() const;
+	// iterations of this run
+	int64_t iterations() const;
+	// argument the benchmark was registered with, 0 for none
+	int64_t range(int index) const;
+
+	// items handled by the whole run, reported per second
+	void SetItemsProcessed(int64_t items);
+	int64_t GetItemsProcessed() const;
+	// text reported after the times
+	void SetLabel(const std::string& label);
+	const std::string& GetLabel() const;
+
+private:
+	int64_t m_iterations;
+	int64_t m_remaining;
+	int64_t m_arg;
+	int64_t m_itemsProcessed;
+	std::string m_label;
+	bool m_bStarted;
+	std::chrono::steady_clock::time_point m_startTime;
+	std::clock_t m_cpuStart;
+	double m_realSeconds;
+	double m_cpuSeconds;
+};
+
+/***********************************************************
+ *  MicroBenchmark
+ *
+ *  This class holds the registered benchmarks and runs the
+ *  ones matching the command line filter.
+ ***********************************************************/
+class MicroBenchmark
+{
+public:
+	typedef void (*BENCHMARK_FUNCTION)(BenchmarkState&);
+
+	// registered benchmark, run once for every argument
+	class Benchmark
+	{
+	public:
+		Benchmark(const char* name, BENCHMARK_FUNCTION function);
+
+		// run the benchmark with an argument as well
+		Benchmark* Arg(int64_t arg);
+
+		std::string m_name;
+		BENCHMARK_FUNCTION m_function;
+		std::vector<int64_t> m_args;
+	};
+
+	// add a benchmark to the list that is run
+	static Benchmark* Register(const char* name, BENCHMARK_FUNCTION function);
+	// run the benchmarks with the command line options
+	// --benchmark_filter=TEXT, --benchmark_min_time=SECONDS and
+	// --benchmark_format=json, returning the exit code
+	static int RunBenchmarks(int argc, char* argv[]);
+};
+
+// keep a value the compiler would otherwise optimize away
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	static volatile const void* sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+#define BENCHMARK_CONCAT_NAME(a, b) a##b
+#define BENCHMARK_UNIQUE_NAME(a, b) BENCHMARK_CONCAT_NAME(a, b)
+
+// register a benchmark function - arguments can be added
+// after it with ->Arg(value)
+#define BENCHMARK(function) \
+	static MicroBenchmark::Benchmark* BENCHMARK_UNIQUE_NAME(g_benchmark, __LINE__) = \
+		MicroBenchmark::Register(#function, function)
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// mock of the Utilities shader manager for the micro-benchmarks - it has the
+// same interface, loads nothing and only counts the uniforms set by name
+//
+// this folder goes on the include path before Utilities, so the scene code
+// includes this header in place of the real one
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "../MockGL.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+
+/***********************************************************
+ *  ShaderManager
+ *
+ *  This class stands in for the shader manager with no
+ *  OpenGL context.  The program ID is the mock program,
+ *  whose uniforms MockGL reports for reflection.
+ ***********************************************************/
+class ShaderManager
+{
+public:
+	// ID of the mock program
+	unsigned int m_programID;
+
+	// constructor
+	ShaderManager()
+	{
+		m_programID = MockGL::MOCK_PROGRAM_ID;
+		m_namedUniformCalls = 0;
+	}
+
+	// nothing is compiled - the mock program is returned
+	GLuint LoadShaders(const char*, const char*)
+	{
+		return(m_programID);
+	}
+	void use() {}
+
+	// uniforms set by name - only counted
+	void setBoolValue(const std::string&, bool) { m_namedUniformCalls++; }
+	void setIntValue(const std::string&, int) { m_namedUniformCalls++; }
+	void setFloatValue(const std::string&, float) { m_namedUniformCalls++; }
+	void setVec2Value(const std::string&, const glm::vec2&) { m_namedUniformCalls++; }
+	void setVec3Value(const std::string&, const glm::vec3&) { m_namedUniformCalls++; }
+	void setVec4Value(const std::string&, const glm::vec4&) { m_namedUniformCalls++; }
+	void setMat4Value(const std::string&, const glm::mat4&) { m_namedUniformCalls++; }
+	void setSampler2DValue(const std::string&, int) { m_namedUniformCalls++; }
+
+	// uniforms set by name since the manager was created
+	long long GetNamedUniformCalls() const
+	{
+		return(m_namedUniformCalls);
+	}
+
+private:
+	long long m_namedUniformCalls;
+};
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+// mockgl.cpp
+// ============
+// point the OpenGL entry points used on the per-draw paths at functions
+// that only count the calls, so the scene code runs with no context
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MockGL.h"
+
+#include <cstring>
+
+// declaration of the global variables and defines
+namespace
+{
+	// one uniform of the mock program
+	struct MOCK_UNIFORM
+	{
+		const char* name;
+		GLenum type;
+	};
+
+	// the active uniforms of the scene shaders
+	const MOCK_UNIFORM MOCK_UNIFORMS[] =
+	{
+		{ "model", GL_FLOAT_MAT4 },
+		{ "view", GL_FLOAT_MAT4 },
+		{ "projection", GL_FLOAT_MAT4 },
+		{ "viewPosition", GL_FLOAT_VEC3 },
+		{ "objectColor", GL_FLOAT_VEC4 },
+		{ "objectTexture", GL_SAMPLER_2D_ARRAY },
+		{ "bUseTexture", GL_BOOL },
+		{ "bUseLighting", GL_BOOL },
+		{ "bUseInstancing", GL_BOOL },
+		{ "bUseDrawBuffer", GL_BOOL },
+		{ "bUseBindlessTextures", GL_BOOL },
+		{ "textureLayer", GL_INT },
+		{ "textureRect", GL_FLOAT_VEC4 },
+		{ "UVscale", GL_FLOAT_VEC2 },
+		{ "materialIndex", GL_INT },
+		{ "clusterTileSize", GL_FLOAT_VEC2 },
+		{ "clusterDepthParams", GL_FLOAT_VEC2 }
+	};
+	const int MOCK_UNIFORM_COUNT = sizeof(MOCK_UNIFORMS) / sizeof(MOCK_UNIFORMS[0]);
+
+	long long g_uniformCalls = 0;
+
+	// uniform uploads - only counted
+	void GLAPIENTRY MockUniform1i(GLint, GLint) { g_uniformCalls++; }
+	void GLAPIENTRY MockUniform1f(GLint, GLfloat) { g_uniformCalls++; }
+	void GLAPIENTRY MockUniform2fv(GLint, GLsizei, const GLfloat*) { g_uniformCalls++; }
+	void GLAPIENTRY MockUniform3fv(GLint, GLsizei, const GLfloat*) { g_uniformCalls++; }
+	void GLAPIENTRY MockUniform4fv(GLint, GLsizei, const GLfloat*) { g_uniformCalls++; }
+	void GLAPIENTRY MockUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { g_uniformCalls++; }
+
+	// binds and deletes - nothing to do
+	void GLAPIENTRY MockUseProgram(GLuint) {}
+	void GLAPIENTRY MockBindVertexArray(GLuint) {}
+	void GLAPIENTRY MockActiveTexture(GLenum) {}
+	void GLAPIENTRY MockDeleteBuffers(GLsizei, const GLuint*) {}
+	void GLAPIENTRY MockDeleteVertexArrays(GLsizei, const GLuint*) {}
+	void GLAPIENTRY MockMakeTextureHandleNonResident(GLuint64) {}
+
+	// reflection of the mock program
+	void GLAPIENTRY MockGetProgramiv(GLuint program, GLenum name, GLint* value)
+	{
+		*value = 0;
+		if (program != MockGL::MOCK_PROGRAM_ID)
+		{
+			return;
+		}
+
+		if (name == GL_ACTIVE_UNIFORMS)
+		{
+			*value = MOCK_UNIFORM_COUNT;
+		}
+		else if (name == GL_ACTIVE_UNIFORM_MAX_LENGTH)
+		{
+			for (int i = 0; i < MOCK_UNIFORM_COUNT; i++)
+			{
+				GLint length = (GLint)strlen(MOCK_UNIFORMS[i].name) + 1;
+				if (length > *value)
+				{
+					*value = length;
+				}
+			}
+		}
+	}
+
+	void GLAPIENTRY MockGetActiveUniform(
+		GLuint program,
+		GLuint index,
+		GLsizei bufferSize,
+		GLsizei* length,
+		GLint* size,
+		GLenum* type,
+		GLchar* name)
+	{
+		*length = 0;
+		*size = 0;
+		*type = GL_NONE;
+		if ((program != MockGL::MOCK_PROGRAM_ID) || (index >= (GLuint)MOCK_UNIFORM_COUNT) || (bufferSize <= 0))
+		{
+			return;
+		}
+
+		GLsizei nameLength = (GLsizei)strlen(MOCK_UNIFORMS[index].name);
+		if (nameLength >= bufferSize)
+		{
+			nameLength = bufferSize - 1;
+		}
+		memcpy(name, MOCK_UNIFORMS[index].name, (size_t)nameLength);
+		name[nameLength] = '\0';
+		*length = nameLength;
+		*size = 1;
+		*type = MOCK_UNIFORMS[index].type;
+	}
+
+	GLint GLAPIENTRY MockGetUniformLocation(GLuint program, const GLchar* name)
+	{
+		if (program == MockGL::MOCK_PROGRAM_ID)
+		{
+			for (int i = 0; i < MOCK_UNIFORM_COUNT; i++)
+			{
+				if (strcmp(MOCK_UNIFORMS[i].name, name) == 0)
+				{
+					return(i);
+				}
+			}
+		}
+
+		return(-1);
+	}
+}
+
+/***********************************************************
+ *  Install()
+ *
+ *  This method is used for pointing the GLEW entry points at
+ *  the mock functions.
+ ***********************************************************/
+void MockGL::Install()
+{
+	__glewUniform1i = MockUniform1i;
+	__glewUniform1f = MockUniform1f;
+	__glewUniform2fv = MockUniform2fv;
+	__glewUniform3fv = MockUniform3fv;
+	__glewUniform4fv = MockUniform4fv;
+	__glewUniformMatrix4fv = MockUniformMatrix4fv;
+
+	__glewUseProgram = MockUseProgram;
+	__glewBindVertexArray = MockBindVertexArray;
+	__glewActiveTexture = MockActiveTexture;
+	__glewDeleteBuffers = MockDeleteBuffers;
+	__glewDeleteVertexArrays = MockDeleteVertexArrays;
+	__glewMakeTextureHandleNonResidentARB = MockMakeTextureHandleNonResident;
+
+	__glewGetProgramiv = MockGetProgramiv;
+	__glewGetActiveUniform = MockGetActiveUniform;
+	__glewGetUniformLocation = MockGetUniformLocation;
+
+	g_uniformCalls = 0;
+}
+
+/***********************************************************
+ *  GetUniformCalls()
+ *
+ *  This method is used for getting the number of uniform
+ *  uploads since the last reset.
+ ***********************************************************/
+long long MockGL::GetUniformCalls()
+{
+	return(g_uniformCalls);
+}
+
+/***********************************************************
+ *  ResetUniformCalls()
+ ***********************************************************/
+void MockGL::ResetUniformCalls()
+{
+	g_uniformCalls = 0;
+}
@@ -0,0 +1,43 @@
+///////////////////////////////////////////////////////////////////////////////
+// mockgl.h
+// ============
+// point the OpenGL entry points used on the per-draw paths at functions
+// that only count the calls, so the scene code runs with no context
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  MockGL
+ *
+ *  This class replaces the GLEW entry points that the scene
+ *  reaches while it is created, set up and destroyed and on
+ *  the per-draw paths - uniform uploads, program and vertex
+ *  array binds, buffer deletes and program reflection.  The
+ *  mock program reports the uniforms of the scene shaders,
+ *  so ShaderUniforms resolves real handles and the state
+ *  cache works as it does with a context.
+ *
+ *  Only GLEW pointers are replaced; the OpenGL 1.1 functions
+ *  are exported by the OpenGL library and do nothing when
+ *  there is no current context.
+ ***********************************************************/
+class MockGL
+{
+public:
+	// program ID the mock program reports uniforms for
+	static const GLuint MOCK_PROGRAM_ID = 1;
+
+	// replace the entry points - call before any scene code
+	static void Install();
+
+	// uniform uploads since the last reset
+	static long long GetUniformCalls();
+	static void ResetUniformCalls();
+};
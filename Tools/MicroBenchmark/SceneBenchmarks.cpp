@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebenchmarks.cpp
+// ============
+// micro-benchmarks of the helpers the scene and view run for every draw and
+// every frame - transforms, tag lookups, material selection and the camera
+// matrices - measured on the CPU against the mock OpenGL entry points
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+#include "MockGL.h"
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+#include <camera.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// declaration of the global variables and defines
+namespace
+{
+	// objects the helpers are called for in one frame of the
+	// scene, used to report the cost per frame
+	const int64_t FRAME_DRAW_COUNT = 64;
+
+	/***********************************************************
+	 *  MakeTag()
+	 *
+	 *  Tag of a test texture or material, as long as the tags of
+	 *  the scene so the hashing costs the same.
+	 ***********************************************************/
+	std::string MakeTag(const char* prefix, int index)
+	{
+		return(std::string(prefix) + "_cut_out_texture_" + std::to_string(index));
+	}
+
+	/***********************************************************
+	 *  MakeLabel()
+	 *
+	 *  Label with the uniform uploads of one iteration, which
+	 *  shows how many the state cache elided.
+	 ***********************************************************/
+	std::string MakeLabel(const BenchmarkState& state)
+	{
+		char label[64];
+		snprintf(label, sizeof(label), "%.2f uploads/iter",
+			(double)MockGL::GetUniformCalls() / (double)state.iterations());
+		return(label);
+	}
+}
+
+/***********************************************************
+ *  BenchmarkScene
+ *
+ *  This class opens up the protected per-draw helpers of
+ *  the scene manager to the benchmark fixture.
+ ***********************************************************/
+class BenchmarkScene : public SceneManager
+{
+public:
+	// constructor
+	BenchmarkScene(ShaderManager* pShaderManager, ShaderUniforms* pShaderUniforms)
+		: SceneManager(pShaderManager, pShaderUniforms)
+	{
+	}
+
+	using SceneManager::ResolveShaderUniforms;
+	using SceneManager::RegisterTexture;
+	using SceneManager::FindTextureSlot;
+	using SceneManager::FindMaterial;
+	using SceneManager::AddObjectMaterial;
+	using SceneManager::SetTransformations;
+};
+
+/***********************************************************
+ *  SceneManagerBenchmark
+ *
+ *  This class builds a scene manager with registered
+ *  textures and materials and no loaded meshes, and calls
+ *  its per-draw helpers for the benchmarks.
+ ***********************************************************/
+class SceneManagerBenchmark
+{
+public:
+	// constructor
+	SceneManagerBenchmark(int textureCount, int materialCount)
+	{
+		m_shaderUniforms.Reflect(m_shaderManager.m_programID);
+		m_pScene = new BenchmarkScene(&m_shaderManager, &m_shaderUniforms);
+		m_pScene->ResolveShaderUniforms();
+
+		for (int i = 0; i < textureCount; i++)
+		{
+			std::string tag = MakeTag("texture", i);
+			m_pScene->RegisterTexture(i, tag, "textures/" + tag + ".jpg", (uint64_t)i, false, true);
+			m_textureTags.push_back(tag);
+		}
+
+		for (int i = 0; i < materialCount; i++)
+		{
+			SceneManager::OBJECT_MATERIAL material;
+			material.ambientStrength = 0.2f;
+			material.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+			material.diffuseColor = glm::vec3(0.6f, 0.5f, 0.4f);
+			material.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
+			material.shininess = 8.0f + (float)i;
+			material.tag = MakeTag("material", i);
+			m_pScene->AddObjectMaterial(material);
+			m_materialTags.push_back(material.tag);
+		}
+
+		MockGL::ResetUniformCalls();
+	}
+
+	// destructor
+	~SceneManagerBenchmark()
+	{
+		if (NULL != m_pScene)
+		{
+			delete m_pScene;
+			m_pScene = NULL;
+		}
+	}
+
+	void SetTransformations(const glm::vec3& scaleXYZ, float rotationDegrees, const glm::vec3& positionXYZ)
+	{
+		m_pScene->SetTransformations(scaleXYZ, 0.0f, rotationDegrees, 0.0f, positionXYZ);
+	}
+	int FindTextureSlot(const std::string& tag)
+	{
+		return(m_pScene->FindTextureSlot(tag));
+	}
+	bool FindMaterial(const std::string& tag, SceneManager::OBJECT_MATERIAL& material)
+	{
+		return(m_pScene->FindMaterial(tag, material));
+	}
+	void SetShaderMaterial(const std::string& tag)
+	{
+		m_pScene->SetShaderMaterial(tag);
+	}
+	void SetShaderMaterial(int materialHandle)
+	{
+		m_pScene->SetShaderMaterial(materialHandle);
+	}
+
+	const std::vector<std::string>& GetTextureTags() const
+	{
+		return(m_textureTags);
+	}
+	const std::vector<std::string>& GetMaterialTags() const
+	{
+		return(m_materialTags);
+	}
+
+private:
+	ShaderManager m_shaderManager;
+	ShaderUniforms m_shaderUniforms;
+	BenchmarkScene* m_pScene;
+	std::vector<std::string> m_textureTags;
+	std::vector<std::string> m_materialTags;
+};
+
+/***********************************************************
+ *  BM_SetTransformations()
+ *
+ *  Compose and upload a model matrix that changes on every
+ *  draw, the common case while drawing the scene.
+ ***********************************************************/
+static void BM_SetTransformations(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture(0, 0);
+	glm::vec3 scaleXYZ(2.0f, 1.0f, 2.0f);
+	float offset = 0.0f;
+
+	while (state.KeepRunning())
+	{
+		offset += 0.001f;
+		fixture.SetTransformations(scaleXYZ, 45.0f, glm::vec3(offset, 1.0f, -offset));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_SetTransformations);
+
+/***********************************************************
+ *  BM_SetTransformationsUnchanged()
+ *
+ *  Compose the same model matrix on every draw, so the state
+ *  cache elides the upload and only the math is measured.
+ ***********************************************************/
+static void BM_SetTransformationsUnchanged(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture(0, 0);
+	glm::vec3 scaleXYZ(2.0f, 1.0f, 2.0f);
+	glm::vec3 positionXYZ(3.0f, 1.0f, -3.0f);
+
+	while (state.KeepRunning())
+	{
+		fixture.SetTransformations(scaleXYZ, 45.0f, positionXYZ);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_SetTransformationsUnchanged);
+
+/***********************************************************
+ *  BM_FindTextureSlot()
+ *
+ *  Look up registered texture tags in turn, with the number
+ *  of registered textures as the argument.
+ ***********************************************************/
+static void BM_FindTextureSlot(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture((int)state.range(0), 0);
+	const std::vector<std::string>& tags = fixture.GetTextureTags();
+	size_t next = 0;
+
+	while (state.KeepRunning())
+	{
+		int textureSlot = fixture.FindTextureSlot(tags[next]);
+		DoNotOptimize(textureSlot);
+		next = (next + 1 < tags.size()) ? next + 1 : 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindTextureSlot)->Arg(16)->Arg(1024);
+
+/***********************************************************
+ *  BM_FindTextureSlotMissing()
+ *
+ *  Look up a tag that was never registered.
+ ***********************************************************/
+static void BM_FindTextureSlotMissing(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture((int)state.range(0), 0);
+	std::string tag = MakeTag("missing", 0);
+
+	while (state.KeepRunning())
+	{
+		int textureSlot = fixture.FindTextureSlot(tag);
+		DoNotOptimize(textureSlot);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindTextureSlotMissing)->Arg(16)->Arg(1024);
+
+/***********************************************************
+ *  BM_FindMaterial()
+ *
+ *  Look up defined material tags in turn and copy out the
+ *  material, with the number of materials as the argument.
+ ***********************************************************/
+static void BM_FindMaterial(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture(0, (int)state.range(0));
+	const std::vector<std::string>& tags = fixture.GetMaterialTags();
+	SceneManager::OBJECT_MATERIAL material;
+	size_t next = 0;
+
+	while (state.KeepRunning())
+	{
+		bool bFound = fixture.FindMaterial(tags[next], material);
+		DoNotOptimize(bFound);
+		DoNotOptimize(material);
+		next = (next + 1 < tags.size()) ? next + 1 : 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindMaterial)->Arg(16)->Arg(1024);
+
+/***********************************************************
+ *  BM_SetShaderMaterialByTag()
+ *
+ *  Select materials by tag in turn, the way the scene code
+ *  names them.
+ ***********************************************************/
+static void BM_SetShaderMaterialByTag(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture(0, (int)state.range(0));
+	const std::vector<std::string>& tags = fixture.GetMaterialTags();
+	size_t next = 0;
+
+	while (state.KeepRunning())
+	{
+		fixture.SetShaderMaterial(tags[next]);
+		next = (next + 1 < tags.size()) ? next + 1 : 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_SetShaderMaterialByTag)->Arg(16)->Arg(1024);
+
+/***********************************************************
+ *  BM_SetShaderMaterialByHandle()
+ *
+ *  Select the same materials through the handles the render
+ *  queue keeps, which skips the tag lookup.
+ ***********************************************************/
+static void BM_SetShaderMaterialByHandle(BenchmarkState& state)
+{
+	int materialCount = (int)state.range(0);
+	SceneManagerBenchmark fixture(0, materialCount);
+	int next = 0;
+
+	while (state.KeepRunning())
+	{
+		fixture.SetShaderMaterial(next);
+		next = (next + 1 < materialCount) ? next + 1 : 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_SetShaderMaterialByHandle)->Arg(16)->Arg(1024);
+
+/***********************************************************
+ *  BM_DrawHelpersPerFrame()
+ *
+ *  Run the transform and material helpers for a frame worth
+ *  of draws, to see their share of the frame budget.
+ ***********************************************************/
+static void BM_DrawHelpersPerFrame(BenchmarkState& state)
+{
+	SceneManagerBenchmark fixture(0, 16);
+	const std::vector<std::string>& tags = fixture.GetMaterialTags();
+	glm::vec3 scaleXYZ(1.0f, 1.0f, 1.0f);
+
+	while (state.KeepRunning())
+	{
+		for (int64_t draw = 0; draw < FRAME_DRAW_COUNT; draw++)
+		{
+			float offset = (float)draw;
+			fixture.SetTransformations(scaleXYZ, offset, glm::vec3(offset, 0.0f, -offset));
+			fixture.SetShaderMaterial(tags[(size_t)draw % tags.size()]);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * FRAME_DRAW_COUNT);
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_DrawHelpersPerFrame);
+
+/***********************************************************
+ *  BM_CameraGetViewMatrix()
+ *
+ *  Build the view matrix of a moving camera.
+ ***********************************************************/
+static void BM_CameraGetViewMatrix(BenchmarkState& state)
+{
+	Camera camera;
+	camera.Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	camera.Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	camera.Up = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	while (state.KeepRunning())
+	{
+		camera.Position.x += 0.001f;
+		glm::mat4 view = camera.GetViewMatrix();
+		DoNotOptimize(view);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CameraGetViewMatrix);
+
+/***********************************************************
+ *  BM_BuildProjectionMatrix()
+ *
+ *  Build the projection matrix for the size of the view.
+ ***********************************************************/
+static void BM_BuildProjectionMatrix(BenchmarkState& state)
+{
+	ShaderManager shaderManager;
+	ViewManager viewManager(&shaderManager);
+
+	while (state.KeepRunning())
+	{
+		glm::mat4 projection = viewManager.BuildProjectionMatrix();
+		DoNotOptimize(projection);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BuildProjectionMatrix);
+
+/***********************************************************
+ *  BM_PrepareSceneView()
+ *
+ *  Run the per-frame view update with no window, which
+ *  builds both matrices and uploads the camera uniforms.
+ ***********************************************************/
+static void BM_PrepareSceneView(BenchmarkState& state)
+{
+	ShaderManager shaderManager;
+	ShaderUniforms shaderUniforms;
+	shaderUniforms.Reflect(shaderManager.m_programID);
+	ViewManager viewManager(&shaderManager);
+	viewManager.SetShaderUniforms(&shaderUniforms);
+	MockGL::ResetUniformCalls();
+
+	while (state.KeepRunning())
+	{
+		viewManager.PrepareSceneView(1.0f);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(MakeLabel(state));
+}
+BENCHMARK(BM_PrepareSceneView);
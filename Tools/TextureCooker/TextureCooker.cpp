@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecooker.cpp
+// ============
+// offline tool that compresses the scene texture images into BC1, BC3 or
+// BC7 blocks with their mipmaps and writes them next to the images as KTX2
+//
+// the tool is its own console target, built by the CMakeLists.txt in this
+// folder from this file together with Source/BlockCompression.cpp,
+// Source/ImageMipmaps.cpp and Source/KtxFile.cpp - it needs no OpenGL context
+//
+// usage: TextureCooker [--bc7] [--force] [image files...]
+//   --bc7    cook every image as BC7 instead of BC1/BC3
+//   --force  cook images whose cooked file is already up to date
+// without image files, every image in the scene texture folder is cooked
+//
+//  Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cmath>
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"      // Image loading Utility functions
+
+#include "BlockCompression.h"
+#include "ImageMipmaps.h"
+#include "KtxFile.h"
+
+// declaration of the global variables and defines
+namespace
+{
+	// folder of the scene textures, relative to the folder
+	// the scene is run from
+	const char* const DEFAULT_TEXTURE_FOLDER = "../../Utilities/textures";
+
+	// cooking options from the command line
+	struct COOK_OPTIONS
+	{
+		bool bUseBC7;
+		bool bForce;
+	};
+}
+
+// Function declarations
+bool IsSourceImage(const std::filesystem::path& path);
+bool CookTexture(const std::string& filename, const COOK_OPTIONS& options);
+double MeasurePSNR(const unsigned char* original, const unsigned char* decoded, int width, int height, int channels);
+
+/***********************************************************
+ *  main()
+ *
+ *  This function gets called after the application has been
+ *  launched.  It cooks the images named on the command line,
+ *  or every image of the scene texture folder.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	COOK_OPTIONS options;
+	options.bUseBC7 = false;
+	options.bForce = false;
+
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bc7") == 0)
+		{
+			options.bUseBC7 = true;
+		}
+		else if (strcmp(argv[i], "--force") == 0)
+		{
+			options.bForce = true;
+		}
+		else
+		{
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	if (filenames.empty())
+	{
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(DEFAULT_TEXTURE_FOLDER, error))
+		{
+			if (entry.is_regular_file() && IsSourceImage(entry.path()))
+			{
+				filenames.push_back(entry.path().string());
+			}
+		}
+		if (error)
+		{
+			std::cout << "Could not open texture folder:" << DEFAULT_TEXTURE_FOLDER << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	int failedCount = 0;
+	for (int i = 0; i < filenames.size(); i++)
+	{
+		if (CookTexture(filenames[i], options) == false)
+		{
+			failedCount++;
+		}
+	}
+
+	std::cout << "INFO: Cooked " << (filenames.size() - failedCount) << " of "
+		<< filenames.size() << " textures" << std::endl;
+
+	return (failedCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+ *  IsSourceImage()
+ *
+ *  This function is used for checking that a file is an
+ *  image the scene can load, by its extension.
+ ***********************************************************/
+bool IsSourceImage(const std::filesystem::path& path)
+{
+	std::string extension = path.extension().string();
+	for (int i = 0; i < extension.size(); i++)
+	{
+		extension[i] = (char)tolower((unsigned char)extension[i]);
+	}
+
+	return((extension == ".jpg") || (extension == ".jpeg") ||
+		(extension == ".png") || (extension == ".tga") || (extension == ".bmp"));
+}
+
+/***********************************************************
+ *  CookTexture()
+ *
+ *  This function is used for cooking one image.  The image
+ *  is flipped as it is loaded, like the scene loads it, and
+ *  its mipmaps are built with the same box filter before
+ *  every level is compressed.  Opaque images become BC1 and
+ *  images with alpha become BC3, unless BC7 was asked for.
+ *  An image whose cooked file already has its hash is
+ *  skipped.
+ ***********************************************************/
+bool CookTexture(const std::string& filename, const COOK_OPTIONS& options)
+{
+	uint64_t sourceHash = KtxFile::HashFile(filename.c_str());
+	if (sourceHash == 0)
+	{
+		std::cout << "Could not read image:" << filename << std::endl;
+		return(false);
+	}
+
+	std::string cookedPath = KtxFile::GetCookedPath(filename);
+	KtxFile::KTX_INFO cookedInfo;
+	if ((options.bForce == false) &&
+		KtxFile::ReadInfo(cookedPath.c_str(), cookedInfo) &&
+		(cookedInfo.sourceHash == sourceHash))
+	{
+		std::cout << "INFO: Up to date:" << cookedPath << std::endl;
+		return(true);
+	}
+
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	unsigned char* image = stbi_load(filename.c_str(), &width, &height, &colorChannels, 4);
+	if (NULL == image)
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(false);
+	}
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels:" << filename << std::endl;
+		stbi_image_free(image);
+		return(false);
+	}
+
+	std::vector<unsigned char> pixels(image, image + ((size_t)width * height * 4));
+	stbi_image_free(image);
+
+	BlockCompression::BLOCK_FORMAT format = BlockCompression::FORMAT_BC1;
+	if (options.bUseBC7)
+	{
+		format = BlockCompression::FORMAT_BC7;
+	}
+	else if (colorChannels == 4)
+	{
+		format = BlockCompression::FORMAT_BC3;
+	}
+
+	std::vector<ImageMipmaps::MIP_LEVEL> mipLevels;
+	ImageMipmaps::Generate(pixels, width, height, 4, mipLevels);
+
+	KtxFile::KTX_IMAGE cookedImage;
+	cookedImage.info.vkFormat = KtxFile::GetVkFormat(format);
+	cookedImage.info.width = width;
+	cookedImage.info.height = height;
+	cookedImage.info.levelCount = (int)mipLevels.size();
+	cookedImage.info.sourceHash = sourceHash;
+	cookedImage.info.sourceChannels = colorChannels;
+
+	for (int level = 0; level < mipLevels.size(); level++)
+	{
+		ImageMipmaps::MIP_LEVEL cookedLevel = mipLevels[level];
+		cookedLevel.offset = cookedImage.data.size();
+		BlockCompression::CompressImage(
+			format,
+			&pixels[mipLevels[level].offset],
+			cookedLevel.width,
+			cookedLevel.height,
+			cookedImage.data);
+		cookedLevel.size = cookedImage.data.size() - cookedLevel.offset;
+		cookedImage.levels.push_back(cookedLevel);
+	}
+
+	// measure the error of the first level
+	std::vector<unsigned char> decoded;
+	BlockCompression::DecompressImage(format, cookedImage.data.data(), width, height, decoded);
+	double psnr = MeasurePSNR(pixels.data(), decoded.data(), width, height, colorChannels);
+
+	if (KtxFile::Write(cookedPath.c_str(), cookedImage) == false)
+	{
+		std::cout << "Could not write cooked texture:" << cookedPath << std::endl;
+		return(false);
+	}
+
+	const char* formatNames[] = { "BC1", "BC3", "BC7" };
+	std::cout << "INFO: Cooked " << filename << " -> " << cookedPath
+		<< ", " << formatNames[format] << ", " << width << "x" << height
+		<< ", levels:" << cookedImage.info.levelCount
+		<< ", bytes:" << cookedImage.data.size() << " of " << pixels.size()
+		<< ", PSNR:" << psnr << " dB" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  MeasurePSNR()
+ *
+ *  This function is used for measuring the peak signal to
+ *  noise ratio of a decoded image against the original, over
+ *  the color channels the source image has.
+ ***********************************************************/
+double MeasurePSNR(const unsigned char* original, const unsigned char* decoded, int width, int height, int channels)
+{
+	double squaredError = 0.0;
+	size_t texelCount = (size_t)width * height;
+	for (size_t i = 0; i < texelCount; i++)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			double difference = (double)original[(i * 4) + c] - (double)decoded[(i * 4) + c];
+			squaredError += difference * difference;
+		}
+	}
+
+	double meanSquaredError = squaredError / ((double)texelCount * channels);
+	if (meanSquaredError <= 0.0)
+	{
+		return(99.0);
+	}
+
+	return(10.0 * std::log10((255.0 * 255.0) / meanSquaredError));
+}
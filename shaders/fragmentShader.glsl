@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// clustered phong lighting for the scene fragments - only the lights
+// assigned to the fragment's view-space cluster are evaluated, using the
+// entry of the material block selected by the draw or instance, and the
+// layer of the texture array selected the same way, wrapped into the
+// rectangle of the texture when it shares an atlas page and kept off
+// the mipmap levels of a streamed texture that are not resident
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+#extension GL_ARB_bindless_texture : enable
+
+// std140 layout - matches MaterialBuffer::GPU_MATERIAL
+struct Material {
+	vec3 ambientColor;
+	float ambientStrength;
+	vec3 diffuseColor;
+	float shininess;
+	vec3 specularColor;
+	float padding;
+};
+
+// std430 layout - matches LightManager::GPU_LIGHT
+struct LightSource {
+	vec4 position;			// xyz position, w range
+	vec4 direction;			// xyz direction, w type
+	vec4 ambientColor;		// w focal strength
+	vec4 diffuseColor;		// w specular intensity
+	vec4 specularColor;
+	vec4 spotCone;			// x cos inner, y cos outer
+};
+
+#define MAX_MATERIALS 64
+#define LIGHT_SPOT 1
+
+// size of the cluster grid - matches LightManager
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+in vec4 fragmentColor;
+in vec2 fragmentUVscale;
+flat in int fragmentMaterialIndex;
+flat in int fragmentTextureLayer;
+flat in vec4 fragmentTextureRect;
+
+out vec4 outFragmentColor;
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+uniform sampler2DArray objectTexture;
+uniform vec3 viewPosition;
+uniform mat4 view;
+
+// pixel size of a cluster tile, and the scale and bias that
+// turn log(view depth) into a depth slice
+uniform vec2 clusterTileSize = vec2(1.0f, 1.0f);
+uniform vec2 clusterDepthParams = vec2(0.0f, 0.0f);
+
+// every light source of the scene
+layout (std430, binding = 1) readonly buffer LightBuffer
+{
+	LightSource lights[];
+};
+
+// first index and count into lightIndices for every cluster
+layout (std430, binding = 2) readonly buffer ClusterBuffer
+{
+	uvec2 clusterRanges[];
+};
+
+// light indices of all of the clusters, one list after another
+layout (std430, binding = 3) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+#ifdef GL_ARB_bindless_texture
+// handle of every texture array, used instead of objectTexture
+// when the arrays are resident - the array index is packed above
+// the layer in fragmentTextureLayer
+layout (std430, binding = 5) readonly buffer TextureHandleBuffer
+{
+	uvec2 textureHandles[];
+};
+
+uniform bool bUseBindlessTextures = false;
+#endif
+
+// every object material, uploaded once at load time
+layout (std140) uniform MaterialBlock
+{
+	Material materials[MAX_MATERIALS];
+};
+
+// function prototypes
+uint FindCluster();
+vec4 SampleTexture(vec2 textureCoordinate);
+void ClampGradients(vec2 layerSize, float minLevel, inout vec2 gradientX, inout vec2 gradientY);
+vec3 CalcLightSource(LightSource light, Material surface, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+
+void main()
+{
+	// material of the current draw or instance
+	Material surface = materials[clamp(fragmentMaterialIndex, 0, MAX_MATERIALS - 1)];
+
+	if (bUseLighting == true)
+	{
+		// properties used for calculating the lighting
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 viewDirection = normalize(viewPosition - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+
+		// only the lights that reach this cluster
+		uvec2 clusterRange = clusterRanges[FindCluster()];
+		for (uint i = 0u; i < clusterRange.y; i++)
+		{
+			uint lightIndex = lightIndices[clusterRange.x + i];
+			phongResult += CalcLightSource(lights[lightIndex], surface, lightNormal, fragmentPosition, viewDirection);
+		}
+
+		if (bUseTexture == true)
+		{
+			vec4 textureColor = SampleTexture(fragmentTextureCoordinate * fragmentUVscale);
+			outFragmentColor = vec4(phongResult * textureColor.xyz, textureColor.a);
+		}
+		else
+		{
+			outFragmentColor = vec4(phongResult * fragmentColor.xyz, fragmentColor.a);
+		}
+	}
+	else
+	{
+		if (bUseTexture == true)
+		{
+			outFragmentColor = SampleTexture(fragmentTextureCoordinate * fragmentUVscale);
+		}
+		else
+		{
+			outFragmentColor = fragmentColor;
+		}
+	}
+}
+
+// find the cluster that holds the current fragment
+uint FindCluster()
+{
+	float viewDepth = max(-(view * vec4(fragmentPosition, 1.0f)).z, 0.0001f);
+	int slice = int(floor((log(viewDepth) * clusterDepthParams.x) - clusterDepthParams.y));
+	ivec2 tile = ivec2(gl_FragCoord.xy / clusterTileSize);
+
+	slice = clamp(slice, 0, CLUSTER_COUNT_Z - 1);
+	tile = clamp(tile, ivec2(0), ivec2(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1));
+
+	return(uint((((slice * CLUSTER_COUNT_Y) + tile.y) * CLUSTER_COUNT_X) + tile.x));
+}
+
+// stretch the gradients so that the sampled mipmap level is never finer
+// than the first level of a streamed texture that is resident
+void ClampGradients(vec2 layerSize, float minLevel, inout vec2 gradientX, inout vec2 gradientY)
+{
+	vec2 texelsX = gradientX * layerSize;
+	vec2 texelsY = gradientY * layerSize;
+	float level = 0.5f * log2(max(max(dot(texelsX, texelsX), dot(texelsY, texelsY)), 1.0e-8f));
+	if (level < minLevel)
+	{
+		float stretch = exp2(minLevel - level);
+		gradientX *= stretch;
+		gradientY *= stretch;
+	}
+}
+
+// sample the layer of the texture array selected for the fragment - the
+// coordinate repeats inside the texture rectangle, and the gradients of
+// the unwrapped coordinate keep the mipmap level steady across the wrap
+vec4 SampleTexture(vec2 textureCoordinate)
+{
+	vec2 rectCoordinate = fragmentTextureRect.xy + (fract(textureCoordinate) * fragmentTextureRect.zw);
+	vec2 gradientX = dFdx(textureCoordinate) * fragmentTextureRect.zw;
+	vec2 gradientY = dFdy(textureCoordinate) * fragmentTextureRect.zw;
+	// the layer sits in the low 16 bits and the finest level to
+	// sample in bits 24 to 27
+	float layer = float(fragmentTextureLayer & 0xFFFF);
+	float minLevel = float((fragmentTextureLayer >> 24) & 0xF);
+
+#ifdef GL_ARB_bindless_texture
+	if (bUseBindlessTextures == true)
+	{
+		sampler2DArray textureArray = sampler2DArray(textureHandles[(fragmentTextureLayer >> 16) & 0xFF]);
+		if (minLevel > 0.0f)
+		{
+			ClampGradients(vec2(textureSize(textureArray, 0).xy), minLevel, gradientX, gradientY);
+		}
+		return(textureGrad(textureArray, vec3(rectCoordinate, layer), gradientX, gradientY));
+	}
+#endif
+
+	if (minLevel > 0.0f)
+	{
+		ClampGradients(vec2(textureSize(objectTexture, 0).xy), minLevel, gradientX, gradientY);
+	}
+	return(textureGrad(objectTexture, vec3(rectCoordinate, layer), gradientX, gradientY));
+}
+
+// calculate the phong contribution of one light source
+vec3 CalcLightSource(LightSource light, Material surface, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	vec3 lightOffset = light.position.xyz - vertexPosition;
+	float lightDistance = length(lightOffset);
+	vec3 lightDirection = lightOffset / max(lightDistance, 0.0001f);
+
+	// smooth window that fades the light out at its range - a
+	// light with no range is not faded at all
+	float attenuation = 1.0f;
+	if (light.position.w > 0.0f)
+	{
+		float rangeRatio = lightDistance / light.position.w;
+		attenuation = clamp(1.0f - (rangeRatio * rangeRatio * rangeRatio * rangeRatio), 0.0f, 1.0f);
+		attenuation *= attenuation;
+	}
+
+	// spot lights fade between the inner and the outer cone
+	if (int(light.direction.w) == LIGHT_SPOT)
+	{
+		float spotCosine = dot(-lightDirection, light.direction.xyz);
+		attenuation *= smoothstep(light.spotCone.y, light.spotCone.x, spotCosine);
+	}
+
+	// ambient lighting
+	ambient = light.ambientColor.rgb * surface.ambientColor * surface.ambientStrength;
+
+	// diffuse lighting
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	diffuse = impact * light.diffuseColor.rgb * surface.diffuseColor;
+
+	// specular lighting - focal strength and intensity are packed in w
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), light.ambientColor.w);
+	specular = light.diffuseColor.w * specularComponent * light.specularColor.rgb * surface.specularColor;
+
+	return(attenuation * (ambient + diffuse + specular));
+}
@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the scene vertices - per-draw values come from the uniforms,
+// from the per-instance attributes when bUseInstancing is set, or from
+// the draw buffer when bUseDrawBuffer is set
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+// per-instance attributes - the model matrix uses locations 3 to 6
+layout (location = 3) in mat4 inInstanceModel;
+layout (location = 7) in vec4 inInstanceColor;
+layout (location = 8) in vec2 inInstanceUVscale;
+layout (location = 9) in int inInstanceMaterial;
+layout (location = 11) in int inInstanceTextureLayer;
+layout (location = 12) in vec4 inInstanceTextureRect;
+
+// index into the draw buffer - an instanced attribute counting up
+// from the base instance of each indirect draw command
+layout (location = 10) in uint inDrawIndex;
+
+// per-draw values of the multi-draw indirect path
+struct DrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 UVscale;
+	int materialIndex;
+	int textureLayer;
+	vec4 textureRect;
+};
+
+layout (std430, binding = 4) readonly buffer DrawBuffer
+{
+	DrawData draws[];
+};
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+out vec4 fragmentColor;
+out vec2 fragmentUVscale;
+flat out int fragmentMaterialIndex;
+flat out int fragmentTextureLayer;
+flat out vec4 fragmentTextureRect;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform bool bUseInstancing = false;
+uniform bool bUseDrawBuffer = false;
+uniform vec4 objectColor = vec4(1.0f);
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+uniform int materialIndex = 0;
+uniform int textureLayer = 0;
+uniform vec4 textureRect = vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+void main()
+{
+	mat4 modelMatrix = model;
+
+	if (bUseDrawBuffer == true)
+	{
+		DrawData draw = draws[inDrawIndex];
+		modelMatrix = draw.model;
+		fragmentColor = draw.color;
+		fragmentUVscale = draw.UVscale;
+		// draws without a material keep the current one
+		fragmentMaterialIndex = (draw.materialIndex >= 0) ? draw.materialIndex : materialIndex;
+		fragmentTextureLayer = draw.textureLayer;
+		fragmentTextureRect = draw.textureRect;
+	}
+	else if (bUseInstancing == true)
+	{
+		modelMatrix = inInstanceModel;
+		fragmentColor = inInstanceColor;
+		fragmentUVscale = inInstanceUVscale;
+		// instances without a material keep the current one
+		fragmentMaterialIndex = (inInstanceMaterial >= 0) ? inInstanceMaterial : materialIndex;
+		fragmentTextureLayer = inInstanceTextureLayer;
+		fragmentTextureRect = inInstanceTextureRect;
+	}
+	else
+	{
+		fragmentColor = objectColor;
+		fragmentUVscale = UVscale;
+		fragmentMaterialIndex = materialIndex;
+		fragmentTextureLayer = textureLayer;
+		fragmentTextureRect = textureRect;
+	}
+
+	// transforms vertices into clip coordinates
+	gl_Position = projection * view * modelMatrix * vec4(inVertexPosition, 1.0f);
+
+	// gets fragment / pixel position in world space only (exclude view and projection)
+	fragmentPosition = vec3(modelMatrix * vec4(inVertexPosition, 1.0f));
+
+	// get normal vectors in world space only and exclude normal translation properties
+	fragmentVertexNormal = mat3(transpose(inverse(modelMatrix))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+}